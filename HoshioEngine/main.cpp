@@ -4,6 +4,7 @@
 #include "Engine/ShaderEditor/RenderGraph/DrawScreenNode.h"
 #include "Engine/Panel/Editor/EditorGUIManager.h"
 #include "Engine/Panel/Editor/EditorInspectorPanel.h"
+#include "Utils/TextureCooker.h"
 #include "test/SimplePathTrace/SimplePathTrace.h"
 #include "test/Test3D/Test3D.h"
 #include "test/TestModel/TestModel.h"
@@ -19,12 +20,18 @@ int main() {
 
 		Fence& fence = VulkanPlus::Plus().CreateFences("test-fence", 1).second[0];
 
+#ifndef NDEBUG
+		ShaderCompiler::Compiler().StartHotReload();
+#endif // !NDEBUG
+
 		Semaphore semaphore_image_available;
 		Semaphore semaphore_render_over;
 
 		VulkanPlus::Plus().CreateTexture2D("test", "res/images/icon-1024.png", VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM, true);
 		Texture2D& texture = VulkanPlus::Plus().GetTexture2D("test").second[0];
-		Texture2D bg("res/images/kayoko-bg.png", VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM, true);
+		//Cooked once into a KTX2 with its mips, DrawScreenNode streams in what the swapchain's size needs
+		TextureCooker::Cook("res/images/kayoko-bg.png", "cache/textures/kayoko-bg.ktx2", { .format = COOK_FORMAT::RGBA8, .srgb = false });
+		int bg = VulkanPlus::Plus().CreateStreamedTexture2D("kayoko-bg", "cache/textures/kayoko-bg.ktx2").first;
 
 
 		Sampler& sampler_linear = VulkanPlus::Plus().CreateSampler("sampler_linear", Sampler::SamplerCreateInfo()).second[0];
@@ -54,8 +61,8 @@ int main() {
 			//std::unique_ptr<RenderNode> testPBR = std::make_unique<TestPBR>();
 			//testPBR->Init();
 			
-			std::unique_ptr<RenderNode> testCubeMap = std::make_unique<TestCubeMap>();
-			testCubeMap->Init();
+			//std::unique_ptr<RenderNode> testCubeMap = std::make_unique<TestCubeMap>();
+			//testCubeMap->Init();
 
 			//EditorGUIManager::Instance().editorPanels.push_back(std::make_unique<CurvePanel>());
 
@@ -69,7 +76,12 @@ int main() {
 
 				commandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
-				testCubeMap->Render();
+				//Before any draw is recorded, it may rewrite descriptor sets
+				VulkanPlus::Plus().TextureStreaming().Update(commandBuffer);
+
+				//Requests the background's levels for this swapchain, the next Update() streams them in
+				drawScreenNode->Render();
+				//testCubeMap->Render();
 
 				commandBuffer.End();
 
@@ -84,8 +96,16 @@ int main() {
 
 				fence.Wait();
 				fence.Reset();
+
+				//The previous frame has retired, swapping pipelines here cannot race the GPU
+				ShaderCompiler::Compiler().ApplyPendingReloads();
+				VulkanPlus::Plus().CollectAsyncPipelines();
+				GeometryPool::Pool().ReleaseRetired();
+				FrameMemory::EndFrame();
 			}
 
+			ShaderCompiler::Compiler().StopHotReload();
+			VulkanPlus::Plus().WaitAsyncPipelines();
 			VulkanBase::Base().WaitIdle();
 		}
 		VulkanBase::Base().WaitIdle();
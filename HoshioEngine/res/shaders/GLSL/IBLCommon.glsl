@@ -0,0 +1,65 @@
+/*
+* Shared by the IBLBaker passes. Every pass runs 8x8 threads per workgroup, one workgroup z per cube face,
+* writes binding 1 and reads binding 0 (cube faces are written through 2D array views).
+*/
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(push_constant) uniform pushConstant {
+	float roughness;
+	uint sampleCount;
+};
+
+const float PI = 3.14159265359;
+
+// Direction through the center of texel p of a size x size cube face, Vulkan face order and orientation
+vec3 CubeDirection(uint face, ivec2 p, int size) {
+	vec2 uv = (vec2(p) + 0.5) / float(size) * 2.0 - 1.0;
+	vec3 direction;
+	switch (face) {
+	case 0: direction = vec3(1.0, -uv.y, -uv.x); break;
+	case 1: direction = vec3(-1.0, -uv.y, uv.x); break;
+	case 2: direction = vec3(uv.x, 1.0, uv.y); break;
+	case 3: direction = vec3(uv.x, -1.0, -uv.y); break;
+	case 4: direction = vec3(uv.x, -uv.y, 1.0); break;
+	default: direction = vec3(-uv.x, -uv.y, -1.0); break;
+	}
+	return normalize(direction);
+}
+
+vec2 Hammersley(uint i, uint n) {
+	return vec2(float(i) / float(n), float(bitfieldReverse(i)) * 2.3283064365386963e-10);
+}
+
+// Tangent space sample around n
+vec3 ToWorld(vec3 v, vec3 n) {
+	vec3 up = abs(n.z) < 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(1.0, 0.0, 0.0);
+	vec3 tangent = normalize(cross(up, n));
+	vec3 bitangent = cross(n, tangent);
+	return tangent * v.x + bitangent * v.y + n * v.z;
+}
+
+// Half vector distributed by GGX D * NdotH, alpha = roughness^2
+vec3 ImportanceSampleGGX(vec2 xi, vec3 n, float roughness) {
+	float a = roughness * roughness;
+	float phi = 2.0 * PI * xi.x;
+	float cosTheta = sqrt((1.0 - xi.y) / (1.0 + (a * a - 1.0) * xi.y));
+	float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+	return ToWorld(vec3(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta), n);
+}
+
+float DistributionGGX(float NdotH, float roughness) {
+	float a2 = roughness * roughness * roughness * roughness;
+	float d = NdotH * NdotH * (a2 - 1.0) + 1.0;
+	return a2 / (PI * d * d);
+}
+
+/*
+* Filtered importance sampling: a sample of density pdf stands for 1 / (sampleCount * pdf) steradians,
+* read the source level whose texels cover about that much instead of aliasing on level 0.
+*/
+float SourceLod(float pdf, int sourceSize) {
+	float texelSolidAngle = 4.0 * PI / (6.0 * float(sourceSize * sourceSize));
+	float sampleSolidAngle = 1.0 / (float(sampleCount) * pdf + 1e-4);
+	return max(0.5 * log2(sampleSolidAngle / texelSolidAngle) + 1.0, 0.0);
+}
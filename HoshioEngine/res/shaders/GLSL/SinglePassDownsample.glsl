@@ -0,0 +1,112 @@
+/*
+* Single pass downsampler, in the style of AMD FidelityFX SPD.
+* Every workgroup reduces a 64x64 tile of level 0 into levels 1-6 through shared memory,
+* the last workgroup of each layer to finish then reduces level 6 into levels 7-12.
+* The including shader defines vec4 Reduce(vec4 v0, vec4 v1, vec4 v2, vec4 v3) before including this file.
+* STORAGE_FORMAT:	format qualifier of the destination views, e.g. rgba8
+* SRGB:				destinations are UNORM views of an sRGB image, values are encoded/decoded here
+*/
+
+layout(local_size_x = 256) in;
+
+layout(binding = 0) uniform sampler2DArray u_Source;
+layout(binding = 1, STORAGE_FORMAT) uniform coherent image2DArray u_Destinations[12];
+layout(binding = 2) coherent buffer AtomicCounters {
+	uint counters[];	// one per layer, zeroed before the dispatch
+};
+
+layout(push_constant) uniform pushConstant {
+	uint mipCount;			// levels written after level 0, 1-12
+	uint workGroupCount;	// workgroups per layer
+};
+
+shared vec4 s_Tile[16][16];
+shared bool s_IsLastGroup;
+
+#ifdef SRGB
+vec3 SrgbToLinear(vec3 c) {
+	return mix(c / 12.92, pow((c + 0.055) / 1.055, vec3(2.4)), greaterThan(c, vec3(0.04045)));
+}
+
+vec3 LinearToSrgb(vec3 c) {
+	return mix(c * 12.92, 1.055 * pow(c, vec3(1.0 / 2.4)) - 0.055, greaterThan(c, vec3(0.0031308)));
+}
+#endif
+
+// Array elements are only ever indexed with constants, no dynamic indexing feature is needed
+#define STORE_CASE(i) case i + 1: if (all(lessThan(p, imageSize(u_Destinations[i]).xy))) imageStore(u_Destinations[i], ivec3(p, layer), value); break;
+
+void Store(uint mip, ivec2 p, int layer, vec4 value) {
+#ifdef SRGB
+	value.rgb = LinearToSrgb(value.rgb);
+#endif
+	switch (mip) {
+	STORE_CASE(0) STORE_CASE(1) STORE_CASE(2) STORE_CASE(3) STORE_CASE(4) STORE_CASE(5)
+	STORE_CASE(6) STORE_CASE(7) STORE_CASE(8) STORE_CASE(9) STORE_CASE(10) STORE_CASE(11)
+	}
+}
+
+// Reads outside the level are clamped to its edge, like a blit of an odd extent
+vec4 Load(uint baseMip, ivec2 p, int layer) {
+	if (baseMip == 0)
+		return texelFetch(u_Source, ivec3(min(p, textureSize(u_Source, 0).xy - 1), layer), 0);
+	vec4 value = imageLoad(u_Destinations[5], ivec3(min(p, imageSize(u_Destinations[5]).xy - 1), layer));
+#ifdef SRGB
+	value.rgb = SrgbToLinear(value.rgb);
+#endif
+	return value;
+}
+
+// Writes levels baseMip + 1 to baseMip + 6 of the 64x64 tile of baseMip at tile * 64
+void DownsampleTile(uint baseMip, ivec2 tile, int layer) {
+	ivec2 thread = ivec2(gl_LocalInvocationIndex % 16, gl_LocalInvocationIndex / 16);
+
+	// Every thread owns a 4x4 block: 2x2 texels of the first level, one of the second
+	vec4 texels[4];
+	for (int i = 0; i < 4; i++) {
+		ivec2 offset = ivec2(i & 1, i >> 1);
+		ivec2 p = tile * 64 + thread * 4 + offset * 2;
+		texels[i] = Reduce(Load(baseMip, p, layer), Load(baseMip, p + ivec2(1, 0), layer),
+			Load(baseMip, p + ivec2(0, 1), layer), Load(baseMip, p + ivec2(1, 1), layer));
+		Store(baseMip + 1, tile * 32 + thread * 2 + offset, layer, texels[i]);
+	}
+	if (mipCount < baseMip + 2)
+		return;
+	vec4 value = Reduce(texels[0], texels[1], texels[2], texels[3]);
+	Store(baseMip + 2, tile * 16 + thread, layer, value);
+	s_Tile[thread.y][thread.x] = value;
+	barrier();
+
+	// The rest goes through shared memory, each level keeps a quarter of the threads busy
+	int size = 8;
+	for (uint mip = baseMip + 3; mip <= baseMip + 6 && mip <= mipCount; mip++, size /= 2) {
+		bool active = all(lessThan(thread, ivec2(size)));
+		if (active)
+			value = Reduce(s_Tile[thread.y * 2][thread.x * 2], s_Tile[thread.y * 2][thread.x * 2 + 1],
+				s_Tile[thread.y * 2 + 1][thread.x * 2], s_Tile[thread.y * 2 + 1][thread.x * 2 + 1]);
+		barrier();
+		if (active) {
+			s_Tile[thread.y][thread.x] = value;
+			Store(mip, tile * size + thread, layer, value);
+		}
+		barrier();
+	}
+}
+
+void main() {
+	int layer = int(gl_WorkGroupID.z);
+	DownsampleTile(0u, ivec2(gl_WorkGroupID.xy), layer);
+	if (mipCount <= 6)
+		return;
+
+	// Publish this group's part of level 6, the group that finishes a layer last carries on alone
+	memoryBarrierImage();
+	barrier();
+	if (gl_LocalInvocationIndex == 0)
+		s_IsLastGroup = atomicAdd(counters[layer], 1u) == workGroupCount - 1u;
+	barrier();
+	if (!s_IsLastGroup)
+		return;
+	memoryBarrierImage();
+	DownsampleTile(6u, ivec2(0), layer);
+}
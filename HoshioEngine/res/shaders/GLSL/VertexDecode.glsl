@@ -0,0 +1,12 @@
+/*
+* Decoding for vertex elements of Engine/Actor/VertexFormat.h the vertex fetch does not do on its own.
+* SNORM, UNORM and SFLOAT16 attributes already arrive as floats.
+*/
+
+// oct16: unit vector folded onto an octahedron, e is the R16G16_SNORM attribute
+vec3 OctDecode(vec2 e) {
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+	return normalize(n);
+}
@@ -27,6 +27,11 @@ namespace HoshioEngine {
 
 		void UnMapMemory(VkDeviceSize size, VkDeviceSize offset = 0) const;
 
+		//For memory that stays mapped, no-ops on coherent memory
+		void FlushMemory(VkDeviceSize size, VkDeviceSize offset = 0) const;
+
+		void InvalidateMemory(VkDeviceSize size, VkDeviceSize offset = 0) const;
+
 		void SynchronizeData(const void* pData_src, VkDeviceSize size, VkDeviceSize offset = 0) const;
 
 		void RetrieveData(void* pData_dst, VkDeviceSize size, VkDeviceSize offset = 0) const;
@@ -74,6 +79,8 @@ namespace HoshioEngine {
 
 		void MapMemory(void*& pData, VkDeviceSize size, VkDeviceSize offset = 0) const;
 		void UnMapMemory(VkDeviceSize size, VkDeviceSize offset = 0) const;
+		void FlushMemory(VkDeviceSize size, VkDeviceSize offset = 0) const;
+		void InvalidateMemory(VkDeviceSize size, VkDeviceSize offset = 0) const;
 		void SynchronizeData(const void* pData_src, VkDeviceSize size, VkDeviceSize offset = 0) const;
 		void RetrieveData(void* pData_dst, VkDeviceSize size, VkDeviceSize offset = 0) const;
 
@@ -1,7 +1,9 @@
 #ifndef _PIPELINE_MANAGER_H_
 #define _PIPELINE_MANAGER_H_
 
-#include "Base/VulkanBase.h"
+#include "Base/ShaderCompiler.h"
+#include "Utils/WorkerPool.h"
+#include <list>
 
 namespace HoshioEngine {
 	class ShaderModule {
@@ -49,6 +51,7 @@ namespace HoshioEngine {
 		Pipeline(VkComputePipelineCreateInfo& createInfo);
 		Pipeline(Pipeline&& other);
 		~Pipeline();
+		Pipeline& operator=(Pipeline&& other) noexcept;
 		operator VkPipeline() const;
 		const VkPipeline* Address() const;
 
@@ -155,6 +158,15 @@ namespace HoshioEngine {
 
 		PipelineConfigurator& AddVertexInputAttribute(uint32_t location, uint32_t binding, VkFormat format, uint32_t offset);
 
+		//Binding and attributes of a VertexFormat<...> (Engine/Actor/VertexFormat.h), locations start at firstLocation
+		template<typename Format>
+		PipelineConfigurator& AddVertexFormat(uint32_t binding, VkVertexInputRate inputRate = VK_VERTEX_INPUT_RATE_VERTEX, uint32_t firstLocation = 0) {
+			auto attributes = Format::AttributeDescriptions(binding, firstLocation);
+			AddVertexInputBindings(binding, Format::stride, inputRate);
+			vertexInputAttributes.insert(vertexInputAttributes.end(), attributes.begin(), attributes.end());
+			return *this;
+		}
+
 		PipelineConfigurator& PrimitiveTopology(VkPrimitiveTopology topology, VkBool32 primitiveRestartEnable = VK_FALSE);
 
 		PipelineConfigurator& TessPatchControlPoints(uint32_t controlPointCount);
@@ -215,6 +227,19 @@ namespace HoshioEngine {
 
 	class PipelineManager {
 	private:
+		struct AsyncPipeline {
+			std::future<Pipeline> future;
+			//Drawn with while the future is pending (or failed); M_INVALID_ID means skip the draw
+			int fallback_id = M_INVALID_ID;
+			//Order of the request, see RetiredShaderModule
+			uint64_t serial = 0;
+		};
+		//Replaced while requests were pending, destroyed once every request issued before serial has finished
+		struct RetiredShaderModule {
+			ShaderModule module;
+			uint64_t serial;
+		};
+
 		int m_shader_module_id = 0;
 		int m_pipeline_layout_id = 0;
 		int m_pipeline_id = 0;
@@ -225,16 +250,29 @@ namespace HoshioEngine {
 		std::unordered_map<int, PipelineLayout> mPipelineLayouts;
 		std::unordered_map<std::string, int> mPipelineIDs;
 		std::unordered_map<int, Pipeline> mPipelines;
+		std::unordered_map<int, AsyncPipeline> mAsyncPipelines;
+		std::vector<AsyncPipeline> discardedPipelines;
+		//A list, ShaderModule cannot be move assigned
+		std::list<RetiredShaderModule> retiredShaderModules;
+		uint64_t m_async_serial = 0;
+		//Declared last so that it is joined before anything a queued build reads goes away
+		WorkerPool pipelineWorkers;
+
+		void RetireShaderModule(ShaderModule& shaderModule);
+		void ReleaseRetiredShaderModules();
 
 		std::pair<int, std::span<ShaderModule>> RecreateShaderModule(int id, std::string& file_path);
 		std::pair<int, std::span<ShaderModule>> RecreateShaderModule(int id, size_t codeSize, const uint32_t* pCode);
 		std::pair<int, std::span<PipelineLayout>> RecreatePipelineLayout(int id, VkPipelineLayoutCreateInfo& createInfo);
 		std::pair<int, std::span<Pipeline>> RecreatePipeline(int id, VkGraphicsPipelineCreateInfo& createInfo);
 		std::pair<int, std::span<Pipeline>> RecreatePipeline(int id, VkComputePipelineCreateInfo& createInfo);
+		int RegisterAsyncPipeline(std::string& name, std::future<Pipeline> future, int fallback_id);
 
 	public:
 		std::pair<int, std::span<ShaderModule>> CreateShaderModule(std::string name, std::string file_path);
 		std::pair<int, std::span<ShaderModule>> CreateShaderModule(std::string name, size_t codeSize, const uint32_t* pCode);
+		std::pair<int, std::span<ShaderModule>> CreateShaderModule(std::string name, const ShaderCompileInfo& compileInfo);
+		int WatchShaderModule(std::string name, const ShaderCompileInfo& compileInfo, std::function<void()> onReloaded);
 		std::pair<int, std::span<ShaderModule>> GetShaderModule(std::string name);
 		std::pair<int, std::span<ShaderModule>> GetShaderModule(int id);
 		bool HasShaderModule(std::string name);
@@ -257,6 +295,21 @@ namespace HoshioEngine {
 		bool HasPipeline(std::string name);
 		bool HasPipeline(int id);
 		size_t GetPipelineCount() const;
+
+		/*
+		* Async pipelines: creation runs on a worker, the id is usable immediately.
+		* Until the pipeline is installed by CollectAsyncPipelines(), ResolvePipeline() returns the
+		* previous pipeline of that name, else the fallback, else VK_NULL_HANDLE (skip the draw).
+		* Builds run on a fixed pool of workers. Shader modules referenced by the create info must stay alive until
+		* the request completes; modules replaced through CreateShaderModule() are kept until then on their own.
+		*/
+		int RequestPipeline(std::string name, const PipelineConfigurator& configurator, int fallback_id = M_INVALID_ID);
+		int RequestPipeline(std::string name, const VkComputePipelineCreateInfo& createInfo, int fallback_id = M_INVALID_ID);
+		VkPipeline ResolvePipeline(int id);
+		bool IsPipelineReady(int id);
+		//Call at a frame boundary, the replaced pipelines are destroyed immediately, retired shader modules once no build needs them
+		uint32_t CollectAsyncPipelines();
+		void WaitAsyncPipelines();
 	};
 }
 
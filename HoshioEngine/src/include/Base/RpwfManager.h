@@ -2,11 +2,15 @@
 #define _FBO_MANAGER_H_
 
 #include "Base/VulkanBase.h"
+#include <array>
 
 namespace HoshioEngine {
 	class RenderPass {
 	private:
 		VkRenderPass handle = VK_NULL_HANDLE;
+		uint64_t compatibilityHash = 0;
+
+		static uint64_t HashCompatibility(const VkRenderPassCreateInfo& createInfo);
 	public:
 		RenderPass() = default;
 		RenderPass(VkRenderPassCreateInfo& createInfo);
@@ -19,10 +23,16 @@ namespace HoshioEngine {
 
 		void Begin(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer, VkRect2D renderArea, ArrayRef<const VkClearValue> clearValues = {}, VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE) const;
 
+		//For imageless framebuffers, the views are bound here instead of at framebuffer creation
+		void Begin(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer, ArrayRef<const VkImageView> attachments, VkRect2D renderArea, ArrayRef<const VkClearValue> clearValues = {}, VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE) const;
+
 		void NextSubpass(VkCommandBuffer commandBuffer, VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE) const;
 
 		void End(VkCommandBuffer commandBuffer) const;
 
+		//Equal for render passes that are compatible, i.e. may share framebuffers and pipelines
+		uint64_t CompatibilityHash() const;
+
 		void Create(VkRenderPassCreateInfo& createInfo);
 	};
 
@@ -42,6 +52,27 @@ namespace HoshioEngine {
 
 	class RpwfManager {
 	private:
+		struct FramebufferKey {
+			uint64_t renderPassCompatibility = 0;
+			uint32_t width = 0;
+			uint32_t height = 0;
+			uint32_t layers = 1;
+			bool imageless = false;
+			//Inline so that a lookup, done every frame, never allocates
+			static constexpr uint32_t maxAttachmentWords = 48;
+			//Image view handles, or the packed attachment image infos of an imageless framebuffer; unused words stay 0
+			std::array<uint64_t, maxAttachmentWords> attachments = {};
+			uint32_t attachmentCount = 0;
+
+			void Push(uint64_t word);
+			std::span<const uint64_t> Attachments() const { return { attachments.data(), attachmentCount }; }
+			bool operator==(const FramebufferKey& other) const = default;
+		};
+
+		struct FramebufferKeyHash {
+			size_t operator()(const FramebufferKey& key) const;
+		};
+
 		int m_renderpass_id = 0;
 		int m_framebuffer_id = 0;
 
@@ -49,6 +80,7 @@ namespace HoshioEngine {
 		std::unordered_map<int, RenderPass> mRenderPasses;
 		std::unordered_map<std::string, int> mFramebufferIDs;
 		std::unordered_map<int, std::vector<Framebuffer>> mFramebuffers;
+		std::unordered_map<FramebufferKey, Framebuffer, FramebufferKeyHash> mFramebufferCache;
 
 		std::pair<int, std::span<RenderPass>> RecreateRenderPass(int id, VkRenderPassCreateInfo& createInfo);
 		std::pair<int, std::span<Framebuffer>> RecreateFramebuffers(int id, uint32_t count, std::vector<VkFramebufferCreateInfo>& createInfos);
@@ -70,6 +102,20 @@ namespace HoshioEngine {
 		bool HasFramebuffer(std::string name);
 		bool HasFramebuffer(int id);
 		size_t GetFramebuffersCount() const;
+
+		/*
+		* Cached framebuffers, shared by every caller that asks for the same attachments with a compatible render pass.
+		* The returned reference stays valid until the entry is evicted. Evict before destroying an image view that was
+		* passed in here, a recycled handle would otherwise hit the stale framebuffer.
+		*/
+		const Framebuffer& AcquireFramebuffer(const RenderPass& renderPass, ArrayRef<const VkImageView> attachments, VkExtent2D extent, uint32_t layers = 1);
+		//Requires VulkanBase::ImagelessFramebufferSupported(), views are given to RenderPass::Begin each frame
+		const Framebuffer& AcquireImagelessFramebuffer(const RenderPass& renderPass, ArrayRef<const VkFramebufferAttachmentImageInfo> attachmentImageInfos, VkExtent2D extent, uint32_t layers = 1);
+		//Evicts every cached framebuffer that references one of the views; the GPU must be done with them
+		uint32_t EvictFramebuffers(ArrayRef<const VkImageView> attachments);
+		bool EvictFramebuffer(VkFramebuffer framebuffer);
+		void ClearFramebufferCache();
+		size_t GetFramebufferCacheCount() const;
 	};
 
 	
@@ -18,28 +18,45 @@ namespace HoshioEngine {
 
 		void Create(VkSamplerCreateInfo& createInfo);
 
-		static VkSamplerCreateInfo& SamplerCreateInfo(VkFilter magFilter = VK_FILTER_LINEAR,
+		static VkSamplerCreateInfo SamplerCreateInfo(VkFilter magFilter = VK_FILTER_LINEAR,
 			VkFilter minFilter = VK_FILTER_LINEAR,
 			VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR);
 
 	};
 
+	/*
+	* Samplers are deduplicated by the content of their create info: creating the same sampler
+	* under another name (or with AcquireSampler) returns the existing object. Samplers are
+	* never recreated in place, since other names/layouts may share them.
+	*/
 	class SamplerManager {
 	private:
 		int m_sampler_id = 0;
 
 		std::unordered_map<std::string, int> mSamplerIDs;
 		std::unordered_map<int, Sampler> mSamplers;
+		//Normalized create info of each cached sampler, hash -> ids handles collisions
+		std::unordered_map<int, VkSamplerCreateInfo> mSamplerCreateInfos;
+		std::unordered_map<uint64_t, std::vector<int>> mSamplerCache;
+		std::unordered_map<int, std::vector<VkSampler>> mImmutableSamplers;
 
-		std::pair<int, std::span<Sampler>> RecreateSampler(int id, VkSamplerCreateInfo& createInfo);
+		static VkSamplerCreateInfo NormalizeCreateInfo(const VkSamplerCreateInfo& createInfo);
+		static uint64_t HashCreateInfo(const VkSamplerCreateInfo& createInfo);
+		static bool EqualCreateInfo(const VkSamplerCreateInfo& a, const VkSamplerCreateInfo& b);
+
+		int FindCachedSampler(const VkSamplerCreateInfo& normalized, uint64_t hash) const;
 
 	public:
-		std::pair<int, std::span<Sampler>> CreateSampler(std::string name, VkSamplerCreateInfo& createInfo);
+		std::pair<int, std::span<Sampler>> CreateSampler(std::string name, const VkSamplerCreateInfo& createInfo);
+		std::pair<int, std::span<Sampler>> AcquireSampler(const VkSamplerCreateInfo& createInfo);
 		std::pair<int, std::span<Sampler>> GetSampler(std::string name);
 		std::pair<int, std::span<Sampler>> GetSampler(int id);
 		bool HasSampler(std::string name);
 		bool HasSampler(int id);
 		size_t GetSamplerCount() const;
+
+		//For VkDescriptorSetLayoutBinding::pImmutableSamplers, valid until the next call with a larger count
+		const VkSampler* ImmutableSamplers(int id, uint32_t descriptorCount = 1);
 	};
 
 }
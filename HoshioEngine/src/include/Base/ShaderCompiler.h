@@ -0,0 +1,100 @@
+#ifndef _SHADER_COMPILER_H_
+#define _SHADER_COMPILER_H_
+
+#include "Base/VulkanBase.h"
+
+namespace HoshioEngine {
+
+	struct ShaderDefine {
+		std::string name;
+		std::string value = "";
+	};
+
+	struct ShaderCompileInfo {
+		std::string filePath;
+		VkShaderStageFlagBits stage = VK_SHADER_STAGE_VERTEX_BIT;
+		std::vector<ShaderDefine> defines;
+		const char* entry = "main";
+		bool optimize = true;
+	};
+
+	struct ShaderBinary {
+		uint64_t hash = 0;
+		std::vector<uint32_t> code;
+		//The source file itself followed by every file pulled in through #include
+		std::vector<std::string> dependencies;
+	};
+
+	/*
+	* GLSL -> SPIR-V at runtime (shaderc), optimized with the spirv-opt performance passes.
+	* Results are cached under CacheDirectory() as <hash>.spv, the hash being taken over the
+	* preprocessed source, so edits to includes or defines produce a new entry.
+	* Watched shaders are recompiled on a background thread; the new code is only handed back
+	* to the caller inside ApplyPendingReloads(), which must be called at a frame boundary.
+	*/
+	class ShaderCompiler {
+	public:
+		using ReloadCallback = std::function<void(const ShaderBinary& binary)>;
+
+	private:
+		struct WatchEntry {
+			ShaderCompileInfo compileInfo;
+			std::vector<std::pair<std::filesystem::path, std::filesystem::file_time_type>> dependencies;
+			ReloadCallback callback;
+		};
+
+		struct PendingReload {
+			int watch_id;
+			ShaderBinary binary;
+		};
+
+		std::filesystem::path cacheDirectory = "cache/shaders";
+		std::chrono::milliseconds pollInterval = std::chrono::milliseconds(500);
+
+		int m_watch_id = 0;
+		std::unordered_map<int, WatchEntry> mWatchEntries;
+		std::mutex watchMutex;
+
+		std::vector<PendingReload> pendingReloads;
+		std::mutex pendingMutex;
+
+		std::jthread watcher;
+
+		ShaderCompiler() = default;
+		~ShaderCompiler();
+		ShaderCompiler(ShaderCompiler&& other) = delete;
+		ShaderCompiler(const ShaderCompiler& other) = delete;
+		ShaderCompiler& operator=(const ShaderCompiler& other) = delete;
+
+		std::string Preprocess(const ShaderCompileInfo& compileInfo, std::vector<std::string>& dependencies) const;
+		std::vector<uint32_t> CompileToSpirv(const ShaderCompileInfo& compileInfo, const std::string& preprocessed) const;
+		bool LoadCache(uint64_t hash, std::vector<uint32_t>& code) const;
+		void StoreCache(uint64_t hash, const std::vector<uint32_t>& code) const;
+		void WatchLoop(std::stop_token stopToken);
+
+		static std::vector<std::pair<std::filesystem::path, std::filesystem::file_time_type>> DependencyTimes(const std::vector<std::string>& dependencies);
+
+	public:
+		static ShaderCompiler& Compiler();
+
+		const std::filesystem::path& CacheDirectory() const;
+		void SetCacheDirectory(std::filesystem::path directory);
+		void SetPollInterval(std::chrono::milliseconds interval);
+
+		//Throws std::runtime_error with the compiler log on failure, like ShaderModule::Create(filePath)
+		ShaderBinary Compile(const ShaderCompileInfo& compileInfo);
+
+		//Returns the watch id; callback runs on the calling thread of ApplyPendingReloads()
+		int Watch(const ShaderCompileInfo& compileInfo, ReloadCallback callback);
+		void Unwatch(int id);
+
+		void StartHotReload();
+		void StopHotReload();
+		bool IsHotReloading() const;
+
+		//Call once per frame after the in-flight fence has been waited on
+		uint32_t ApplyPendingReloads();
+	};
+}
+
+#endif // !_SHADER_COMPILER_H_
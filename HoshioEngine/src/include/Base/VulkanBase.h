@@ -46,6 +46,10 @@ namespace HoshioEngine {
 
 		void WaitIdle() const;
 
+		//vkCmdDrawIndexedIndirectCount through VK_KHR_draw_indirect_count, only if DrawIndirectCountSupported()
+		void CmdDrawIndexedIndirectCount(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset,
+			VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride) const;
+
 		void SubmitCommandBuffer_Graphics(VkSubmitInfo& submitInfo, VkFence fence = VK_NULL_HANDLE);
 
 		void SubmitCommandBuffer_Graphics(ArrayRef<VkCommandBuffer> commandBuffers, VkFence fence = VK_NULL_HANDLE);
@@ -79,6 +83,10 @@ namespace HoshioEngine {
 
 		const VkPhysicalDeviceMemoryProperties& PhysicalDeviceMemoryProperties() const;
 
+		bool ImagelessFramebufferSupported() const;
+
+		bool DrawIndirectCountSupported() const;
+
 		VkPhysicalDevice AvailablePhysicalDevices(uint32_t index) const;
 
 		VkDevice Device() const;
@@ -155,6 +163,9 @@ namespace HoshioEngine {
 		VkPhysicalDeviceProperties physicalDeviceProperties;
 		VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
 		std::vector<VkPhysicalDevice> availablePhysicalDevices;
+		bool imagelessFramebufferSupported = false;
+		bool drawIndirectCountSupported = false;
+		PFN_vkCmdDrawIndexedIndirectCountKHR pfnCmdDrawIndexedIndirectCount = nullptr;
 
 		VkDevice device;
 		uint32_t queueFamilyIndex_graphics = VK_QUEUE_FAMILY_IGNORED;
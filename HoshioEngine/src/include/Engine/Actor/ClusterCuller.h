@@ -0,0 +1,75 @@
+#ifndef _CLUSTER_CULLER_H_
+#define _CLUSTER_CULLER_H_
+
+#include "Plus/BufferManager.h"
+#include "Base/DescriptorManager.h"
+#include "Base/PipelineManager.h"
+#include "Engine/Actor/Camera.h"
+#include "Engine/Actor/MeshletBuilder.h"
+
+namespace HoshioEngine {
+
+	//Frustum and camera in world space, taken once per frame
+	struct CullView {
+		//Normalized, inside where dot(plane.xyz, p) + plane.w >= 0
+		glm::vec4 planes[6];
+		glm::vec3 position;
+
+		//Planes of a projection with depth from 0 to 1, an infinite far plane never culls
+		static CullView FromViewProjection(const glm::mat4& viewProjection, const glm::vec3& position);
+		static CullView FromCamera(const Camera& camera);
+	};
+
+	/*
+	* Culls a mesh's meshlets on the GPU against the frustum and their normal cones (res/shaders/GLSL/ClusterCull.comp)
+	* and draws what is left with indirect draws through the mesh's own index buffer, no mesh shaders involved.
+	* With VK_KHR_draw_indirect_count the surviving draws are compacted and counted on the GPU,
+	* otherwise every meshlet keeps its draw and culled ones have an instance count of 0.
+	*/
+	class ClusterCuller {
+	public:
+		//Per mesh copy of its meshlets and the draws culled from them, keep alive until the recorded commands have completed
+		class Resources {
+		private:
+			friend class ClusterCuller;
+			StorageBuffer meshletBuffer;
+			StorageBuffer drawBuffer;
+			StorageBuffer countBuffer;
+			DescriptorSet descriptorSet;
+			uint32_t meshletCount = 0;
+			//Meshlets the last CmdCull() went through
+			uint32_t culledMeshletCount = 0;
+		public:
+			Resources() = default;
+			Resources(Resources&& other) noexcept = default;
+			~Resources();
+			bool Empty() const { return !meshletCount; }
+		};
+
+	private:
+		DescriptorSetLayout descriptorSetLayout;
+		PipelineLayout pipelineLayout;
+		Pipeline pipeline;
+		bool compacts = false;
+		bool multiDrawIndirect = false;
+
+		ClusterCuller() = default;
+		ClusterCuller(ClusterCuller&& other) = delete;
+		ClusterCuller(const ClusterCuller& other) = delete;
+		ClusterCuller& operator=(const ClusterCuller& other) = delete;
+
+		void CreatePipeline();
+
+	public:
+		static ClusterCuller& Culler();
+
+		void Upload(Resources& resources, ArrayRef<const Meshlet> meshlets);
+		//Outside of a render pass; transform maps the meshlets' (unquantized) mesh space to world space
+		void CmdCull(VkCommandBuffer commandBuffer, Resources& resources, const CullView& view, const glm::mat4& transform,
+			uint32_t firstMeshlet, uint32_t meshletCount, uint32_t indexOffset = 0, int32_t vertexOffset = 0);
+		//Inside the render pass, with the mesh's vertex and index buffers bound
+		void CmdDraw(VkCommandBuffer commandBuffer, const Resources& resources) const;
+	};
+}
+
+#endif // !_CLUSTER_CULLER_H_
@@ -0,0 +1,117 @@
+#ifndef _GPU_SCENE_H_
+#define _GPU_SCENE_H_
+
+#include "Engine/Actor/Model.h"
+
+namespace HoshioEngine {
+
+	/*
+	* Pipeline GpuScene culls with (res/shaders/GLSL/SceneCull.comp) and the layout of the set its transforms are read through.
+	* With VK_KHR_draw_indirect_count the visible draws are compacted per batch and counted on the GPU,
+	* otherwise every draw keeps its slot and culled ones have an instance count of 0.
+	*/
+	class SceneCuller {
+	private:
+		friend class GpuScene;
+		DescriptorSetLayout cullSetLayout;
+		DescriptorSetLayout instanceSetLayout;
+		PipelineLayout pipelineLayout;
+		Pipeline pipeline;
+		bool compacts = false;
+		bool multiDrawIndirect = false;
+		//Without it indirect draws cannot tell the vertex shader their instance, each draw is then recorded on its own
+		bool drawIndirectFirstInstance = false;
+
+		SceneCuller() = default;
+		SceneCuller(SceneCuller&& other) = delete;
+		SceneCuller(const SceneCuller& other) = delete;
+		SceneCuller& operator=(const SceneCuller& other) = delete;
+
+		void CreatePipeline();
+
+	public:
+		static SceneCuller& Culler();
+
+		//One readonly storage buffer at binding 0 for the vertex stage, mat4 transforms[] indexed by gl_InstanceIndex
+		const DescriptorSetLayout& InstanceSetLayout();
+	};
+
+	/*
+	* Models placed any number of times, drawn without a CPU loop over them.
+	* Transforms, bounds and draw records live in storage buffers, a compute pass culls every draw against the frustum
+	* and writes the indirect commands, so recording a frame costs one dispatch and one indirect draw per batch.
+	* Draws are batched by mesh: a batch only changes the bound material and, when it lives elsewhere, the geometry,
+	* so the number of batches grows with the distinct meshes placed, never with the instances of them.
+	* Meshes are drawn whole at level 0, the models have to be set up and outlive the scene.
+	*/
+	class GpuScene {
+	private:
+		//std430, where a draw's mesh sits in the geometry buffers and its bounding sphere in the space of its vertices
+		struct DrawRecord {
+			glm::vec3 center;
+			float radius;
+			uint32_t indexCount;
+			uint32_t firstIndex;
+			int32_t vertexOffset;
+			uint32_t instance;
+			uint32_t batch;
+			//First slot of the batch in the draw buffer
+			uint32_t firstDraw;
+			uint32_t padding[2];
+		};
+		struct Batch {
+			const Mesh* mesh;
+			uint32_t firstDraw;
+			uint32_t drawCount;
+		};
+
+		//Per instance, the model transform with the model's position dequantization in front
+		std::vector<glm::mat4> transforms;
+		std::vector<glm::mat4> dequantizations;
+		//Per placed mesh in the order added, sorted by batch into records when uploaded
+		std::vector<std::pair<const Mesh*, DrawRecord>> placed;
+		std::vector<DrawRecord> records;
+		std::vector<Batch> batches;
+		bool recordsChanged = false;
+		//Transforms SetTransform() touched since the last upload, as [begin, end)
+		uint32_t changedBegin = 0;
+		uint32_t changedEnd = 0;
+
+		StorageBuffer transformBuffer;
+		StorageBuffer recordBuffer;
+		StorageBuffer drawBuffer;
+		StorageBuffer countBuffer;
+		//Transforms on their way to a transformBuffer the host cannot write, copied within the frame's command buffer
+		StagingBuffer transformStaging;
+		DescriptorSet cullSet;
+		DescriptorSet instanceSet;
+		VkDeviceSize transformCapacity = 0;
+		VkDeviceSize recordCapacity = 0;
+
+		void Upload(VkCommandBuffer commandBuffer);
+		void WriteDescriptorSets();
+
+	public:
+		GpuScene() = default;
+		GpuScene(GpuScene&& other) = delete;
+		GpuScene(const GpuScene& other) = delete;
+		GpuScene& operator=(const GpuScene& other) = delete;
+		~GpuScene();
+
+		//Places every indexed mesh of the model, returns the instance to move it with
+		uint32_t AddInstance(const Model& model, const glm::mat4& transform = glm::mat4(1.f));
+		void SetTransform(uint32_t instance, const glm::mat4& transform);
+		void Clear();
+
+		uint32_t InstanceCount() const;
+		uint32_t DrawCount() const;
+		uint32_t BatchCount() const;
+
+		//Outside of a render pass, uploads what changed since the last call and culls every draw
+		void CmdCull(VkCommandBuffer commandBuffer, const CullView& view);
+		//Inside the render pass, with a pipeline whose layout has SceneCuller::InstanceSetLayout() at instance_set
+		void CmdDraw(VkCommandBuffer commandBuffer, ShaderInfo& shader_info, uint32_t instance_set) const;
+	};
+}
+
+#endif // !_GPU_SCENE_H_
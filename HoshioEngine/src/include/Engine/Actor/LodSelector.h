@@ -0,0 +1,50 @@
+#ifndef _LOD_SELECTOR_H_
+#define _LOD_SELECTOR_H_
+
+#include "Engine/Actor/Camera.h"
+#include "Engine/Actor/Mesh.h"
+
+namespace HoshioEngine {
+
+	//What level selection needs of a camera, taken once per frame
+	struct LodView {
+		glm::vec3 position;
+		//Pixels one unit covers at a distance of one unit
+		float pixelsPerUnit;
+		//Anything closer counts as this far away
+		float zNear;
+
+		//Viewport of the swapchain
+		static LodView FromCamera(const Camera& camera);
+		static LodView FromCamera(const Camera& camera, VkExtent2D viewport);
+	};
+
+	/*
+	* Picks per mesh the coarsest level whose error, projected at the point of the mesh's bounding sphere closest to the camera,
+	* stays within PixelThreshold() / QualityBias() pixels. Going coarser than the current level needs the error to stay below
+	* (1 - Hysteresis()) of that as well, so a mesh sitting at a switching distance does not pop back and forth.
+	*/
+	class LodSelector {
+	private:
+		static float pixelThreshold;
+		static float qualityBias;
+		static float hysteresis;
+
+	public:
+		static float PixelThreshold();
+		static void SetPixelThreshold(float pixels);
+		//Global detail scale for dynamic resolution or frame time control, above 1 keeps finer levels longer
+		static float QualityBias();
+		static void SetQualityBias(float bias);
+		static float Hysteresis();
+		static void SetHysteresis(float fraction);
+
+		//Pixels one mesh unit of error covers at worst; bounds in mesh space, transform from mesh to world space
+		static float PixelsPerMeshUnit(const LodView& view, const MeshBounds& bounds, const glm::mat4& transform);
+		static float ScreenSpaceError(const LodView& view, const MeshBounds& bounds, const glm::mat4& transform, float error);
+		//currentLod is the level picked last frame
+		static uint32_t SelectLod(const LodView& view, ArrayRef<const MeshLod> lods, const MeshBounds& bounds, const glm::mat4& transform, uint32_t currentLod);
+	};
+}
+
+#endif // !_LOD_SELECTOR_H_
@@ -2,7 +2,9 @@
 #define _MESH_H_
 
 #include "Plus/VulkanPlus.h"
+#include "Plus/GeometryPool.h"
 #include "Engine/Actor/Vertex.h"
+#include "Engine/Actor/ClusterCuller.h"
 
 namespace HoshioEngine {
 
@@ -16,6 +18,20 @@ namespace HoshioEngine {
 	struct TextureInfo {
 		uint32_t id;
 		TEXTURE_TYPE type;
+		//Key of the texture in VulkanPlus, relative to the model's directory
+		std::string name;
+	};
+
+	//Axis aligned box in mesh space, empty until a point is added
+	struct MeshBounds {
+		glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+		glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+
+		void Extend(const glm::vec3& point) { min = glm::min(min, point), max = glm::max(max, point); }
+		void Extend(const MeshBounds& other) { min = glm::min(min, other.min), max = glm::max(max, other.max); }
+		bool Empty() const { return min.x > max.x; }
+		glm::vec3 Center() const { return (min + max) * 0.5f; }
+		glm::vec3 Extent() const { return max - min; }
 	};
 
 	struct ShaderInfo {
@@ -29,30 +45,57 @@ namespace HoshioEngine {
 
 	class Mesh {
 	public:
-		std::vector<Vertex> vertices;
+		VertexStream vertices;
 		std::vector<uint32_t> indices;
 		std::vector<TextureInfo> textures;
+		MeshBounds bounds;
+		//Level 0 covers the original indices, coarser levels follow it in the same index buffer
+		std::vector<MeshLod> lods;
+		//Level Render() draws, clamped to the coarsest one
+		uint32_t lod = 0;
+		//Clusters of every level, empty if the mesh was not clustered
+		std::vector<Meshlet> meshlets;
 
+		//Ranges in the shared geometry pool, empty if the mesh has buffers of its own
+		GeometryPool::Allocation geometry;
+		//Only for attributes in separate arrays, which the pool does not take
 		VertexBuffer vertexBuffer;
 		IndexBuffer indexBuffer;
+		ClusterCuller::Resources clusters;
+		//Set by CullClusters(), the next Render() draws what survived instead of the whole level
+		bool clustersCulled = false;
 
 
 		DescriptorSet sampler_set;
 		DescriptorSet uniform_set;
 
-		Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices, std::vector<TextureInfo> textures);
+		//Bounds are computed from the POSITION attribute, without lods all indices are level 0
+		Mesh(VertexStream vertices, std::vector<uint32_t> indices, std::vector<TextureInfo> textures, std::vector<MeshLod> lods = {}, std::vector<Meshlet> meshlets = {});
+		Mesh(VertexStream vertices, std::vector<uint32_t> indices, std::vector<TextureInfo> textures, const MeshBounds& bounds, std::vector<MeshLod> lods = {}, std::vector<Meshlet> meshlets = {});
 		Mesh(const Mesh&) = delete;            
 		Mesh& operator=(const Mesh&) = delete;
 		Mesh(Mesh&&) noexcept = default;       
 		Mesh& operator=(Mesh&&) noexcept = default;
 		virtual ~Mesh() = default;
 
+		//BindGeometry() then Draw()
 		virtual void Render(ShaderInfo& shader_info);
+		//BindMaterial() then the draw of the current level
+		virtual void Draw(ShaderInfo& shader_info);
+		void BindGeometry(VkCommandBuffer commandBuffer) const;
+		//The mesh's descriptor sets, at the sets of shader_info's pipeline layout Draw() uses
+		void BindMaterial(VkCommandBuffer commandBuffer, ShaderInfo& shader_info) const;
+		//Both bind the same buffers, so one BindGeometry() serves both
+		bool SharesGeometryWith(const Mesh& other) const;
 		virtual void SetupMesh(ShaderInfo& shader_info);
 		virtual void UpdateDescriptorSets(ShaderInfo& shader_info);
-		virtual std::vector<float> ReorganizeVertexData();
-		virtual std::vector<VertexInputAttribute> GetVertexInputAttributes();
+		virtual std::pmr::vector<VertexInputAttribute> GetVertexInputAttributes(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 		virtual uint32_t GetVertexInputAttributeStride();
+
+		//Expects a VK_FORMAT_R32G32B32_SFLOAT position, leaves the bounds empty without one
+		void ComputeBounds();
+		//Culls the clusters of the current level, outside of the render pass and after the level is picked; does nothing without clusters
+		void CullClusters(VkCommandBuffer commandBuffer, const CullView& view, const glm::mat4& transform);
 	};
 
 }
@@ -0,0 +1,31 @@
+#ifndef _MESH_CACHE_H_
+#define _MESH_CACHE_H_
+
+#include "Engine/Actor/Mesh.h"
+
+namespace HoshioEngine {
+
+	/*
+	* Engine side copy of imported models under CacheDirectory() as <hash>.hmesh: per mesh the vertex layout, bounds,
+	* texture references, level of detail ranges and the vertex, index and meshlet blobs exactly as Mesh uploads them.
+	* Loading maps the file and copies the blobs out, nothing is parsed or post-processed.
+	*/
+	class MeshCache {
+	private:
+		static std::filesystem::path cacheDirectory;
+
+	public:
+		static const std::filesystem::path& CacheDirectory();
+		static void SetCacheDirectory(std::filesystem::path directory);
+
+		//Hash of the model file and of the material libraries (OBJ mtllib) next to it, keyed with the format version
+		static uint64_t SourceHash(const char* filePath);
+
+		//false if there is no valid cache file of hash; the texture ids are left for the caller to resolve by name
+		static bool Load(uint64_t hash, std::vector<Mesh>& meshes);
+		//Failing to write only prints a warning, the model is loaded either way
+		static void Store(uint64_t hash, ArrayRef<const Mesh> meshes);
+	};
+}
+
+#endif // !_MESH_CACHE_H_
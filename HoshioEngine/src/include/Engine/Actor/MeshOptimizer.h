@@ -0,0 +1,53 @@
+#ifndef _MESH_OPTIMIZER_H_
+#define _MESH_OPTIMIZER_H_
+
+#include "Engine/Actor/Vertex.h"
+#include "Utils/CommonUtils.h"
+
+namespace HoshioEngine {
+
+	//Result of running an index buffer through a FIFO post-transform cache
+	struct VertexCacheStatistics {
+		size_t triangleCount = 0;
+		size_t vertexCount = 0;
+		size_t verticesTransformed = 0;
+
+		//Transformed vertices per triangle, 3 without any reuse, about 0.5 at best for regular meshes
+		float ACMR() const { return triangleCount ? float(verticesTransformed) / triangleCount : 0.f; }
+		//Transformed vertices per vertex, 1 is optimal
+		float ATVR() const { return vertexCount ? float(verticesTransformed) / vertexCount : 0.f; }
+		VertexCacheStatistics& operator+=(const VertexCacheStatistics& other) {
+			triangleCount += other.triangleCount, vertexCount += other.vertexCount, verticesTransformed += other.verticesTransformed;
+			return *this;
+		}
+	};
+
+	struct MeshOptimizationResult {
+		VertexCacheStatistics before;
+		VertexCacheStatistics after;
+	};
+
+	/*
+	* Import time passes over indexed triangle lists, in the order Optimize() runs them:
+	* WeldVertices			merges vertices whose bytes are identical
+	* OptimizeVertexCache	reorders triangles for the post-transform cache (Forsyth's linear-speed algorithm)
+	* OptimizeOverdraw		reorders cache-independent triangle clusters front to back, unless that costs more than threshold in ACMR
+	* OptimizeVertexFetch	reorders vertices by first use and drops unreferenced ones
+	*/
+	struct MeshOptimizer {
+		static constexpr uint32_t defaultCacheSize = 16;
+
+		static VertexCacheStatistics AnalyzeVertexCache(ArrayRef<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = defaultCacheSize);
+
+		//Returns the new vertex count
+		static size_t WeldVertices(VertexStream& vertices, std::vector<uint32_t>& indices);
+		static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+		//Needs a VK_FORMAT_R32G32B32_SFLOAT position, leaves the order alone otherwise
+		static void OptimizeOverdraw(std::vector<uint32_t>& indices, const VertexStream& vertices, float threshold = 1.05f);
+		static void OptimizeVertexFetch(VertexStream& vertices, std::vector<uint32_t>& indices);
+
+		static MeshOptimizationResult Optimize(VertexStream& vertices, std::vector<uint32_t>& indices);
+	};
+}
+
+#endif // !_MESH_OPTIMIZER_H_
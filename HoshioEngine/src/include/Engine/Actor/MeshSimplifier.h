@@ -0,0 +1,61 @@
+#ifndef _MESH_SIMPLIFIER_H_
+#define _MESH_SIMPLIFIER_H_
+
+#include "Engine/Actor/Vertex.h"
+#include "Utils/CommonUtils.h"
+
+namespace HoshioEngine {
+
+	//Range of one level of detail in the mesh's index buffer, every level indexes the same vertices
+	struct MeshLod {
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		//Largest deviation from level 0, in mesh units
+		float error;
+		//Clusters of this level in Mesh::meshlets, none if the mesh was not clustered
+		uint32_t firstMeshlet = 0;
+		uint32_t meshletCount = 0;
+	};
+
+	struct MeshSimplificationSettings {
+		//Attribute differences count as much as a position error of the same size relative to the mesh extent, times these
+		float normalWeight = 0.05f;
+		float uvWeight = 0.5f;
+		float colorWeight = 0.5f;
+		//Open borders stay where they are, otherwise they are only kept from shrinking by extra quadrics
+		bool lockBorder = false;
+	};
+
+	struct MeshLodSettings {
+		//Including level 0, 1 turns generation off
+		uint32_t maxLodCount = 4;
+		//Triangle count of a level relative to the previous one
+		float reduction = 0.5f;
+		//Relative to the largest extent of the mesh
+		float maxError = 0.05f;
+		//Coarser levels are not generated for meshes this small
+		uint32_t minTriangleCount = 64;
+		MeshSimplificationSettings simplification;
+
+		bool Enabled() const { return maxLodCount > 1; }
+		//Stable over padding, for cache keys
+		uint64_t Key() const;
+	};
+
+	/*
+	* Quadric error metric edge collapse (Garland and Heckbert) over indexed triangle lists, vertices stay where they are
+	* and only the indices change. Quadrics carry the vertex attributes as well, so uv islands and hard normals are kept.
+	* Vertices sharing a position with different attributes (seams) collapse together along the seam, vertices on open borders
+	* only along the border, anything more tangled is never moved.
+	*/
+	struct MeshSimplifier {
+		//Collapses until indices has at most targetIndexCount or the next collapse would cost more than targetError (relative
+		//to the mesh extent), pError receives the error reached. Needs a VK_FORMAT_R32G32B32_SFLOAT position, returns indices unchanged otherwise
+		static std::vector<uint32_t> Simplify(const VertexStream& vertices, ArrayRef<const uint32_t> indices, size_t targetIndexCount,
+			float targetError, const MeshSimplificationSettings& settings = {}, float* pError = nullptr);
+		//Appends coarser levels behind level 0, which is all of indices, each one reordered for the vertex cache
+		static std::vector<MeshLod> GenerateLods(const VertexStream& vertices, std::vector<uint32_t>& indices, const MeshLodSettings& settings = {});
+	};
+}
+
+#endif // !_MESH_SIMPLIFIER_H_
@@ -0,0 +1,45 @@
+#ifndef _MESHLET_BUILDER_H_
+#define _MESHLET_BUILDER_H_
+
+#include "Engine/Actor/MeshSimplifier.h"
+
+namespace HoshioEngine {
+
+	//Cluster of up to MeshletBuilder::maxTriangles triangles, laid out as ClusterCull.comp reads it (std430)
+	struct Meshlet {
+		//Bounding sphere in mesh space
+		glm::vec3 center;
+		float radius;
+		//Average normal of the triangles, every one faces away from a camera with
+		//dot(center - camera, coneAxis) >= coneCutoff * length(center - camera) + radius; a cutoff of 1 never culls
+		glm::vec3 coneAxis;
+		float coneCutoff;
+		//Range in the mesh's index buffer
+		uint32_t firstIndex;
+		uint32_t triangleCount;
+		uint32_t vertexCount;
+		uint32_t padding;
+	};
+
+	/*
+	* Splits indexed triangle lists into clusters small enough to be culled one by one. Triangles are only reordered
+	* so that every cluster is a contiguous index range, the clusters draw through the same index buffer as the whole mesh.
+	* A cluster grows by the adjacent triangle that adds the fewest vertices, ties go to the one closest to its average normal.
+	*/
+	struct MeshletBuilder {
+		//Vertices and triangles of a mesh shader meshlet, so the clusters stay usable for one
+		static constexpr uint32_t maxVertices = 64;
+		static constexpr uint32_t maxTriangles = 124;
+
+		//Reorders the triangles of indices and returns their clusters, firstIndex is where indices starts in the index buffer.
+		//Needs a VK_FORMAT_R32G32B32_SFLOAT position, returns no clusters otherwise
+		static std::vector<Meshlet> Build(const VertexStream& vertices, ArrayRef<uint32_t> indices, uint32_t firstIndex = 0, float coneWeight = 0.25f);
+		//Clusters every level in place and fills in the levels' meshlet ranges
+		static std::vector<Meshlet> Build(const VertexStream& vertices, std::vector<uint32_t>& indices, std::vector<MeshLod>& lods, float coneWeight = 0.25f);
+
+		//The test ClusterCull.comp runs, cameraPosition in mesh space
+		static bool IsBackfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition);
+	};
+}
+
+#endif // !_MESHLET_BUILDER_H_
@@ -2,6 +2,9 @@
 #define _MODEL_H_
 
 #include "Mesh.h"
+#include "MeshOptimizer.h"
+#include "VertexQuantizer.h"
+#include "LodSelector.h"
 #include "Actor.h"
 
 namespace HoshioEngine {
@@ -13,23 +16,45 @@ namespace HoshioEngine {
 	class Model : public Actor {
 	public:
 		Model() = default;
-		Model(const char* file_path);
+		Model(const char* file_path, const VertexQuantization& quantization = {}, const MeshLodSettings& lod_settings = {});
 		Model(std::vector<Mesh>& meshes);
-		void LoadModel(std::string path);
+		//Quantization is opt-in, shaders have to decode what it turns on (see VertexQuantization)
+		//Triangle meshes get a chain of coarser index lists unless lod_settings turns it off
+		void LoadModel(std::string path, const VertexQuantization& quantization = {}, const MeshLodSettings& lod_settings = {});
 		void LoadModel(std::vector<Mesh>& meshes);
-		std::vector<VertexInputAttribute> GetVertexInputeAttributes();
+		std::pmr::vector<VertexInputAttribute> GetVertexInputeAttributes(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 		uint32_t GetVertexInputAttributesStride();
+		//Union of the mesh bounds, in model space
+		MeshBounds Bounds() const;
+		const std::vector<Mesh>& Meshes() const { return meshes; }
+		//Identity unless positions were quantized, goes in front of the model matrix
+		glm::mat4 PositionDequantization() const;
+		//Picks every mesh's level for this frame, model_transform is the one the model is drawn with; returns the triangles Render() will draw
+		size_t SelectLods(const LodView& view, const glm::mat4& model_transform = glm::mat4(1.f));
+		//Culls the clusters of the picked levels on the GPU, recorded before the render pass Render() draws them in
+		void CullClusters(VkCommandBuffer commandBuffer, const CullView& view, const glm::mat4& model_transform = glm::mat4(1.f));
 		void Render(ShaderInfo& shader_info);
 		void SetupModel(ShaderInfo& shader_info);
 	private:
 		std::vector<Mesh> meshes;
 		std::string directory = "";
 		MODEL_IMPORT_TYPE model_import_type = MODEL_IMPORT_TYPE::MODLE_TYPE_OBJ;
+		//Summed over the meshes of the last import
+		MeshOptimizationResult optimization;
+		MeshLodSettings lod_settings;
 
 		void CheckModelImportType(std::string& path);
+		//Layout every mesh shares, the model is drawn with one pipeline
+		const VertexLayout& SharedVertexLayout() const;
 		void ProcessNode(aiNode* node, const aiScene* scene);
 		Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene);
 		std::vector<TextureInfo> LoadMaterialTextures(aiMaterial* mat, aiTextureType type, TEXTURE_TYPE type_enum);
+		void PreloadMaterialTextures(const aiScene* scene);
+		//Decodes every named texture VulkanPlus does not have yet on worker threads, names are deduplicated in place
+		void PreloadTextures(std::vector<std::string>& names);
+		//Texture ids of meshes loaded from the cache, which only carry the names
+		void ResolveTextures();
+		void QuantizeMeshes(VertexQuantization quantization);
 	};
 }
 
@@ -20,62 +20,127 @@ namespace HoshioEngine {
 		VETEX_ATTRIBUTE_TYPE type;
 	};
 
+	enum class VERTEX_STORAGE {
+		//One binding, the attributes of a vertex sit next to each other
+		INTERLEAVED,
+		//One binding per attribute, every attribute is a tight array of its own
+		SEPARATE
+	};
+
+	/*
+	* Attribute layout, declared once per mesh instead of carried by every vertex.
+	* Locations follow the order of Add(), offsets are packed without padding.
+	*/
+	class VertexLayout {
+	public:
+		//Vulkan guarantees at least this many vertex input attributes and bindings
+		static constexpr uint32_t maxAttributeCount = 16;
 
-	class Vertex {
 	private:
+		VERTEX_STORAGE storage = VERTEX_STORAGE::INTERLEAVED;
+		VertexInputAttribute attributes[maxAttributeCount] = {};
+		uint32_t attributeCount = 0;
+		uint32_t vertexSize = 0;
+
+	public:
+		VertexLayout(VERTEX_STORAGE storage = VERTEX_STORAGE::INTERLEAVED);
+
+		VertexLayout& Add(VETEX_ATTRIBUTE_TYPE type, VkFormat format);
+
+		VERTEX_STORAGE Storage() const;
+		uint32_t AttributeCount() const;
+		const VertexInputAttribute& Attribute(uint32_t index) const;
+		std::span<const VertexInputAttribute> Attributes() const;
+		uint32_t AttributeSize(uint32_t index) const;
+		//Index of the n-th attribute of type, -1 if there is none
+		int32_t Find(VETEX_ATTRIBUTE_TYPE type, uint32_t n = 0) const;
+		uint32_t Count(VETEX_ATTRIBUTE_TYPE type) const;
+
+		uint32_t BindingCount() const;
+		uint32_t Stride(uint32_t binding = 0) const;
+		//Bytes of one vertex over all bindings
+		uint32_t VertexSize() const;
+
+		//Pass FrameMemory::Frame() or Scratch() when the result is only needed for the frame
+		std::pmr::vector<VertexInputAttribute> GetVertexInputAttributes(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+		//Same storage and the same attributes in the same order, so one pipeline fits both
+		bool operator==(const VertexLayout& other) const;
+	};
+
+	//View of one attribute in a VertexStream, stride is the distance between two vertices
+	template<typename T>
+	class StridedSpan {
+		std::conditional_t<std::is_const_v<T>, const uint8_t*, uint8_t*> pData = nullptr;
+		size_t stride = 0;
+		size_t count = 0;
+	public:
+		StridedSpan() = default;
+		StridedSpan(decltype(pData) pData, size_t stride, size_t count) :pData(pData), stride(stride), count(count) {}
+		T& operator[](size_t index) const { return *reinterpret_cast<T*>(pData + stride * index); }
+		size_t size() const { return count; }
+		size_t Stride() const { return stride; }
+		bool Contiguous() const { return stride == sizeof(T); }
+	};
+
+	/*
+	* Vertex data of a mesh in one allocation, already in the layout the GPU reads:
+	* INTERLEAVED is a single array of vertices, SEPARATE is one tight array per attribute back to back.
+	* Data() can be uploaded as is and binding i read at BindingOffset(i) of that buffer.
+	*/
+	class VertexStream {
+	private:
+		VertexLayout layout;
+		size_t vertexCount = 0;
+		std::vector<uint8_t> data;
+
+		uint8_t* AttributeAddress(uint32_t index, size_t& stride) const;
+
+	public:
+		VertexStream() = default;
+		VertexStream(const VertexLayout& layout, size_t vertexCount = 0);
+		//Copies vertexCount * layout.VertexSize() bytes already laid out as Data() would be
+		VertexStream(const VertexLayout& layout, size_t vertexCount, const uint8_t* pData);
+
+		//Keeps the data of the first min(vertexCount, VertexCount()) vertices, new vertices are zeroed
+		void Resize(size_t vertexCount);
+
+		const VertexLayout& Layout() const;
+		size_t VertexCount() const;
+		bool Empty() const;
+		uint8_t* Data();
+		const uint8_t* Data() const;
+		size_t DataSize() const;
+		size_t BindingOffset(uint32_t binding) const;
+
+		//T has to be the size of the attribute's format, e.g. glm::vec3 for VK_FORMAT_R32G32B32_SFLOAT
 		template<typename T>
-		void checkIndex(const std::vector<T>& container, std::string_view type, uint32_t& id) const {
-			if (id >= container.size()) {
-				std::cout << std::format("[ WARNING ] Vertex : {}_id ({}) is bigger than the count of {} ({})! Automatically clamped to max id ({})\n",
-					type.data(), id, type.data(), container.size(), container.size() - 1);
-				id = container.size() - 1;
-			}
+		StridedSpan<T> Attribute(uint32_t index) {
+			size_t stride;
+			uint8_t* pData = AttributeAddress(index, stride);
+#ifndef NDEBUG
+			if (sizeof(T) != layout.AttributeSize(index))
+				throw std::runtime_error("[ VertexStream ] ERROR::Type does not match the attribute format!");
+#endif // !NDEBUG
+			return StridedSpan<T>(pData, stride, vertexCount);
+		}
+		template<typename T>
+		StridedSpan<const T> Attribute(uint32_t index) const {
+			size_t stride;
+			const uint8_t* pData = AttributeAddress(index, stride);
+#ifndef NDEBUG
+			if (sizeof(T) != layout.AttributeSize(index))
+				throw std::runtime_error("[ VertexStream ] ERROR::Type does not match the attribute format!");
+#endif // !NDEBUG
+			return StridedSpan<const T>(pData, stride, vertexCount);
+		}
+		template<typename T>
+		StridedSpan<T> Attribute(VETEX_ATTRIBUTE_TYPE type, uint32_t n = 0) {
+			int32_t index = layout.Find(type, n);
+			if (index < 0)
+				throw std::runtime_error(std::format("[ VertexStream ] ERROR::Layout has no attribute {} of type {}!", n, magic_enum::enum_name(type)));
+			return Attribute<T>(uint32_t(index));
 		}
-	public:
-		glm::vec3 position = glm::vec3(0.0f);
-		glm::vec3 normal = glm::vec3(0.0f);
-		std::vector<glm::vec4> colors;
-		std::vector<glm::vec2> uvs;
-		std::vector<float> values;
-
-		Vertex(glm::vec3 position = glm::vec3(0.0f),
-			glm::vec3 normal = glm::vec3(0.0f, 0.0f, 1.0f));
-
-		Vertex(Vertex&& other) = default;
-		Vertex& operator=(Vertex&& other) = default;
-
-		Vertex(const Vertex& other) = default;
-		Vertex& operator=(const Vertex& other) = default;
-
-		virtual ~Vertex() = default;
-
-		//const
-		const glm::vec3& GetPosition() const;
-		const glm::vec3& GetNormal() const;
-		const glm::vec2& GetUV(uint32_t id = 0) const;
-		const glm::vec4& GetColor(uint32_t id = 0) const;
-		const float GetValue(uint32_t id = 0) const;
-
-		//non-const
-		void SetPosition(glm::vec3 position);
-		void SetNormal(glm::vec3 normal);
-		void SetUV(uint32_t id, glm::vec2 uv);
-		void SetColor(uint32_t id, glm::vec4 color);
-		void SetValue(uint32_t id, float value);
-
-		void AddUV(glm::vec2 uv);
-		void AddColor(glm::vec4 color);
-		void AddValue(float value);
-
-		
-		size_t GetUVCount() const;
-		size_t GetColorCount() const;
-		size_t GetValueCount() const;
-
-		uint32_t GetVertexInputAttributeStride();
-		uint32_t GetVertexInputAttributeCount();
-		uint32_t GetVertexInputAttributeFloatCount();
-		std::vector<VertexInputAttribute> GetVertexInputAttributes();
 	};
 }
 
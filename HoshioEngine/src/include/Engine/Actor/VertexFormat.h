@@ -0,0 +1,219 @@
+#ifndef _VERTEX_FORMAT_H_
+#define _VERTEX_FORMAT_H_
+
+#include "Engine/Actor/Vertex.h"
+#include <array>
+#include <tuple>
+#include <glm/gtc/type_precision.hpp>
+
+namespace HoshioEngine {
+
+	/*
+	* Elements say how an attribute is stored (Storage, VkFormat) and how a value is packed into it (Source -> Encode()),
+	* the semantic wrappers say what it is. Every element is a multiple of 4 bytes so packed vertices stay aligned.
+	* Decoding is done by the vertex fetch, except for oct16 which needs OctDecode() of res/shaders/GLSL/VertexDecode.glsl.
+	*/
+	namespace VertexElements {
+		template<typename T, VkFormat F>
+		struct Raw {
+			using Storage = T;
+			using Source = T;
+			static constexpr VkFormat format = F;
+			static constexpr Storage Encode(const Source& value) { return value; }
+		};
+
+		using f32x1 = Raw<float, VK_FORMAT_R32_SFLOAT>;
+		using f32x2 = Raw<glm::vec2, VK_FORMAT_R32G32_SFLOAT>;
+		using f32x3 = Raw<glm::vec3, VK_FORMAT_R32G32B32_SFLOAT>;
+		using f32x4 = Raw<glm::vec4, VK_FORMAT_R32G32B32A32_SFLOAT>;
+		using u32x1 = Raw<uint32_t, VK_FORMAT_R32_UINT>;
+
+		struct f16x2 {
+			using Storage = glm::u16vec2;
+			using Source = glm::vec2;
+			static constexpr VkFormat format = VK_FORMAT_R16G16_SFLOAT;
+			static Storage Encode(const Source& value) {
+				uint32_t packed = glm::packHalf2x16(value);
+				return Storage(packed & 0xFFFF, packed >> 16);
+			}
+		};
+
+		struct f16x4 {
+			using Storage = glm::u16vec4;
+			using Source = glm::vec4;
+			static constexpr VkFormat format = VK_FORMAT_R16G16B16A16_SFLOAT;
+			static Storage Encode(const Source& value) {
+				glm::u16vec2 xy = f16x2::Encode({ value.x, value.y }), zw = f16x2::Encode({ value.z, value.w });
+				return Storage(xy.x, xy.y, zw.x, zw.y);
+			}
+		};
+
+		struct unorm8x4 {
+			using Storage = glm::u8vec4;
+			using Source = glm::vec4;
+			static constexpr VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+			static Storage Encode(const Source& value) { return Storage(glm::round(glm::clamp(value, 0.f, 1.f) * 255.f)); }
+		};
+
+		struct unorm16x2 {
+			using Storage = glm::u16vec2;
+			using Source = glm::vec2;
+			static constexpr VkFormat format = VK_FORMAT_R16G16_UNORM;
+			static Storage Encode(const Source& value) { return Storage(glm::round(glm::clamp(value, 0.f, 1.f) * 65535.f)); }
+		};
+
+		struct unorm16x4 {
+			using Storage = glm::u16vec4;
+			using Source = glm::vec4;
+			static constexpr VkFormat format = VK_FORMAT_R16G16B16A16_UNORM;
+			static Storage Encode(const Source& value) { return Storage(glm::round(glm::clamp(value, 0.f, 1.f) * 65535.f)); }
+		};
+
+		struct snorm16x2 {
+			using Storage = glm::i16vec2;
+			using Source = glm::vec2;
+			static constexpr VkFormat format = VK_FORMAT_R16G16_SNORM;
+			static Storage Encode(const Source& value) { return Storage(glm::round(glm::clamp(value, -1.f, 1.f) * 32767.f)); }
+		};
+
+		//Unit vector folded onto an octahedron, 4 bytes instead of 12
+		struct oct16 {
+			using Storage = glm::i16vec2;
+			using Source = glm::vec3;
+			static constexpr VkFormat format = VK_FORMAT_R16G16_SNORM;
+			static Storage Encode(const Source& value) {
+				glm::vec2 p = glm::vec2(value) / std::max(std::abs(value.x) + std::abs(value.y) + std::abs(value.z), 1e-20f);
+				if (value.z < 0.f)
+					p = (1.f - glm::abs(glm::vec2(p.y, p.x))) * glm::vec2(p.x >= 0.f ? 1.f : -1.f, p.y >= 0.f ? 1.f : -1.f);
+				return snorm16x2::Encode(p);
+			}
+		};
+
+		template<typename E, VETEX_ATTRIBUTE_TYPE T>
+		struct Semantic {
+			using Element = E;
+			static constexpr VETEX_ATTRIBUTE_TYPE type = T;
+		};
+
+		template<typename E> struct Position : Semantic<E, VETEX_ATTRIBUTE_TYPE::POSITION> {};
+		template<typename E> struct Normal : Semantic<E, VETEX_ATTRIBUTE_TYPE::NORMAL> {};
+		template<typename E> struct Color : Semantic<E, VETEX_ATTRIBUTE_TYPE::COLOR> {};
+		template<typename E> struct UV : Semantic<E, VETEX_ATTRIBUTE_TYPE::UV> {};
+		template<typename E> struct Value : Semantic<E, VETEX_ATTRIBUTE_TYPE::VALUE> {};
+	}
+
+	namespace VertexFormatDetail {
+		//Members one after another, nothing in between as long as every size is a multiple of 4
+		template<typename First, typename... Rest>
+		struct Storage {
+			First value;
+			Storage<Rest...> rest;
+
+			template<size_t I>
+			auto& Get() {
+				if constexpr (I == 0)
+					return value;
+				else
+					return rest.template Get<I - 1>();
+			}
+			template<size_t I>
+			const auto& Get() const {
+				if constexpr (I == 0)
+					return value;
+				else
+					return rest.template Get<I - 1>();
+			}
+		};
+
+		template<typename Last>
+		struct Storage<Last> {
+			Last value;
+
+			template<size_t I>
+			auto& Get() {
+				static_assert(I == 0, "Attribute index out of range!");
+				return value;
+			}
+			template<size_t I>
+			const auto& Get() const {
+				static_assert(I == 0, "Attribute index out of range!");
+				return value;
+			}
+		};
+	}
+
+	/*
+	* Vertex description resolved at compile time, e.g. VertexFormat<Position<f32x3>, Normal<oct16>, UV<f16x2>>
+	* (names from VertexElements). Gives the packed Vertex struct, the stride, offsets and attribute descriptions,
+	* pass it to PipelineConfigurator::AddVertexFormat<>() and upload arrays of Vertex as they are.
+	*/
+	template<typename... Attributes>
+	struct VertexFormat {
+		static constexpr uint32_t attributeCount = sizeof...(Attributes);
+		static_assert(attributeCount > 0 && attributeCount <= VertexLayout::maxAttributeCount, "A vertex format has 1 to 16 attributes!");
+		static_assert(((sizeof(typename Attributes::Element::Storage) % 4 == 0) && ...), "Vertex elements have to be multiples of 4 bytes!");
+
+		template<size_t I>
+		using AttributeAt = std::tuple_element_t<I, std::tuple<Attributes...>>;
+
+		static constexpr uint32_t stride = (uint32_t(sizeof(typename Attributes::Element::Storage)) + ...);
+		static constexpr std::array<uint32_t, attributeCount> offsets = [] {
+			constexpr uint32_t sizes[] = { uint32_t(sizeof(typename Attributes::Element::Storage))... };
+			std::array<uint32_t, attributeCount> result = {};
+			for (uint32_t i = 1; i < attributeCount; i++)
+				result[i] = result[i - 1] + sizes[i - 1];
+			return result;
+			}();
+
+		//Index of the n-th attribute of type, a compile error if there is none
+		template<VETEX_ATTRIBUTE_TYPE type, uint32_t n = 0>
+		static constexpr uint32_t indexOf = [] {
+			constexpr VETEX_ATTRIBUTE_TYPE types[] = { Attributes::type... };
+			for (uint32_t i = 0, found = 0; i < attributeCount; i++)
+				if (types[i] == type && found++ == n)
+					return i;
+			throw "Vertex format has no such attribute!";
+			}();
+
+		static constexpr std::array<VkVertexInputAttributeDescription, attributeCount> AttributeDescriptions(uint32_t binding = 0, uint32_t firstLocation = 0) {
+			constexpr VkFormat formats[] = { Attributes::Element::format... };
+			std::array<VkVertexInputAttributeDescription, attributeCount> descriptions = {};
+			for (uint32_t i = 0; i < attributeCount; i++)
+				descriptions[i] = { firstLocation + i, binding, formats[i], offsets[i] };
+			return descriptions;
+		}
+
+		//For a VertexStream, SEPARATE storage splits the same attributes into one array each
+		static VertexLayout Layout(VERTEX_STORAGE storage = VERTEX_STORAGE::INTERLEAVED) {
+			VertexLayout layout(storage);
+			(layout.Add(Attributes::type, Attributes::Element::format), ...);
+			return layout;
+		}
+
+		class Vertex {
+		private:
+			VertexFormatDetail::Storage<typename Attributes::Element::Storage...> storage;
+
+			template<size_t... I>
+			void SetAll(std::index_sequence<I...>, const typename Attributes::Element::Source&... values) {
+				(Set<I>(values), ...);
+			}
+		public:
+			Vertex() = default;
+			//Values are given as Source types and encoded, e.g. a glm::vec3 for an oct16 normal
+			Vertex(const typename Attributes::Element::Source&... values) {
+				SetAll(std::index_sequence_for<Attributes...>{}, values...);
+			}
+
+			template<size_t I>
+			auto& Get() { return storage.template Get<I>(); }
+			template<size_t I>
+			const auto& Get() const { return storage.template Get<I>(); }
+			template<size_t I>
+			void Set(const typename AttributeAt<I>::Element::Source& value) { Get<I>() = AttributeAt<I>::Element::Encode(value); }
+		};
+		static_assert(sizeof(Vertex) == stride, "Vertex elements are not packed!");
+	};
+}
+
+#endif // !_VERTEX_FORMAT_H_
@@ -0,0 +1,57 @@
+#ifndef _VERTEX_QUANTIZER_H_
+#define _VERTEX_QUANTIZER_H_
+
+#include "Engine/Actor/Mesh.h"
+
+namespace HoshioEngine {
+
+	enum class UV_QUANTIZATION {
+		NONE,
+		HALF,		//R16G16_SFLOAT, any range, about 1/2048 relative error
+		UNORM16		//R16G16_UNORM, uvs have to be within [0, 1], 1/131070 absolute error
+	};
+
+	//Opt-in encodings, every attribute left at false/NONE keeps its 32 bit float format
+	struct VertexQuantization {
+		//R16G16_SNORM octahedral (VertexElements::oct16), within 0.04 degrees; shaders decode with OctDecode() of res/shaders/GLSL/VertexDecode.glsl
+		bool normals = false;
+		UV_QUANTIZATION uvs = UV_QUANTIZATION::NONE;
+		//R8G8B8A8_UNORM, clamped to [0, 1]
+		bool colors = false;
+		//R16G16B16A16_UNORM within QuantizationBox(), off by at most 0.87 / 65535 of its edge;
+		//transform with PositionDequantization() (or fold it into the model matrix)
+		bool positions = false;
+
+		bool Enabled() const { return normals || uvs != UV_QUANTIZATION::NONE || colors || positions; }
+		//Stable over padding, for cache keys
+		uint32_t Key() const { return uint32_t(normals) | uint32_t(uvs) << 1 | uint32_t(colors) << 3 | uint32_t(positions) << 4; }
+	};
+
+	//Largest difference between a stream and its quantized copy, decoded the way the vertex fetch does
+	struct VertexQuantizationError {
+		float position = 0.f;	//Distance, in mesh units
+		float normal = 0.f;		//Angle, in radians
+		float uv = 0.f;
+		float color = 0.f;
+	};
+
+	/*
+	* Rewrites 32 bit float attributes into smaller formats the vertex fetch mostly decodes on its own.
+	* Positions use a cube rather than the bounds themselves so dequantizing is a uniform scale and normals
+	* can go through the usual inverse transpose of the model matrix.
+	*/
+	struct VertexQuantizer {
+		static MeshBounds QuantizationBox(const MeshBounds& bounds);
+		//Maps unorm16 positions back into mesh space
+		static glm::mat4 PositionDequantization(const MeshBounds& box);
+		static bool UVsInUnitRange(const VertexStream& vertices);
+
+		static VertexLayout QuantizedLayout(const VertexLayout& layout, const VertexQuantization& quantization);
+		//box is only read when positions are quantized
+		static VertexStream Quantize(const VertexStream& vertices, const VertexQuantization& quantization, const MeshBounds& box);
+		//original and quantized must have the same attributes in the same order
+		static VertexQuantizationError MeasureError(const VertexStream& original, const VertexStream& quantized, const MeshBounds& box);
+	};
+}
+
+#endif // !_VERTEX_QUANTIZER_H_
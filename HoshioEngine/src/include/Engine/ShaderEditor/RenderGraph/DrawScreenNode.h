@@ -13,10 +13,13 @@ namespace HoshioEngine {
 		struct TexturePicker {
 			ColorAttachment* colorAttachment = nullptr;
 			Texture2D* texture = nullptr;
+			//Id in VulkanPlus::Plus().TextureStreaming()
+			int streamedTexture = M_INVALID_ID;
 			enum class TextureMode {
 				NO_MODE_SELECTED,
 				COLOR_ATTACHMENT_MODE,
-				TEXTURE_MODE
+				TEXTURE_MODE,
+				STREAMED_TEXTURE_MODE
 			}textureMode = TextureMode::NO_MODE_SELECTED;
 		}texturePicker;
 
@@ -50,6 +53,8 @@ namespace HoshioEngine {
 		DrawScreenNode(VkSampler sampler, ColorAttachment* colorAttachment);
 		DrawScreenNode(VkSampler sampler, Texture2D* texture);
 		DrawScreenNode(VkSampler sampler, Texture2D& texture);
+		DrawScreenNode(VkSampler sampler, int streamedTextureID);
+		~DrawScreenNode() override;
 
 		uint32_t TextureMaxLevel() const;
 
@@ -59,6 +64,9 @@ namespace HoshioEngine {
 
 		void SetSampledImage(Texture2D* texture);
 
+		//Levels are requested for the swapchain's size every time the node is recorded
+		void SetStreamedImage(int streamedTextureID);
+
 		// ͨ RenderNode ̳
 		void ImguiRender() override;
 
@@ -8,6 +8,8 @@ namespace HoshioEngine {
 	protected:
 		BufferMemory bufferMemory;
 		VkDeviceSize memorySize = 0;
+		//The whole allocation stays mapped from Expand() until Release()
+		void* pData_mapped = nullptr;
 		Image alisedImage;
 	public:
 		StagingBuffer() = default;
@@ -78,6 +80,11 @@ namespace HoshioEngine {
 
 		void TransferData(const void* pData_src, VkDeviceSize size, VkDeviceSize offset = 0) const;
 
+		//Writes host-visible memory directly, otherwise goes through stagingBuffer with a copy recorded into commandBuffer, nothing is submitted.
+		//stagingBuffer must not be touched again before commandBuffer has executed. Returns whether a copy was recorded,
+		//its reads then need a barrier after VK_PIPELINE_STAGE_TRANSFER_BIT
+		bool CmdTransferData(VkCommandBuffer commandBuffer, StagingBuffer& stagingBuffer, const void* pData_src, VkDeviceSize size, VkDeviceSize offset = 0) const;
+
 		void TransferData(const auto& data_src) const {
 			TransferData(&data_src, sizeof data_src);
 		};
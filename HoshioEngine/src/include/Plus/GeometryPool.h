@@ -0,0 +1,98 @@
+#ifndef _GEOMETRY_POOL_H_
+#define _GEOMETRY_POOL_H_
+
+#include "Plus/BufferManager.h"
+#include "Utils/RangeAllocator.h"
+
+namespace HoshioEngine {
+
+	/*
+	* A few large vertex and index buffers shared by every mesh, suballocated with RangeAllocator.
+	* Vertices go to a block of their stride, so a mesh's vertexOffset counts whole vertices and its indices stay
+	* as they were; indices all go to uint32 blocks. Meshes in the same blocks draw after a single bind.
+	* A block is added whenever none has room, anything larger than BlockSize() gets a block of its own.
+	* Freed ranges are only handed out again after ReleaseRetired(), a frame still in flight may be drawing from them.
+	*/
+	class GeometryPool {
+	public:
+		//Ranges of one mesh, given back to the pool when destroyed
+		class Allocation {
+		private:
+			friend class GeometryPool;
+			static constexpr uint32_t noBlock = std::numeric_limits<uint32_t>::max();
+			uint32_t vertexBlock = noBlock;
+			uint32_t firstVertex = 0;
+			uint32_t vertexCount = 0;
+			uint32_t indexBlock = noBlock;
+			uint32_t firstIndex = 0;
+			uint32_t indexCount = 0;
+		public:
+			Allocation() = default;
+			Allocation(Allocation&& other) noexcept;
+			Allocation& operator=(Allocation&& other) noexcept;
+			~Allocation();
+
+			bool Empty() const { return vertexBlock == noBlock && indexBlock == noBlock; }
+			//VK_NULL_HANDLE without vertices or without indices
+			VkBuffer VertexBuffer() const;
+			VkBuffer IndexBuffer() const;
+			//vertexOffset of vkCmdDrawIndexed, firstVertex of vkCmdDraw
+			uint32_t FirstVertex() const { return firstVertex; }
+			int32_t VertexOffset() const { return int32_t(firstVertex); }
+			//Added to the mesh's own firstIndex
+			uint32_t FirstIndex() const { return firstIndex; }
+		};
+
+	private:
+		struct VertexBlock {
+			VertexBuffer buffer;
+			RangeAllocator ranges;
+			uint32_t stride;
+		};
+		struct IndexBlock {
+			IndexBuffer buffer;
+			RangeAllocator ranges;
+		};
+		//A freed allocation's ranges, blocks and offsets as Allocation keeps them
+		struct RetiredRanges {
+			uint32_t vertexBlock;
+			uint32_t firstVertex;
+			uint32_t vertexCount;
+			uint32_t indexBlock;
+			uint32_t firstIndex;
+			uint32_t indexCount;
+		};
+
+		std::vector<VertexBlock> vertexBlocks;
+		std::vector<IndexBlock> indexBlocks;
+		std::vector<RetiredRanges> retiredRanges;
+		VkDeviceSize blockSize = VkDeviceSize(64) << 20;
+
+		GeometryPool() = default;
+		GeometryPool(GeometryPool&& other) = delete;
+		GeometryPool(const GeometryPool& other) = delete;
+		GeometryPool& operator=(const GeometryPool& other) = delete;
+
+		void Free(Allocation& allocation);
+
+	public:
+		static GeometryPool& Pool();
+
+		VkDeviceSize BlockSize() const;
+		//Only blocks added afterwards are affected
+		void SetBlockSize(VkDeviceSize size);
+
+		//Copies vertexCount interleaved vertices of stride bytes and the indices in, either may be empty
+		Allocation Allocate(const void* pVertices, uint32_t vertexCount, uint32_t stride, ArrayRef<const uint32_t> indices);
+		//Call once per frame after the in-flight fence has been waited on, gives the ranges freed until then back to their blocks
+		void ReleaseRetired();
+
+		uint32_t VertexBlockCount() const;
+		uint32_t IndexBlockCount() const;
+		//Bytes handed out, retired ranges included, and bytes of all blocks together
+		VkDeviceSize UsedSize() const;
+		VkDeviceSize CapacitySize() const;
+	};
+}
+
+#endif // !_GEOMETRY_POOL_H_
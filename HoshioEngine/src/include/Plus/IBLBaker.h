@@ -0,0 +1,99 @@
+#ifndef _IBL_BAKER_H_
+#define _IBL_BAKER_H_
+
+#include "Plus/ImageManager.h"
+
+namespace HoshioEngine {
+
+	struct IBLSettings {
+		//Cube an equirectangular source is projected onto before filtering
+		uint32_t environmentExtent = 512;
+		uint32_t irradianceExtent = 32;
+		uint32_t prefilteredExtent = 128;
+		//Roughness 0 at level 0 up to 1 at the last level
+		uint32_t prefilteredMipCount = 6;
+		uint32_t brdfLutExtent = 256;
+		uint32_t irradianceSampleCount = 1024;
+		uint32_t prefilterSampleCount = 1024;
+		uint32_t brdfLutSampleCount = 1024;
+	};
+
+	//Image written by IBLBaker, sampled like any other texture
+	class IBLTexture : public Texture {
+	private:
+		friend class IBLBaker;
+		VkExtent2D extent = {};
+		uint32_t mipLevelCount = 1;
+	public:
+		IBLTexture() = default;
+		Texture::DescriptorImageInfo;
+		VkExtent2D Extent() const;
+		uint32_t MipLevelCount() const;
+	};
+
+	/*
+	* Split sum image based lighting:
+	* irradiance	RGBA16F cube, irradiance / PI, diffuse = albedo * texture(irradiance, N)
+	* prefiltered	RGBA16F cube, GGX filtered radiance, textureLod(prefiltered, R, roughness * (MipLevelCount() - 1))
+	* brdfLut		RG32F, (scale, bias) of F0 at uv = (NdotV, roughness)
+	*/
+	struct IBLMaps {
+		IBLTexture irradiance;
+		IBLTexture prefiltered;
+		IBLTexture brdfLut;
+		//Key of the cache file, derived from the source hash and the settings
+		uint64_t hash = 0;
+		bool loadedFromCache = false;
+	};
+
+	/*
+	* Bakes IBLMaps with compute shaders (res/shaders/GLSL/IBL*.comp) and caches the results under
+	* CacheDirectory() as <hash>.ibl, so a valid cache skips the bake and, for files, the source decode.
+	* Everything is submitted and waited on before returning, like texture creation.
+	*/
+	class IBLBaker {
+	private:
+		std::filesystem::path cacheDirectory = "cache/ibl";
+
+		DescriptorSetLayout descriptorSetLayout;
+		PipelineLayout pipelineLayout;
+		std::unordered_map<std::string, Pipeline> mPipelines;
+		VkSampler sampler = VK_NULL_HANDLE;
+
+		IBLBaker() = default;
+		IBLBaker(IBLBaker&& other) = delete;
+		IBLBaker(const IBLBaker& other) = delete;
+		IBLBaker& operator=(const IBLBaker& other) = delete;
+
+		void CreateLayouts();
+		VkPipeline AcquirePipeline(const char* shaderPath);
+		static void CreateTarget(IBLTexture& texture, VkFormat format, uint32_t extent, uint32_t mipLevelCount, bool cube);
+		void CreateTargets(IBLMaps& maps, const IBLSettings& settings) const;
+		bool LoadCache(IBLMaps& maps, const IBLSettings& settings) const;
+		void StoreCache(const IBLMaps& maps, const IBLSettings& settings, const uint8_t* pData) const;
+		//Records the three passes reading environment, then copies the results into the main staging buffer
+		void CmdBake(VkCommandBuffer commandBuffer, IBLMaps& maps, VkImageView environment, const IBLSettings& settings,
+			std::vector<DescriptorSet>& descriptorSets, std::vector<ImageView>& imageViews);
+		//Records one pass writing level mipLevel of target, source may be VK_NULL_HANDLE
+		void CmdDispatch(VkCommandBuffer commandBuffer, const char* shaderPath, VkDescriptorImageInfo source, const IBLTexture& target, VkFormat format,
+			uint32_t mipLevel, uint32_t layerCount, float roughness, uint32_t sampleCount, std::vector<DescriptorSet>& descriptorSets, std::vector<ImageView>& imageViews);
+		void Bake_Internal(IBLMaps& maps, VkImageView environment, const IBLSettings& settings);
+
+	public:
+		static IBLBaker& Baker();
+
+		const std::filesystem::path& CacheDirectory() const;
+		void SetCacheDirectory(std::filesystem::path directory);
+
+		//Creates the maps and fills them from the cache file of sourceHash and settings if there is a valid one
+		bool LoadCached(IBLMaps& maps, uint64_t sourceHash, const IBLSettings& settings = {});
+		//sourceHash identifies the cube's content, e.g. HashFiles() of the files it was loaded from
+		void Bake(IBLMaps& maps, const TextureCube& environment, uint64_t sourceHash, const IBLSettings& settings = {});
+		//Radiance HDR (or any stb readable) panorama, +Y at the top row
+		void BakeEquirectangular(IBLMaps& maps, const char* filePath, const IBLSettings& settings = {});
+
+		static uint64_t HashFiles(ArrayRef<const char* const> filePaths);
+	};
+}
+
+#endif // !_IBL_BAKER_H_
@@ -3,25 +3,41 @@
 
 #include "Plus/BufferManager.h"
 #include "Base/RpwfManager.h"
+#include "Utils/TextureContainer.h"
 
 namespace HoshioEngine {
+	struct ImageData {
+		std::unique_ptr<uint8_t[]> pData;
+		VkExtent2D extent = {};
+	};
+
 	class Texture {
 	protected:
 		ImageMemory imageMemory;
 		ImageView imageView;
 		Texture() = default;
 		void CreateImageMemory(VkImageType imageType, VkFormat format, VkExtent3D extent, uint32_t mipLevelCount, uint32_t arrayLayerCount, VkImageCreateFlags flags = 0);
-		void CreateImageView(VkImageViewType viewType, VkFormat format, uint32_t mipLevelCount, uint32_t arrayLayerCount, VkImageViewCreateFlags flags = 0);
+		void CreateImageView(VkImageViewType viewType, VkFormat format, uint32_t mipLevelCount, uint32_t arrayLayerCount, VkImageViewCreateFlags flags = 0, uint32_t baseMipLevel = 0);
 		//static std::unique_ptr<uint8_t[]> LoadFile_Internal(const auto* address, size_t fileSize, VkExtent2D& extent, VkFormat format);
 		static std::unique_ptr<uint8_t[]> LoadFile_Internal(const char* address, size_t fileSize, VkExtent2D& extent, VkFormat format);
 		static std::unique_ptr<uint8_t[]> LoadFile_Internal(const uint8_t* address, size_t fileSize, VkExtent2D& extent, VkFormat format);
+		//Decodes the files spread over at most one worker per hardware thread and hands the pixels to consumer(index, pImageData, extent) on that worker.
+		//Returns once all of them are done, rethrowing the first failure.
+		static void DecodeFilesParallel(ArrayRef<const char* const> filePaths, VkFormat format,
+			const std::function<void(size_t index, const uint8_t* pImageData, VkExtent2D extent)>& consumer);
+		//Format the staging buffer is filled in: format_final when PixelConverter can produce it on the CPU,
+		//so the GPU neither blits nor allocates a conversion image, format_initial otherwise
+		static VkFormat StagingFormat(VkFormat format_initial, VkFormat format_final);
+		//Copies every stored level as-is, nothing is blitted or generated
+		void CreateFromContainer(const TextureContainer& container, VkImageViewType viewType, VkImageCreateFlags flags = 0);
 	public:
 		VkImageView ImageView() const;
 		VkImage Image() const;
 		const VkImageView* AddressOfImageView() const;
 		const VkImage* AddressOfImage() const;
 
-		VkDescriptorImageInfo DescriptorImageInfo(VkSampler sampler) const;
+		//sampler may be VK_NULL_HANDLE when the binding uses immutable samplers
+		VkDescriptorImageInfo DescriptorImageInfo(VkSampler sampler = VK_NULL_HANDLE) const;
 
 		[[nodiscard]]
 		static std::unique_ptr<uint8_t[]> LoadFile(const char* filePath, VkExtent2D& extent, VkFormat format);
@@ -29,11 +45,21 @@ namespace HoshioEngine {
 		[[nodiscard]]
 		static std::unique_ptr<uint8_t[]> LoadFile(const uint8_t* fileBinaries, size_t fileSize, VkExtent2D& extent, VkFormat format);
 
+		//Decoded on a pool shared by every call, files beyond its thread count wait their turn
+		[[nodiscard]]
+		static std::future<ImageData> LoadFileAsync(std::string filePath, VkFormat format);
+
+		//Parses the header only
+		static bool ReadFileExtent(const char* filePath, VkExtent2D& extent);
+
+		//With format given, mips are generated by MipGenerator when it supports the image and blitted level by level otherwise
 		static void CopyBlitAndGenerateMipmap2D(VkBuffer buffer_copyFrom, VkImage image_copyTo, VkImage image_blitTo, VkExtent2D imageExtent,
-			uint32_t mipLevelCount = 1, uint32_t layerCount = 1, VkFilter minFilter = VK_FILTER_LINEAR);
+			uint32_t mipLevelCount = 1, uint32_t layerCount = 1, VkFilter minFilter = VK_FILTER_LINEAR, VkFormat format = VK_FORMAT_UNDEFINED);
 
 		static void BlitAndGenerateMipmap2D(VkImage image_preinitialized, VkImage image_final, VkExtent2D imageExtent,
-			uint32_t mipLevelCount = 1, uint32_t layerCount = 1, VkFilter minFilter = VK_FILTER_LINEAR);
+			uint32_t mipLevelCount = 1, uint32_t layerCount = 1, VkFilter minFilter = VK_FILTER_LINEAR, VkFormat format = VK_FORMAT_UNDEFINED);
+
+		static bool FormatIsSupported(VkFormat format);
 	};
 
 	class Texture2D : public Texture {
@@ -47,6 +73,7 @@ namespace HoshioEngine {
 		Texture2D() = default;
 		Texture2D(const char* filePath, VkFormat initial_format, VkFormat final_format, bool generateMip = true);
 		Texture2D(const uint8_t* pImageData, VkExtent2D extent, VkFormat initial_format, VkFormat final_format, bool generateMip = true);
+		Texture2D(const TextureContainer& container);
 
 		Texture::DescriptorImageInfo;
 		VkExtent2D Extent() const;
@@ -57,6 +84,8 @@ namespace HoshioEngine {
 
 		void Create(const char* filePath, VkFormat initial_format, VkFormat final_format, bool generateMip = true);
 		void Create(const uint8_t* pImageData, VkExtent2D extent, VkFormat initial_format, VkFormat final_format, bool generateMip = true);
+		//.ktx2/.dds files passed to Create(filePath, ...) end up here, the formats and generateMip are taken from the container
+		void Create(const TextureContainer& container);
 	};
 
 	class TextureArray : public Texture {
@@ -64,13 +93,15 @@ namespace HoshioEngine {
 		VkExtent2D extent = {};
 		uint32_t layerCount = 0;
 
-		void Create_Internal(VkFormat format_initial, VkFormat format_final, bool generateMipmap);
+		//mipLevelCount 0 means the full chain
+		void Create_Internal(VkFormat format_initial, VkFormat format_final, bool generateMipmap, uint32_t mipLevelCount = 0);
 	public:
 		TextureArray() = default;
 		TextureArray(const char* filepath, VkExtent2D extentInTiles, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
 		TextureArray(const uint8_t* pImageData, VkExtent2D fullExtent, VkExtent2D extentInTiles, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
 		TextureArray(ArrayRef<const char* const> filepaths, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
 		TextureArray(ArrayRef<const uint8_t* const> psImageData, VkExtent2D extent, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
+		TextureArray(const TextureContainer& container);
 		Texture::DescriptorImageInfo;
 		VkExtent2D Extent() const;
 		uint32_t Width() const;
@@ -80,6 +111,7 @@ namespace HoshioEngine {
 		void Create(const uint8_t* pImageData, VkExtent2D fullExtent, VkExtent2D extentInTiles, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
 		void Create(ArrayRef<const char* const> filepaths, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
 		void Create(ArrayRef<const uint8_t* const> psImageData, VkExtent2D extent, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
+		void Create(const TextureContainer& container);
 	};
 
 	class TextureCube : public Texture {
@@ -87,6 +119,8 @@ namespace HoshioEngine {
 		VkExtent2D extent = {};
 		VkExtent2D GetExtentInTiles(const glm::uvec2*& facePositions, bool lookFromOutside, bool loadPreviousResult = false);
 		void Create_Internal(VkFormat format_initial, VkFormat format_final, bool generateMipmap);
+		//Copies one face out of a source with the given row pitch, flipped so it reads correctly from inside the cube
+		static void WriteFace(uint8_t* pData_dst, VkFormat format_dst, const uint8_t* pImageData, VkFormat format_src, size_t srcRowPitch, VkExtent2D extent, size_t face, bool lookFromOutside);
 	public:
 		/*
 			Order of facePositions[6], in left handed coordinate, looking from inside:
@@ -106,6 +140,7 @@ namespace HoshioEngine {
 		TextureCube(const uint8_t* pImageData, VkExtent2D fullExtent, const glm::uvec2 facePositions[6], VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
 		TextureCube(const char* const* filepaths, VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
 		TextureCube(const uint8_t* const* psImageData, VkExtent2D extent, VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
+		TextureCube(const TextureContainer& container);
 		Texture::DescriptorImageInfo;
 		VkExtent2D Extent() const;
 		uint32_t Width() const;
@@ -114,6 +149,8 @@ namespace HoshioEngine {
 		void Create(const uint8_t* pImageData, VkExtent2D fullExtent, const glm::uvec2 facePositions[6], VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
 		void Create(const char* const* filepaths, VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
 		void Create(const uint8_t* const* psImageData, VkExtent2D extent, VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
+		//Faces are expected in Vulkan order and orientation already, facePositions and lookFromOutside do not apply
+		void Create(const TextureContainer& container);
 	};
 
 
@@ -128,7 +165,8 @@ namespace HoshioEngine {
 		const VkImageView* AddressOfImageView() const;
 		const VkImage* AddressOfImage() const;
 
-		VkDescriptorImageInfo DescriptorImageInfo(VkSampler sampler) const;
+		//sampler may be VK_NULL_HANDLE when the binding uses immutable samplers
+		VkDescriptorImageInfo DescriptorImageInfo(VkSampler sampler = VK_NULL_HANDLE) const;
 	};
 
 	class ColorAttachment : public Attachment {
@@ -194,18 +232,18 @@ namespace HoshioEngine {
 		int m_depth_stencil_attachment_id = 0;
 		int m_cube_attachment_id = 0;
 
-		std::unordered_map<std::string, int> mTexture2DIDs;
+		std::unordered_map<std::string, int, StringHash, std::equal_to<>> mTexture2DIDs;
 		std::unordered_map<int, Texture2D> mTexture2Ds;
-		std::unordered_map<std::string, int> mTextureArrayIDs;
+		std::unordered_map<std::string, int, StringHash, std::equal_to<>> mTextureArrayIDs;
 		std::unordered_map<int, TextureArray> mTextureArrays;
-		std::unordered_map<std::string, int> mTextureCubeIDs;
+		std::unordered_map<std::string, int, StringHash, std::equal_to<>> mTextureCubeIDs;
 		std::unordered_map<int, TextureCube> mTextureCubes;
 
-		std::unordered_map<std::string, int> mColorAttachmentIDs;
+		std::unordered_map<std::string, int, StringHash, std::equal_to<>> mColorAttachmentIDs;
 		std::unordered_map<int, std::vector<ColorAttachment>> mColorAttachments;
-		std::unordered_map<std::string, int> mDepthStencilAttachmentIDs;
+		std::unordered_map<std::string, int, StringHash, std::equal_to<>> mDepthStencilAttachmentIDs;
 		std::unordered_map<int, std::vector<DepthStencilAttachment>> mDepthStencilAttachments;
-		std::unordered_map<std::string, int> mCubeAttachmentIDs;
+		std::unordered_map<std::string, int, StringHash, std::equal_to<>> mCubeAttachmentIDs;
 		std::unordered_map<int, std::vector<CubeAttachment>> mCubeAttachments;
 
 
@@ -224,9 +262,11 @@ namespace HoshioEngine {
 
 		std::pair<int, std::span<Texture2D>> CreateTexture2D(std::string name, const char* filePath, VkFormat initial_format, VkFormat final_format, bool generateMip = true);
 		std::pair<int, std::span<Texture2D>> CreateTexture2D(std::string name, const uint8_t* pImageData, VkExtent2D extent, VkFormat initial_format, VkFormat final_format, bool generateMip = true);
-		std::pair<int, std::span<Texture2D>> GetTexture2D(std::string name);
+		//Files are decoded in parallel, uploads run in request order on the calling thread as each decode lands
+		std::vector<int> CreateTexture2Ds(ArrayRef<const std::string> names, ArrayRef<const char* const> filePaths, VkFormat initial_format, VkFormat final_format, bool generateMip = true);
+		std::pair<int, std::span<Texture2D>> GetTexture2D(std::string_view name);
 		std::pair<int, std::span<Texture2D>> GetTexture2D(int id);
-		bool HasTexture2D(std::string name);
+		bool HasTexture2D(std::string_view name);
 		bool HasTexture2D(int id);
 		size_t GetTexture2DCount() const;
 
@@ -234,9 +274,9 @@ namespace HoshioEngine {
 		std::pair<int, std::span<TextureArray>> CreateTextureArray(std::string name, const uint8_t* pImageData, VkExtent2D fullExtent, VkExtent2D extentInTiles, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
 		std::pair<int, std::span<TextureArray>> CreateTextureArray(std::string name, ArrayRef<const char* const> filepaths, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
 		std::pair<int, std::span<TextureArray>> CreateTextureArray(std::string name, ArrayRef<const uint8_t* const> psImageData, VkExtent2D extent, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
-		std::pair<int, std::span<TextureArray>> GetTextureArray(std::string name);
+		std::pair<int, std::span<TextureArray>> GetTextureArray(std::string_view name);
 		std::pair<int, std::span<TextureArray>> GetTextureArray(int id);
-		bool HasTextureArray(std::string name);
+		bool HasTextureArray(std::string_view name);
 		bool HasTextureArray(int id);
 		size_t GetTextureArrayCount() const;
 
@@ -245,39 +285,39 @@ namespace HoshioEngine {
 		std::pair<int, std::span<TextureCube>> CreateTextureCube(std::string name, const uint8_t* pImageData, VkExtent2D fullExtent, const glm::uvec2 facePositions[6], VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
 		std::pair<int, std::span<TextureCube>> CreateTextureCube(std::string name, const char* const* filepaths, VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
 		std::pair<int, std::span<TextureCube>> CreateTextureCube(std::string name, const uint8_t* const* psImageData, VkExtent2D extent, VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
-		std::pair<int, std::span<TextureCube>> GetTextureCube(std::string name);
+		std::pair<int, std::span<TextureCube>> GetTextureCube(std::string_view name);
 		std::pair<int, std::span<TextureCube>> GetTextureCube(int id);
-		bool HasTextureCube(std::string name);
+		bool HasTextureCube(std::string_view name);
 		bool HasTextureCube(int id);
 		size_t GetTextureCubeCount() const;
 
 		std::pair<int, std::span<ColorAttachment>> CreateColorAttachments(std::string name, uint32_t count, VkFormat format, VkExtent2D extent, bool hasMipmap = true, uint32_t layerCount = 1,
 			VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT, VkImageUsageFlags otherUsages = 0);
-		std::pair<int, std::span<ColorAttachment>> GetColorAttachments(std::string name);
+		std::pair<int, std::span<ColorAttachment>> GetColorAttachments(std::string_view name);
 		std::pair<int, std::span<ColorAttachment>> GetColorAttachments(int id);
-		int DestroyColorAttachments(std::string name);
+		int DestroyColorAttachments(std::string_view name);
 		int DestroyColorAttachments(int id);
-		bool HasColorAttachments(std::string name);
+		bool HasColorAttachments(std::string_view name);
 		bool HasColorAttachments(int id);
 		size_t GetColorAttachmentsCount() const;
 
 		std::pair<int, std::span<DepthStencilAttachment>> CreateDepthStencilAttachments(std::string name, uint32_t count, VkFormat format, VkExtent2D extent, bool stencilOnly = false, uint32_t layerCount = 1,
 			VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT, VkImageUsageFlags otherUsages = 0);
-		std::pair<int, std::span<DepthStencilAttachment>> GetDepthStencilAttachments(std::string name);
+		std::pair<int, std::span<DepthStencilAttachment>> GetDepthStencilAttachments(std::string_view name);
 		std::pair<int, std::span<DepthStencilAttachment>> GetDepthStencilAttachments(int id);
-		int DestroyDepthStencilAttachments(std::string name);
+		int DestroyDepthStencilAttachments(std::string_view name);
 		int DestroyDepthStencilAttachments(int id);
-		bool HasDepthStencilAttachments(std::string name);
+		bool HasDepthStencilAttachments(std::string_view name);
 		bool HasDepthStencilAttachments(int id);
 		size_t GetDepthStencilAttachmentsCount() const;
 
 		std::pair<int, std::span<CubeAttachment>> CreateCubeAttachments(std::string name, uint32_t count, VkFormat format, VkExtent2D extent, bool hasMipmap = true, 
 			VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT, VkImageUsageFlags otherUsages = 0);
-		std::pair<int, std::span<CubeAttachment>> GetCubeAttachments(std::string name);
+		std::pair<int, std::span<CubeAttachment>> GetCubeAttachments(std::string_view name);
 		std::pair<int, std::span<CubeAttachment>> GetCubeAttachments(int id);
-		int DestroyCubeAttachments(std::string name);
+		int DestroyCubeAttachments(std::string_view name);
 		int DestroyCubeAttachments(int id);
-		bool HasCubeAttachments(std::string name);
+		bool HasCubeAttachments(std::string_view name);
 		bool HasCubeAttachments(int id);
 		size_t GetCubeAttachmentsCount() const;
 		
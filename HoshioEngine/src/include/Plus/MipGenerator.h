@@ -0,0 +1,77 @@
+#ifndef _MIP_GENERATOR_H_
+#define _MIP_GENERATOR_H_
+
+#include "Plus/BufferManager.h"
+#include "Base/DescriptorManager.h"
+#include "Base/PipelineManager.h"
+#include "Utils/ImageUtils.h"
+
+namespace HoshioEngine {
+
+	enum class MIP_FILTER {
+		AVERAGE,
+		MIN,
+		MAX
+	};
+
+	/*
+	* Compute replacement for ImageUtils::CmdGenerateMipmap2D: up to 12 levels of every layer in one dispatch,
+	* with no barrier between levels (res/shaders/GLSL/SinglePassDownsample.glsl).
+	* The image needs VK_IMAGE_USAGE_STORAGE_BIT and RequiredImageCreateFlags(format);
+	* sRGB images are written through UNORM views and filtered in linear space.
+	*/
+	class MipGenerator {
+	public:
+		//Per-call views and descriptor set, keep alive until the recorded commands have completed
+		class Resources {
+		private:
+			friend class MipGenerator;
+			std::vector<ImageView> imageViews;
+			DescriptorSet descriptorSet;
+		public:
+			Resources() = default;
+			Resources(Resources&& other) noexcept = default;
+			~Resources();
+		};
+
+	private:
+		DescriptorSetLayout descriptorSetLayout;
+		PipelineLayout pipelineLayout;
+		//Keyed by shader path, storage format and filter
+		std::unordered_map<std::string, Pipeline> mPipelines;
+		//One atomic counter per layer
+		StorageBuffer counterBuffer;
+		VkSampler sampler = VK_NULL_HANDLE;
+
+		MipGenerator() = default;
+		MipGenerator(MipGenerator&& other) = delete;
+		MipGenerator(const MipGenerator& other) = delete;
+		MipGenerator& operator=(const MipGenerator& other) = delete;
+
+		void CreateLayouts();
+		VkPipeline AcquirePipeline(VkFormat format, MIP_FILTER filter, const char* customShaderPath);
+
+	public:
+		static constexpr uint32_t maxGeneratedMipCount = 12;
+
+		static MipGenerator& Generator();
+
+		//Format the destination levels are written as, VK_FORMAT_UNDEFINED if the shader has no qualifier for it
+		static VkFormat StorageFormat(VkFormat format);
+		static VkImageCreateFlags RequiredImageCreateFlags(VkFormat format);
+		static bool FormatIsSupported(VkFormat format);
+		//Images over 4096 that need more than 6 levels go beyond what a single workgroup can finish
+		static bool IsSupported(VkFormat format, VkExtent2D imageExtent, uint32_t mipLevelCount);
+
+		/*
+		* Same contract as ImageUtils::CmdGenerateMipmap2D: level 0 has been written by a transfer and is in
+		* TRANSFER_SRC_OPTIMAL, every level ends up in imgBarrier_to.
+		* customShaderPath is a compute shader defining Reduce() and including SinglePassDownsample.glsl, filter is then ignored.
+		*/
+		void CmdGenerateMipmap2D(Resources& resources, VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkExtent2D imageExtent,
+			uint32_t mipLevelCount, uint32_t layerCount, ImageBarrierInfo imgBarrier_to, MIP_FILTER filter = MIP_FILTER::AVERAGE,
+			const char* customShaderPath = nullptr);
+	};
+}
+
+#endif // !_MIP_GENERATOR_H_
@@ -0,0 +1,65 @@
+#ifndef _TEXTURE_ATLAS_H_
+#define _TEXTURE_ATLAS_H_
+
+#include "Plus/ImageManager.h"
+#include "Utils/SkylinePacker.h"
+
+namespace HoshioEngine {
+
+	struct TextureAtlasSettings {
+		VkExtent2D layerExtent = { 2048, 2048 };
+		//Levels of the atlas, every one of them keeps a border around each image
+		uint32_t mipLevelCount = 4;
+		//Border texels around each image at level 0, raised to 1 << (mipLevelCount - 1) if smaller
+		uint32_t padding = 0;
+	};
+
+	//Where one image ended up, uv_atlas = uv * uvScale + uvOffset on layer
+	struct AtlasRegion {
+		uint32_t layer = 0;
+		VkRect2D rect = {};
+		glm::vec2 uvScale = glm::vec2(1.f);
+		glm::vec2 uvOffset = glm::vec2(0.f);
+
+		//uv has to be in [0, 1], wrap it with fract() first if the mesh repeats the image
+		glm::vec2 Transform(glm::vec2 uv) const;
+		//(uvScale, uvOffset) for a push constant or a uniform
+		glm::vec4 UVTransform() const;
+	};
+
+	/*
+	* Packs many small images into the layers of one TextureArray, so they share one allocation, view and descriptor.
+	* Every image is surrounded by copies of its edge texels and starts on a multiple of 1 << (mipLevelCount - 1),
+	* so bilinear filtering on any level of the atlas never reads a neighbour.
+	* Images larger than layerExtent minus the border are rejected.
+	*/
+	class TextureAtlas : public TextureArray {
+	private:
+		uint32_t mipLevelCount = 1;
+		uint32_t padding = 0;
+		std::vector<AtlasRegion> regions;
+		float occupancy = 0.f;
+
+		//Places images[i] into regions[i] and its padded block into blocks[i], returns the layer count
+		uint32_t Pack(ArrayRef<const ImageData> images, const TextureAtlasSettings& settings, std::vector<VkRect2D>& blocks);
+
+	public:
+		TextureAtlas() = default;
+		TextureAtlas(ArrayRef<const char* const> filePaths, VkFormat format_initial, VkFormat format_final, const TextureAtlasSettings& settings = {});
+		TextureAtlas(ArrayRef<const ImageData> images, VkFormat format_initial, VkFormat format_final, const TextureAtlasSettings& settings = {});
+		TextureArray::DescriptorImageInfo;
+		uint32_t MipLevelCount() const;
+		uint32_t Padding() const;
+		//Same order as the images passed to Create()
+		const AtlasRegion& Region(size_t index) const;
+		std::span<const AtlasRegion> Regions() const;
+		//Image area over the area of all layers
+		float Occupancy() const;
+
+		void Create(ArrayRef<const char* const> filePaths, VkFormat format_initial, VkFormat format_final, const TextureAtlasSettings& settings = {});
+		//Pixels are in format_initial
+		void Create(ArrayRef<const ImageData> images, VkFormat format_initial, VkFormat format_final, const TextureAtlasSettings& settings = {});
+	};
+}
+
+#endif // !_TEXTURE_ATLAS_H_
@@ -0,0 +1,112 @@
+#ifndef _TEXTURE_STREAMER_H_
+#define _TEXTURE_STREAMER_H_
+
+#include "Plus/ImageManager.h"
+
+namespace HoshioEngine {
+
+	struct TextureStreamingSettings {
+		//Bytes copied into streamed textures per Update(), a single level larger than this still goes through alone
+		VkDeviceSize uploadBudgetPerFrame = 16ull << 20;
+		//Sum of allocated levels over every streamed texture, stream-ins wait while it would be exceeded
+		VkDeviceSize residentBudget = 512ull << 20;
+		//Frames a level must be unwanted before it is dropped, keeps levels from bouncing at a boundary
+		uint32_t evictionDelayFrames = 60;
+		//Levels no larger than this are uploaded at creation and never evicted
+		uint32_t tailExtent = 64;
+	};
+
+	/*
+	* 2D texture backed by a KTX2/DDS file that only keeps levels [AllocatedMip(), MipLevelCount()) in memory,
+	* of which [ResidentMip(), MipLevelCount()) have been uploaded. The view starts at ResidentMip(), so sampling
+	* clamps to the finest level that is there and no sampler minLod is needed.
+	* The image is reallocated only when demand moves past what it holds: once up to the requested level, which the
+	* following frames then fill in level by level, and once down when the finer levels are evicted.
+	* The file stays mapped for the lifetime of the texture, missing levels are read from it on demand.
+	*/
+	class StreamedTexture2D : public Texture {
+	public:
+		struct DescriptorBinding {
+			VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+			VkSampler sampler = VK_NULL_HANDLE;
+			uint32_t binding = 0;
+			uint32_t arrayElement = 0;
+		};
+
+	private:
+		friend class TextureStreamer;
+		TextureContainer container;
+		uint32_t allocatedMip = 0;
+		uint32_t residentMip = 0;
+		uint32_t tailMip = 0;
+		//Finest level requested since the last Update(), UINT32_MAX if nobody asked
+		uint32_t requestedMip = UINT32_MAX;
+		uint32_t unwantedFrames = 0;
+		std::vector<DescriptorBinding> descriptorBindings;
+
+		VkDeviceSize LevelRangeSize(uint32_t firstMip, uint32_t endMip) const;
+		/*
+		* When newAllocatedMip differs, moves the current image into retired and creates one holding [newAllocatedMip, MipLevelCount()),
+		* recording copies of the uploaded levels both have. Then records uploads of levels [newResidentMip, ResidentMip()) from pStaging,
+		* which is written from stagingOffset on and advanced past what was used, and replaces the view with one starting at newResidentMip.
+		*/
+		void CmdSetResidency(VkCommandBuffer commandBuffer, uint32_t newAllocatedMip, uint32_t newResidentMip,
+			VkBuffer stagingBuffer, uint8_t* pStaging, VkDeviceSize& stagingOffset, std::vector<std::pair<ImageMemory, ImageView>>& retired);
+		void RewriteDescriptors() const;
+
+	public:
+		StreamedTexture2D() = default;
+
+		VkExtent2D Extent() const;
+		VkFormat Format() const;
+		uint32_t MipLevelCount() const;
+		uint32_t AllocatedMip() const;
+		uint32_t ResidentMip() const;
+		VkExtent2D ResidentExtent() const;
+		VkDeviceSize ResidentSize() const;
+		bool IsFullyResident() const;
+	};
+
+	/*
+	* Owns every StreamedTexture2D and moves their residency towards what was requested, within the budgets.
+	* Update() must be called once per frame, after the previous frame's fence, before any draw is recorded
+	* and outside of a render pass: it rewrites registered descriptor sets and records copies into commandBuffer.
+	*/
+	class TextureStreamer {
+	private:
+		int m_streamed_texture_id = 0;
+		std::unordered_map<std::string, int, StringHash, std::equal_to<>> mStreamedTextureIDs;
+		std::unordered_map<int, StreamedTexture2D> mStreamedTextures;
+
+		TextureStreamingSettings settings;
+		StagingBuffer stagingBuffer;
+		//Replaced images and views the last recorded frame may still read, destroyed on the next Update()
+		std::vector<std::pair<ImageMemory, ImageView>> retired;
+		//Bytes of every allocated level, what residentBudget is checked against
+		VkDeviceSize residentSize = 0;
+
+	public:
+		std::pair<int, std::span<StreamedTexture2D>> CreateStreamedTexture2D(std::string name, const char* filePath);
+		std::pair<int, std::span<StreamedTexture2D>> GetStreamedTexture2D(std::string_view name);
+		std::pair<int, std::span<StreamedTexture2D>> GetStreamedTexture2D(int id);
+		bool HasStreamedTexture2D(std::string_view name);
+		bool HasStreamedTexture2D(int id);
+		size_t GetStreamedTexture2DCount() const;
+
+		//The descriptor is written now and rewritten every time the texture's view changes
+		void BindDescriptor(int id, VkDescriptorSet descriptorSet, VkSampler sampler, uint32_t binding, uint32_t arrayElement = 0);
+		void UnbindDescriptors(VkDescriptorSet descriptorSet);
+
+		//How many pixels the texture's longer side covers on screen this frame, the finest request of the frame wins
+		void RequestScreenSize(int id, float pixels);
+		void RequestMip(int id, uint32_t mipLevel);
+
+		void Update(VkCommandBuffer commandBuffer);
+
+		const TextureStreamingSettings& Settings() const;
+		void SetSettings(const TextureStreamingSettings& settings);
+		VkDeviceSize ResidentSize() const;
+	};
+}
+
+#endif // !_TEXTURE_STREAMER_H_
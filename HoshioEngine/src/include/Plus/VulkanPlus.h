@@ -9,6 +9,8 @@
 #include "Base/SyncManager.h"
 #include "Base/PipelineManager.h"
 #include "Plus/ImageManager.h"
+#include "Plus/TextureStreamer.h"
+#include "Utils/FrameAllocator.h"
 
 namespace HoshioEngine {
 	
@@ -28,14 +30,16 @@ namespace HoshioEngine {
 		CommandBuffer commandBuffer_present;
 
 		DescriptorPool descriptorPool;
-		std::vector<Framebuffer> swapchainFramebuffers;
+		//Owned by rpwf_manager's framebuffer cache; a single entry each when imageless framebuffers are used
+		std::vector<const Framebuffer*> swapchainFramebuffers;
 		std::vector<DepthStencilAttachment> swapchainDepthStencilAttachments;
-		std::vector<Framebuffer> swapchainFramebuffersWithDepthStencil;
+		std::vector<const Framebuffer*> swapchainFramebuffersWithDepthStencil;
 		RenderPass swapchainRenderPass;
 		RenderPass swapchainRenderPassWithDepthStencil;
 		VertexBuffer defaultVertexBuffer;
 
 		ImageManager image_manager;
+		TextureStreamer texture_streamer;
 		SamplerManager sampler_manager;
 		RpwfManager rpwf_manager;
 		QueryPoolManager query_pool_manager;
@@ -66,18 +70,22 @@ namespace HoshioEngine {
 		const VertexBuffer& DefaultVertexBuffer() const;
 		const Framebuffer& CurrentSwapchainFramebuffer() const;
 		const Framebuffer& CurrentSwapchainFramebufferWithDepthStencil() const;
-		const std::vector<Framebuffer>& SwapchainFramebuffers() const;
-		const std::vector<Framebuffer>& SwapchainFramebuffersWithDepthStencil() const;
+		const std::vector<const Framebuffer*>& SwapchainFramebuffers() const;
+		const std::vector<const Framebuffer*>& SwapchainFramebuffersWithDepthStencil() const;
 		const RenderPass& SwapchainRenderPass() const;
 		const RenderPass& SwapchainRenderPassWithDepthStencil() const;
+		//Begins the swapchain render pass on the current image, binding the views itself when the framebuffer is imageless
+		void BeginSwapchainRenderPass(VkCommandBuffer commandBuffer, bool withDepthStencil, VkRect2D renderArea, ArrayRef<const VkClearValue> clearValues = {},
+			VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE) const;
 
 		void ExecuteCommandBuffer_Graphics(VkCommandBuffer commandBuffer) const;
 
 		std::pair<int, std::span<Texture2D>> CreateTexture2D(std::string name, const char* filePath, VkFormat initial_format, VkFormat final_format, bool generateMip = true);
 		std::pair<int, std::span<Texture2D>> CreateTexture2D(std::string name, const uint8_t* pImageData, VkExtent2D extent, VkFormat initial_format, VkFormat final_format, bool generateMip = true);
-		std::pair<int, std::span<Texture2D>> GetTexture2D(std::string name);
+		std::vector<int> CreateTexture2Ds(ArrayRef<const std::string> names, ArrayRef<const char* const> filePaths, VkFormat initial_format, VkFormat final_format, bool generateMip = true);
+		std::pair<int, std::span<Texture2D>> GetTexture2D(std::string_view name);
 		std::pair<int, std::span<Texture2D>> GetTexture2D(int id);
-		bool HasTexture2D(std::string name);
+		bool HasTexture2D(std::string_view name);
 		bool HasTexture2D(int id);
 		size_t GetTextureCount() const;
 
@@ -85,9 +93,9 @@ namespace HoshioEngine {
 		std::pair<int, std::span<TextureArray>> CreateTextureArray(std::string name, const uint8_t* pImageData, VkExtent2D fullExtent, VkExtent2D extentInTiles, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
 		std::pair<int, std::span<TextureArray>> CreateTextureArray(std::string name, ArrayRef<const char* const> filepaths, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
 		std::pair<int, std::span<TextureArray>> CreateTextureArray(std::string name, ArrayRef<const uint8_t* const> psImageData, VkExtent2D extent, VkFormat format_initial, VkFormat format_final, bool generateMipmap = true);
-		std::pair<int, std::span<TextureArray>> GetTextureArray(std::string name);
+		std::pair<int, std::span<TextureArray>> GetTextureArray(std::string_view name);
 		std::pair<int, std::span<TextureArray>> GetTextureArray(int id);
-		bool HasTextureArray(std::string name);
+		bool HasTextureArray(std::string_view name);
 		bool HasTextureArray(int id);
 		size_t GetTextureArrayCount() const;
 
@@ -96,41 +104,50 @@ namespace HoshioEngine {
 		std::pair<int, std::span<TextureCube>> CreateTextureCube(std::string name, const uint8_t* pImageData, VkExtent2D fullExtent, const glm::uvec2 facePositions[6], VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
 		std::pair<int, std::span<TextureCube>> CreateTextureCube(std::string name, const char* const* filepaths, VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
 		std::pair<int, std::span<TextureCube>> CreateTextureCube(std::string name, const uint8_t* const* psImageData, VkExtent2D extent, VkFormat format_initial, VkFormat format_final, bool lookFromOutside = false, bool generateMipmap = true);
-		std::pair<int, std::span<TextureCube>> GetTextureCube(std::string name);
+		std::pair<int, std::span<TextureCube>> GetTextureCube(std::string_view name);
 		std::pair<int, std::span<TextureCube>> GetTextureCube(int id);
-		bool HasTextureCube(std::string name);
+		bool HasTextureCube(std::string_view name);
 		bool HasTextureCube(int id);
 		size_t GetTextureCubeCount() const;
 
+		std::pair<int, std::span<StreamedTexture2D>> CreateStreamedTexture2D(std::string name, const char* filePath);
+		std::pair<int, std::span<StreamedTexture2D>> GetStreamedTexture2D(std::string_view name);
+		std::pair<int, std::span<StreamedTexture2D>> GetStreamedTexture2D(int id);
+		bool HasStreamedTexture2D(std::string_view name);
+		bool HasStreamedTexture2D(int id);
+		size_t GetStreamedTexture2DCount() const;
+		//Requests, descriptor bindings, budgets and the per-frame Update()
+		TextureStreamer& TextureStreaming();
+
 
 
 		std::pair<int, std::span<ColorAttachment>> CreateColorAttachments(std::string name, uint32_t count, VkFormat format, VkExtent2D extent, bool hasMipmap = true, uint32_t layerCount = 1,
 			VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT, VkImageUsageFlags otherUsages = 0);
-		int DestroyColorAttachments(std::string name);
+		int DestroyColorAttachments(std::string_view name);
 		int DestroyColorAttachments(int id);
-		std::pair<int, std::span<ColorAttachment>> GetColorAttachments(std::string name);
+		std::pair<int, std::span<ColorAttachment>> GetColorAttachments(std::string_view name);
 		std::pair<int, std::span<ColorAttachment>> GetColorAttachments(int id);
-		bool HasColorAttachments(std::string name);
+		bool HasColorAttachments(std::string_view name);
 		bool HasColorAttachments(int id);
 		size_t GetColorAttachmentsCount() const;
 
 		std::pair<int, std::span<DepthStencilAttachment>> CreateDepthStencilAttachments(std::string name, uint32_t count, VkFormat format, VkExtent2D extent, bool stencilOnly = false, uint32_t layerCount = 1,
 			VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT, VkImageUsageFlags otherUsages = 0);
-		int DestroyDepthStencilAttachments(std::string name);
+		int DestroyDepthStencilAttachments(std::string_view name);
 		int DestroyDepthStencilAttachments(int id);
-		std::pair<int, std::span<DepthStencilAttachment>> GetDepthStencilAttachments(std::string name);
+		std::pair<int, std::span<DepthStencilAttachment>> GetDepthStencilAttachments(std::string_view name);
 		std::pair<int, std::span<DepthStencilAttachment>> GetDepthStencilAttachments(int id);
-		bool HasDepthStencilAttachments(std::string name);
+		bool HasDepthStencilAttachments(std::string_view name);
 		bool HasDepthStencilAttachments(int id);
 		size_t GetDepthStencilAttachmentsCount() const;
 
 		std::pair<int, std::span<CubeAttachment>> CreateCubeAttachments(std::string name, uint32_t count, VkFormat format, VkExtent2D extent, bool hasMipmap = true,
 			VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT, VkImageUsageFlags otherUsages = 0);
-		std::pair<int, std::span<CubeAttachment>> GetCubeAttachments(std::string name);
+		std::pair<int, std::span<CubeAttachment>> GetCubeAttachments(std::string_view name);
 		std::pair<int, std::span<CubeAttachment>> GetCubeAttachments(int id);
-		int DestroyCubeAttachments(std::string name);
+		int DestroyCubeAttachments(std::string_view name);
 		int DestroyCubeAttachments(int id);
-		bool HasCubeAttachments(std::string name);
+		bool HasCubeAttachments(std::string_view name);
 		bool HasCubeAttachments(int id);
 		size_t GetCubeAttachmentsCount() const;
 
@@ -144,6 +161,11 @@ namespace HoshioEngine {
 		bool HasFramebuffers(std::string name);
 		bool HasFramebuffers(int id);
 		size_t GetFramebuffersCount() const;
+		const Framebuffer& AcquireFramebuffer(const RenderPass& renderPass, ArrayRef<const VkImageView> attachments, VkExtent2D extent, uint32_t layers = 1);
+		const Framebuffer& AcquireImagelessFramebuffer(const RenderPass& renderPass, ArrayRef<const VkFramebufferAttachmentImageInfo> attachmentImageInfos, VkExtent2D extent, uint32_t layers = 1);
+		uint32_t EvictFramebuffers(ArrayRef<const VkImageView> attachments);
+		bool EvictFramebuffer(VkFramebuffer framebuffer);
+		size_t GetFramebufferCacheCount() const;
 
 		std::pair<int, std::span<Fence>> CreateFences(std::string name, uint32_t count, VkFenceCreateFlags flags = 0);
 		std::pair<int, std::span<Fence>> GetFences(std::string name);
@@ -161,6 +183,8 @@ namespace HoshioEngine {
 
 		std::pair<int, std::span<ShaderModule>>  CreateShaderModule(std::string name, const char* filePath);
 		std::pair<int, std::span<ShaderModule>>  CreateShaderModule(std::string name, size_t codeSize, const uint32_t* pCode);
+		std::pair<int, std::span<ShaderModule>>  CreateShaderModule(std::string name, const ShaderCompileInfo& compileInfo);
+		int WatchShaderModule(std::string name, const ShaderCompileInfo& compileInfo, std::function<void()> onReloaded);
 		std::pair<int, std::span<ShaderModule>>  GetShaderModule(std::string name);
 		std::pair<int, std::span<ShaderModule>>  GetShaderModule(int id);
 		bool HasShaderModule(std::string name);
@@ -176,6 +200,12 @@ namespace HoshioEngine {
 		std::pair<int, std::span<Pipeline>> GetPipeline(std::string name);
 		std::pair<int, std::span<Pipeline>> GetPipeline(int id);
 		size_t GetPipelineCount() const;
+		int RequestPipeline(std::string name, const PipelineConfigurator& configurator, int fallback_id = M_INVALID_ID);
+		int RequestPipeline(std::string name, const VkComputePipelineCreateInfo& createInfo, int fallback_id = M_INVALID_ID);
+		VkPipeline ResolvePipeline(int id);
+		bool IsPipelineReady(int id);
+		uint32_t CollectAsyncPipelines();
+		void WaitAsyncPipelines();
 
 		std::pair<int, std::span<PipelineLayout>> CreatePipelineLayout(std::string name, VkPipelineLayoutCreateInfo& createInfo);
 		std::pair<int, std::span<PipelineLayout>> GetPipelineLayout(std::string name);
@@ -198,12 +228,14 @@ namespace HoshioEngine {
 		bool HasTimestampQueries(int id);
 		size_t GetTimestampQueriesCount() const;
 
-		std::pair<int, std::span<Sampler>> CreateSampler(std::string name, VkSamplerCreateInfo& createInfo);
+		std::pair<int, std::span<Sampler>> CreateSampler(std::string name, const VkSamplerCreateInfo& createInfo);
+		std::pair<int, std::span<Sampler>> AcquireSampler(const VkSamplerCreateInfo& createInfo);
 		std::pair<int, std::span<Sampler>> GetSampler(std::string name);
 		std::pair<int, std::span<Sampler>> GetSampler(int id);
 		bool HasSampler(std::string name);
 		bool HasSampler(int id);
 		size_t GetSamplerCount() const;
+		const VkSampler* ImmutableSamplers(int id, uint32_t descriptorCount = 1);
 
 		std::pair<int, std::span<DescriptorSetLayout>> CreateDescriptorSetLayout(std::string name, VkDescriptorSetLayoutCreateInfo& createInfo);
 		std::pair<int, std::span<DescriptorSetLayout>> GetDescriptorSetLayout(std::string name);
@@ -27,6 +27,12 @@ public:
     ArrayRef& operator=(const ArrayRef&) = delete;
 };
 
+//Transparent hash, lets name -> id maps be searched with a std::string_view without building a std::string
+struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view value) const { return std::hash<std::string_view>{}(value); }
+};
+
 
 //helper
 enum class FONT_COLOR
@@ -48,5 +54,11 @@ void PrintProgressBar(int progress, int total, const char* tips = "Progress");
 
 glm::mat4 FlipVertical(const glm::mat4& projection);
 
+//FNV-1a, used as the key of the on-disk caches
+uint64_t HashBytes(const void* pData, size_t size, uint64_t seed = 14695981039346656037ull);
+
+//Splits [0, count) into one contiguous chunk per thread (0 = every hardware thread), returns when all are done and rethrows the first failure
+void ParallelFor(size_t count, uint32_t threadCount, const std::function<void(size_t begin, size_t end)>& body);
+
 #endif // !_COMMON_UTILS_H_
 
@@ -0,0 +1,69 @@
+#ifndef _FRAME_ALLOCATOR_H_
+#define _FRAME_ALLOCATOR_H_
+
+#include "VulkanCommon.h"
+
+namespace HoshioEngine {
+
+	/*
+	* Bump allocator over a list of blocks. Deallocation is a no-op, everything comes back at once on Reset().
+	* A Reset() after the arena had to grow merges the blocks into one, so a steady workload settles on a
+	* single block and stops calling into the heap.
+	*/
+	class LinearArena : public std::pmr::memory_resource {
+	private:
+		struct Block {
+			std::byte* pData;
+			size_t capacity;
+		};
+
+		std::vector<Block> blocks;
+		size_t initialCapacity;
+		size_t currentBlock = 0;
+		size_t offset = 0;
+		size_t bytesUsed = 0;
+
+		void* TryAllocate(size_t bytes, size_t alignment);
+		void Release();
+
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	public:
+		explicit LinearArena(size_t initialCapacity = 1 << 20);
+		LinearArena(LinearArena&& other) = delete;
+		LinearArena(const LinearArena& other) = delete;
+		LinearArena& operator=(const LinearArena& other) = delete;
+		~LinearArena();
+
+		void Reset();
+
+		size_t BytesUsed() const;
+		size_t Capacity() const;
+	};
+
+	/*
+	* Memory for temporaries that die with the frame.
+	* Frame() belongs to the main thread and is reset by EndFrame().
+	* Scratch() is per thread and rewinds itself the first time a thread uses it in a new frame,
+	* so worker threads never need to be told the frame ended.
+	*/
+	class FrameMemory {
+	private:
+		FrameMemory() = delete;
+
+	public:
+		static LinearArena& Frame();
+		static LinearArena& Scratch();
+
+		//Call once per frame after the in-flight fence has been waited on
+		static void EndFrame();
+		static uint64_t FrameIndex();
+
+		//Heap allocations made so far by the calling thread; only counted in debug builds, always 0 otherwise
+		static uint64_t HeapAllocationCount();
+	};
+}
+
+#endif // !_FRAME_ALLOCATOR_H_
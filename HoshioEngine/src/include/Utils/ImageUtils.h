@@ -16,6 +16,13 @@ namespace HoshioEngine {
 			:isNeeded(true), stage(stage), access(access), layout(layout) {};
 	};
 
+	enum class TEXEL_TRANSFORM {
+		NONE,
+		FLIP_HORIZONTAL,
+		FLIP_VERTICAL,
+		ROTATE_180
+	};
+
 	struct ImageUtils {
 
 		static uint32_t CalculateMipLevelCount(VkExtent2D extent);
@@ -33,6 +40,10 @@ namespace HoshioEngine {
 
 		static void CmdGenerateMipmap2D(VkCommandBuffer commandBuffer, VkImage image, VkExtent2D imageExtent, uint32_t mipLevelCount, uint32_t layerCount,
 			ImageBarrierInfo  imgBarrier_to, VkFilter minFilter = VK_FILTER_LINEAR);
+
+		//CPU side copy of a texel rectangle, rows are mirrored with SSE2 (AVX2 if compiled for it) for 4, 8 and 16 byte texels
+		static void CopyTexels(const uint8_t* pSrc, size_t srcRowPitch, uint8_t* pDst, size_t dstRowPitch,
+			VkExtent2D extent, size_t texelSize, TEXEL_TRANSFORM transform = TEXEL_TRANSFORM::NONE);
 	};
 }
 
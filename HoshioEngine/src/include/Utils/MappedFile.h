@@ -0,0 +1,36 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include "VulkanCommon.h"
+
+namespace HoshioEngine {
+
+	//Read-only view of a whole file, mapped instead of read so loaders can copy straight out of the page cache
+	class MappedFile {
+	private:
+		const uint8_t* pData = nullptr;
+		size_t size = 0;
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#else
+		int fileDescriptor = -1;
+#endif
+	public:
+		MappedFile() = default;
+		MappedFile(const char* filePath);
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+		~MappedFile();
+
+		const uint8_t* Data() const;
+		size_t Size() const;
+
+		//Throws std::runtime_error if the file cannot be opened or mapped
+		void Open(const char* filePath);
+		void Close();
+	};
+}
+
+#endif // !_MAPPED_FILE_H_
@@ -0,0 +1,30 @@
+#ifndef _PIXEL_CONVERTER_H_
+#define _PIXEL_CONVERTER_H_
+
+#include "Utils/ImageUtils.h"
+
+namespace HoshioEngine {
+
+	/*
+	* CPU conversion between uncompressed color formats, with the same result as a blit between them:
+	* texels are decoded to RGBA (missing G and B read 0, missing A reads 1) and encoded into the destination.
+	* Handles 1-4 component 8 bit UNORM/SRGB (RGB or BGR order), 16 bit UNORM, 16 and 32 bit SFLOAT.
+	* Swizzles, 8 to 16 bit, float32 to float16 (F16C if compiled for it), sRGB encode/decode and RGB to RGBA expansion
+	* have SIMD or table driven kernels, every other pair goes through floats.
+	*/
+	struct PixelConverter {
+		static bool CanConvert(VkFormat srcFormat, VkFormat dstFormat);
+
+		//pSrc and pDst must not overlap
+		static void ConvertRow(const uint8_t* pSrc, VkFormat srcFormat, uint8_t* pDst, VkFormat dstFormat, size_t texelCount);
+
+		//ImageUtils::CopyTexels converting from srcFormat to dstFormat on the way, runs on the calling thread
+		static void ConvertTexels(const uint8_t* pSrc, size_t srcRowPitch, VkFormat srcFormat, uint8_t* pDst, size_t dstRowPitch, VkFormat dstFormat,
+			VkExtent2D extent, TEXEL_TRANSFORM transform = TEXEL_TRANSFORM::NONE);
+
+		//Tightly packed texels, split over threadCount workers (0 for the hardware concurrency)
+		static void Convert(const uint8_t* pSrc, VkFormat srcFormat, uint8_t* pDst, VkFormat dstFormat, size_t texelCount, uint32_t threadCount = 0);
+	};
+}
+
+#endif // !_PIXEL_CONVERTER_H_
@@ -0,0 +1,40 @@
+#ifndef _RANGE_ALLOCATOR_H_
+#define _RANGE_ALLOCATOR_H_
+
+#include "VulkanCommon.h"
+
+namespace HoshioEngine {
+
+	/*
+	* First fit allocator over [0, capacity) in whatever unit the caller counts in (vertices, indices, bytes).
+	* Free ranges are kept by offset, a freed range merges with free neighbours on either side,
+	* so the free list never holds two ranges that touch.
+	*/
+	class RangeAllocator {
+	private:
+		//Offset -> size
+		std::map<uint32_t, uint32_t> freeRanges;
+		uint32_t capacity = 0;
+		uint32_t freeSize = 0;
+
+	public:
+		static constexpr uint32_t invalidOffset = std::numeric_limits<uint32_t>::max();
+
+		RangeAllocator() = default;
+		RangeAllocator(uint32_t capacity);
+
+		void Reset(uint32_t capacity);
+
+		//invalidOffset if no free range is large enough
+		uint32_t Allocate(uint32_t size);
+		//Has to be a range Allocate() returned and not freed since
+		void Free(uint32_t offset, uint32_t size);
+
+		uint32_t Capacity() const;
+		uint32_t FreeSize() const;
+		uint32_t LargestFreeRange() const;
+		size_t FreeRangeCount() const;
+	};
+}
+
+#endif // !_RANGE_ALLOCATOR_H_
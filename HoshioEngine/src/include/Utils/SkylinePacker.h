@@ -0,0 +1,46 @@
+#ifndef _SKYLINE_PACKER_H_
+#define _SKYLINE_PACKER_H_
+
+#include "VulkanCommon.h"
+
+namespace HoshioEngine {
+
+	/*
+	* Rectangle packer keeping only the top edge ("skyline") of what has been placed so far.
+	* Rectangles go to the start of a skyline segment where their top edge ends up lowest (bottom left rule),
+	* the space hidden under a rectangle wider than the segment it lands on is given up.
+	*/
+	class SkylinePacker {
+	private:
+		struct Segment {
+			uint32_t x;
+			uint32_t y;
+			uint32_t width;
+		};
+
+		VkExtent2D extent = {};
+		std::vector<Segment> skyline;
+		uint64_t usedArea = 0;
+
+		//y the rectangle would sit at if placed at the start of skyline[index], false if it does not fit there
+		bool Fits(size_t index, VkExtent2D size, uint32_t& y) const;
+
+	public:
+		SkylinePacker() = default;
+		SkylinePacker(VkExtent2D extent);
+
+		void Reset(VkExtent2D extent);
+
+		//Best position for size without placing it, false if it fits nowhere
+		bool Find(VkExtent2D size, VkOffset2D& offset) const;
+		//rect.offset has to come from Find() on the current state
+		void Insert(VkRect2D rect);
+		bool Pack(VkExtent2D size, VkOffset2D& offset);
+
+		VkExtent2D Extent() const;
+		//Placed area over the whole area
+		float Occupancy() const;
+	};
+}
+
+#endif // !_SKYLINE_PACKER_H_
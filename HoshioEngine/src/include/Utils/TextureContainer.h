@@ -0,0 +1,56 @@
+#ifndef _TEXTURE_CONTAINER_H_
+#define _TEXTURE_CONTAINER_H_
+
+#include "Utils/MappedFile.h"
+
+namespace HoshioEngine {
+
+	/*
+	* GPU-ready texture read from a KTX2 or DDS file, payload kept as stored (BCn blocks or raw texels).
+	* The payload is laid out level by level, each level holding layerCount * faceCount tightly packed images,
+	* which is exactly the order vkCmdCopyBufferToImage expects for array layer = layer * faceCount + face.
+	* Nothing is copied at parse time: regions describe where every image sits in the source bytes,
+	* CopyData() writes the level-major layout straight into the destination (usually mapped staging memory).
+	*/
+	struct TextureContainer {
+		struct Level {
+			VkDeviceSize offset = 0;
+			VkDeviceSize size = 0;
+			VkExtent2D extent = {};
+		};
+
+		struct CopyRegion {
+			size_t srcOffset = 0;
+			VkDeviceSize dstOffset = 0;
+			VkDeviceSize size = 0;
+		};
+
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		VkExtent2D extent = {};
+		uint32_t layerCount = 1;
+		uint32_t faceCount = 1;
+		std::vector<Level> levels;
+		std::vector<CopyRegion> regions;
+		//Source of regions; Load() keeps the mapping alive, LoadKtx2/LoadDds leave the caller's bytes borrowed
+		const uint8_t* pSource = nullptr;
+		std::shared_ptr<MappedFile> mappedFile;
+
+		uint32_t MipLevelCount() const { return uint32_t(levels.size()); }
+		VkDeviceSize DataSize() const { return levels.empty() ? 0 : levels.back().offset + levels.back().size; }
+		void CopyData(uint8_t* pData_dst) const;
+		//Only the images of one level, written as if pData_dst was levels[level].offset in the full layout
+		void CopyLevel(uint32_t level, uint8_t* pData_dst) const;
+		uint32_t ArrayLayerCount() const { return layerCount * faceCount; }
+		bool IsCube() const { return faceCount == 6; }
+
+		//By extension, .ktx2 or .dds
+		static bool IsContainerFile(std::string_view filePath);
+
+		//Maps the file; throws std::runtime_error if it cannot be read or uses a layout that is not supported
+		static TextureContainer Load(const char* filePath);
+		static TextureContainer LoadKtx2(const uint8_t* pFile, size_t fileSize);
+		static TextureContainer LoadDds(const uint8_t* pFile, size_t fileSize);
+	};
+}
+
+#endif // !_TEXTURE_CONTAINER_H_
@@ -0,0 +1,56 @@
+#ifndef _TEXTURE_COOKER_H_
+#define _TEXTURE_COOKER_H_
+
+#include "Utils/CommonUtils.h"
+
+namespace HoshioEngine {
+
+	enum class COOK_FORMAT {
+		RGBA8,
+		BC5,	//Normal maps, keeps RG and renormalizes every mip
+		BC7
+	};
+
+	struct CookOptions {
+		COOK_FORMAT format = COOK_FORMAT::BC7;
+		//Filter in linear space and tag the output as sRGB, ignored for BC5
+		bool srgb = true;
+		bool generateMips = true;
+		//0 uses every hardware thread
+		uint32_t threadCount = 0;
+	};
+
+	/*
+	* Turns PNG/JPG sources into KTX2 files that TextureContainer uploads as stored.
+	* Mips are box filtered (SSE) in linear space, blocks are encoded on all threads.
+	* The hash of the source bytes and options is written into the KTX2 key/value data,
+	* Cook() skips any output whose recorded hash still matches.
+	*/
+	class TextureCooker {
+	public:
+		struct Level {
+			VkExtent2D extent = {};
+			std::vector<uint8_t> data;
+		};
+
+	private:
+		static std::vector<std::vector<glm::vec4>> BuildMipChain(const uint8_t* pRgba8, VkExtent2D extent, const CookOptions& options);
+		static std::vector<uint8_t> ToRgba8(const std::vector<glm::vec4>& pixels, const CookOptions& options);
+
+	public:
+		static VkFormat OutputFormat(const CookOptions& options);
+		static uint64_t SourceHash(const uint8_t* pFile, size_t fileSize, const CookOptions& options);
+		//0 if the file is missing or was not written by the cooker
+		static uint64_t ReadCookedHash(const std::filesystem::path& cookedPath);
+
+		//Returns false when the output is already up to date; throws std::runtime_error on failure
+		static bool Cook(const std::filesystem::path& input, const std::filesystem::path& output, const CookOptions& options, bool force = false);
+
+		static void EncodeBC7(const uint8_t* pRgba8, VkExtent2D extent, uint8_t* pBlocks, uint32_t threadCount = 0);
+		static void EncodeBC5(const uint8_t* pRgba8, VkExtent2D extent, uint8_t* pBlocks, uint32_t threadCount = 0);
+
+		static void WriteKtx2(const std::filesystem::path& output, VkFormat format, ArrayRef<const Level> levels, uint64_t sourceHash);
+	};
+}
+
+#endif // !_TEXTURE_COOKER_H_
@@ -0,0 +1,50 @@
+#ifndef _WORKER_POOL_H_
+#define _WORKER_POOL_H_
+
+#include "VulkanCommon.h"
+#include <deque>
+
+namespace HoshioEngine {
+
+	/*
+	* A fixed set of threads taking tasks off one queue in submission order.
+	* Unlike std::async the number of threads never grows with the number of tasks, and
+	* dropping a returned future does not block. Queued tasks still run when the pool is destroyed.
+	*/
+	class WorkerPool {
+	private:
+		std::vector<std::thread> workers;
+		std::deque<std::function<void()>> tasks;
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool stopping = false;
+
+		void Work();
+
+	public:
+		//0 = one thread less than the hardware has, at least one
+		explicit WorkerPool(uint32_t threadCount = 0);
+		WorkerPool(WorkerPool&& other) = delete;
+		WorkerPool(const WorkerPool& other) = delete;
+		WorkerPool& operator=(const WorkerPool& other) = delete;
+		~WorkerPool();
+
+		uint32_t ThreadCount() const;
+
+		template<typename Task>
+		std::future<std::invoke_result_t<Task&>> Submit(Task&& task) {
+			using Result = std::invoke_result_t<Task&>;
+			//std::function needs a copyable target, packaged_task is move-only
+			auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+			std::future<Result> future = packaged->get_future();
+			{
+				std::lock_guard lock(mutex);
+				tasks.emplace_back([packaged] { (*packaged)(); });
+			}
+			condition.notify_one();
+			return future;
+		}
+	};
+}
+
+#endif // !_WORKER_POOL_H_
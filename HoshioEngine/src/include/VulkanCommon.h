@@ -23,6 +23,12 @@
 #include <mutex>
 #include <stdexcept>
 #include <future>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+#include <condition_variable>
+#include <algorithm>
+#include <memory_resource>
 
 #ifdef NDEBUG
 	#include <Python.h>
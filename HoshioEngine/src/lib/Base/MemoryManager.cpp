@@ -83,20 +83,40 @@ namespace HoshioEngine {
 
 	void DeviceMemory::UnMapMemory(VkDeviceSize size, VkDeviceSize offset) const
 	{
-		if (!(memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
-			AdjustNoCoherentMemorySize(size, offset);
-			VkMappedMemoryRange range = {
-				.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-				.memory = handle,
-				.offset = offset,
-				.size = size
-			};
-			if (vkFlushMappedMemoryRanges(VulkanBase::Base().Device(), 1, &range) != VK_SUCCESS)
-				throw std::runtime_error("Failed to flush mapped memory range!");
-		}
+		FlushMemory(size, offset);
 		vkUnmapMemory(VulkanBase::Base().Device(), handle);
 	}
 
+	void DeviceMemory::FlushMemory(VkDeviceSize size, VkDeviceSize offset) const
+	{
+		if (memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+			return;
+		AdjustNoCoherentMemorySize(size, offset);
+		VkMappedMemoryRange range = {
+			.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+			.memory = handle,
+			.offset = offset,
+			.size = size
+		};
+		if (vkFlushMappedMemoryRanges(VulkanBase::Base().Device(), 1, &range) != VK_SUCCESS)
+			throw std::runtime_error("Failed to flush mapped memory range!");
+	}
+
+	void DeviceMemory::InvalidateMemory(VkDeviceSize size, VkDeviceSize offset) const
+	{
+		if (memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+			return;
+		AdjustNoCoherentMemorySize(size, offset);
+		VkMappedMemoryRange range = {
+			.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+			.memory = handle,
+			.offset = offset,
+			.size = size
+		};
+		if (vkInvalidateMappedMemoryRanges(VulkanBase::Base().Device(), 1, &range) != VK_SUCCESS)
+			throw std::runtime_error("Failed to invalidate mapped memory range!");
+	}
+
 	void DeviceMemory::SynchronizeData(const void* pData_src, VkDeviceSize size, VkDeviceSize offset) const
 	{
 		void* pData_dst;
@@ -269,6 +289,16 @@ namespace HoshioEngine {
 		deviceMemory.UnMapMemory(size, offset);
 	}
 
+	void BufferMemory::FlushMemory(VkDeviceSize size, VkDeviceSize offset) const
+	{
+		deviceMemory.FlushMemory(size, offset);
+	}
+
+	void BufferMemory::InvalidateMemory(VkDeviceSize size, VkDeviceSize offset) const
+	{
+		deviceMemory.InvalidateMemory(size, offset);
+	}
+
 	void BufferMemory::SynchronizeData(const void* pData_src, VkDeviceSize size, VkDeviceSize offset) const
 	{
 		deviceMemory.SynchronizeData(pData_src, size, offset);
@@ -155,6 +155,17 @@ namespace HoshioEngine {
 		return &handle;
 	}
 
+	Pipeline& Pipeline::operator=(Pipeline&& other) noexcept
+	{
+		if (this != &other) {
+			if (handle)
+				vkDestroyPipeline(VulkanBase::Base().Device(), handle, nullptr);
+			handle = other.handle;
+			other.handle = VK_NULL_HANDLE;
+		}
+		return *this;
+	}
+
 	void Pipeline::Create(VkGraphicsPipelineCreateInfo& createInfo)
 	{
 		createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -852,7 +863,7 @@ namespace HoshioEngine {
 	std::pair<int, std::span<ShaderModule>> PipelineManager::RecreateShaderModule(int id, std::string& file_path)
 	{
 		if (auto it = mShaderModules.find(id); it != mShaderModules.end()) {
-			it->second.~ShaderModule();
+			RetireShaderModule(it->second);
 			it->second.Create(file_path.c_str());
 			return { id, std::span<ShaderModule>(&it->second, 1) };
 		}
@@ -863,7 +874,7 @@ namespace HoshioEngine {
 	std::pair<int, std::span<ShaderModule>> PipelineManager::RecreateShaderModule(int id, size_t codeSize, const uint32_t* pCode)
 	{
 		if (auto it = mShaderModules.find(id); it != mShaderModules.end()) {
-			it->second.~ShaderModule();
+			RetireShaderModule(it->second);
 			it->second.Create(codeSize, pCode);
 			return { id, std::span<ShaderModule>(&it->second, 1) };
 		}
@@ -953,6 +964,27 @@ namespace HoshioEngine {
 		return { id, std::span<ShaderModule>(&vec, 1) };
 	}
 
+	std::pair<int, std::span<ShaderModule>> PipelineManager::CreateShaderModule(std::string name, const ShaderCompileInfo& compileInfo)
+	{
+		ShaderBinary binary = ShaderCompiler::Compiler().Compile(compileInfo);
+		return CreateShaderModule(std::move(name), binary.code.size() * sizeof(uint32_t), binary.code.data());
+	}
+
+	int PipelineManager::WatchShaderModule(std::string name, const ShaderCompileInfo& compileInfo, std::function<void()> onReloaded)
+	{
+		if (!HasShaderModule(name)) {
+			std::cerr << std::format("[ERROR] PipelineManager: ShaderModule with name '{}' do not exist!\n", name);
+			return M_INVALID_ID;
+		}
+		//Runs inside ShaderCompiler::ApplyPendingReloads(), i.e. at a frame boundary
+		return ShaderCompiler::Compiler().Watch(compileInfo, [this, name, onReloaded = std::move(onReloaded)](const ShaderBinary& binary) {
+			if (CreateShaderModule(name, binary.code.size() * sizeof(uint32_t), binary.code.data()).first == M_INVALID_ID)
+				return;
+			if (onReloaded)
+				onReloaded();
+			});
+	}
+
 	std::pair<int, std::span<ShaderModule>> PipelineManager::GetShaderModule(std::string name)
 	{
 		if (auto it = mShaderModuleIDs.find(name); it != mShaderModuleIDs.end())
@@ -991,7 +1023,7 @@ namespace HoshioEngine {
 		if (auto it = mPipelineLayoutIDs.find(name); it != mPipelineLayoutIDs.end())
 			return RecreatePipelineLayout(it->second, createInfo);
 
-		const int id = m_shader_module_id++;
+		const int id = m_pipeline_layout_id++;
 
 		auto [it1, ok1] = mPipelineLayouts.emplace(id, createInfo);
 		if (!ok1) {
@@ -1048,7 +1080,7 @@ namespace HoshioEngine {
 		if (auto it = mPipelineIDs.find(name); it != mPipelineIDs.end())
 			return RecreatePipeline(it->second, createInfo);
 
-		const int id = m_shader_module_id++;
+		const int id = m_pipeline_id++;
 
 		auto [it1, ok1] = mPipelines.emplace(id, createInfo);
 		if (!ok1) {
@@ -1072,7 +1104,7 @@ namespace HoshioEngine {
 		if (auto it = mPipelineIDs.find(name); it != mPipelineIDs.end())
 			return RecreatePipeline(it->second, createInfo);
 
-		const int id = m_shader_module_id++;
+		const int id = m_pipeline_id++;
 
 		auto [it1, ok1] = mPipelines.emplace(id, createInfo);
 		if (!ok1) {
@@ -1118,6 +1150,11 @@ namespace HoshioEngine {
 	int PipelineManager::DestroyPipeline(int id)
 	{
 		if (auto it = mPipelines.find(id); it != mPipelines.end()) {
+			if (auto async = mAsyncPipelines.find(id); async != mAsyncPipelines.end()) {
+				if (async->second.future.valid())
+					discardedPipelines.push_back(std::move(async->second));
+				mAsyncPipelines.erase(async);
+			}
 			it->second.~Pipeline();
 			return it->first;
 		}
@@ -1142,6 +1179,133 @@ namespace HoshioEngine {
 		return mPipelines.size();
 	}
 
+	int PipelineManager::RegisterAsyncPipeline(std::string& name, std::future<Pipeline> future, int fallback_id)
+	{
+		int id = M_INVALID_ID;
+		if (auto it = mPipelineIDs.find(name); it != mPipelineIDs.end())
+			id = it->second;
+		else {
+			id = m_pipeline_id++;
+			//Empty placeholder, ResolvePipeline() falls through to the fallback until the future is collected
+			auto [it1, ok1] = mPipelines.emplace(id, Pipeline());
+			if (!ok1) {
+				std::cerr << std::format("[ERROR] PipelineManager: Emplace pipeline for '{}' (id={}) failed\n", name, id);
+				discardedPipelines.push_back({ std::move(future), M_INVALID_ID, m_async_serial++ });
+				return M_INVALID_ID;
+			}
+			mPipelineIDs.emplace(name, id);
+		}
+
+		//A newer request for the same name supersedes the pending one
+		if (auto it = mAsyncPipelines.find(id); it != mAsyncPipelines.end() && it->second.future.valid())
+			discardedPipelines.push_back(std::move(it->second));
+		mAsyncPipelines.insert_or_assign(id, AsyncPipeline{ std::move(future), fallback_id, m_async_serial++ });
+		return id;
+	}
+
+	void PipelineManager::RetireShaderModule(ShaderModule& shaderModule)
+	{
+		bool pending = !discardedPipelines.empty() || std::any_of(mAsyncPipelines.begin(), mAsyncPipelines.end(),
+			[](const auto& async) { return async.second.future.valid(); });
+		//A worker may still be compiling a pipeline against the old module, it is kept instead of waiting for the worker
+		if (pending)
+			retiredShaderModules.push_back({ std::move(shaderModule), m_async_serial });
+		else
+			shaderModule.~ShaderModule();
+	}
+
+	void PipelineManager::ReleaseRetiredShaderModules()
+	{
+		if (retiredShaderModules.empty())
+			return;
+		uint64_t oldestPending = m_async_serial;
+		for (auto& discarded : discardedPipelines)
+			oldestPending = std::min(oldestPending, discarded.serial);
+		for (auto& [id, async] : mAsyncPipelines)
+			if (async.future.valid())
+				oldestPending = std::min(oldestPending, async.serial);
+		std::erase_if(retiredShaderModules, [oldestPending](const RetiredShaderModule& retired) {
+			return retired.serial <= oldestPending;
+			});
+	}
+
+	int PipelineManager::RequestPipeline(std::string name, const PipelineConfigurator& configurator, int fallback_id)
+	{
+		//The configurator is copied into the task, its copy constructor rebinds the inner pointers
+		std::future<Pipeline> future = pipelineWorkers.Submit([configurator]() mutable {
+			return Pipeline(static_cast<VkGraphicsPipelineCreateInfo&>(configurator));
+			});
+		return RegisterAsyncPipeline(name, std::move(future), fallback_id);
+	}
+
+	int PipelineManager::RequestPipeline(std::string name, const VkComputePipelineCreateInfo& createInfo, int fallback_id)
+	{
+		std::future<Pipeline> future = pipelineWorkers.Submit([createInfo]() mutable {
+			return Pipeline(createInfo);
+			});
+		return RegisterAsyncPipeline(name, std::move(future), fallback_id);
+	}
+
+	VkPipeline PipelineManager::ResolvePipeline(int id)
+	{
+		auto it = mPipelines.find(id);
+		if (it == mPipelines.end()) {
+			std::cerr << std::format("[ERROR] PipelineManager: Pipeline with id {} do not exist!\n", id);
+			return VK_NULL_HANDLE;
+		}
+		if (VkPipeline pipeline = it->second)
+			return pipeline;
+		if (auto async = mAsyncPipelines.find(id); async != mAsyncPipelines.end())
+			if (auto fallback = mPipelines.find(async->second.fallback_id); fallback != mPipelines.end())
+				return fallback->second;
+		return VK_NULL_HANDLE;
+	}
+
+	bool PipelineManager::IsPipelineReady(int id)
+	{
+		return !mAsyncPipelines.contains(id) && HasPipeline(id) && static_cast<VkPipeline>(mPipelines.at(id)) != VK_NULL_HANDLE;
+	}
+
+	uint32_t PipelineManager::CollectAsyncPipelines()
+	{
+		std::erase_if(discardedPipelines, [](const AsyncPipeline& discarded) {
+			return discarded.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+			});
+
+		uint32_t count = 0;
+		for (auto it = mAsyncPipelines.begin(); it != mAsyncPipelines.end();) {
+			std::future<Pipeline>& future = it->second.future;
+			if (!future.valid() || future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				++it;
+				continue;
+			}
+			try {
+				Pipeline pipeline = future.get();
+				if (auto target = mPipelines.find(it->first); target != mPipelines.end())
+					target->second = std::move(pipeline);
+				it = mAsyncPipelines.erase(it);
+				count++;
+			}
+			catch (const std::runtime_error& e) {
+				//The future is consumed, the entry stays so that the fallback keeps being resolved
+				std::cerr << std::format("[ERROR] PipelineManager: Async pipeline with id {} failed, keeping its fallback!\n{}\n", it->first, e.what());
+				++it;
+			}
+		}
+		ReleaseRetiredShaderModules();
+		return count;
+	}
+
+	void PipelineManager::WaitAsyncPipelines()
+	{
+		for (auto& discarded : discardedPipelines)
+			discarded.future.wait();
+		for (auto& [id, async] : mAsyncPipelines)
+			if (async.future.valid())
+				async.future.wait();
+		CollectAsyncPipelines();
+	}
+
 #pragma endregion
 
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ namespace HoshioEngine {
 	RenderPass::RenderPass(RenderPass&& other) noexcept
 	{
 		handle = other.handle;
+		compatibilityHash = other.compatibilityHash;
 		other.handle = VK_NULL_HANDLE;
 	}
 
@@ -50,6 +51,23 @@ namespace HoshioEngine {
 		Begin(commandBuffer, beginInfo, subpassContents);
 	}
 
+	void RenderPass::Begin(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer, ArrayRef<const VkImageView> attachments, VkRect2D renderArea, ArrayRef<const VkClearValue> clearValues, VkSubpassContents subpassContents) const
+	{
+		VkRenderPassAttachmentBeginInfo attachmentBeginInfo = {
+			.sType = VK_STRUCTURE_TYPE_RENDER_PASS_ATTACHMENT_BEGIN_INFO,
+			.attachmentCount = static_cast<uint32_t>(attachments.size()),
+			.pAttachments = attachments.data()
+		};
+		VkRenderPassBeginInfo beginInfo = {
+			.pNext = &attachmentBeginInfo,
+			.framebuffer = framebuffer,
+			.renderArea = renderArea,
+			.clearValueCount = static_cast<uint32_t>(clearValues.size()),
+			.pClearValues = clearValues.data()
+		};
+		Begin(commandBuffer, beginInfo, subpassContents);
+	}
+
 	void RenderPass::NextSubpass(VkCommandBuffer commandBuffer, VkSubpassContents subpassContents) const
 	{
 		vkCmdNextSubpass(commandBuffer, subpassContents);
@@ -60,11 +78,62 @@ namespace HoshioEngine {
 		vkCmdEndRenderPass(commandBuffer);
 	}
 
+	uint64_t RenderPass::CompatibilityHash() const
+	{
+		return compatibilityHash;
+	}
+
 	void RenderPass::Create(VkRenderPassCreateInfo& createInfo)
 	{
 		createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
 		if (vkCreateRenderPass(VulkanBase::Base().Device(), &createInfo, nullptr, &handle))
 			throw std::runtime_error("Failed to create a render pass");
+		compatibilityHash = HashCompatibility(createInfo);
+	}
+
+	uint64_t RenderPass::HashCompatibility(const VkRenderPassCreateInfo& createInfo)
+	{
+		//Load/store ops and image layouts do not affect compatibility, everything else does.
+		//Attachments are compared by index, which is stricter than the spec but never wrong.
+		//pNext chains (e.g. multiview) are not looked at.
+		std::vector<uint32_t> words = { createInfo.flags, createInfo.attachmentCount };
+		for (uint32_t i = 0; i < createInfo.attachmentCount; i++) {
+			const VkAttachmentDescription& attachment = createInfo.pAttachments[i];
+			words.insert(words.end(), { attachment.flags, uint32_t(attachment.format), uint32_t(attachment.samples) });
+		}
+
+		auto AppendReferences = [&words](uint32_t count, const VkAttachmentReference* pReferences) {
+			if (!pReferences)
+				count = 0;
+			words.push_back(count);
+			for (uint32_t i = 0; i < count; i++)
+				words.push_back(pReferences[i].attachment);
+		};
+
+		words.push_back(createInfo.subpassCount);
+		for (uint32_t i = 0; i < createInfo.subpassCount; i++) {
+			const VkSubpassDescription& subpass = createInfo.pSubpasses[i];
+			words.insert(words.end(), { subpass.flags, uint32_t(subpass.pipelineBindPoint) });
+			AppendReferences(subpass.inputAttachmentCount, subpass.pInputAttachments);
+			AppendReferences(subpass.colorAttachmentCount, subpass.pColorAttachments);
+			AppendReferences(subpass.colorAttachmentCount, subpass.pResolveAttachments);
+			AppendReferences(1, subpass.pDepthStencilAttachment);
+			words.push_back(subpass.preserveAttachmentCount);
+			for (uint32_t j = 0; j < subpass.preserveAttachmentCount; j++)
+				words.push_back(subpass.pPreserveAttachments[j]);
+		}
+
+		words.push_back(createInfo.dependencyCount);
+		for (uint32_t i = 0; i < createInfo.dependencyCount; i++) {
+			const VkSubpassDependency& dependency = createInfo.pDependencies[i];
+			words.insert(words.end(), {
+				dependency.srcSubpass, dependency.dstSubpass,
+				dependency.srcStageMask, dependency.dstStageMask,
+				dependency.srcAccessMask, dependency.dstAccessMask,
+				dependency.dependencyFlags });
+		}
+
+		return HashBytes(words.data(), words.size() * sizeof(uint32_t));
 	}
 
 #pragma endregion
@@ -126,7 +195,7 @@ namespace HoshioEngine {
 	{
 
 		if (count == 0) {
-			std::cerr << std::format("[ERROR] SyncManager: '{}' requested 0 Framebuffers\n", id);
+			std::cerr << std::format("[ERROR] RpwfManager: '{}' requested 0 Framebuffers\n", id);
 			return { M_INVALID_ID, {} };
 		}
 
@@ -137,7 +206,7 @@ namespace HoshioEngine {
 				it->second[i].Create(createInfos[i]);
 			return { id, std::span<Framebuffer>(it->second.data(), it->second.size()) };
 		}
-		std::cerr << std::format("[ERROR] SyncManager: Framebuffers with id {} do not exist!\n", id);
+		std::cerr << std::format("[ERROR] RpwfManager: Framebuffers with id {} do not exist!\n", id);
 		return { M_INVALID_ID, {} };
 	}
 
@@ -156,7 +225,7 @@ namespace HoshioEngine {
 
 		auto [it2, ok2] = mRenderPassIDs.emplace(name, id);
 		if (!ok2) {
-			std::cerr << std::format("[WARNING] RpwfPassManager: Renderpass '{}' has not been recorded!\n", name);
+			std::cerr << std::format("[WARNING] RpwfManager: Renderpass '{}' has not been recorded!\n", name);
 			mRenderPasses.erase(id);
 			return { M_INVALID_ID, {} };
 		}
@@ -205,7 +274,7 @@ namespace HoshioEngine {
 			return RecreateFramebuffers(it->second, count, createInfos);
 
 		if (count == 0) {
-			std::cerr << std::format("[ERROR] SyncManager: '{}' requested 0 Framebuffers\n", name);
+			std::cerr << std::format("[ERROR] RpwfManager: '{}' requested 0 Framebuffers\n", name);
 			return { M_INVALID_ID, {} };
 		}
 
@@ -217,13 +286,13 @@ namespace HoshioEngine {
 
 		auto [it1, ok1] = mFramebuffers.emplace(id, std::move(framebuffers));
 		if (!ok1) {
-			std::cerr << std::format("[ERROR] SyncManager: Emplace framebuffers for '{}' (id={}) failed\n", name, id);
+			std::cerr << std::format("[ERROR] RpwfManager: Emplace framebuffers for '{}' (id={}) failed\n", name, id);
 			return { M_INVALID_ID, {} };
 		}
 
 		auto [it2, ok2] = mFramebufferIDs.emplace(name, id);
 		if (!ok2) {
-			std::cerr << std::format("[WARNING] SyncManager: Framebuffer '{}' has not been recorded!\n", name);
+			std::cerr << std::format("[WARNING] RpwfManager: Framebuffer '{}' has not been recorded!\n", name);
 			mFramebuffers.erase(id);
 			return { M_INVALID_ID, {} };
 		}
@@ -236,7 +305,7 @@ namespace HoshioEngine {
 	{
 		if (auto it = mFramebufferIDs.find(name); it != mFramebufferIDs.end())
 			return GetFramebuffers(it->second);
-		std::cerr << std::format("[ERROR] SyncManager: Framebuffers with name '{}' do not exist!\n", name);
+		std::cerr << std::format("[ERROR] RpwfManager: Framebuffers with name '{}' do not exist!\n", name);
 		return { M_INVALID_ID, {} };
 	}
 
@@ -244,7 +313,7 @@ namespace HoshioEngine {
 	{
 		if (auto it = mFramebuffers.find(id); it != mFramebuffers.end())
 			return { id, std::span<Framebuffer>(it->second.data(), it->second.size()) };
-		std::cerr << std::format("[ERROR] SyncManager: Framebuffers with id {} do not exist!\n", id);
+		std::cerr << std::format("[ERROR] RpwfManager: Framebuffers with id {} do not exist!\n", id);
 		return { M_INVALID_ID, {} };
 	}
 
@@ -252,7 +321,7 @@ namespace HoshioEngine {
 	{
 		if (auto it = mFramebufferIDs.find(name); it != mFramebufferIDs.end())
 			return DestroyFramebuffers(it->second);
-		std::cerr << std::format("[WARNING] SyncManager: Framebuffers with name '{}' do not exist!\n", name);
+		std::cerr << std::format("[WARNING] RpwfManager: Framebuffers with name '{}' do not exist!\n", name);
 		return M_INVALID_ID;
 	}
 
@@ -262,7 +331,7 @@ namespace HoshioEngine {
 			it->second.clear();
 			return it->first;
 		}
-		std::cerr << std::format("[WARNING] SyncManager: Framebuffers with id {} do not exist!\n", id);
+		std::cerr << std::format("[WARNING] RpwfManager: Framebuffers with id {} do not exist!\n", id);
 		return M_INVALID_ID;
 	}
 
@@ -280,7 +349,121 @@ namespace HoshioEngine {
 
 	size_t RpwfManager::GetFramebuffersCount() const
 	{
-		return mFramebuffers.size();;
+		return mFramebuffers.size();
+	}
+
+	void RpwfManager::FramebufferKey::Push(uint64_t word)
+	{
+		if (attachmentCount == maxAttachmentWords) {
+			std::cerr << std::format("[ RpwfManager ] ERROR\nA framebuffer key holds at most {} words of attachments!\n", maxAttachmentWords);
+			throw std::runtime_error("[ RpwfManager ] ERROR::Too many framebuffer attachments!");
+		}
+		attachments[attachmentCount++] = word;
+	}
+
+	size_t RpwfManager::FramebufferKeyHash::operator()(const FramebufferKey& key) const
+	{
+		uint32_t header[4] = { key.width, key.height, key.layers, key.imageless };
+		uint64_t hash = HashBytes(&key.renderPassCompatibility, sizeof key.renderPassCompatibility);
+		hash = HashBytes(header, sizeof header, hash);
+		return static_cast<size_t>(HashBytes(key.attachments.data(), key.attachmentCount * sizeof(uint64_t), hash));
+	}
+
+	const Framebuffer& RpwfManager::AcquireFramebuffer(const RenderPass& renderPass, ArrayRef<const VkImageView> attachments, VkExtent2D extent, uint32_t layers)
+	{
+		FramebufferKey key = {
+			.renderPassCompatibility = renderPass.CompatibilityHash(),
+			.width = extent.width,
+			.height = extent.height,
+			.layers = layers
+		};
+		for (VkImageView attachment : attachments)
+			key.Push(reinterpret_cast<uint64_t>(attachment));
+
+		if (auto it = mFramebufferCache.find(key); it != mFramebufferCache.end())
+			return it->second;
+
+		VkFramebufferCreateInfo createInfo = {
+			.renderPass = renderPass,
+			.attachmentCount = static_cast<uint32_t>(attachments.size()),
+			.pAttachments = attachments.data(),
+			.width = extent.width,
+			.height = extent.height,
+			.layers = layers
+		};
+		return mFramebufferCache.emplace(std::move(key), createInfo).first->second;
+	}
+
+	const Framebuffer& RpwfManager::AcquireImagelessFramebuffer(const RenderPass& renderPass, ArrayRef<const VkFramebufferAttachmentImageInfo> attachmentImageInfos, VkExtent2D extent, uint32_t layers)
+	{
+		if (!VulkanBase::Base().ImagelessFramebufferSupported())
+			throw std::runtime_error("Imageless framebuffers are not supported by the device");
+
+		FramebufferKey key = {
+			.renderPassCompatibility = renderPass.CompatibilityHash(),
+			.width = extent.width,
+			.height = extent.height,
+			.layers = layers,
+			.imageless = true
+		};
+		for (const VkFramebufferAttachmentImageInfo& imageInfo : attachmentImageInfos) {
+			key.Push(uint64_t(imageInfo.flags) << 32 | imageInfo.usage);
+			key.Push(uint64_t(imageInfo.width) << 32 | imageInfo.height);
+			key.Push(uint64_t(imageInfo.layerCount) << 32 | imageInfo.viewFormatCount);
+			for (uint32_t i = 0; i < imageInfo.viewFormatCount; i++)
+				key.Push(uint64_t(imageInfo.pViewFormats[i]));
+		}
+
+		if (auto it = mFramebufferCache.find(key); it != mFramebufferCache.end())
+			return it->second;
+
+		std::vector<VkFramebufferAttachmentImageInfo> imageInfos(attachmentImageInfos.begin(), attachmentImageInfos.end());
+		for (auto& imageInfo : imageInfos)
+			imageInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENT_IMAGE_INFO;
+		VkFramebufferAttachmentsCreateInfo attachmentsCreateInfo = {
+			.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENTS_CREATE_INFO,
+			.attachmentImageInfoCount = static_cast<uint32_t>(imageInfos.size()),
+			.pAttachmentImageInfos = imageInfos.data()
+		};
+		VkFramebufferCreateInfo createInfo = {
+			.pNext = &attachmentsCreateInfo,
+			.flags = VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT,
+			.renderPass = renderPass,
+			.attachmentCount = static_cast<uint32_t>(imageInfos.size()),
+			.width = extent.width,
+			.height = extent.height,
+			.layers = layers
+		};
+		return mFramebufferCache.emplace(std::move(key), createInfo).first->second;
+	}
+
+	uint32_t RpwfManager::EvictFramebuffers(ArrayRef<const VkImageView> attachments)
+	{
+		return static_cast<uint32_t>(std::erase_if(mFramebufferCache, [&attachments](const auto& entry) {
+			if (entry.first.imageless)
+				return false;
+			for (VkImageView attachment : attachments)
+				if (std::ranges::find(entry.first.Attachments(), reinterpret_cast<uint64_t>(attachment)) != entry.first.Attachments().end())
+					return true;
+			return false;
+			}));
+	}
+
+	bool RpwfManager::EvictFramebuffer(VkFramebuffer framebuffer)
+	{
+		return std::erase_if(mFramebufferCache, [framebuffer](const auto& entry) {
+			return static_cast<VkFramebuffer>(entry.second) == framebuffer;
+			}) > 0;
+	}
+
+	void RpwfManager::ClearFramebufferCache()
+	{
+		mFramebufferCache.clear();
+	}
+
+	size_t RpwfManager::GetFramebufferCacheCount() const
+	{
+		return mFramebufferCache.size();
 	}
 
 #pragma endregion
@@ -32,13 +32,13 @@ namespace HoshioEngine {
 		if (vkCreateSampler(VulkanBase::Base().Device(), &createInfo, nullptr, &handle) != VK_SUCCESS)
 			throw std::runtime_error("Failed to create a sampler.");
 	}
-	VkSamplerCreateInfo& Sampler::SamplerCreateInfo(VkFilter magFilter, VkFilter minFilter, VkSamplerMipmapMode mipmapMode)
+	VkSamplerCreateInfo Sampler::SamplerCreateInfo(VkFilter magFilter, VkFilter minFilter, VkSamplerMipmapMode mipmapMode)
 	{
-		static VkSamplerCreateInfo createInfo = {
+		VkSamplerCreateInfo createInfo = {
 			.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-			.magFilter = VK_FILTER_LINEAR,
-			.minFilter = VK_FILTER_LINEAR,
-			.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+			.magFilter = magFilter,
+			.minFilter = minFilter,
+			.mipmapMode = mipmapMode,
 			.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
 			.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
 			.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
@@ -52,11 +52,6 @@ namespace HoshioEngine {
 			.borderColor = {},
 			.unnormalizedCoordinates = VK_FALSE
 		};
-
-		createInfo.magFilter = magFilter;
-		createInfo.minFilter = minFilter;
-		createInfo.mipmapMode = mipmapMode;
-
 		return createInfo;
 	}
 
@@ -64,40 +59,93 @@ namespace HoshioEngine {
 
 #pragma region SamplerManager
 
-	std::pair<int, std::span<Sampler>> SamplerManager::RecreateSampler(int id, VkSamplerCreateInfo& createInfo)
+	VkSamplerCreateInfo SamplerManager::NormalizeCreateInfo(const VkSamplerCreateInfo& createInfo)
 	{
-		if (auto it = mSamplers.find(id); it != mSamplers.end()) {
-			it->second.~Sampler();
-			it->second.Create(createInfo);
-			return { id, std::span<Sampler>(&it->second, 1) };
-		}
-		std::cerr << std::format("[ERROR] SamplerManager: Sampler with id {} do not exist!\n", id);
-		return { M_INVALID_ID, {} };
+		//Fields ignored by the driver must not split the cache
+		VkSamplerCreateInfo normalized = createInfo;
+		normalized.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		normalized.pNext = nullptr;
+		if (!normalized.anisotropyEnable)
+			normalized.maxAnisotropy = 1.f;
+		if (!normalized.compareEnable)
+			normalized.compareOp = VK_COMPARE_OP_NEVER;
+		bool usesBorder =
+			normalized.addressModeU == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+			normalized.addressModeV == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+			normalized.addressModeW == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+		if (!usesBorder)
+			normalized.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+		return normalized;
 	}
-	std::pair<int, std::span<Sampler>> SamplerManager::CreateSampler(std::string name, VkSamplerCreateInfo& createInfo)
+
+	uint64_t SamplerManager::HashCreateInfo(const VkSamplerCreateInfo& createInfo)
 	{
-		if (auto it = mSamplerIDs.find(name); it != mSamplerIDs.end())
-			return RecreateSampler(it->second, createInfo);
+		//Every member from flags on is 4 bytes wide, so the range has no padding
+		constexpr size_t offset = offsetof(VkSamplerCreateInfo, flags);
+		return HashBytes(reinterpret_cast<const uint8_t*>(&createInfo) + offset, sizeof(VkSamplerCreateInfo) - offset);
+	}
 
-		const int id = m_sampler_id++;
+	bool SamplerManager::EqualCreateInfo(const VkSamplerCreateInfo& a, const VkSamplerCreateInfo& b)
+	{
+		constexpr size_t offset = offsetof(VkSamplerCreateInfo, flags);
+		return !memcmp(reinterpret_cast<const uint8_t*>(&a) + offset, reinterpret_cast<const uint8_t*>(&b) + offset, sizeof(VkSamplerCreateInfo) - offset);
+	}
 
-		auto [it1, ok1] = mSamplers.emplace(id, createInfo);
-		if (!ok1) {
-			std::cerr << std::format("[ERROR] SamplerManager: Emplace sampler for '{}' (id={}) failed\n", name, id);
+	int SamplerManager::FindCachedSampler(const VkSamplerCreateInfo& normalized, uint64_t hash) const
+	{
+		if (auto it = mSamplerCache.find(hash); it != mSamplerCache.end())
+			for (int id : it->second)
+				if (EqualCreateInfo(mSamplerCreateInfos.at(id), normalized))
+					return id;
+		return M_INVALID_ID;
+	}
+
+	std::pair<int, std::span<Sampler>> SamplerManager::AcquireSampler(const VkSamplerCreateInfo& createInfo)
+	{
+		//Extension structs (reduction mode, ycbcr conversion...) are not part of the key, such samplers are not shared
+		bool cacheable = createInfo.pNext == nullptr;
+		VkSamplerCreateInfo normalized = NormalizeCreateInfo(createInfo);
+		uint64_t hash = HashCreateInfo(normalized);
+
+		if (cacheable)
+			if (int id = FindCachedSampler(normalized, hash); id != M_INVALID_ID)
+				return GetSampler(id);
+
+		if (mSamplers.size() >= VulkanBase::Base().PhysicalDeviceProperties().limits.maxSamplerAllocationCount) {
+			std::cerr << std::format("[ERROR] SamplerManager: Sampler count reached the device limit ({})!\n", mSamplers.size());
 			return { M_INVALID_ID, {} };
 		}
 
-		auto [it2, ok2] = mSamplerIDs.emplace(name, id);
-		if (!ok2) {
-			std::cerr << std::format("[WARNING] SamplerManager: Sampler '{}' has not been recorded!\n", name);
-			mSamplers.erase(id);
+		const int id = m_sampler_id++;
+
+		VkSamplerCreateInfo ci = createInfo;
+		ci.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		auto [it1, ok1] = mSamplers.emplace(id, ci);
+		if (!ok1) {
+			std::cerr << std::format("[ERROR] SamplerManager: Emplace sampler (id={}) failed\n", id);
 			return { M_INVALID_ID, {} };
 		}
+		if (cacheable) {
+			mSamplerCreateInfos.emplace(id, normalized);
+			mSamplerCache[hash].push_back(id);
+		}
 
 		auto& vec = it1->second;
 		return { id, std::span<Sampler>(&vec, 1) };
 	}
 
+	std::pair<int, std::span<Sampler>> SamplerManager::CreateSampler(std::string name, const VkSamplerCreateInfo& createInfo)
+	{
+		auto result = AcquireSampler(createInfo);
+		if (result.first == M_INVALID_ID) {
+			std::cerr << std::format("[WARNING] SamplerManager: Sampler '{}' has not been recorded!\n", name);
+			return result;
+		}
+		//Rebinding a name leaves the previous sampler alive for whoever else shares it
+		mSamplerIDs.insert_or_assign(std::move(name), result.first);
+		return result;
+	}
+
 	std::pair<int, std::span<Sampler>> SamplerManager::GetSampler(std::string name)
 	{
 		if (auto it = mSamplerIDs.find(name); it != mSamplerIDs.end())
@@ -128,6 +176,21 @@ namespace HoshioEngine {
 		return mSamplers.size();
 	}
 
+	const VkSampler* SamplerManager::ImmutableSamplers(int id, uint32_t descriptorCount)
+	{
+		auto it = mSamplers.find(id);
+		if (it == mSamplers.end()) {
+			std::cerr << std::format("[ERROR] SamplerManager: Sampler with id {} do not exist!\n", id);
+			return nullptr;
+		}
+		if (descriptorCount <= 1)
+			return it->second.Address();
+		std::vector<VkSampler>& samplers = mImmutableSamplers[id];
+		if (samplers.size() < descriptorCount)
+			samplers.resize(descriptorCount, it->second);
+		return samplers.data();
+	}
+
 #pragma endregion
 
 }
\ No newline at end of file
@@ -0,0 +1,380 @@
+#include "Base/ShaderCompiler.h"
+
+#include <shaderc/shaderc.hpp>
+#include <spirv-tools/optimizer.hpp>
+
+namespace HoshioEngine {
+
+	namespace {
+		constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+
+		std::string ReadTextFile(const std::filesystem::path& path, bool& ok)
+		{
+			std::ifstream file(path, std::ios::binary);
+			ok = static_cast<bool>(file);
+			if (!ok)
+				return {};
+			std::stringstream ss;
+			ss << file.rdbuf();
+			return ss.str();
+		}
+
+		shaderc_shader_kind ShaderKind(VkShaderStageFlagBits stage)
+		{
+			switch (stage)
+			{
+			case VK_SHADER_STAGE_VERTEX_BIT:
+				return shaderc_glsl_vertex_shader;
+			case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
+				return shaderc_glsl_tess_control_shader;
+			case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
+				return shaderc_glsl_tess_evaluation_shader;
+			case VK_SHADER_STAGE_GEOMETRY_BIT:
+				return shaderc_glsl_geometry_shader;
+			case VK_SHADER_STAGE_FRAGMENT_BIT:
+				return shaderc_glsl_fragment_shader;
+			case VK_SHADER_STAGE_COMPUTE_BIT:
+				return shaderc_glsl_compute_shader;
+			case VK_SHADER_STAGE_TASK_BIT_EXT:
+				return shaderc_glsl_task_shader;
+			case VK_SHADER_STAGE_MESH_BIT_EXT:
+				return shaderc_glsl_mesh_shader;
+			default:
+				throw std::runtime_error(std::format("[ ShaderCompiler ] ERROR\nUnsupported shader stage: {}\n", static_cast<uint32_t>(stage)));
+			}
+		}
+
+		//Clamp the target environment to what both shaderc and the created instance support
+		std::pair<shaderc_env_version, spv_target_env> TargetEnvironment()
+		{
+			uint32_t apiVersion = VulkanBase::Base().ApiVersion();
+			if (apiVersion >= VK_API_VERSION_1_3)
+				return { shaderc_env_version_vulkan_1_3, SPV_ENV_VULKAN_1_3 };
+			if (apiVersion >= VK_API_VERSION_1_2)
+				return { shaderc_env_version_vulkan_1_2, SPV_ENV_VULKAN_1_2 };
+			if (apiVersion >= VK_API_VERSION_1_1)
+				return { shaderc_env_version_vulkan_1_1, SPV_ENV_VULKAN_1_1 };
+			return { shaderc_env_version_vulkan_1_0, SPV_ENV_VULKAN_1_0 };
+		}
+
+		class FileIncluder : public shaderc::CompileOptions::IncluderInterface {
+		private:
+			struct IncludeData {
+				shaderc_include_result result = {};
+				std::string sourceName;
+				std::string content;
+			};
+
+			std::vector<std::string>& dependencies;
+
+		public:
+			FileIncluder(std::vector<std::string>& dependencies) :dependencies(dependencies) {}
+
+			shaderc_include_result* GetInclude(const char* requested_source, shaderc_include_type type, const char* requesting_source, size_t include_depth) override
+			{
+				std::filesystem::path path = requested_source;
+				if (type == shaderc_include_type_relative)
+					path = std::filesystem::path(requesting_source).parent_path() / requested_source;
+
+				IncludeData* pData = new IncludeData;
+				bool ok = false;
+				pData->content = ReadTextFile(path, ok);
+				if (ok) {
+					pData->sourceName = path.lexically_normal().generic_string();
+					if (std::find(dependencies.begin(), dependencies.end(), pData->sourceName) == dependencies.end())
+						dependencies.push_back(pData->sourceName);
+				}
+				else
+					//An empty source name tells shaderc the include failed, content holds the message
+					pData->content = std::format("Failed to open the include file: {}", path.generic_string());
+
+				pData->result = {
+					.source_name = pData->sourceName.c_str(),
+					.source_name_length = pData->sourceName.size(),
+					.content = pData->content.c_str(),
+					.content_length = pData->content.size(),
+					.user_data = pData
+				};
+				return &pData->result;
+			}
+
+			void ReleaseInclude(shaderc_include_result* data) override
+			{
+				delete static_cast<IncludeData*>(data->user_data);
+			}
+		};
+	}
+
+	ShaderCompiler::~ShaderCompiler()
+	{
+		StopHotReload();
+	}
+
+	ShaderCompiler& ShaderCompiler::Compiler()
+	{
+		static ShaderCompiler compiler;
+		return compiler;
+	}
+
+	const std::filesystem::path& ShaderCompiler::CacheDirectory() const
+	{
+		return cacheDirectory;
+	}
+
+	void ShaderCompiler::SetCacheDirectory(std::filesystem::path directory)
+	{
+		cacheDirectory = std::move(directory);
+	}
+
+	void ShaderCompiler::SetPollInterval(std::chrono::milliseconds interval)
+	{
+		pollInterval = interval;
+	}
+
+	std::string ShaderCompiler::Preprocess(const ShaderCompileInfo& compileInfo, std::vector<std::string>& dependencies) const
+	{
+		bool ok = false;
+		std::string source = ReadTextFile(compileInfo.filePath, ok);
+		if (!ok) {
+			std::cout << std::format("[ ShaderCompiler ] ERROR \nFailed to open the file : {}\n", compileInfo.filePath);
+			throw std::runtime_error(std::format("Failed to open the file : {}", compileInfo.filePath));
+		}
+		dependencies.push_back(std::filesystem::path(compileInfo.filePath).lexically_normal().generic_string());
+
+		shaderc::CompileOptions options;
+		for (auto& define : compileInfo.defines)
+			options.AddMacroDefinition(define.name, define.value);
+		options.SetIncluder(std::make_unique<FileIncluder>(dependencies));
+
+		shaderc::Compiler compiler;
+		shaderc::PreprocessedSourceCompilationResult result =
+			compiler.PreprocessGlsl(source, ShaderKind(compileInfo.stage), compileInfo.filePath.c_str(), options);
+		if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+			throw std::runtime_error(std::format("[ ShaderCompiler ] ERROR\nFailed to preprocess {}\n{}", compileInfo.filePath, result.GetErrorMessage()));
+
+		return std::string(result.cbegin(), result.cend());
+	}
+
+	std::vector<uint32_t> ShaderCompiler::CompileToSpirv(const ShaderCompileInfo& compileInfo, const std::string& preprocessed) const
+	{
+		auto [shadercEnv, spirvEnv] = TargetEnvironment();
+
+		//spirv-opt is run explicitly below so that the pass list is the same as the offline tools
+		shaderc::CompileOptions options;
+		options.SetTargetEnvironment(shaderc_target_env_vulkan, shadercEnv);
+		options.SetOptimizationLevel(shaderc_optimization_level_zero);
+
+		shaderc::Compiler compiler;
+		shaderc::SpvCompilationResult result =
+			compiler.CompileGlslToSpv(preprocessed, ShaderKind(compileInfo.stage), compileInfo.filePath.c_str(), compileInfo.entry, options);
+		if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+			throw std::runtime_error(std::format("[ ShaderCompiler ] ERROR\nFailed to compile {}\n{}", compileInfo.filePath, result.GetErrorMessage()));
+		if (result.GetNumWarnings())
+			std::cout << std::format("[ ShaderCompiler ] WARNING\n{}", result.GetErrorMessage());
+
+		std::vector<uint32_t> code(result.cbegin(), result.cend());
+		if (!compileInfo.optimize)
+			return code;
+
+		spvtools::Optimizer optimizer(spirvEnv);
+		optimizer.SetMessageConsumer([&compileInfo](spv_message_level_t level, const char*, const spv_position_t&, const char* message) {
+			if (level <= SPV_MSG_ERROR)
+				std::cerr << std::format("[ ShaderCompiler ] spirv-opt: {}: {}\n", compileInfo.filePath, message);
+			});
+		optimizer.RegisterPerformancePasses();
+
+		std::vector<uint32_t> optimized;
+		if (!optimizer.Run(code.data(), code.size(), &optimized)) {
+			std::cout << std::format("[ ShaderCompiler ] WARNING\nspirv-opt failed on {}, the unoptimized module is used\n", compileInfo.filePath);
+			return code;
+		}
+		return optimized;
+	}
+
+	bool ShaderCompiler::LoadCache(uint64_t hash, std::vector<uint32_t>& code) const
+	{
+		std::ifstream file(cacheDirectory / std::format("{:016x}.spv", hash), std::ios::ate | std::ios::binary);
+		if (!file)
+			return false;
+		size_t fileSize = static_cast<size_t>(file.tellg());
+		if (fileSize < 4 || fileSize % 4)
+			return false;
+		code.resize(fileSize / 4);
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(code.data()), fileSize);
+		return file && code[0] == SPIRV_MAGIC;
+	}
+
+	void ShaderCompiler::StoreCache(uint64_t hash, const std::vector<uint32_t>& code) const
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(cacheDirectory, ec);
+		std::filesystem::path path = cacheDirectory / std::format("{:016x}.spv", hash);
+		//Write then rename, a concurrent LoadCache() never sees a partially written file
+		std::filesystem::path tempPath = path;
+		tempPath += std::format(".{}.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file) {
+				std::cout << std::format("[ ShaderCompiler ] WARNING\nFailed to write the shader cache: {}\n", path.generic_string());
+				return;
+			}
+			file.write(reinterpret_cast<const char*>(code.data()), code.size() * sizeof(uint32_t));
+		}
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+			std::filesystem::remove(tempPath, ec);
+	}
+
+	ShaderBinary ShaderCompiler::Compile(const ShaderCompileInfo& compileInfo)
+	{
+		ShaderBinary binary;
+		std::string preprocessed = Preprocess(compileInfo, binary.dependencies);
+
+		//Includes and defines are already expanded in the preprocessed text
+		const uint32_t key[] = {
+			static_cast<uint32_t>(compileInfo.stage),
+			static_cast<uint32_t>(compileInfo.optimize),
+			static_cast<uint32_t>(TargetEnvironment().first)
+		};
+		binary.hash = HashBytes(preprocessed.data(), preprocessed.size());
+		binary.hash = HashBytes(key, sizeof key, binary.hash);
+		binary.hash = HashBytes(compileInfo.entry, strlen(compileInfo.entry), binary.hash);
+
+		if (LoadCache(binary.hash, binary.code))
+			return binary;
+
+		binary.code = CompileToSpirv(compileInfo, preprocessed);
+		StoreCache(binary.hash, binary.code);
+		std::cout << std::format("[ ShaderCompiler ] Compiled {} ({:016x})\n", compileInfo.filePath, binary.hash);
+		return binary;
+	}
+
+	std::vector<std::pair<std::filesystem::path, std::filesystem::file_time_type>> ShaderCompiler::DependencyTimes(const std::vector<std::string>& dependencies)
+	{
+		std::vector<std::pair<std::filesystem::path, std::filesystem::file_time_type>> times;
+		times.reserve(dependencies.size());
+		for (auto& dependency : dependencies) {
+			std::error_code ec;
+			times.emplace_back(dependency, std::filesystem::last_write_time(dependency, ec));
+		}
+		return times;
+	}
+
+	int ShaderCompiler::Watch(const ShaderCompileInfo& compileInfo, ReloadCallback callback)
+	{
+		//Usually a cache hit, only needed to know the include files
+		ShaderBinary binary = Compile(compileInfo);
+
+		std::lock_guard<std::mutex> lock(watchMutex);
+		const int id = m_watch_id++;
+		mWatchEntries.emplace(id, WatchEntry{ compileInfo, DependencyTimes(binary.dependencies), std::move(callback) });
+		return id;
+	}
+
+	void ShaderCompiler::Unwatch(int id)
+	{
+		std::lock_guard<std::mutex> lock(watchMutex);
+		if (!mWatchEntries.erase(id))
+			std::cerr << std::format("[WARNING] ShaderCompiler: Watch with id {} do not exist!\n", id);
+	}
+
+	void ShaderCompiler::StartHotReload()
+	{
+		if (watcher.joinable())
+			return;
+		watcher = std::jthread([this](std::stop_token stopToken) { WatchLoop(stopToken); });
+	}
+
+	void ShaderCompiler::StopHotReload()
+	{
+		if (!watcher.joinable())
+			return;
+		watcher.request_stop();
+		watcher.join();
+	}
+
+	bool ShaderCompiler::IsHotReloading() const
+	{
+		return watcher.joinable();
+	}
+
+	void ShaderCompiler::WatchLoop(std::stop_token stopToken)
+	{
+		std::mutex sleepMutex;
+		std::condition_variable_any sleepCv;
+		while (!stopToken.stop_requested()) {
+			std::vector<std::pair<int, ShaderCompileInfo>> dirtyEntries;
+			{
+				std::lock_guard<std::mutex> lock(watchMutex);
+				for (auto& [id, entry] : mWatchEntries)
+					for (auto& [path, time] : entry.dependencies) {
+						std::error_code ec;
+						if (auto current = std::filesystem::last_write_time(path, ec); !ec && current != time) {
+							dirtyEntries.emplace_back(id, entry.compileInfo);
+							break;
+						}
+					}
+			}
+
+			for (auto& [id, compileInfo] : dirtyEntries) {
+				std::vector<std::string> dependencies;
+				try {
+					ShaderBinary binary = Compile(compileInfo);
+					dependencies = binary.dependencies;
+					std::lock_guard<std::mutex> lock(pendingMutex);
+					pendingReloads.emplace_back(id, std::move(binary));
+				}
+				catch (const std::runtime_error& e) {
+					//Keep the old pipeline, try again on the next save
+					std::cerr << e.what() << '\n';
+				}
+
+				std::lock_guard<std::mutex> lock(watchMutex);
+				if (auto it = mWatchEntries.find(id); it != mWatchEntries.end()) {
+					if (dependencies.empty())
+						for (auto& [path, time] : it->second.dependencies) {
+							std::error_code ec;
+							time = std::filesystem::last_write_time(path, ec);
+						}
+					else
+						it->second.dependencies = DependencyTimes(dependencies);
+				}
+			}
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			sleepCv.wait_for(lock, stopToken, pollInterval, [] { return false; });
+		}
+	}
+
+	uint32_t ShaderCompiler::ApplyPendingReloads()
+	{
+		std::vector<PendingReload> reloads;
+		{
+			std::lock_guard<std::mutex> lock(pendingMutex);
+			if (pendingReloads.empty())
+				return 0;
+			reloads.swap(pendingReloads);
+		}
+
+		uint32_t count = 0;
+		for (auto& reload : reloads) {
+			ReloadCallback callback;
+			{
+				std::lock_guard<std::mutex> lock(watchMutex);
+				if (auto it = mWatchEntries.find(reload.watch_id); it != mWatchEntries.end())
+					callback = it->second.callback;
+			}
+			if (!callback)
+				continue;
+			try {
+				callback(reload.binary);
+				count++;
+			}
+			catch (const std::runtime_error& e) {
+				std::cerr << std::format("[ ShaderCompiler ] ERROR\nHot reload of {} failed\n{}\n", reload.binary.dependencies.front(), e.what());
+			}
+		}
+		return count;
+	}
+}
@@ -315,6 +315,30 @@ namespace HoshioEngine {
 		VkPhysicalDeviceDescriptorIndexingFeatures indexing{};
 		indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
 		indexing.descriptorBindingPartiallyBound = VK_TRUE;
+		//Imageless framebuffers are core since 1.2, enable them when the device reports the feature
+		vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+		VkPhysicalDeviceImagelessFramebufferFeatures imagelessFramebuffer = {
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGELESS_FRAMEBUFFER_FEATURES
+		};
+		if (apiVersion >= VK_API_VERSION_1_2 && physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_2) {
+			VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+				.pNext = &imagelessFramebuffer
+			};
+			vkGetPhysicalDeviceFeatures2(physicalDevice, &physicalDeviceFeatures2);
+		}
+		imagelessFramebufferSupported = imagelessFramebuffer.imagelessFramebuffer;
+		if (imagelessFramebufferSupported)
+			indexing.pNext = &imagelessFramebuffer;
+		//Draw counts written by the GPU, enabled whenever the device has the extension
+		uint32_t extensionCount = 0;
+		vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+		std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+		vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+		drawIndirectCountSupported = std::ranges::any_of(availableExtensions,
+			[](const VkExtensionProperties& extension) { return !strcmp(extension.extensionName, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME); });
+		if (drawIndirectCountSupported && std::ranges::none_of(deviceExtensions, [](const char* name) { return !strcmp(name, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME); }))
+			AddDeviceExtension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
 		VkDeviceCreateInfo deviceCreateInfo = {
 			.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
 			.pNext = &indexing,
@@ -333,8 +357,10 @@ namespace HoshioEngine {
 			vkGetDeviceQueue(device, queueFamilyIndex_present, 0, &queue_present);
 		if (queueFamilyIndex_compute != VK_QUEUE_FAMILY_IGNORED)
 			vkGetDeviceQueue(device, queueFamilyIndex_compute, 0, &queue_compute);
-		vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
 		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &physicalDeviceMemoryProperties);
+		pfnCmdDrawIndexedIndirectCount = drawIndirectCountSupported ?
+			reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(vkGetDeviceProcAddr(device, "vkCmdDrawIndexedIndirectCountKHR")) : nullptr;
+		drawIndirectCountSupported = pfnCmdDrawIndexedIndirectCount;
 		out << std::format("Renderer: {}\n", physicalDeviceProperties.deviceName);
 		for (auto& func : callbacks_createDevice)
 			func();
@@ -515,6 +541,12 @@ namespace HoshioEngine {
 			throw std::runtime_error("Failed to wait for device into idle!");
 	}
 
+	void VulkanBase::CmdDrawIndexedIndirectCount(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset,
+		VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride) const
+	{
+		pfnCmdDrawIndexedIndirectCount(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
+	}
+
 	void VulkanBase::SubmitCommandBuffer_Graphics(VkSubmitInfo& submitInfo, VkFence fence)
 	{
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -635,6 +667,16 @@ namespace HoshioEngine {
 		return this->physicalDeviceMemoryProperties;
 	}
 
+	bool VulkanBase::ImagelessFramebufferSupported() const
+	{
+		return this->imagelessFramebufferSupported;
+	}
+
+	bool VulkanBase::DrawIndirectCountSupported() const
+	{
+		return this->drawIndirectCountSupported;
+	}
+
 	VkPhysicalDevice VulkanBase::AvailablePhysicalDevices(uint32_t index) const
 	{
 		return this->availablePhysicalDevices[index];
@@ -0,0 +1,224 @@
+#include "Engine/Actor/ClusterCuller.h"
+#include "Plus/VulkanPlus.h"
+#include "Base/ShaderCompiler.h"
+
+namespace HoshioEngine {
+
+	namespace {
+		constexpr const char* shaderPath = "res/shaders/GLSL/ClusterCull.comp";
+		constexpr uint32_t workGroupSize = 64;
+
+		//128 bytes, the most every device guarantees
+		struct PushConstants {
+			glm::vec4 planes[6];
+			glm::vec3 cameraPosition;
+			uint32_t coneCulling;
+			uint32_t firstMeshlet;
+			uint32_t meshletCount;
+			uint32_t indexOffset;
+			int32_t vertexOffset;
+		};
+
+		glm::vec4 NormalizePlane(const glm::vec4& plane) {
+			float length = glm::length(glm::vec3(plane));
+			//No direction left, as for the far plane of an infinite projection
+			return length > 1e-12f ? plane / length : glm::vec4(0.f, 0.f, 0.f, 1.f);
+		}
+	}
+
+#pragma region CullView
+
+	CullView CullView::FromViewProjection(const glm::mat4& viewProjection, const glm::vec3& position)
+	{
+		//Rows of the matrix combined as in Gribb and Hartmann, with the near plane at clip z = 0
+		glm::mat4 rows = glm::transpose(viewProjection);
+		CullView view;
+		view.planes[0] = NormalizePlane(rows[3] + rows[0]);
+		view.planes[1] = NormalizePlane(rows[3] - rows[0]);
+		view.planes[2] = NormalizePlane(rows[3] + rows[1]);
+		view.planes[3] = NormalizePlane(rows[3] - rows[1]);
+		view.planes[4] = NormalizePlane(rows[2]);
+		view.planes[5] = NormalizePlane(rows[3] - rows[2]);
+		view.position = position;
+		return view;
+	}
+
+	CullView CullView::FromCamera(const Camera& camera)
+	{
+		return FromViewProjection(camera.PerspectiveTransform() * camera.ViewTransform(), camera.Position());
+	}
+
+#pragma endregion
+
+#pragma region Resources
+
+	ClusterCuller::Resources::~Resources()
+	{
+		if (descriptorSet != VK_NULL_HANDLE)
+			VulkanPlus::Plus().DescriptorPool().FreeDescriptorSets(descriptorSet);
+	}
+
+#pragma endregion
+
+#pragma region ClusterCuller
+
+	ClusterCuller& ClusterCuller::Culler()
+	{
+		static ClusterCuller culler;
+		return culler;
+	}
+
+	void ClusterCuller::CreatePipeline()
+	{
+		VkDescriptorSetLayoutBinding bindings[] = {
+			{ 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT }
+		};
+		VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
+			.bindingCount = uint32_t(std::size(bindings)),
+			.pBindings = bindings
+		};
+		descriptorSetLayout.Create(descriptorSetLayoutCreateInfo);
+
+		VkPushConstantRange pushConstantRange = { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants) };
+		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
+			.setLayoutCount = 1,
+			.pSetLayouts = descriptorSetLayout.Address(),
+			.pushConstantRangeCount = 1,
+			.pPushConstantRanges = &pushConstantRange
+		};
+		pipelineLayout.Create(pipelineLayoutCreateInfo);
+
+		//Without a GPU side count every meshlet keeps its slot, drawn in one call only with multiDrawIndirect
+		compacts = VulkanBase::Base().DrawIndirectCountSupported();
+		VkPhysicalDeviceFeatures features;
+		vkGetPhysicalDeviceFeatures(VulkanBase::Base().PhysicalDevice(), &features);
+		multiDrawIndirect = features.multiDrawIndirect;
+
+		ShaderCompileInfo compileInfo = {
+			.filePath = shaderPath,
+			.stage = VK_SHADER_STAGE_COMPUTE_BIT
+		};
+		if (compacts)
+			compileInfo.defines.push_back({ "COMPACT" });
+		ShaderBinary binary = ShaderCompiler::Compiler().Compile(compileInfo);
+		ShaderModule shaderModule(binary.code.size() * sizeof(uint32_t), binary.code.data());
+		VkComputePipelineCreateInfo createInfo = {
+			.stage = shaderModule.ShaderStageCi(VK_SHADER_STAGE_COMPUTE_BIT),
+			.layout = pipelineLayout
+		};
+		pipeline.Create(createInfo);
+	}
+
+	void ClusterCuller::Upload(Resources& resources, ArrayRef<const Meshlet> meshlets)
+	{
+		if (descriptorSetLayout == VK_NULL_HANDLE)
+			CreatePipeline();
+		resources.meshletCount = uint32_t(meshlets.size());
+		resources.culledMeshletCount = 0;
+		if (meshlets.size() == 0)
+			return;
+
+		VkDeviceSize meshletSize = meshlets.size() * sizeof(Meshlet);
+		VkDeviceSize drawSize = meshlets.size() * sizeof(VkDrawIndexedIndirectCommand);
+		resources.meshletBuffer.Create(meshletSize).TransferData(meshlets.data(), meshletSize);
+		resources.drawBuffer.Create(drawSize, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+		resources.countBuffer.Create(sizeof(uint32_t), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+
+		if (resources.descriptorSet == VK_NULL_HANDLE)
+			VulkanPlus::Plus().DescriptorPool().AllocateDescriptorSets(resources.descriptorSet, descriptorSetLayout);
+		VkDescriptorBufferInfo meshletInfo = { resources.meshletBuffer, 0, meshletSize };
+		VkDescriptorBufferInfo drawInfo = { resources.drawBuffer, 0, drawSize };
+		VkDescriptorBufferInfo countInfo = { resources.countBuffer, 0, sizeof(uint32_t) };
+		resources.descriptorSet.Write(meshletInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 0);
+		resources.descriptorSet.Write(drawInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1);
+		resources.descriptorSet.Write(countInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2);
+	}
+
+	void ClusterCuller::CmdCull(VkCommandBuffer commandBuffer, Resources& resources, const CullView& view, const glm::mat4& transform,
+		uint32_t firstMeshlet, uint32_t meshletCount, uint32_t indexOffset, int32_t vertexOffset)
+	{
+		if (uint64_t(firstMeshlet) + meshletCount > resources.meshletCount) {
+			std::cerr << std::format("[ ClusterCuller ] ERROR\nMeshlets {} to {} are out of the {} uploaded!\n",
+				firstMeshlet, uint64_t(firstMeshlet) + meshletCount, resources.meshletCount);
+			throw std::runtime_error("[ ClusterCuller ] ERROR::Meshlet range out of bounds!");
+		}
+		resources.culledMeshletCount = meshletCount;
+		if (!meshletCount)
+			return;
+
+		//Planes and camera go to mesh space instead of every meshlet to world space, which keeps the tests exact under any scale
+		PushConstants pushConstants;
+		glm::mat4 transposed = glm::transpose(transform);
+		for (uint32_t i = 0; i < 6; i++)
+			pushConstants.planes[i] = NormalizePlane(transposed * view.planes[i]);
+		pushConstants.cameraPosition = glm::vec3(glm::inverse(transform) * glm::vec4(view.position, 1.f));
+		//A mirroring transform turns the winding and with it which side of a triangle is culled
+		pushConstants.coneCulling = glm::determinant(glm::mat3(transform)) > 0.f;
+		pushConstants.firstMeshlet = firstMeshlet;
+		pushConstants.meshletCount = meshletCount;
+		pushConstants.indexOffset = indexOffset;
+		pushConstants.vertexOffset = vertexOffset;
+
+		//Last frame's draws may still be reading the buffers this dispatch writes
+		VkBufferMemoryBarrier barriers[2] = {
+			{
+				.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+				.srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+				.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.buffer = resources.drawBuffer,
+				.size = VK_WHOLE_SIZE
+			},
+			{
+				.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+				.srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+				.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.buffer = resources.countBuffer,
+				.size = VK_WHOLE_SIZE
+			}
+		};
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+			0, nullptr, 2, barriers, 0, nullptr);
+		if (compacts) {
+			vkCmdFillBuffer(commandBuffer, resources.countBuffer, 0, sizeof(uint32_t), 0);
+			barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+				0, nullptr, 1, &barriers[1], 0, nullptr);
+		}
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, resources.descriptorSet.Address(), 0, nullptr);
+		vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof pushConstants, &pushConstants);
+		vkCmdDispatch(commandBuffer, (meshletCount + workGroupSize - 1) / workGroupSize, 1, 1);
+
+		for (auto& barrier : barriers)
+			barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+			barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+			0, nullptr, 2, barriers, 0, nullptr);
+	}
+
+	void ClusterCuller::CmdDraw(VkCommandBuffer commandBuffer, const Resources& resources) const
+	{
+		uint32_t drawCount = resources.culledMeshletCount;
+		if (!drawCount)
+			return;
+		constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+		if (compacts)
+			VulkanBase::Base().CmdDrawIndexedIndirectCount(commandBuffer, resources.drawBuffer, 0, resources.countBuffer, 0, drawCount, stride);
+		else if (multiDrawIndirect)
+			vkCmdDrawIndexedIndirect(commandBuffer, resources.drawBuffer, 0, drawCount, stride);
+		else
+			for (uint32_t i = 0; i < drawCount; i++)
+				vkCmdDrawIndexedIndirect(commandBuffer, resources.drawBuffer, VkDeviceSize(i) * stride, 1, stride);
+	}
+
+#pragma endregion
+
+}
@@ -0,0 +1,362 @@
+#include "Engine/Actor/GpuScene.h"
+#include "Base/ShaderCompiler.h"
+
+namespace HoshioEngine {
+
+	namespace {
+		constexpr const char* shaderPath = "res/shaders/GLSL/SceneCull.comp";
+		constexpr uint32_t workGroupSize = 64;
+
+		//100 bytes, world space planes as CullView has them
+		struct PushConstants {
+			glm::vec4 planes[6];
+			uint32_t drawCount;
+		};
+
+		float MaxScale(const glm::mat4& transform) {
+			return std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+		}
+
+		//Creates the buffer the first time, afterwards waits for the device and replaces it
+		void Reserve(StorageBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags otherUsages = 0) {
+			if (VkBuffer(buffer) == VK_NULL_HANDLE)
+				buffer.Create(size, otherUsages);
+			else
+				buffer.Recreate(size, otherUsages);
+		}
+	}
+
+#pragma region SceneCuller
+
+	SceneCuller& SceneCuller::Culler()
+	{
+		static SceneCuller culler;
+		return culler;
+	}
+
+	const DescriptorSetLayout& SceneCuller::InstanceSetLayout()
+	{
+		if (cullSetLayout == VK_NULL_HANDLE)
+			CreatePipeline();
+		return instanceSetLayout;
+	}
+
+	void SceneCuller::CreatePipeline()
+	{
+		VkDescriptorSetLayoutBinding cullBindings[] = {
+			{ 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT }
+		};
+		VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
+			.bindingCount = uint32_t(std::size(cullBindings)),
+			.pBindings = cullBindings
+		};
+		cullSetLayout.Create(descriptorSetLayoutCreateInfo);
+
+		VkDescriptorSetLayoutBinding instanceBinding = { 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT };
+		descriptorSetLayoutCreateInfo.bindingCount = 1;
+		descriptorSetLayoutCreateInfo.pBindings = &instanceBinding;
+		instanceSetLayout.Create(descriptorSetLayoutCreateInfo);
+
+		VkPushConstantRange pushConstantRange = { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants) };
+		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
+			.setLayoutCount = 1,
+			.pSetLayouts = cullSetLayout.Address(),
+			.pushConstantRangeCount = 1,
+			.pPushConstantRanges = &pushConstantRange
+		};
+		pipelineLayout.Create(pipelineLayoutCreateInfo);
+
+		compacts = VulkanBase::Base().DrawIndirectCountSupported();
+		VkPhysicalDeviceFeatures features;
+		vkGetPhysicalDeviceFeatures(VulkanBase::Base().PhysicalDevice(), &features);
+		multiDrawIndirect = features.multiDrawIndirect;
+		drawIndirectFirstInstance = features.drawIndirectFirstInstance;
+		if (!drawIndirectFirstInstance)
+			std::cout << std::format("[ SceneCuller ] WARNING\nNo drawIndirectFirstInstance, scenes are drawn one direct draw per mesh instance and not culled!\n");
+
+		ShaderCompileInfo compileInfo = {
+			.filePath = shaderPath,
+			.stage = VK_SHADER_STAGE_COMPUTE_BIT
+		};
+		if (compacts)
+			compileInfo.defines.push_back({ "COMPACT" });
+		ShaderBinary binary = ShaderCompiler::Compiler().Compile(compileInfo);
+		ShaderModule shaderModule(binary.code.size() * sizeof(uint32_t), binary.code.data());
+		VkComputePipelineCreateInfo createInfo = {
+			.stage = shaderModule.ShaderStageCi(VK_SHADER_STAGE_COMPUTE_BIT),
+			.layout = pipelineLayout
+		};
+		pipeline.Create(createInfo);
+	}
+
+#pragma endregion
+
+#pragma region GpuScene
+
+	GpuScene::~GpuScene()
+	{
+		if (cullSet != VK_NULL_HANDLE)
+			VulkanPlus::Plus().DescriptorPool().FreeDescriptorSets(cullSet);
+		if (instanceSet != VK_NULL_HANDLE)
+			VulkanPlus::Plus().DescriptorPool().FreeDescriptorSets(instanceSet);
+	}
+
+	uint32_t GpuScene::AddInstance(const Model& model, const glm::mat4& transform)
+	{
+		uint32_t instance = uint32_t(transforms.size());
+		glm::mat4 dequantization = model.PositionDequantization();
+		//Bounds are kept in the space of the vertices, the one the instance transform maps from
+		glm::mat4 quantization = glm::inverse(dequantization);
+		float scale = MaxScale(quantization);
+		transforms.push_back(transform * dequantization);
+		dequantizations.push_back(dequantization);
+
+		for (auto& mesh : model.Meshes()) {
+			if (mesh.indices.empty() || mesh.lods.empty())
+				continue;
+			const MeshLod& level = mesh.lods[0];
+			DrawRecord record = {
+				.indexCount = level.indexCount,
+				.firstIndex = mesh.geometry.FirstIndex() + level.firstIndex,
+				.vertexOffset = mesh.geometry.VertexOffset(),
+				.instance = instance
+			};
+			//Nothing to cull by without bounds, such a mesh is always drawn
+			if (mesh.bounds.Empty())
+				record.center = glm::vec3(0.f), record.radius = std::numeric_limits<float>::max();
+			else
+				record.center = glm::vec3(quantization * glm::vec4(mesh.bounds.Center(), 1.f)),
+				record.radius = glm::length(mesh.bounds.Extent()) * 0.5f * scale;
+			placed.emplace_back(&mesh, record);
+		}
+		recordsChanged = true;
+		return instance;
+	}
+
+	void GpuScene::SetTransform(uint32_t instance, const glm::mat4& transform)
+	{
+		if (instance >= transforms.size()) {
+			std::cerr << std::format("[ GpuScene ] ERROR\nInstance {} is out of the {} placed!\n", instance, transforms.size());
+			throw std::runtime_error("[ GpuScene ] ERROR::Instance out of bounds!");
+		}
+		transforms[instance] = transform * dequantizations[instance];
+		if (changedBegin == changedEnd)
+			changedBegin = instance, changedEnd = instance + 1;
+		else
+			changedBegin = std::min(changedBegin, instance), changedEnd = std::max(changedEnd, instance + 1);
+	}
+
+	void GpuScene::Clear()
+	{
+		transforms.clear();
+		dequantizations.clear();
+		placed.clear();
+		records.clear();
+		batches.clear();
+		recordsChanged = false;
+		changedBegin = changedEnd = 0;
+	}
+
+	uint32_t GpuScene::InstanceCount() const
+	{
+		return uint32_t(transforms.size());
+	}
+
+	uint32_t GpuScene::DrawCount() const
+	{
+		return uint32_t(placed.size());
+	}
+
+	uint32_t GpuScene::BatchCount() const
+	{
+		return uint32_t(batches.size());
+	}
+
+	void GpuScene::Upload(VkCommandBuffer commandBuffer)
+	{
+		bool buffersChanged = false;
+		if (transforms.size() > transformCapacity) {
+			transformCapacity = std::max<VkDeviceSize>(transforms.size(), transformCapacity * 2);
+			Reserve(transformBuffer, transformCapacity * sizeof(glm::mat4));
+			buffersChanged = true;
+		}
+		if (recordsChanged) {
+			//Batches in the order their meshes were first placed, which keeps the meshes of a model, and so its geometry, together
+			batches.clear();
+			std::unordered_map<const Mesh*, uint32_t> batchOf;
+			for (auto& [mesh, record] : placed) {
+				auto [iter, inserted] = batchOf.try_emplace(mesh, uint32_t(batches.size()));
+				if (inserted)
+					batches.push_back({ mesh, 0, 0 });
+				batches[iter->second].drawCount++;
+			}
+			uint32_t firstDraw = 0;
+			for (auto& batch : batches)
+				batch.firstDraw = firstDraw, firstDraw += batch.drawCount;
+
+			records.resize(placed.size());
+			std::vector<uint32_t> filled(batches.size());
+			for (auto& [mesh, record] : placed) {
+				uint32_t batch = batchOf[mesh];
+				record.batch = batch;
+				record.firstDraw = batches[batch].firstDraw;
+				records[record.firstDraw + filled[batch]++] = record;
+			}
+
+			if (records.size() > recordCapacity) {
+				recordCapacity = std::max<VkDeviceSize>(records.size(), recordCapacity * 2);
+				Reserve(recordBuffer, recordCapacity * sizeof(DrawRecord));
+				Reserve(drawBuffer, recordCapacity * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+				//A batch has at least one draw, so there are never more counts than records
+				Reserve(countBuffer, recordCapacity * sizeof(uint32_t), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+				buffersChanged = true;
+			}
+			if (records.size())
+				recordBuffer.TransferData(records.data(), records.size() * sizeof(DrawRecord));
+		}
+		if (buffersChanged)
+			WriteDescriptorSets();
+
+		//Transforms change every frame, so unlike records they never wait on a submit of their own.
+		//The previous frame's fence has been waited on, nothing can still be reading the old ones
+		bool copied = false;
+		if ((recordsChanged || buffersChanged) && transforms.size())
+			copied = transformBuffer.CmdTransferData(commandBuffer, transformStaging, transforms.data(), transforms.size() * sizeof(glm::mat4));
+		else if (changedBegin < changedEnd)
+			copied = transformBuffer.CmdTransferData(commandBuffer, transformStaging, transforms.data() + changedBegin,
+				(changedEnd - changedBegin) * sizeof(glm::mat4), changedBegin * sizeof(glm::mat4));
+		if (copied) {
+			VkBufferMemoryBarrier barrier = {
+				.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+				.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+				.dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.buffer = transformBuffer,
+				.size = VK_WHOLE_SIZE
+			};
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0,
+				0, nullptr, 1, &barrier, 0, nullptr);
+		}
+		recordsChanged = false;
+		changedBegin = changedEnd = 0;
+	}
+
+	void GpuScene::WriteDescriptorSets()
+	{
+		//Both sets are written at once, so neither exists before both buffers do
+		if (!transformCapacity || !recordCapacity)
+			return;
+		SceneCuller& culler = SceneCuller::Culler();
+		if (cullSet == VK_NULL_HANDLE) {
+			VulkanPlus::Plus().DescriptorPool().AllocateDescriptorSets(cullSet, culler.cullSetLayout);
+			VulkanPlus::Plus().DescriptorPool().AllocateDescriptorSets(instanceSet, culler.instanceSetLayout);
+		}
+		VkDescriptorBufferInfo transformInfo = { transformBuffer, 0, VK_WHOLE_SIZE };
+		VkDescriptorBufferInfo recordInfo = { recordBuffer, 0, VK_WHOLE_SIZE };
+		VkDescriptorBufferInfo drawInfo = { drawBuffer, 0, VK_WHOLE_SIZE };
+		VkDescriptorBufferInfo countInfo = { countBuffer, 0, VK_WHOLE_SIZE };
+		cullSet.Write(transformInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 0);
+		cullSet.Write(recordInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1);
+		cullSet.Write(drawInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2);
+		cullSet.Write(countInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3);
+		instanceSet.Write(transformInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 0);
+	}
+
+	void GpuScene::CmdCull(VkCommandBuffer commandBuffer, const CullView& view)
+	{
+		SceneCuller& culler = SceneCuller::Culler();
+		if (culler.cullSetLayout == VK_NULL_HANDLE)
+			culler.CreatePipeline();
+		Upload(commandBuffer);
+		//Direct draws ignore what the dispatch would write
+		if (records.empty() || !culler.drawIndirectFirstInstance)
+			return;
+
+		PushConstants pushConstants;
+		std::copy(std::begin(view.planes), std::end(view.planes), pushConstants.planes);
+		pushConstants.drawCount = uint32_t(records.size());
+
+		//Last frame's draws may still be reading the buffers this dispatch writes
+		VkBufferMemoryBarrier barriers[2] = {
+			{
+				.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+				.srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+				.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.buffer = drawBuffer,
+				.size = VK_WHOLE_SIZE
+			},
+			{
+				.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+				.srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+				.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.buffer = countBuffer,
+				.size = VK_WHOLE_SIZE
+			}
+		};
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+			0, nullptr, 2, barriers, 0, nullptr);
+		if (culler.compacts) {
+			vkCmdFillBuffer(commandBuffer, countBuffer, 0, batches.size() * sizeof(uint32_t), 0);
+			barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+				0, nullptr, 1, &barriers[1], 0, nullptr);
+		}
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler.pipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler.pipelineLayout, 0, 1, cullSet.Address(), 0, nullptr);
+		vkCmdPushConstants(commandBuffer, culler.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof pushConstants, &pushConstants);
+		vkCmdDispatch(commandBuffer, (pushConstants.drawCount + workGroupSize - 1) / workGroupSize, 1, 1);
+
+		for (auto& barrier : barriers)
+			barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+			barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+			0, nullptr, 2, barriers, 0, nullptr);
+	}
+
+	void GpuScene::CmdDraw(VkCommandBuffer commandBuffer, ShaderInfo& shader_info, uint32_t instance_set) const
+	{
+		if (records.empty())
+			return;
+		const SceneCuller& culler = SceneCuller::Culler();
+		PipelineLayout& pipeline_layout = VulkanPlus::Plus().GetPipelineLayout(shader_info.pipeline_layout_id).second[0];
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout,
+			instance_set, 1, instanceSet.Address(), 0, nullptr);
+
+		constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+		const Mesh* bound = nullptr;
+		for (uint32_t i = 0; i < batches.size(); i++) {
+			const Batch& batch = batches[i];
+			if (!bound || !batch.mesh->SharesGeometryWith(*bound)) {
+				batch.mesh->BindGeometry(commandBuffer);
+				bound = batch.mesh;
+			}
+			batch.mesh->BindMaterial(commandBuffer, shader_info);
+
+			VkDeviceSize offset = VkDeviceSize(batch.firstDraw) * stride;
+			if (!culler.drawIndirectFirstInstance)
+				for (uint32_t j = batch.firstDraw; j < batch.firstDraw + batch.drawCount; j++)
+					vkCmdDrawIndexed(commandBuffer, records[j].indexCount, 1, records[j].firstIndex, records[j].vertexOffset, records[j].instance);
+			else if (culler.compacts)
+				VulkanBase::Base().CmdDrawIndexedIndirectCount(commandBuffer, drawBuffer, offset, countBuffer, VkDeviceSize(i) * sizeof(uint32_t),
+					batch.drawCount, stride);
+			else if (culler.multiDrawIndirect)
+				vkCmdDrawIndexedIndirect(commandBuffer, drawBuffer, offset, batch.drawCount, stride);
+			else
+				for (uint32_t j = 0; j < batch.drawCount; j++)
+					vkCmdDrawIndexedIndirect(commandBuffer, drawBuffer, offset + VkDeviceSize(j) * stride, 1, stride);
+		}
+	}
+
+#pragma endregion
+
+}
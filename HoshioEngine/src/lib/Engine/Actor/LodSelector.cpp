@@ -0,0 +1,93 @@
+#include "Engine/Actor/LodSelector.h"
+
+namespace HoshioEngine {
+
+	LodView LodView::FromCamera(const Camera& camera)
+	{
+		return FromCamera(camera, VulkanBase::Base().SwapchainExtent());
+	}
+
+	LodView LodView::FromCamera(const Camera& camera, VkExtent2D viewport)
+	{
+		//The projection maps tan(fovy / 2) to half the height and aspect * tan(fovy / 2) to half the width,
+		//unless the aspect ratio differs from the viewport's the two agree and either is exact
+		float tangent = std::tan(glm::radians(camera.fovy) * 0.5f);
+		float aspect = VulkanBase::Base().AspectRatio();
+		float pixelsPerUnit = std::max(viewport.height / (2.f * tangent), viewport.width / (2.f * aspect * tangent));
+		return { camera.Position(), pixelsPerUnit, camera.zNear };
+	}
+
+	float LodSelector::pixelThreshold = 1.f;
+	float LodSelector::qualityBias = 1.f;
+	float LodSelector::hysteresis = 0.25f;
+
+	float LodSelector::PixelThreshold()
+	{
+		return pixelThreshold;
+	}
+
+	void LodSelector::SetPixelThreshold(float pixels)
+	{
+		pixelThreshold = std::max(pixels, 0.f);
+	}
+
+	float LodSelector::QualityBias()
+	{
+		return qualityBias;
+	}
+
+	void LodSelector::SetQualityBias(float bias)
+	{
+		qualityBias = std::max(bias, 1e-3f);
+	}
+
+	float LodSelector::Hysteresis()
+	{
+		return hysteresis;
+	}
+
+	void LodSelector::SetHysteresis(float fraction)
+	{
+		hysteresis = glm::clamp(fraction, 0.f, 0.9f);
+	}
+
+	float LodSelector::PixelsPerMeshUnit(const LodView& view, const MeshBounds& bounds, const glm::mat4& transform)
+	{
+		if (bounds.Empty())
+			return std::numeric_limits<float>::max();
+		//Errors and the radius grow with the largest axis scale of the transform
+		float scale = std::max(glm::length(glm::vec3(transform[0])), std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+		glm::vec3 center = glm::vec3(transform * glm::vec4(bounds.Center(), 1.f));
+		float radius = glm::length(bounds.Extent()) * 0.5f * scale;
+		float distance = std::max(glm::length(center - view.position) - radius, view.zNear);
+		return view.pixelsPerUnit * scale / distance;
+	}
+
+	float LodSelector::ScreenSpaceError(const LodView& view, const MeshBounds& bounds, const glm::mat4& transform, float error)
+	{
+		return error * PixelsPerMeshUnit(view, bounds, transform);
+	}
+
+	uint32_t LodSelector::SelectLod(const LodView& view, ArrayRef<const MeshLod> lods, const MeshBounds& bounds, const glm::mat4& transform, uint32_t currentLod)
+	{
+		if (lods.size() < 2)
+			return 0;
+		float pixels = PixelsPerMeshUnit(view, bounds, transform);
+		float threshold = pixelThreshold / qualityBias;
+		currentLod = std::min(currentLod, uint32_t(lods.size() - 1));
+
+		uint32_t lod = 0;
+		for (uint32_t level = uint32_t(lods.size() - 1); level > 0; level--)
+			if (lods[level].error * pixels <= threshold) {
+				lod = level;
+				break;
+			}
+		if (lod <= currentLod)
+			return lod;
+		//Coarser than last frame only once the error is clearly below the threshold
+		for (uint32_t level = lod; level > currentLod; level--)
+			if (lods[level].error * pixels <= threshold * (1.f - hysteresis))
+				return level;
+		return currentLod;
+	}
+}
@@ -2,26 +2,83 @@
 #include "Wins/GlfwManager.h"
 
 namespace HoshioEngine {
-	Mesh::Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices, std::vector<TextureInfo> textures)
+	Mesh::Mesh(VertexStream vertices, std::vector<uint32_t> indices, std::vector<TextureInfo> textures, std::vector<MeshLod> lods, std::vector<Meshlet> meshlets)
+		:vertices(std::move(vertices)), indices(std::move(indices)), textures(std::move(textures)), lods(std::move(lods)), meshlets(std::move(meshlets))
 	{
-		this->vertices = vertices;
-		this->indices = indices;
-		this->textures = textures;
+		ComputeBounds();
+		if (this->lods.empty() && !this->indices.empty())
+			this->lods.push_back({ 0, uint32_t(this->indices.size()), 0.f });
 	}
 
-	void Mesh::Render(ShaderInfo& shader_info)
+	Mesh::Mesh(VertexStream vertices, std::vector<uint32_t> indices, std::vector<TextureInfo> textures, const MeshBounds& bounds, std::vector<MeshLod> lods, std::vector<Meshlet> meshlets)
+		:vertices(std::move(vertices)), indices(std::move(indices)), textures(std::move(textures)), bounds(bounds), lods(std::move(lods)), meshlets(std::move(meshlets))
 	{
-		//get the resources for rendering
-		PipelineLayout& pipeline_layout = VulkanPlus::Plus().GetPipelineLayout(shader_info.pipeline_layout_id).second[0];
+		if (this->lods.empty() && !this->indices.empty())
+			this->lods.push_back({ 0, uint32_t(this->indices.size()), 0.f });
+	}
 
-		//get the commandBuffer
-		const CommandBuffer& commandBuffer = VulkanPlus::Plus().CommandBuffer_Graphics();
+	void Mesh::ComputeBounds()
+	{
+		bounds = {};
+		int32_t index = vertices.Layout().Find(VETEX_ATTRIBUTE_TYPE::POSITION);
+		if (index < 0 || vertices.Layout().Attribute(index).format != VK_FORMAT_R32G32B32_SFLOAT)
+			return;
+		StridedSpan<const glm::vec3> positions = std::as_const(vertices).Attribute<glm::vec3>(uint32_t(index));
+		for (size_t i = 0; i < positions.size(); i++)
+			bounds.Extend(positions[i]);
+	}
+
+	void Mesh::CullClusters(VkCommandBuffer commandBuffer, const CullView& view, const glm::mat4& transform)
+	{
+		if (clusters.Empty() || lods.empty())
+			return;
+		const MeshLod& level = lods[std::min<size_t>(lod, lods.size() - 1)];
+		ClusterCuller::Culler().CmdCull(commandBuffer, clusters, view, transform, level.firstMeshlet, level.meshletCount,
+			geometry.FirstIndex(), geometry.VertexOffset());
+		clustersCulled = true;
+	}
 
-		VkDeviceSize offset = 0;
-		if(!vertices.empty())
-			vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffer.Address(), &offset);
+	void Mesh::BindGeometry(VkCommandBuffer commandBuffer) const
+	{
+		if (!geometry.Empty()) {
+			VkBuffer buffer = geometry.VertexBuffer();
+			VkDeviceSize offset = 0;
+			if (buffer != VK_NULL_HANDLE)
+				vkCmdBindVertexBuffers(commandBuffer, 0, 1, &buffer, &offset);
+			if (geometry.IndexBuffer() != VK_NULL_HANDLE)
+				vkCmdBindIndexBuffer(commandBuffer, geometry.IndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+			return;
+		}
+		//Every binding reads the same buffer, separate attribute arrays start at their own offset
+		if (!vertices.Empty()) {
+			uint32_t bindingCount = vertices.Layout().BindingCount();
+			VkBuffer buffers[VertexLayout::maxAttributeCount];
+			VkDeviceSize offsets[VertexLayout::maxAttributeCount];
+			for (uint32_t i = 0; i < bindingCount; i++)
+				buffers[i] = vertexBuffer, offsets[i] = vertices.BindingOffset(i);
+			vkCmdBindVertexBuffers(commandBuffer, 0, bindingCount, buffers, offsets);
+		}
 		if (!indices.empty())
 			vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+	}
+
+	bool Mesh::SharesGeometryWith(const Mesh& other) const
+	{
+		return !geometry.Empty() && !other.geometry.Empty() &&
+			geometry.VertexBuffer() == other.geometry.VertexBuffer() && geometry.IndexBuffer() == other.geometry.IndexBuffer();
+	}
+
+	void Mesh::Render(ShaderInfo& shader_info)
+	{
+		BindGeometry(VulkanPlus::Plus().CommandBuffer_Graphics());
+		Draw(shader_info);
+	}
+
+	void Mesh::BindMaterial(VkCommandBuffer commandBuffer, ShaderInfo& shader_info) const
+	{
+		//get the resources for rendering
+		PipelineLayout& pipeline_layout = VulkanPlus::Plus().GetPipelineLayout(shader_info.pipeline_layout_id).second[0];
+
 		//bind sampler descriptor set
 		if (shader_info.sampler_set_layout_id != M_INVALID_ID)
 			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 
@@ -29,102 +86,54 @@ namespace HoshioEngine {
 		if (shader_info.uniform_set_layout_id != M_INVALID_ID)
 			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout,
 				2, 1, uniform_set.Address(), 0, nullptr);
-		if(!indices.empty())
-			vkCmdDrawIndexed(commandBuffer, indices.size(), 1, 0, 0, 0);
-		else
-			vkCmdDraw(commandBuffer, vertices.size(), 1, 0, 0);
 	}
 
-	std::vector<float> Mesh::ReorganizeVertexData()
+	void Mesh::Draw(ShaderInfo& shader_info)
 	{
-		if (vertices.empty()) {
-			return std::vector<float>();
-		}
-
-		size_t floats_per_vertex = vertices[0].GetVertexInputAttributeFloatCount();
-		size_t total_float_count = floats_per_vertex * vertices.size();
-
-		std::vector<float> vertex_data(total_float_count);
-
-		for (size_t i = 0; i < vertices.size(); i++) {
-			size_t vertex_start = i * floats_per_vertex;
-			size_t float_offset = 0;
-
-			memcpy(
-				vertex_data.data() + vertex_start + float_offset,
-				&vertices[i].position,
-				3 * sizeof(float)
-			);
-			float_offset += 3;  
-
-			memcpy(
-				vertex_data.data() + vertex_start + float_offset,
-				&vertices[i].normal,
-				3 * sizeof(float)
-			);
-			float_offset += 3;  
-
-			size_t color_count = vertices[i].GetColorCount();
-			if (color_count != 0) {
-				memcpy(
-					vertex_data.data() + vertex_start + float_offset,
-					vertices[i].colors.data(),
-					color_count * 4 * sizeof(float)
-				);
-				float_offset += color_count * 4;
-			}
-
-			size_t uv_count = vertices[i].GetUVCount();
-			if (uv_count != 0) {
-				memcpy(
-					vertex_data.data() + vertex_start + float_offset,
-					vertices[i].uvs.data(),
-					uv_count * 2 * sizeof(float)
-				);
-				float_offset += uv_count * 2;
-			}
+		//get the commandBuffer
+		const CommandBuffer& commandBuffer = VulkanPlus::Plus().CommandBuffer_Graphics();
 
-			size_t value_count = vertices[i].GetValueCount();
-			if (value_count != 0) {
-				memcpy(
-					&vertex_data[vertex_start + float_offset],
-					vertices[i].values.data(),
-					value_count * sizeof(float)
-				);
-				float_offset += value_count;
-			}
+		BindMaterial(commandBuffer, shader_info);
+		if (clustersCulled) {
+			ClusterCuller::Culler().CmdDraw(commandBuffer, clusters);
+			clustersCulled = false;
 		}
-
-		return vertex_data;
+		else if (!indices.empty()) {
+			const MeshLod& level = lods[std::min<size_t>(lod, lods.size() - 1)];
+			vkCmdDrawIndexed(commandBuffer, level.indexCount, 1, geometry.FirstIndex() + level.firstIndex, geometry.VertexOffset(), 0);
+		}
+		else
+			vkCmdDraw(commandBuffer, vertices.VertexCount(), 1, geometry.FirstVertex(), 0);
 	}
 
-	std::vector<VertexInputAttribute> Mesh::GetVertexInputAttributes()
+	std::pmr::vector<VertexInputAttribute> Mesh::GetVertexInputAttributes(std::pmr::memory_resource* resource)
 	{
-		if (vertices.empty()) {
-			return std::vector<VertexInputAttribute>();
-		}
-		return vertices[0].GetVertexInputAttributes();
+		return vertices.Layout().GetVertexInputAttributes(resource);
 	}
 
 	uint32_t Mesh::GetVertexInputAttributeStride()
 	{
-		if (vertices.empty()) {
-			return 0;
-		}
-		return vertices[0].GetVertexInputAttributeStride();
+		return vertices.Layout().Stride();
 	}
 
 	void Mesh::SetupMesh(ShaderInfo& shader_info)
 	{
-		//create buffer for the mesh
-		std::vector<float> reorganize_vertices = ReorganizeVertexData();
-		if(!vertices.empty())
-			vertexBuffer.Create(sizeof(float) * reorganize_vertices.size())
-				.TransferData(reorganize_vertices.data(), sizeof(float) * reorganize_vertices.size());
-
-		if(!indices.empty())
-			indexBuffer.Create(sizeof(uint32_t) * indices.size())
-				.TransferData(indices.data(), sizeof(uint32_t) * indices.size());
+		//Interleaved vertices and the indices go to the shared pool, the stream is already laid out the way the pipeline reads it
+		if (vertices.Layout().BindingCount() <= 1)
+			geometry = GeometryPool::Pool().Allocate(vertices.Data(), uint32_t(vertices.VertexCount()), uint32_t(vertices.Layout().Stride()),
+				{ indices.data(), indices.size() });
+		else {
+			if (!vertices.Empty())
+				vertexBuffer.Create(vertices.DataSize())
+					.TransferData(vertices.Data(), vertices.DataSize());
+
+			if (!indices.empty())
+				indexBuffer.Create(sizeof(uint32_t) * indices.size())
+					.TransferData(indices.data(), sizeof(uint32_t) * indices.size());
+		}
+
+		if (!meshlets.empty())
+			ClusterCuller::Culler().Upload(clusters, { meshlets.data(), meshlets.size() });
 
 		//allocate descriptor set for the mesh
 
@@ -0,0 +1,287 @@
+#include "Engine/Actor/MeshCache.h"
+#include "Utils/MappedFile.h"
+
+namespace HoshioEngine {
+
+	namespace {
+		constexpr uint32_t cacheMagic = 0x48534D48;	//"HMSH"
+		//Bump whenever the import or the blob layout changes, old cache files are then ignored
+		constexpr uint32_t cacheVersion = 4;
+		//Blobs start at multiples of this, so indices and vertices can be read in place
+		constexpr uint64_t blobAlignment = 16;
+
+		struct CacheHeader {
+			uint32_t magic;
+			uint32_t version;
+			uint64_t hash;
+			uint32_t meshCount;
+			uint32_t textureCount;
+			uint32_t stringsSize;
+			uint32_t lodCount;
+		};
+
+		struct MeshRecord {
+			uint64_t vertexCount;
+			uint64_t vertexOffset;
+			uint64_t indexCount;
+			uint64_t indexOffset;
+			uint64_t meshletCount;
+			uint64_t meshletOffset;
+			uint32_t storage;
+			uint32_t attributeCount;
+			uint32_t formats[VertexLayout::maxAttributeCount];
+			uint32_t types[VertexLayout::maxAttributeCount];
+			float boundsMin[3];
+			float boundsMax[3];
+			uint32_t firstTexture;
+			uint32_t textureCount;
+			uint32_t firstLod;
+			uint32_t lodCount;
+		};
+
+		struct TextureRecord {
+			uint32_t type;
+			uint32_t nameOffset;
+			uint32_t nameLength;
+		};
+
+		struct LodRecord {
+			uint32_t firstIndex;
+			uint32_t indexCount;
+			float error;
+			uint32_t firstMeshlet;
+			uint32_t meshletCount;
+		};
+
+		uint64_t AlignBlob(uint64_t offset) {
+			return (offset + blobAlignment - 1) & ~(blobAlignment - 1);
+		}
+
+		//offset + count * elementSize <= fileSize, without the sum or the product wrapping around
+		bool FitsInFile(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize) {
+			return offset <= fileSize && (!elementSize || count <= (fileSize - offset) / elementSize);
+		}
+	}
+
+	std::filesystem::path MeshCache::cacheDirectory = "cache/meshes";
+
+	const std::filesystem::path& MeshCache::CacheDirectory()
+	{
+		return cacheDirectory;
+	}
+
+	void MeshCache::SetCacheDirectory(std::filesystem::path directory)
+	{
+		cacheDirectory = std::move(directory);
+	}
+
+	uint64_t MeshCache::SourceHash(const char* filePath)
+	{
+		MappedFile file(filePath);
+		uint64_t hash = HashBytes(file.Data(), file.Size(), HashBytes(&cacheVersion, sizeof cacheVersion));
+
+		//Materials live in their own files, an edited .mtl has to invalidate the cache as well
+		std::string_view text(reinterpret_cast<const char*>(file.Data()), file.Size());
+		std::filesystem::path directory = std::filesystem::path(filePath).parent_path();
+		for (size_t position = text.find("mtllib"); position != std::string_view::npos; position = text.find("mtllib", position + 6)) {
+			if (position && text[position - 1] != '\n')
+				continue;
+			size_t begin = text.find_first_not_of(" \t", position + 6);
+			size_t end = text.find_first_of("\r\n", begin);
+			if (begin == std::string_view::npos)
+				break;
+			std::filesystem::path materialPath = directory / text.substr(begin, end == std::string_view::npos ? end : end - begin);
+			std::error_code ec;
+			if (!std::filesystem::is_regular_file(materialPath, ec))
+				continue;
+			MappedFile material(materialPath.string().c_str());
+			hash = HashBytes(material.Data(), material.Size(), hash);
+		}
+		return hash;
+	}
+
+	bool MeshCache::Load(uint64_t hash, std::vector<Mesh>& meshes)
+	{
+		std::filesystem::path path = cacheDirectory / std::format("{:016x}.hmesh", hash);
+		std::error_code ec;
+		if (!std::filesystem::is_regular_file(path, ec))
+			return false;
+		MappedFile file;
+		try {
+			file.Open(path.string().c_str());
+		}
+		catch (const std::runtime_error&) {
+			return false;
+		}
+
+		const uint8_t* pFile = file.Data();
+		CacheHeader header;
+		if (file.Size() < sizeof header)
+			return false;
+		memcpy(&header, pFile, sizeof header);
+		if (header.magic != cacheMagic || header.version != cacheVersion || header.hash != hash)
+			return false;
+		uint64_t tableSize = sizeof header + uint64_t(header.meshCount) * sizeof(MeshRecord) + uint64_t(header.textureCount) * sizeof(TextureRecord) +
+			uint64_t(header.lodCount) * sizeof(LodRecord) + header.stringsSize;
+		if (file.Size() < tableSize)
+			return false;
+		const uint8_t* pMeshRecords = pFile + sizeof header;
+		const uint8_t* pTextureRecords = pMeshRecords + header.meshCount * sizeof(MeshRecord);
+		const uint8_t* pLodRecords = pTextureRecords + header.textureCount * sizeof(TextureRecord);
+		const char* pStrings = reinterpret_cast<const char*>(pLodRecords + header.lodCount * sizeof(LodRecord));
+
+		//Everything is checked before anything is created, a truncated or foreign file is just a cache miss
+		std::vector<MeshRecord> records(header.meshCount);
+		std::vector<VertexLayout> layouts(header.meshCount);
+		std::vector<std::vector<uint32_t>> indexArrays(header.meshCount);
+		for (uint32_t i = 0; i < header.meshCount; i++) {
+			MeshRecord& record = records[i];
+			memcpy(&record, pMeshRecords + i * sizeof(MeshRecord), sizeof record);
+			if (record.attributeCount > VertexLayout::maxAttributeCount || record.storage > uint32_t(VERTEX_STORAGE::SEPARATE) ||
+				uint64_t(record.firstTexture) + record.textureCount > header.textureCount || uint64_t(record.firstLod) + record.lodCount > header.lodCount)
+				return false;
+			for (uint32_t l = 0; l < record.lodCount; l++) {
+				LodRecord lod;
+				memcpy(&lod, pLodRecords + (record.firstLod + l) * sizeof(LodRecord), sizeof lod);
+				if (uint64_t(lod.firstIndex) + lod.indexCount > record.indexCount || uint64_t(lod.firstMeshlet) + lod.meshletCount > record.meshletCount)
+					return false;
+			}
+			layouts[i] = VertexLayout(VERTEX_STORAGE(record.storage));
+			for (uint32_t a = 0; a < record.attributeCount; a++)
+				layouts[i].Add(VETEX_ATTRIBUTE_TYPE(record.types[a]), VkFormat(record.formats[a]));
+			if (!FitsInFile(record.vertexOffset, record.vertexCount, layouts[i].VertexSize(), file.Size()) ||
+				!FitsInFile(record.indexOffset, record.indexCount, sizeof(uint32_t), file.Size()) ||
+				!FitsInFile(record.meshletOffset, record.meshletCount, sizeof(Meshlet), file.Size()))
+				return false;
+			//An index past the vertices would have the GPU read outside the vertex buffer
+			std::vector<uint32_t>& indices = indexArrays[i];
+			indices.resize(size_t(record.indexCount));
+			memcpy(indices.data(), pFile + record.indexOffset, indices.size() * sizeof(uint32_t));
+			if (std::ranges::any_of(indices, [&](uint32_t index) { return index >= record.vertexCount; }))
+				return false;
+			for (uint64_t m = 0; m < record.meshletCount; m++) {
+				Meshlet meshlet;
+				memcpy(&meshlet, pFile + record.meshletOffset + m * sizeof(Meshlet), sizeof meshlet);
+				if (uint64_t(meshlet.firstIndex) + uint64_t(meshlet.triangleCount) * 3 > record.indexCount)
+					return false;
+			}
+		}
+		for (uint32_t i = 0; i < header.textureCount; i++) {
+			TextureRecord texture;
+			memcpy(&texture, pTextureRecords + i * sizeof(TextureRecord), sizeof texture);
+			if (uint64_t(texture.nameOffset) + texture.nameLength > header.stringsSize)
+				return false;
+		}
+
+		meshes.reserve(meshes.size() + header.meshCount);
+		for (uint32_t i = 0; i < header.meshCount; i++) {
+			const MeshRecord& record = records[i];
+			VertexStream vertices(layouts[i], size_t(record.vertexCount), pFile + record.vertexOffset);
+			std::vector<TextureInfo> textures(record.textureCount);
+			for (uint32_t t = 0; t < record.textureCount; t++) {
+				TextureRecord texture;
+				memcpy(&texture, pTextureRecords + (record.firstTexture + t) * sizeof(TextureRecord), sizeof texture);
+				textures[t] = { uint32_t(M_INVALID_ID), TEXTURE_TYPE(texture.type), std::string(pStrings + texture.nameOffset, texture.nameLength) };
+			}
+			std::vector<MeshLod> lods(record.lodCount);
+			for (uint32_t l = 0; l < record.lodCount; l++) {
+				LodRecord lod;
+				memcpy(&lod, pLodRecords + (record.firstLod + l) * sizeof(LodRecord), sizeof lod);
+				lods[l] = { lod.firstIndex, lod.indexCount, lod.error, lod.firstMeshlet, lod.meshletCount };
+			}
+			std::vector<Meshlet> meshlets(size_t(record.meshletCount));
+			memcpy(meshlets.data(), pFile + record.meshletOffset, meshlets.size() * sizeof(Meshlet));
+			MeshBounds bounds = {
+				{ record.boundsMin[0], record.boundsMin[1], record.boundsMin[2] },
+				{ record.boundsMax[0], record.boundsMax[1], record.boundsMax[2] }
+			};
+			meshes.emplace_back(std::move(vertices), std::move(indexArrays[i]), std::move(textures), bounds, std::move(lods), std::move(meshlets));
+		}
+		return true;
+	}
+
+	void MeshCache::Store(uint64_t hash, ArrayRef<const Mesh> meshes)
+	{
+		CacheHeader header = { cacheMagic, cacheVersion, hash, uint32_t(meshes.size()) };
+		std::vector<MeshRecord> records(meshes.size());
+		std::vector<TextureRecord> textures;
+		std::vector<LodRecord> lods;
+		std::string strings;
+		for (size_t i = 0; i < meshes.size(); i++) {
+			const Mesh& mesh = meshes[i];
+			const VertexLayout& layout = mesh.vertices.Layout();
+			MeshRecord& record = records[i];
+			record.vertexCount = mesh.vertices.VertexCount();
+			record.indexCount = mesh.indices.size();
+			record.meshletCount = mesh.meshlets.size();
+			record.storage = uint32_t(layout.Storage());
+			record.attributeCount = layout.AttributeCount();
+			for (uint32_t a = 0; a < layout.AttributeCount(); a++)
+				record.formats[a] = uint32_t(layout.Attribute(a).format),
+				record.types[a] = uint32_t(layout.Attribute(a).type);
+			memcpy(record.boundsMin, &mesh.bounds.min, sizeof record.boundsMin);
+			memcpy(record.boundsMax, &mesh.bounds.max, sizeof record.boundsMax);
+			record.firstTexture = uint32_t(textures.size());
+			record.textureCount = uint32_t(mesh.textures.size());
+			for (const TextureInfo& texture : mesh.textures) {
+				textures.push_back({ uint32_t(texture.type), uint32_t(strings.size()), uint32_t(texture.name.size()) });
+				strings += texture.name;
+			}
+			record.firstLod = uint32_t(lods.size());
+			record.lodCount = uint32_t(mesh.lods.size());
+			for (const MeshLod& lod : mesh.lods)
+				lods.push_back({ lod.firstIndex, lod.indexCount, lod.error, lod.firstMeshlet, lod.meshletCount });
+		}
+		header.textureCount = uint32_t(textures.size());
+		header.lodCount = uint32_t(lods.size());
+		header.stringsSize = uint32_t(strings.size());
+
+		uint64_t offset = sizeof header + records.size() * sizeof(MeshRecord) + textures.size() * sizeof(TextureRecord) + lods.size() * sizeof(LodRecord) + strings.size();
+		for (size_t i = 0; i < meshes.size(); i++) {
+			records[i].vertexOffset = offset = AlignBlob(offset);
+			offset += meshes[i].vertices.DataSize();
+			records[i].indexOffset = offset = AlignBlob(offset);
+			offset += meshes[i].indices.size() * sizeof(uint32_t);
+			records[i].meshletOffset = offset = AlignBlob(offset);
+			offset += meshes[i].meshlets.size() * sizeof(Meshlet);
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(cacheDirectory, ec);
+		std::filesystem::path path = cacheDirectory / std::format("{:016x}.hmesh", hash);
+		//Write then rename, a crash halfway never leaves a file that looks valid
+		std::filesystem::path tempPath = path;
+		tempPath += ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file) {
+				std::cout << std::format("[ MeshCache ] WARNING\nFailed to write the mesh cache: {}\n", path.generic_string());
+				return;
+			}
+			file.write(reinterpret_cast<const char*>(&header), sizeof header);
+			file.write(reinterpret_cast<const char*>(records.data()), std::streamsize(records.size() * sizeof(MeshRecord)));
+			file.write(reinterpret_cast<const char*>(textures.data()), std::streamsize(textures.size() * sizeof(TextureRecord)));
+			file.write(reinterpret_cast<const char*>(lods.data()), std::streamsize(lods.size() * sizeof(LodRecord)));
+			file.write(strings.data(), std::streamsize(strings.size()));
+			const char padding[blobAlignment] = {};
+			auto WriteBlob = [&](uint64_t blobOffset, const void* pData, size_t size) {
+				file.write(padding, std::streamsize(blobOffset - uint64_t(file.tellp())));
+				file.write(reinterpret_cast<const char*>(pData), std::streamsize(size));
+				};
+			for (size_t i = 0; i < meshes.size(); i++) {
+				WriteBlob(records[i].vertexOffset, meshes[i].vertices.Data(), meshes[i].vertices.DataSize());
+				WriteBlob(records[i].indexOffset, meshes[i].indices.data(), meshes[i].indices.size() * sizeof(uint32_t));
+				WriteBlob(records[i].meshletOffset, meshes[i].meshlets.data(), meshes[i].meshlets.size() * sizeof(Meshlet));
+			}
+			if (!file) {
+				std::cout << std::format("[ MeshCache ] WARNING\nFailed to write the mesh cache: {}\n", path.generic_string());
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				return;
+			}
+		}
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+			std::filesystem::remove(tempPath, ec);
+	}
+}
@@ -0,0 +1,291 @@
+#include "Engine/Actor/MeshOptimizer.h"
+
+namespace HoshioEngine {
+
+	namespace {
+		//Forsyth's scoring, the cache modelled here is larger than the one analyzed so vertices fade out gradually
+		constexpr uint32_t scoreCacheSize = 32;
+		constexpr float cacheDecayPower = 1.5f;
+		constexpr float lastTriangleScore = 0.75f;
+		constexpr float valenceBoostScale = 2.f;
+		constexpr float valenceBoostPower = 0.5f;
+
+		float VertexScore(int32_t cachePosition, uint32_t liveTriangleCount) {
+			if (!liveTriangleCount)
+				return -1.f;
+			float score = 0.f;
+			if (cachePosition >= 0)
+				score = cachePosition < 3 ? lastTriangleScore :
+					std::pow(1.f - float(cachePosition - 3) / (scoreCacheSize - 3), cacheDecayPower);
+			return score + valenceBoostScale * std::pow(float(liveTriangleCount), -valenceBoostPower);
+		}
+
+		//Vertex i of the result is vertex remap[i] of the source
+		VertexStream Gather(const VertexStream& source, ArrayRef<const uint32_t> remap) {
+			const VertexLayout& layout = source.Layout();
+			VertexStream result(layout, remap.size());
+			if (layout.Storage() == VERTEX_STORAGE::INTERLEAVED) {
+				size_t vertexSize = layout.VertexSize();
+				for (size_t i = 0; i < remap.size(); i++)
+					memcpy(result.Data() + i * vertexSize, source.Data() + remap[i] * vertexSize, vertexSize);
+			}
+			else
+				for (uint32_t a = 0; a < layout.AttributeCount(); a++) {
+					size_t attributeSize = layout.AttributeSize(a);
+					const uint8_t* pSrc = source.Data() + source.BindingOffset(a);
+					uint8_t* pDst = result.Data() + result.BindingOffset(a);
+					for (size_t i = 0; i < remap.size(); i++)
+						memcpy(pDst + i * attributeSize, pSrc + remap[i] * attributeSize, attributeSize);
+				}
+			return result;
+		}
+
+		//Vertices of either storage as one record each, points into the stream when it is already interleaved
+		const uint8_t* Interleave(const VertexStream& vertices, std::vector<uint8_t>& buffer) {
+			const VertexLayout& layout = vertices.Layout();
+			if (layout.Storage() == VERTEX_STORAGE::INTERLEAVED)
+				return vertices.Data();
+			size_t vertexSize = layout.VertexSize();
+			buffer.resize(vertices.VertexCount() * vertexSize);
+			for (uint32_t a = 0, offset = 0; a < layout.AttributeCount(); offset += layout.AttributeSize(a), a++) {
+				size_t attributeSize = layout.AttributeSize(a);
+				const uint8_t* pSrc = vertices.Data() + vertices.BindingOffset(a);
+				for (size_t i = 0; i < vertices.VertexCount(); i++)
+					memcpy(buffer.data() + i * vertexSize + offset, pSrc + i * attributeSize, attributeSize);
+			}
+			return buffer.data();
+		}
+	}
+
+	VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(ArrayRef<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize)
+	{
+		VertexCacheStatistics statistics = { indices.size() / 3, vertexCount };
+		//Time stamp of each vertex' entry into the cache, a vertex is cached while fewer than cacheSize misses happened since
+		std::vector<size_t> timeStamps(vertexCount, 0);
+		size_t time = cacheSize + 1;
+		for (uint32_t index : indices)
+			if (time - timeStamps[index] > cacheSize)
+				timeStamps[index] = time++;
+		statistics.verticesTransformed = time - (cacheSize + 1);
+		return statistics;
+	}
+
+	size_t MeshOptimizer::WeldVertices(VertexStream& vertices, std::vector<uint32_t>& indices)
+	{
+		size_t vertexCount = vertices.VertexCount();
+		size_t vertexSize = vertices.Layout().VertexSize();
+		std::vector<uint8_t> buffer;
+		const uint8_t* pVertices = Interleave(vertices, buffer);
+
+		//Open addressing over vertex bytes, table[slot] is the first vertex seen with those bytes
+		size_t tableSize = 16;
+		while (tableSize < vertexCount * 2)
+			tableSize <<= 1;
+		std::vector<uint32_t> table(tableSize, UINT32_MAX);
+		std::vector<uint32_t> remap(vertexCount);
+		std::vector<uint32_t> unique;
+		for (size_t i = 0; i < vertexCount; i++) {
+			const uint8_t* pVertex = pVertices + i * vertexSize;
+			size_t slot = HashBytes(pVertex, vertexSize) & (tableSize - 1);
+			while (table[slot] != UINT32_MAX && memcmp(pVertices + unique[table[slot]] * vertexSize, pVertex, vertexSize))
+				slot = (slot + 1) & (tableSize - 1);
+			if (table[slot] == UINT32_MAX) {
+				table[slot] = uint32_t(unique.size());
+				unique.push_back(uint32_t(i));
+			}
+			remap[i] = table[slot];
+		}
+		if (unique.size() == vertexCount)
+			return vertexCount;
+
+		for (uint32_t& index : indices)
+			index = remap[index];
+		vertices = Gather(vertices, { unique.data(), unique.size() });
+		return unique.size();
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+	{
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount < 2)
+			return;
+
+		//Triangles of each vertex not emitted yet, packed per vertex
+		std::vector<uint32_t> liveCounts(vertexCount, 0);
+		for (uint32_t index : indices)
+			liveCounts[index]++;
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (size_t v = 0; v < vertexCount; v++)
+			adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveCounts[v];
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+				adjacency[fill[indices[i]]++] = uint32_t(i / 3);
+		}
+
+		std::vector<int32_t> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		for (size_t v = 0; v < vertexCount; v++)
+			vertexScores[v] = VertexScore(-1, liveCounts[v]);
+		std::vector<float> triangleScores(triangleCount);
+		for (size_t t = 0; t < triangleCount; t++)
+			triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+		std::vector<bool> emitted(triangleCount, false);
+
+		uint32_t cache[scoreCacheSize + 3];
+		uint32_t cacheCount = 0;
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+		size_t bestTriangle = std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin();
+		//Where to look for an unemitted triangle when nothing in the cache is adjacent to one
+		size_t cursor = 0;
+
+		while (result.size() < indices.size()) {
+			if (bestTriangle == SIZE_MAX) {
+				while (emitted[cursor])
+					cursor++;
+				bestTriangle = cursor;
+			}
+			const uint32_t* triangle = &indices[bestTriangle * 3];
+			result.insert(result.end(), triangle, triangle + 3);
+			emitted[bestTriangle] = true;
+
+			uint32_t newCache[scoreCacheSize + 3];
+			uint32_t newCacheCount = 0;
+			for (uint32_t i = 0; i < 3; i++) {
+				uint32_t v = triangle[i];
+				//Swap the triangle out of the vertex's live range
+				uint32_t* pBegin = &adjacency[adjacencyOffsets[v]];
+				uint32_t* pEnd = pBegin + liveCounts[v];
+				std::iter_swap(std::find(pBegin, pEnd, uint32_t(bestTriangle)), pEnd - 1);
+				liveCounts[v]--;
+				newCache[newCacheCount++] = v;
+			}
+			for (uint32_t i = 0; i < cacheCount; i++)
+				if (cache[i] != triangle[0] && cache[i] != triangle[1] && cache[i] != triangle[2])
+					newCache[newCacheCount++] = cache[i];
+
+			//Vertices pushed out of the cache lose their position, everything in it gets rescored
+			for (uint32_t i = scoreCacheSize; i < newCacheCount; i++)
+				cachePositions[newCache[i]] = -1;
+			cacheCount = std::min(newCacheCount, scoreCacheSize);
+			memcpy(cache, newCache, sizeof(uint32_t) * cacheCount);
+
+			bestTriangle = SIZE_MAX;
+			float bestScore = -1.f;
+			for (uint32_t i = 0; i < newCacheCount; i++) {
+				uint32_t v = newCache[i];
+				if (i < scoreCacheSize)
+					cachePositions[v] = int32_t(i);
+				float delta = VertexScore(cachePositions[v], liveCounts[v]) - vertexScores[v];
+				vertexScores[v] += delta;
+				for (uint32_t a = 0; a < liveCounts[v]; a++) {
+					uint32_t t = adjacency[adjacencyOffsets[v] + a];
+					triangleScores[t] += delta;
+					if (triangleScores[t] > bestScore)
+						bestScore = triangleScores[t], bestTriangle = t;
+				}
+			}
+		}
+		indices = std::move(result);
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const VertexStream& vertices, float threshold)
+	{
+		int32_t positionIndex = vertices.Layout().Find(VETEX_ATTRIBUTE_TYPE::POSITION);
+		size_t triangleCount = indices.size() / 3;
+		if (positionIndex < 0 || vertices.Layout().Attribute(positionIndex).format != VK_FORMAT_R32G32B32_SFLOAT || triangleCount < 2)
+			return;
+		StridedSpan<const glm::vec3> positions = vertices.Attribute<glm::vec3>(uint32_t(positionIndex));
+		VertexCacheStatistics original = AnalyzeVertexCache({ indices.data(), indices.size() }, vertices.VertexCount());
+
+		//A cluster starts where the cache has nothing of the previous triangles left, moving it costs no extra misses
+		std::vector<size_t> clusterStarts;
+		{
+			std::vector<size_t> timeStamps(vertices.VertexCount(), 0);
+			size_t time = defaultCacheSize + 1;
+			for (size_t t = 0; t < triangleCount; t++) {
+				uint32_t misses = 0;
+				for (uint32_t i = 0; i < 3; i++)
+					if (time - timeStamps[indices[t * 3 + i]] > defaultCacheSize)
+						timeStamps[indices[t * 3 + i]] = time++, misses++;
+				if (misses == 3 || !t)
+					clusterStarts.push_back(t);
+			}
+		}
+		if (clusterStarts.size() < 2)
+			return;
+		clusterStarts.push_back(triangleCount);
+
+		//Clusters facing away from the mesh's center are likely in front, they are drawn first to occlude the rest
+		struct Cluster {
+			size_t begin;
+			size_t end;
+			glm::vec3 centroid;
+			glm::vec3 normal;
+			float sortKey;
+		};
+		std::vector<Cluster> clusters(clusterStarts.size() - 1);
+		glm::vec3 meshCentroid(0.f);
+		float meshArea = 0.f;
+		for (size_t c = 0; c < clusters.size(); c++) {
+			Cluster& cluster = clusters[c];
+			cluster = { clusterStarts[c], clusterStarts[c + 1], glm::vec3(0.f), glm::vec3(0.f), 0.f };
+			float area = 0.f;
+			for (size_t t = cluster.begin; t < cluster.end; t++) {
+				glm::vec3 p0 = positions[indices[t * 3]], p1 = positions[indices[t * 3 + 1]], p2 = positions[indices[t * 3 + 2]];
+				glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+				float triangleArea = glm::length(normal);
+				cluster.centroid += (p0 + p1 + p2) * (triangleArea / 3.f);
+				cluster.normal += normal;
+				area += triangleArea;
+			}
+			meshCentroid += cluster.centroid;
+			meshArea += area;
+			cluster.centroid = area > 0.f ? cluster.centroid / area : positions[indices[cluster.begin * 3]];
+			float normalLength = glm::length(cluster.normal);
+			cluster.normal = normalLength > 0.f ? cluster.normal / normalLength : glm::vec3(0.f);
+		}
+		if (meshArea > 0.f)
+			meshCentroid /= meshArea;
+		for (Cluster& cluster : clusters)
+			cluster.sortKey = glm::dot(cluster.centroid - meshCentroid, cluster.normal);
+		std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+		for (const Cluster& cluster : clusters)
+			result.insert(result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+		VertexCacheStatistics sorted = AnalyzeVertexCache({ result.data(), result.size() }, vertices.VertexCount());
+		if (sorted.ACMR() <= original.ACMR() * threshold)
+			indices = std::move(result);
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(VertexStream& vertices, std::vector<uint32_t>& indices)
+	{
+		std::vector<uint32_t> remap(vertices.VertexCount(), UINT32_MAX);
+		std::vector<uint32_t> order;
+		order.reserve(vertices.VertexCount());
+		for (uint32_t& index : indices) {
+			if (remap[index] == UINT32_MAX) {
+				remap[index] = uint32_t(order.size());
+				order.push_back(index);
+			}
+			index = remap[index];
+		}
+		vertices = Gather(vertices, { order.data(), order.size() });
+	}
+
+	MeshOptimizationResult MeshOptimizer::Optimize(VertexStream& vertices, std::vector<uint32_t>& indices)
+	{
+		MeshOptimizationResult result;
+		result.before = AnalyzeVertexCache({ indices.data(), indices.size() }, vertices.VertexCount());
+		WeldVertices(vertices, indices);
+		OptimizeVertexCache(indices, vertices.VertexCount());
+		OptimizeOverdraw(indices, vertices);
+		OptimizeVertexFetch(vertices, indices);
+		result.after = AnalyzeVertexCache({ indices.data(), indices.size() }, vertices.VertexCount());
+		return result;
+	}
+}
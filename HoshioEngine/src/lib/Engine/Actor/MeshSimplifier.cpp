@@ -0,0 +1,557 @@
+#include "Engine/Actor/MeshSimplifier.h"
+#include "Engine/Actor/MeshOptimizer.h"
+
+namespace HoshioEngine {
+
+	namespace {
+		constexpr uint32_t maxAttributeComponents = 16;
+		//Planes through open edges, perpendicular to their triangle, weigh this much more than the triangles' own planes
+		constexpr float borderWeight = 10.f;
+		//Cosine of the largest rotation a triangle may go through in one collapse
+		constexpr float maxNormalRotation = 0.25f;
+		//A level that keeps more than this of the previous one's triangles is not worth its indices
+		constexpr float minLodProgress = 0.85f;
+
+		enum class VERTEX_KIND {
+			MANIFOLD,	//Moves anywhere
+			BORDER,		//On one open edge loop, moves along it
+			SEAM,		//One of two vertices at a position that differ in attributes, moves along the seam with its partner
+			LOCKED		//Corners, seam ends, non-manifold vertices, never moves
+		};
+
+		//Sum of weighted squared distances to planes, error(p) = p'Ap + 2b'p + c
+		struct Quadric {
+			double a00 = 0., a11 = 0., a22 = 0., a01 = 0., a02 = 0., a12 = 0.;
+			double b0 = 0., b1 = 0., b2 = 0., c = 0.;
+			double weight = 0.;
+
+			//Plane dot(normal, p) + distance = 0
+			static Quadric Plane(const glm::vec3& normal, float distance, float weight) {
+				double x = normal.x, y = normal.y, z = normal.z, d = distance, w = weight;
+				return { w * x * x, w * y * y, w * z * z, w * x * y, w * x * z, w * y * z, w * x * d, w * y * d, w * z * d, w * d * d, w };
+			}
+			Quadric& operator+=(const Quadric& other) {
+				a00 += other.a00, a11 += other.a11, a22 += other.a22, a01 += other.a01, a02 += other.a02, a12 += other.a12;
+				b0 += other.b0, b1 += other.b1, b2 += other.b2, c += other.c, weight += other.weight;
+				return *this;
+			}
+			//Mean squared distance over the planes
+			double Error(const glm::vec3& p) const {
+				double x = p.x, y = p.y, z = p.z;
+				double error = a00 * x * x + a11 * y * y + a22 * z * z + 2. * (a01 * x * y + a02 * x * z + a12 * y * z) +
+					2. * (b0 * x + b1 * y + b2 * z) + c;
+				return std::max(error, 0.) / std::max(weight, 1e-30);
+			}
+		};
+
+		class Simplification {
+		public:
+			Simplification(const VertexStream& vertices, ArrayRef<const uint32_t> indices, const MeshSimplificationSettings& settings);
+
+			bool Valid() const { return !positions.empty(); }
+			//Continues from where the last call stopped, quadrics keep what was collapsed before
+			void Run(size_t targetIndexCount, float targetError);
+			const std::vector<uint32_t>& Indices() const { return indices; }
+			//Relative to the mesh extent, including the attribute terms
+			float Error() const { return float(std::sqrt(maxCost)); }
+			//Position part of Error() only
+			float GeometricError() const { return float(std::sqrt(maxPositionCost)); }
+			//Mesh units per unit of Error()
+			float Scale() const { return scale; }
+
+		private:
+			//Centered and divided by the largest extent
+			std::vector<glm::vec3> positions;
+			float scale = 1.f;
+			//Attributes scaled by the square roots of their weights, componentCount floats per vertex
+			uint32_t componentCount = 0;
+			std::vector<float> attributes;
+			//First vertex at the same position, and the next one in a circular list of them
+			std::vector<uint32_t> positionRemap;
+			std::vector<uint32_t> wedges;
+			std::vector<VERTEX_KIND> kinds;
+			//Neighbours along the open edge loop of BORDER and SEAM vertices
+			std::vector<uint32_t> openNext;
+			std::vector<uint32_t> openPrevious;
+			//Per position
+			std::vector<Quadric> quadrics;
+			//Per vertex, sum of weight, weight * attribute and weight * |attribute|^2
+			std::vector<double> attributeWeights;
+			std::vector<double> attributeSums;
+			std::vector<double> attributeSquares;
+			std::vector<uint32_t> indices;
+			double maxCost = 0.;
+			double maxPositionCost = 0.;
+
+			//Vertex to triangle lists of the current indices
+			std::vector<uint32_t> adjacencyOffsets;
+			std::vector<uint32_t> adjacency;
+
+			void ClassifyVertices(std::vector<uint8_t>& openCorners, bool lockBorder);
+			void AccumulateQuadrics(const std::vector<uint8_t>& openCorners);
+			void BuildAdjacency();
+			uint32_t Partner(uint32_t v) const { return kinds[v] == VERTEX_KIND::SEAM ? wedges[v] : v; }
+			bool CanCollapse(uint32_t v, uint32_t t) const;
+			double AttributeError(uint32_t v, uint32_t t) const;
+			double CollapseCost(uint32_t v, uint32_t t) const;
+			//Triangles of v around edge (v, t), counted by position so seams see both sides
+			uint32_t SharedTriangles(uint32_t v, uint32_t t) const;
+			//Edge collapse would pinch the surface, when v and t have more common neighbours than triangles on their edge
+			bool BreaksLink(uint32_t v, uint32_t t) const;
+			bool FlipsTriangles(uint32_t v, uint32_t t) const;
+			void MergeAttributes(uint32_t v, uint32_t t);
+			void MergeOpenEdges(uint32_t v, uint32_t t);
+		};
+
+		Simplification::Simplification(const VertexStream& vertices, ArrayRef<const uint32_t> indices, const MeshSimplificationSettings& settings)
+			:indices(indices.begin(), indices.end())
+		{
+			const VertexLayout& layout = vertices.Layout();
+			int32_t positionIndex = layout.Find(VETEX_ATTRIBUTE_TYPE::POSITION);
+			if (positionIndex < 0 || layout.Attribute(positionIndex).format != VK_FORMAT_R32G32B32_SFLOAT || this->indices.size() % 3)
+				return;
+			size_t vertexCount = vertices.VertexCount();
+
+			StridedSpan<const glm::vec3> sourcePositions = vertices.Attribute<glm::vec3>(uint32_t(positionIndex));
+			glm::vec3 minimum(std::numeric_limits<float>::max()), maximum(std::numeric_limits<float>::lowest());
+			for (size_t i = 0; i < vertexCount; i++)
+				minimum = glm::min(minimum, sourcePositions[i]), maximum = glm::max(maximum, sourcePositions[i]);
+			glm::vec3 extent = maximum - minimum;
+			scale = std::max(std::max(extent.x, std::max(extent.y, extent.z)), 1e-12f);
+			glm::vec3 center = (minimum + maximum) * 0.5f;
+			positions.resize(vertexCount);
+			for (size_t i = 0; i < vertexCount; i++)
+				positions[i] = (sourcePositions[i] - center) / scale;
+
+			//Float attributes only, quantized streams are simplified before they are quantized
+			for (uint32_t a = 0; a < layout.AttributeCount(); a++) {
+				const VertexInputAttribute& attribute = layout.Attribute(a);
+				float weight = 0.f;
+				if (attribute.type == VETEX_ATTRIBUTE_TYPE::NORMAL && attribute.format == VK_FORMAT_R32G32B32_SFLOAT)
+					weight = settings.normalWeight;
+				else if (attribute.type == VETEX_ATTRIBUTE_TYPE::UV && attribute.format == VK_FORMAT_R32G32_SFLOAT)
+					weight = settings.uvWeight;
+				else if (attribute.type == VETEX_ATTRIBUTE_TYPE::COLOR && attribute.format == VK_FORMAT_R32G32B32A32_SFLOAT)
+					weight = settings.colorWeight;
+				uint32_t components = vkuFormatComponentCount(attribute.format);
+				if (weight <= 0.f || componentCount + components > maxAttributeComponents)
+					continue;
+				attributes.resize(vertexCount * maxAttributeComponents);
+				float factor = std::sqrt(weight);
+				auto Read = [&]<typename T>(T) {
+					StridedSpan<const T> values = vertices.Attribute<T>(a);
+					for (size_t i = 0; i < vertexCount; i++)
+						for (uint32_t c = 0; c < components; c++)
+							attributes[i * maxAttributeComponents + componentCount + c] = values[i][c] * factor;
+				};
+				if (components == 2)
+					Read(glm::vec2());
+				else if (components == 3)
+					Read(glm::vec3());
+				else
+					Read(glm::vec4());
+				componentCount += components;
+			}
+			if (componentCount) {
+				for (size_t i = 0; i < vertexCount; i++)
+					std::copy_n(attributes.begin() + i * maxAttributeComponents, componentCount, attributes.begin() + i * componentCount);
+				attributes.resize(vertexCount * componentCount);
+			}
+
+			//Open addressing over position bytes, like MeshOptimizer::WeldVertices
+			size_t tableSize = 16;
+			while (tableSize < vertexCount * 2)
+				tableSize <<= 1;
+			std::vector<uint32_t> table(tableSize, UINT32_MAX);
+			positionRemap.resize(vertexCount);
+			wedges.resize(vertexCount);
+			for (uint32_t i = 0; i < vertexCount; i++) {
+				size_t slot = HashBytes(&positions[i], sizeof(glm::vec3)) & (tableSize - 1);
+				while (table[slot] != UINT32_MAX && memcmp(&positions[table[slot]], &positions[i], sizeof(glm::vec3)))
+					slot = (slot + 1) & (tableSize - 1);
+				if (table[slot] == UINT32_MAX) {
+					table[slot] = i;
+					positionRemap[i] = wedges[i] = i;
+				}
+				else {
+					uint32_t first = table[slot];
+					positionRemap[i] = first;
+					wedges[i] = wedges[first];
+					wedges[first] = i;
+				}
+			}
+
+			std::vector<uint8_t> openCorners;
+			ClassifyVertices(openCorners, settings.lockBorder);
+			AccumulateQuadrics(openCorners);
+		}
+
+		void Simplification::ClassifyVertices(std::vector<uint8_t>& openCorners, bool lockBorder)
+		{
+			size_t vertexCount = positions.size();
+			auto Key = [](uint32_t a, uint32_t b) { return uint64_t(a) << 32 | b; };
+			std::unordered_map<uint64_t, uint32_t> edges, positionEdges;
+			edges.reserve(indices.size());
+			positionEdges.reserve(indices.size());
+			for (size_t i = 0; i < indices.size(); i++) {
+				uint32_t a = indices[i], b = indices[i % 3 == 2 ? i - 2 : i + 1];
+				edges[Key(a, b)]++;
+				positionEdges[Key(positionRemap[a], positionRemap[b])]++;
+			}
+
+			//Corner i is open when the edge from it to the next corner has no opposite half edge
+			std::vector<uint8_t> tangled(vertexCount, 0);
+			std::vector<uint32_t> openCounts(vertexCount, 0), borderCounts(vertexCount, 0);
+			openNext.assign(vertexCount, UINT32_MAX);
+			openPrevious.assign(vertexCount, UINT32_MAX);
+			openCorners.assign(indices.size(), 0);
+			for (size_t i = 0; i < indices.size(); i++) {
+				uint32_t a = indices[i], b = indices[i % 3 == 2 ? i - 2 : i + 1];
+				if (edges[Key(a, b)] > 1 || positionEdges[Key(positionRemap[a], positionRemap[b])] > 1)
+					tangled[a] = tangled[b] = 1;
+				if (edges.contains(Key(b, a)))
+					continue;
+				openCorners[i] = 1;
+				openCounts[a]++, openCounts[b]++;
+				openNext[a] = b, openPrevious[b] = a;
+				if (!positionEdges.contains(Key(positionRemap[b], positionRemap[a])))
+					borderCounts[a]++, borderCounts[b]++;
+			}
+
+			kinds.assign(vertexCount, VERTEX_KIND::LOCKED);
+			for (uint32_t v = 0; v < vertexCount; v++) {
+				if (tangled[v])
+					continue;
+				uint32_t w = wedges[v];
+				if (w == v) {
+					if (!openCounts[v])
+						kinds[v] = VERTEX_KIND::MANIFOLD;
+					else if (openCounts[v] == 2 && borderCounts[v] == 2 && openNext[v] != UINT32_MAX && openPrevious[v] != UINT32_MAX && !lockBorder)
+						kinds[v] = VERTEX_KIND::BORDER;
+				}
+				else if (wedges[w] == v && !tangled[w] && openCounts[v] == 2 && openCounts[w] == 2 && !borderCounts[v] && !borderCounts[w] &&
+					openNext[v] != UINT32_MAX && openPrevious[v] != UINT32_MAX && openNext[w] != UINT32_MAX && openPrevious[w] != UINT32_MAX)
+					kinds[v] = VERTEX_KIND::SEAM;
+			}
+		}
+
+		void Simplification::AccumulateQuadrics(const std::vector<uint8_t>& openCorners)
+		{
+			size_t vertexCount = positions.size();
+			quadrics.assign(vertexCount, {});
+			attributeWeights.assign(vertexCount, 0.);
+			attributeSums.assign(vertexCount * componentCount, 0.);
+			attributeSquares.assign(vertexCount, 0.);
+			for (size_t i = 0; i < indices.size(); i += 3) {
+				const glm::vec3& p0 = positions[indices[i]], & p1 = positions[indices[i + 1]], & p2 = positions[indices[i + 2]];
+				glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+				float doubleArea = glm::length(normal);
+				if (doubleArea == 0.f)
+					continue;
+				normal /= doubleArea;
+				Quadric plane = Quadric::Plane(normal, -glm::dot(normal, p0), doubleArea * 0.5f);
+				for (uint32_t c = 0; c < 3; c++) {
+					uint32_t v = indices[i + c];
+					quadrics[positionRemap[v]] += plane;
+					double weight = doubleArea / 6.;
+					attributeWeights[v] += weight;
+					for (uint32_t k = 0; k < componentCount; k++) {
+						double value = attributes[v * componentCount + k];
+						attributeSums[v * componentCount + k] += weight * value;
+						attributeSquares[v] += weight * value * value;
+					}
+
+					//Borders and seams would otherwise shrink freely inside the plane of their triangles
+					if (!openCorners[i + c])
+						continue;
+					uint32_t next = indices[i + (c + 1) % 3];
+					glm::vec3 edge = positions[next] - positions[v];
+					glm::vec3 edgeNormal = glm::cross(edge, normal);
+					float edgeLength = glm::length(edgeNormal);
+					if (edgeLength == 0.f)
+						continue;
+					edgeNormal /= edgeLength;
+					Quadric edgePlane = Quadric::Plane(edgeNormal, -glm::dot(edgeNormal, positions[v]), glm::dot(edge, edge) * borderWeight);
+					quadrics[positionRemap[v]] += edgePlane;
+					quadrics[positionRemap[next]] += edgePlane;
+				}
+			}
+		}
+
+		void Simplification::BuildAdjacency()
+		{
+			size_t vertexCount = positions.size();
+			adjacencyOffsets.assign(vertexCount + 1, 0);
+			for (uint32_t index : indices)
+				adjacencyOffsets[index + 1]++;
+			for (size_t v = 0; v < vertexCount; v++)
+				adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+			adjacency.resize(indices.size());
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+				adjacency[fill[indices[i]]++] = uint32_t(i / 3);
+		}
+
+		bool Simplification::CanCollapse(uint32_t v, uint32_t t) const
+		{
+			if (positionRemap[v] == positionRemap[t])
+				return false;
+			switch (kinds[v]) {
+			case VERTEX_KIND::MANIFOLD:
+				return true;
+			case VERTEX_KIND::BORDER:
+				//A three edge loop would close up
+				return (kinds[t] == VERTEX_KIND::BORDER || kinds[t] == VERTEX_KIND::LOCKED) && (openNext[v] == t || openPrevious[v] == t) &&
+					openNext[openNext[v]] != openPrevious[v];
+			case VERTEX_KIND::SEAM: {
+				if (kinds[t] != VERTEX_KIND::SEAM || (openNext[v] != t && openPrevious[v] != t))
+					return false;
+				uint32_t v1 = wedges[v], t1 = wedges[t];
+				return openNext[v1] == t1 || openPrevious[v1] == t1;
+			}
+			default:
+				return false;
+			}
+		}
+
+		double Simplification::AttributeError(uint32_t v, uint32_t t) const
+		{
+			if (!componentCount || attributeWeights[v] == 0.)
+				return 0.;
+			const float* pTarget = attributes.data() + t * componentCount;
+			const double* pSums = attributeSums.data() + v * componentCount;
+			double error = attributeSquares[v];
+			for (uint32_t k = 0; k < componentCount; k++)
+				error += attributeWeights[v] * pTarget[k] * pTarget[k] - 2. * pTarget[k] * pSums[k];
+			return std::max(error, 0.) / attributeWeights[v];
+		}
+
+		double Simplification::CollapseCost(uint32_t v, uint32_t t) const
+		{
+			double cost = quadrics[positionRemap[v]].Error(positions[t]) + AttributeError(v, t);
+			if (kinds[v] == VERTEX_KIND::SEAM)
+				cost += AttributeError(wedges[v], wedges[t]);
+			return cost;
+		}
+
+		uint32_t Simplification::SharedTriangles(uint32_t v, uint32_t t) const
+		{
+			uint32_t count = 0;
+			for (uint32_t w = v;;) {
+				for (uint32_t a = adjacencyOffsets[w]; a < adjacencyOffsets[w + 1]; a++) {
+					const uint32_t* pTriangle = indices.data() + adjacency[a] * 3;
+					for (uint32_t c = 0; c < 3; c++)
+						if (positionRemap[pTriangle[c]] == positionRemap[t]) {
+							count++;
+							break;
+						}
+				}
+				if ((w = wedges[w]) == v)
+					break;
+			}
+			return count;
+		}
+
+		bool Simplification::BreaksLink(uint32_t v, uint32_t t) const
+		{
+			auto Neighbours = [&](uint32_t vertex, std::vector<uint32_t>& result) {
+				for (uint32_t w = vertex;;) {
+					for (uint32_t a = adjacencyOffsets[w]; a < adjacencyOffsets[w + 1]; a++)
+						for (uint32_t c = 0; c < 3; c++) {
+							uint32_t position = positionRemap[indices[adjacency[a] * 3 + c]];
+							if (position != positionRemap[v] && position != positionRemap[t])
+								result.push_back(position);
+						}
+					if ((w = wedges[w]) == vertex)
+						break;
+				}
+				std::sort(result.begin(), result.end());
+				result.erase(std::unique(result.begin(), result.end()), result.end());
+			};
+			std::vector<uint32_t> neighboursV, neighboursT, common;
+			Neighbours(v, neighboursV);
+			Neighbours(t, neighboursT);
+			std::set_intersection(neighboursV.begin(), neighboursV.end(), neighboursT.begin(), neighboursT.end(), std::back_inserter(common));
+			return common.size() > SharedTriangles(v, t);
+		}
+
+		bool Simplification::FlipsTriangles(uint32_t v, uint32_t t) const
+		{
+			for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; a++) {
+				const uint32_t* pTriangle = indices.data() + adjacency[a] * 3;
+				glm::vec3 before[3], after[3];
+				bool collapses = false;
+				for (uint32_t c = 0; c < 3; c++) {
+					collapses |= positionRemap[pTriangle[c]] == positionRemap[t];
+					before[c] = after[c] = positions[pTriangle[c]];
+					if (pTriangle[c] == v)
+						after[c] = positions[t];
+				}
+				//Triangles on the edge disappear
+				if (collapses)
+					continue;
+				//Folding over, or turning far enough to end up as a sliver along an edge
+				glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+				glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+				if (glm::dot(normalBefore, normalAfter) <= maxNormalRotation * glm::length(normalBefore) * glm::length(normalAfter))
+					return true;
+			}
+			return false;
+		}
+
+		void Simplification::MergeAttributes(uint32_t v, uint32_t t)
+		{
+			attributeWeights[t] += attributeWeights[v];
+			attributeSquares[t] += attributeSquares[v];
+			for (uint32_t k = 0; k < componentCount; k++)
+				attributeSums[t * componentCount + k] += attributeSums[v * componentCount + k];
+		}
+
+		void Simplification::MergeOpenEdges(uint32_t v, uint32_t t)
+		{
+			if (kinds[v] != VERTEX_KIND::BORDER && kinds[v] != VERTEX_KIND::SEAM)
+				return;
+			if (openNext[v] == t) {
+				openPrevious[t] = openPrevious[v];
+				openNext[openPrevious[v]] = t;
+			}
+			else {
+				openNext[t] = openNext[v];
+				openPrevious[openNext[v]] = t;
+			}
+		}
+
+		void Simplification::Run(size_t targetIndexCount, float targetError)
+		{
+			if (!Valid())
+				return;
+			double costLimit = double(targetError) * targetError;
+			size_t vertexCount = positions.size();
+			struct Collapse {
+				uint32_t v;
+				uint32_t t;
+				double cost;
+			};
+			std::vector<Collapse> collapses;
+			std::vector<uint32_t> remap(vertexCount);
+			std::vector<uint8_t> locked(vertexCount);
+
+			//Each pass collapses the cheapest edges whose neighbourhoods do not overlap, then rebuilds the index list
+			while (indices.size() > targetIndexCount) {
+				BuildAdjacency();
+				collapses.clear();
+				for (size_t i = 0; i < indices.size(); i++) {
+					uint32_t a = indices[i], b = indices[i % 3 == 2 ? i - 2 : i + 1];
+					//Inner edges are seen from both triangles, once is enough
+					if (a > b && kinds[a] == VERTEX_KIND::MANIFOLD && kinds[b] == VERTEX_KIND::MANIFOLD)
+						continue;
+					double costAB = CanCollapse(a, b) ? CollapseCost(a, b) : std::numeric_limits<double>::max();
+					double costBA = CanCollapse(b, a) ? CollapseCost(b, a) : std::numeric_limits<double>::max();
+					if (costAB == std::numeric_limits<double>::max() && costBA == std::numeric_limits<double>::max())
+						continue;
+					collapses.push_back(costAB <= costBA ? Collapse{ a, b, costAB } : Collapse{ b, a, costBA });
+				}
+				if (collapses.empty())
+					break;
+				std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+				std::iota(remap.begin(), remap.end(), 0u);
+				std::fill(locked.begin(), locked.end(), 0);
+				size_t trianglesToRemove = (indices.size() - targetIndexCount + 2) / 3;
+				size_t trianglesRemoved = 0;
+				for (const Collapse& collapse : collapses) {
+					if (collapse.cost > costLimit || trianglesRemoved >= trianglesToRemove)
+						break;
+					//Seam vertices take their partner along, onto the partner of t
+					uint32_t v = collapse.v, t = collapse.t, v1 = Partner(v), t1 = v1 != v ? Partner(t) : t;
+					if (locked[v] || locked[t] || locked[v1] || locked[t1])
+						continue;
+					if (BreaksLink(v, t) || FlipsTriangles(v, t) || (v1 != v && FlipsTriangles(v1, t1)))
+						continue;
+
+					trianglesRemoved += SharedTriangles(v, t);
+					//Every vertex of the touched triangles stays put for the rest of the pass, which keeps adjacency and costs valid
+					for (uint32_t w : { v, v1 })
+						for (uint32_t a = adjacencyOffsets[w]; a < adjacencyOffsets[w + 1]; a++)
+							for (uint32_t c = 0; c < 3; c++) {
+								uint32_t corner = indices[adjacency[a] * 3 + c];
+								locked[corner] = locked[Partner(corner)] = 1;
+							}
+					locked[t] = locked[t1] = 1;
+
+					remap[v] = t;
+					remap[v1] = t1;
+					quadrics[positionRemap[t]] += quadrics[positionRemap[v]];
+					MergeAttributes(v, t);
+					MergeOpenEdges(v, t);
+					if (v1 != v) {
+						MergeAttributes(v1, t1);
+						MergeOpenEdges(v1, t1);
+					}
+					maxCost = std::max(maxCost, collapse.cost);
+					maxPositionCost = std::max(maxPositionCost, quadrics[positionRemap[t]].Error(positions[t]));
+				}
+				if (!trianglesRemoved)
+					break;
+
+				size_t count = 0;
+				for (size_t i = 0; i < indices.size(); i += 3) {
+					uint32_t a = remap[indices[i]], b = remap[indices[i + 1]], c = remap[indices[i + 2]];
+					uint32_t pa = positionRemap[a], pb = positionRemap[b], pc = positionRemap[c];
+					if (pa == pb || pb == pc || pc == pa)
+						continue;
+					indices[count++] = a, indices[count++] = b, indices[count++] = c;
+				}
+				indices.resize(count);
+			}
+		}
+	}
+
+	uint64_t MeshLodSettings::Key() const
+	{
+		uint32_t counts[] = { maxLodCount, minTriangleCount, uint32_t(simplification.lockBorder) };
+		float values[] = { reduction, maxError, simplification.normalWeight, simplification.uvWeight, simplification.colorWeight };
+		return HashBytes(values, sizeof values, HashBytes(counts, sizeof counts));
+	}
+
+	std::vector<uint32_t> MeshSimplifier::Simplify(const VertexStream& vertices, ArrayRef<const uint32_t> indices, size_t targetIndexCount,
+		float targetError, const MeshSimplificationSettings& settings, float* pError)
+	{
+		Simplification simplification(vertices, indices, settings);
+		simplification.Run(targetIndexCount, targetError);
+		if (pError)
+			*pError = simplification.Error();
+		return simplification.Indices();
+	}
+
+	std::vector<MeshLod> MeshSimplifier::GenerateLods(const VertexStream& vertices, std::vector<uint32_t>& indices, const MeshLodSettings& settings)
+	{
+		std::vector<MeshLod> lods;
+		if (indices.empty())
+			return lods;
+		lods.push_back({ 0, uint32_t(indices.size()), 0.f });
+		if (!settings.Enabled() || indices.size() / 3 < settings.minTriangleCount * 2)
+			return lods;
+		Simplification simplification(vertices, { indices.data(), indices.size() }, settings.simplification);
+		if (!simplification.Valid())
+			return lods;
+
+		//Every level continues collapsing the previous one, so errors and quadrics accumulate from level 0
+		size_t previousCount = indices.size();
+		for (uint32_t level = 1; level < settings.maxLodCount; level++) {
+			size_t targetCount = size_t(previousCount / 3 * settings.reduction) * 3;
+			if (targetCount / 3 < settings.minTriangleCount)
+				break;
+			simplification.Run(targetCount, settings.maxError);
+			size_t count = simplification.Indices().size();
+			if (count > previousCount * minLodProgress)
+				break;
+			std::vector<uint32_t> lod = simplification.Indices();
+			MeshOptimizer::OptimizeVertexCache(lod, vertices.VertexCount());
+			lods.push_back({ uint32_t(indices.size()), uint32_t(count), simplification.GeometricError() * simplification.Scale() });
+			indices.insert(indices.end(), lod.begin(), lod.end());
+			previousCount = count;
+		}
+		return lods;
+	}
+}
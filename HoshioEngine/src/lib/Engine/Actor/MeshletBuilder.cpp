@@ -0,0 +1,214 @@
+#include "Engine/Actor/MeshletBuilder.h"
+#include "Engine/Actor/MeshOptimizer.h"
+
+namespace HoshioEngine {
+
+	namespace {
+		constexpr uint32_t noCluster = std::numeric_limits<uint32_t>::max();
+		//Free triangles ahead of the cursor searched for the closest one once nothing adjacent is left
+		constexpr uint32_t jumpWindow = 64;
+
+		//Sphere around the vertices' box and the cone around the triangles' normals
+		void ComputeBounds(Meshlet& meshlet, StridedSpan<const glm::vec3> positions, ArrayRef<const uint32_t> vertices,
+			ArrayRef<const glm::vec3> normals)
+		{
+			glm::vec3 minimum(std::numeric_limits<float>::max()), maximum(std::numeric_limits<float>::lowest());
+			for (uint32_t vertex : vertices)
+				minimum = glm::min(minimum, positions[vertex]), maximum = glm::max(maximum, positions[vertex]);
+			meshlet.center = (minimum + maximum) * 0.5f;
+			meshlet.radius = 0.f;
+			for (uint32_t vertex : vertices)
+				meshlet.radius = std::max(meshlet.radius, glm::length(positions[vertex] - meshlet.center));
+
+			glm::vec3 normalSum(0.f);
+			for (const glm::vec3& normal : normals)
+				normalSum += normal;
+			float length = glm::length(normalSum);
+			meshlet.coneAxis = length > 1e-6f ? normalSum / length : glm::vec3(0.f, 0.f, 1.f);
+			//Degenerate triangles have no normal and are never rasterized, they do not widen the cone
+			float minDot = length > 1e-6f ? 1.f : -1.f;
+			for (const glm::vec3& normal : normals)
+				if (normal != glm::vec3(0.f))
+					minDot = std::min(minDot, glm::dot(normal, meshlet.coneAxis));
+			//A cone of 90 degrees or more faces every direction
+			meshlet.coneCutoff = minDot > 0.f ? std::sqrt(1.f - minDot * minDot) : 1.f;
+		}
+	}
+
+	std::vector<Meshlet> MeshletBuilder::Build(const VertexStream& vertices, ArrayRef<uint32_t> indices, uint32_t firstIndex, float coneWeight)
+	{
+		std::vector<Meshlet> meshlets;
+		const VertexLayout& layout = vertices.Layout();
+		int32_t positionIndex = layout.Find(VETEX_ATTRIBUTE_TYPE::POSITION);
+		size_t triangleCount = indices.size() / 3;
+		if (positionIndex < 0 || layout.Attribute(positionIndex).format != VK_FORMAT_R32G32B32_SFLOAT || !triangleCount || indices.size() % 3)
+			return meshlets;
+		StridedSpan<const glm::vec3> positions = vertices.Attribute<glm::vec3>(uint32_t(positionIndex));
+		size_t vertexCount = vertices.VertexCount();
+
+		std::vector<glm::vec3> normals(triangleCount);
+		for (size_t t = 0; t < triangleCount; t++) {
+			const glm::vec3& a = positions[indices[t * 3]];
+			glm::vec3 normal = glm::cross(positions[indices[t * 3 + 1]] - a, positions[indices[t * 3 + 2]] - a);
+			float length = glm::length(normal);
+			normals[t] = length > 0.f ? normal / length : glm::vec3(0.f);
+		}
+
+		//Triangles around each vertex
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (size_t i = 0; i < indices.size(); i++)
+			adjacencyOffsets[indices[i] + 1]++;
+		for (size_t v = 0; v < vertexCount; v++)
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+				adjacency[fill[indices[i]]++] = uint32_t(i / 3);
+		}
+
+		std::vector<bool> assigned(triangleCount, false);
+		//Local index of each vertex in the cluster being built, noCluster outside of it
+		std::vector<uint32_t> localIndices(vertexCount, noCluster);
+		std::vector<uint32_t> clusterVertices;
+		std::vector<uint32_t> clusterTriangles;
+		std::vector<glm::vec3> clusterNormals;
+		std::vector<uint32_t> localOrder;
+		std::vector<uint32_t> reordered;
+		reordered.reserve(indices.size());
+		clusterVertices.reserve(maxVertices);
+		clusterTriangles.reserve(maxTriangles);
+		glm::vec3 normalSum(0.f);
+		glm::vec3 minimum(std::numeric_limits<float>::max()), maximum(std::numeric_limits<float>::lowest());
+		size_t cursor = 0;
+
+		auto NewVertexCount = [&](size_t triangle) {
+			return uint32_t(localIndices[indices[triangle * 3]] == noCluster) + uint32_t(localIndices[indices[triangle * 3 + 1]] == noCluster) +
+				uint32_t(localIndices[indices[triangle * 3 + 2]] == noCluster);
+			};
+		auto Add = [&](size_t triangle) {
+			for (uint32_t corner = 0; corner < 3; corner++) {
+				uint32_t vertex = indices[triangle * 3 + corner];
+				if (localIndices[vertex] == noCluster) {
+					localIndices[vertex] = uint32_t(clusterVertices.size());
+					clusterVertices.push_back(vertex);
+					minimum = glm::min(minimum, positions[vertex]), maximum = glm::max(maximum, positions[vertex]);
+				}
+			}
+			assigned[triangle] = true;
+			clusterTriangles.push_back(uint32_t(triangle));
+			normalSum += normals[triangle];
+			};
+		auto Flush = [&]() {
+			//Cache order within the cluster, on local indices so the pass only sees the cluster's vertices
+			localOrder.clear();
+			for (uint32_t triangle : clusterTriangles)
+				for (uint32_t corner = 0; corner < 3; corner++)
+					localOrder.push_back(localIndices[indices[triangle * 3 + corner]]);
+			MeshOptimizer::OptimizeVertexCache(localOrder, clusterVertices.size());
+
+			Meshlet meshlet = {};
+			meshlet.firstIndex = firstIndex + uint32_t(reordered.size());
+			meshlet.triangleCount = uint32_t(clusterTriangles.size());
+			meshlet.vertexCount = uint32_t(clusterVertices.size());
+			for (uint32_t local : localOrder)
+				reordered.push_back(clusterVertices[local]);
+			clusterNormals.clear();
+			for (uint32_t triangle : clusterTriangles)
+				clusterNormals.push_back(normals[triangle]);
+			ComputeBounds(meshlet, positions, { clusterVertices.data(), clusterVertices.size() }, { clusterNormals.data(), clusterNormals.size() });
+			meshlets.push_back(meshlet);
+
+			for (uint32_t vertex : clusterVertices)
+				localIndices[vertex] = noCluster;
+			clusterVertices.clear();
+			clusterTriangles.clear();
+			normalSum = glm::vec3(0.f);
+			minimum = glm::vec3(std::numeric_limits<float>::max()), maximum = glm::vec3(std::numeric_limits<float>::lowest());
+			};
+
+		for (;;) {
+			while (cursor < triangleCount && assigned[cursor])
+				cursor++;
+			if (cursor == triangleCount)
+				break;
+			//Clusters start at the first free triangle, the input order is already local
+			Add(cursor);
+
+			while (clusterTriangles.size() < maxTriangles) {
+				float axisLength = glm::length(normalSum);
+				glm::vec3 axis = axisLength > 1e-6f ? normalSum / axisLength : glm::vec3(0.f);
+				size_t best = triangleCount;
+				float bestScore = std::numeric_limits<float>::max();
+				bool full = false;
+				for (size_t i = 0; i < clusterVertices.size(); i++) {
+					uint32_t vertex = clusterVertices[i];
+					for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; a++) {
+						uint32_t triangle = adjacency[a];
+						if (assigned[triangle])
+							continue;
+						uint32_t newVertices = NewVertexCount(triangle);
+						if (clusterVertices.size() + newVertices > maxVertices) {
+							full = true;
+							continue;
+						}
+						//New vertices always outweigh the normal term, which stays below 2 * coneWeight
+						float score = float(newVertices) + coneWeight * (1.f - glm::dot(normals[triangle], axis));
+						if (score < bestScore)
+							bestScore = score, best = triangle;
+					}
+				}
+				if (best == triangleCount && !full) {
+					//Nothing adjacent is left, jump to the closest free triangle that fits among the next few in input order
+					glm::vec3 center = (minimum + maximum) * 0.5f;
+					float bestDistance = std::numeric_limits<float>::max();
+					uint32_t searched = 0;
+					while (cursor < triangleCount && assigned[cursor])
+						cursor++;
+					for (size_t triangle = cursor; triangle < triangleCount && searched < jumpWindow; triangle++) {
+						if (assigned[triangle])
+							continue;
+						searched++;
+						if (clusterVertices.size() + NewVertexCount(triangle) > maxVertices)
+							continue;
+						glm::vec3 centroid = (positions[indices[triangle * 3]] + positions[indices[triangle * 3 + 1]] + positions[indices[triangle * 3 + 2]]) / 3.f;
+						float distance = glm::length(centroid - center);
+						if (distance < bestDistance)
+							bestDistance = distance, best = triangle;
+					}
+				}
+				if (best == triangleCount)
+					break;
+				Add(best);
+			}
+			Flush();
+		}
+
+		std::copy(reordered.begin(), reordered.end(), indices.begin());
+		return meshlets;
+	}
+
+	std::vector<Meshlet> MeshletBuilder::Build(const VertexStream& vertices, std::vector<uint32_t>& indices, std::vector<MeshLod>& lods, float coneWeight)
+	{
+		std::vector<Meshlet> meshlets;
+		for (MeshLod& lod : lods) {
+			std::vector<Meshlet> level = Build(vertices, { indices.data() + lod.firstIndex, lod.indexCount }, lod.firstIndex, coneWeight);
+			//Either every level is clustered or none, a level without clusters could not be drawn through them
+			if (level.empty()) {
+				for (MeshLod& cleared : lods)
+					cleared.firstMeshlet = cleared.meshletCount = 0;
+				return {};
+			}
+			lod.firstMeshlet = uint32_t(meshlets.size());
+			lod.meshletCount = uint32_t(level.size());
+			meshlets.insert(meshlets.end(), level.begin(), level.end());
+		}
+		return meshlets;
+	}
+
+	bool MeshletBuilder::IsBackfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition)
+	{
+		glm::vec3 direction = meshlet.center - cameraPosition;
+		return glm::dot(direction, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(direction) + meshlet.radius;
+	}
+}
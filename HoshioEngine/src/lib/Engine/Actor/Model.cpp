@@ -1,9 +1,14 @@
 #include "Engine/Actor/Model.h"
+#include "Engine/Actor/MeshCache.h"
+#include "Engine/Actor/MeshOptimizer.h"
+#include "Engine/Actor/MeshSimplifier.h"
+#include "Engine/Actor/MeshletBuilder.h"
+#include "Engine/Actor/VertexQuantizer.h"
 
 namespace HoshioEngine {
-	Model::Model(const char* file_path)
+	Model::Model(const char* file_path, const VertexQuantization& quantization, const MeshLodSettings& lod_settings)
 	{
-		LoadModel(file_path);
+		LoadModel(file_path, quantization, lod_settings);
 	}
 
 	Model::Model(std::vector<Mesh>& meshes) : meshes(std::move(meshes))
@@ -15,8 +20,15 @@ namespace HoshioEngine {
 		Pipeline& pipeline = VulkanPlus::Plus().GetPipeline(shader_info.pipeline_id).second[0];
 		const CommandBuffer& commandBuffer = VulkanPlus::Plus().CommandBuffer_Graphics();
 		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-		for (auto& mesh : meshes)
-			mesh.Render(shader_info);
+		//Meshes in the same pool blocks, usually all of them, draw without rebinding
+		const Mesh* bound = nullptr;
+		for (auto& mesh : meshes) {
+			if (!bound || !mesh.SharesGeometryWith(*bound)) {
+				mesh.BindGeometry(commandBuffer);
+				bound = &mesh;
+			}
+			mesh.Draw(shader_info);
+		}
 	}
 
 	void Model::SetupModel(ShaderInfo& shader_info)
@@ -25,8 +37,22 @@ namespace HoshioEngine {
 			mesh.SetupMesh(shader_info);
 	}
 
-	void Model::LoadModel(std::string path)
+	void Model::LoadModel(std::string path, const VertexQuantization& quantization, const MeshLodSettings& lod_settings)
 	{
+		directory = path.substr(0, path.find_last_of('/'));
+		CheckModelImportType(path);
+
+		//A cooked copy of the same source skips Assimp entirely
+		uint32_t quantizationKey = quantization.Key();
+		uint64_t lodKey = lod_settings.Key();
+		uint64_t hash = HashBytes(&quantizationKey, sizeof quantizationKey, MeshCache::SourceHash(path.c_str()));
+		hash = HashBytes(&lodKey, sizeof lodKey, hash);
+		if (MeshCache::Load(hash, meshes)) {
+			ResolveTextures();
+			std::cout << std::format("Successfully load the model : {} ({} meshes, cooked)\n", path, meshes.size());
+			return;
+		}
+
 		Assimp::Importer importer;
 		const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenNormals);
 
@@ -36,13 +62,38 @@ namespace HoshioEngine {
 			return;
 		}
 
-		directory = path.substr(0, path.find_last_of('/'));
-		CheckModelImportType(path);
-
-
+		PreloadMaterialTextures(scene);
+		optimization = {};
+		this->lod_settings = lod_settings;
 		ProcessNode(scene->mRootNode, scene);
+		if (quantization.Enabled())
+			QuantizeMeshes(quantization);
+		MeshCache::Store(hash, { meshes.data(), meshes.size() });
+
+		std::cout << std::format("Successfully load the model : {} ({} meshes)\n", path, meshes.size());
+		std::cout << std::format("Optimized : {} -> {} vertices, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}\n",
+			optimization.before.vertexCount, optimization.after.vertexCount, optimization.before.ACMR(), optimization.after.ACMR(),
+			optimization.before.ATVR(), optimization.after.ATVR());
 
-		std::cout << std::format("Successfully load the model : {}\n", path);
+		//Meshes with fewer levels count with their coarsest one
+		size_t level_count = 0;
+		for (auto& mesh : meshes)
+			level_count = std::max(level_count, mesh.lods.size());
+		std::string lod_triangles;
+		for (size_t level = 0; level < level_count; level++) {
+			size_t triangle_count = 0;
+			for (auto& mesh : meshes)
+				if (!mesh.lods.empty())
+					triangle_count += mesh.lods[std::min(level, mesh.lods.size() - 1)].indexCount / 3;
+			lod_triangles += std::format(level ? " -> {}" : "{}", triangle_count);
+		}
+		if (level_count > 1)
+			std::cout << std::format("LODs : {} triangles\n", lod_triangles);
+		size_t meshlet_count = 0;
+		for (auto& mesh : meshes)
+			meshlet_count += mesh.meshlets.size();
+		if (meshlet_count)
+			std::cout << std::format("Meshlets : {} over all levels\n", meshlet_count);
 
 	}
 
@@ -84,52 +135,60 @@ namespace HoshioEngine {
 
 	Mesh Model::ProcessMesh(aiMesh* mesh, const aiScene* scene)
 	{
-		std::vector<Vertex> vertices;
+		//Layout first, then one allocation for all vertex data and one for the indices
+		uint32_t color_count = 0, uv_count = 0;
+		while (mesh->HasVertexColors(color_count))
+			color_count++;
+		while (mesh->HasTextureCoords(uv_count))
+			uv_count++;
+		VertexLayout layout;
+		layout.Add(VETEX_ATTRIBUTE_TYPE::POSITION, VK_FORMAT_R32G32B32_SFLOAT)
+			.Add(VETEX_ATTRIBUTE_TYPE::NORMAL, VK_FORMAT_R32G32B32_SFLOAT);
+		for (uint32_t i = 0; i < color_count; i++)
+			layout.Add(VETEX_ATTRIBUTE_TYPE::COLOR, VK_FORMAT_R32G32B32A32_SFLOAT);
+		for (uint32_t i = 0; i < uv_count; i++)
+			layout.Add(VETEX_ATTRIBUTE_TYPE::UV, VK_FORMAT_R32G32_SFLOAT);
+
+		VertexStream vertices(layout, mesh->mNumVertices);
 		std::vector<uint32_t> indices;
 		std::vector<TextureInfo> textures;
 
+		StridedSpan<glm::vec3> positions = vertices.Attribute<glm::vec3>(VETEX_ATTRIBUTE_TYPE::POSITION);
+		StridedSpan<glm::vec3> normals = vertices.Attribute<glm::vec3>(VETEX_ATTRIBUTE_TYPE::NORMAL);
 		for (uint32_t i = 0; i < mesh->mNumVertices; i++) {
-
-			Vertex vertex;
-
-			glm::vec3 vector;
-			vector.x = mesh->mVertices[i].x;
-			vector.y = mesh->mVertices[i].y;
-			vector.z = mesh->mVertices[i].z;
-			vertex.SetPosition(vector);
-
-			vector.x = mesh->mNormals[i].x;
-			vector.y = mesh->mNormals[i].y;
-			vector.z = mesh->mNormals[i].z;
-			vertex.SetNormal(vector);
-
-			uint32_t index = 0;
-			glm::vec2 uv;
-			while (mesh->HasTextureCoords(index)) {
-				uv.y = mesh->mTextureCoords[index][i].y;
-				uv.x = mesh->mTextureCoords[index][i].x;
-				vertex.AddUV(uv);
-				index += 1;
-			}
-
-			index = 0;
-			glm::vec4 color;
-			while (mesh->HasVertexColors(index)) {
-				color.x = mesh->mColors[index][i].r;
-				color.y = mesh->mColors[index][i].g;
-				color.z = mesh->mColors[index][i].b;
-				color.w = mesh->mColors[index][i].a;
-				vertex.AddColor(color);
-				index += 1;
-			}
-
-			vertices.push_back(vertex);
+			positions[i] = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+			normals[i] = glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+		}
+		for (uint32_t c = 0; c < color_count; c++) {
+			StridedSpan<glm::vec4> colors = vertices.Attribute<glm::vec4>(VETEX_ATTRIBUTE_TYPE::COLOR, c);
+			for (uint32_t i = 0; i < mesh->mNumVertices; i++)
+				colors[i] = glm::vec4(mesh->mColors[c][i].r, mesh->mColors[c][i].g, mesh->mColors[c][i].b, mesh->mColors[c][i].a);
+		}
+		for (uint32_t t = 0; t < uv_count; t++) {
+			StridedSpan<glm::vec2> uvs = vertices.Attribute<glm::vec2>(VETEX_ATTRIBUTE_TYPE::UV, t);
+			for (uint32_t i = 0; i < mesh->mNumVertices; i++)
+				uvs[i] = glm::vec2(mesh->mTextureCoords[t][i].x, mesh->mTextureCoords[t][i].y);
 		}
 
+		//aiProcess_Triangulate leaves points and lines as they are, so faces are counted rather than assumed to be triangles
+		size_t index_count = 0;
+		for (uint32_t i = 0; i < mesh->mNumFaces; i++)
+			index_count += mesh->mFaces[i].mNumIndices;
+		indices.reserve(index_count);
 		for (uint32_t i = 0; i < mesh->mNumFaces; i++) {
-			aiFace face = mesh->mFaces[i];
-			for (uint32_t j = 0; j < face.mNumIndices; j++)
-				indices.push_back(face.mIndices[j]);
+			const aiFace& face = mesh->mFaces[i];
+			indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+		}
+
+		//Points and lines would be taken for triangles, only pure triangle meshes are optimized, simplified and clustered
+		std::vector<MeshLod> lods;
+		std::vector<Meshlet> meshlets;
+		if (mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE) {
+			MeshOptimizationResult result = MeshOptimizer::Optimize(vertices, indices);
+			optimization.before += result.before;
+			optimization.after += result.after;
+			lods = MeshSimplifier::GenerateLods(vertices, indices, lod_settings);
+			meshlets = MeshletBuilder::Build(vertices, indices, lods);
 		}
 
 		if (mesh->mMaterialIndex >= 0) {
@@ -157,23 +216,104 @@ namespace HoshioEngine {
 			textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
 		}
 
-		std::cout << std::format("Successfully load the mesh : {}\n",mesh->mName.C_Str());
-
-		return Mesh(vertices, indices, textures);
+		return Mesh(std::move(vertices), std::move(indices), std::move(textures), std::move(lods), std::move(meshlets));
 	}
 
-	std::vector<VertexInputAttribute> Model::GetVertexInputeAttributes()
+	std::pmr::vector<VertexInputAttribute> Model::GetVertexInputeAttributes(std::pmr::memory_resource* resource)
 	{
 		if (meshes.empty())
-			return std::vector<VertexInputAttribute>();
-		return meshes[0].GetVertexInputAttributes();
+			return std::pmr::vector<VertexInputAttribute>(resource);
+		return SharedVertexLayout().GetVertexInputAttributes(resource);
 	}
 
 	uint32_t Model::GetVertexInputAttributesStride()
 	{
 		if (meshes.empty())
 			return 0;
-		return meshes[0].GetVertexInputAttributeStride();
+		return SharedVertexLayout().Stride();
+	}
+
+	void Model::ResolveTextures()
+	{
+		std::vector<std::string> names;
+		for (auto& mesh : meshes)
+			for (auto& texture : mesh.textures)
+				names.push_back(texture.name);
+		PreloadTextures(names);
+		for (auto& mesh : meshes)
+			for (auto& texture : mesh.textures)
+				texture.id = VulkanPlus::Plus().GetTexture2D(texture.name).first;
+	}
+
+	void Model::QuantizeMeshes(VertexQuantization quantization)
+	{
+		//One box and one uv encoding for all meshes, so they keep sharing a layout
+		if (quantization.uvs == UV_QUANTIZATION::UNORM16 &&
+			!std::all_of(meshes.begin(), meshes.end(), [](const Mesh& mesh) { return VertexQuantizer::UVsInUnitRange(mesh.vertices); }))
+			quantization.uvs = UV_QUANTIZATION::HALF;
+		MeshBounds box = VertexQuantizer::QuantizationBox(Bounds());
+
+		size_t size_before = 0, size_after = 0;
+		VertexQuantizationError error;
+		for (auto& mesh : meshes) {
+			VertexStream quantized = VertexQuantizer::Quantize(mesh.vertices, quantization, box);
+			VertexQuantizationError mesh_error = VertexQuantizer::MeasureError(mesh.vertices, quantized, box);
+			error.position = std::max(error.position, mesh_error.position);
+			error.normal = std::max(error.normal, mesh_error.normal);
+			error.uv = std::max(error.uv, mesh_error.uv);
+			error.color = std::max(error.color, mesh_error.color);
+			size_before += mesh.vertices.DataSize();
+			size_after += quantized.DataSize();
+			mesh.vertices = std::move(quantized);
+		}
+		std::cout << std::format("Quantized : {} -> {} bytes of vertices, max error position {:.3g}, normal {:.3g} deg, uv {:.3g}, color {:.3g}\n",
+			size_before, size_after, error.position, glm::degrees(error.normal), error.uv, error.color);
+	}
+
+	glm::mat4 Model::PositionDequantization() const
+	{
+		if (meshes.empty())
+			return glm::mat4(1.f);
+		const VertexLayout& layout = SharedVertexLayout();
+		int32_t index = layout.Find(VETEX_ATTRIBUTE_TYPE::POSITION);
+		if (index < 0 || layout.Attribute(index).format == VK_FORMAT_R32G32B32_SFLOAT)
+			return glm::mat4(1.f);
+		return VertexQuantizer::PositionDequantization(VertexQuantizer::QuantizationBox(Bounds()));
+	}
+
+	size_t Model::SelectLods(const LodView& view, const glm::mat4& model_transform)
+	{
+		size_t triangle_count = 0;
+		for (auto& mesh : meshes) {
+			if (mesh.lods.empty())
+				continue;
+			mesh.lod = LodSelector::SelectLod(view, { mesh.lods.data(), mesh.lods.size() }, mesh.bounds, model_transform, mesh.lod);
+			triangle_count += mesh.lods[mesh.lod].indexCount / 3;
+		}
+		return triangle_count;
+	}
+
+	void Model::CullClusters(VkCommandBuffer commandBuffer, const CullView& view, const glm::mat4& model_transform)
+	{
+		for (auto& mesh : meshes)
+			mesh.CullClusters(commandBuffer, view, model_transform);
+	}
+
+	MeshBounds Model::Bounds() const
+	{
+		MeshBounds bounds;
+		for (auto& mesh : meshes)
+			bounds.Extend(mesh.bounds);
+		return bounds;
+	}
+
+	const VertexLayout& Model::SharedVertexLayout() const
+	{
+		const VertexLayout& layout = meshes[0].vertices.Layout();
+		for (size_t i = 1; i < meshes.size(); i++)
+			if (!(meshes[i].vertices.Layout() == layout))
+				throw std::runtime_error(std::format("[ Model ] ERROR::Mesh {} has a different vertex layout than mesh 0!", i));
+		return layout;
 	}
 
 	std::vector<TextureInfo> Model::LoadMaterialTextures(aiMaterial* mat, aiTextureType type, TEXTURE_TYPE type_enum)
@@ -184,14 +324,52 @@ namespace HoshioEngine {
 			aiString str;
 			mat->GetTexture(type, i, &str);
 			TextureInfo texture;
-			std::string texture_path = directory + "/" + std::string(str.C_Str());
-			if (VulkanPlus::Plus().HasTexture2D(std::string(str.C_Str())))
-				texture.id = VulkanPlus::Plus().GetTexture2D(std::string(str.C_Str())).first;
+			texture.name = str.C_Str();
+			std::string texture_path = directory + "/" + texture.name;
+			if (VulkanPlus::Plus().HasTexture2D(texture.name))
+				texture.id = VulkanPlus::Plus().GetTexture2D(texture.name).first;
 			else
-				texture.id = VulkanPlus::Plus().CreateTexture2D(std::string(str.C_Str()), texture_path.c_str(), VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM).first;
+				texture.id = VulkanPlus::Plus().CreateTexture2D(texture.name, texture_path.c_str(), VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM).first;
 			texture.type = type_enum;
-			textures.push_back(texture);
+			textures.push_back(std::move(texture));
 		}
 		return textures;
 	}
+
+	void Model::PreloadMaterialTextures(const aiScene* scene)
+	{
+		//Decode every texture the materials reference on worker threads up front, LoadMaterialTextures then only looks them up
+		std::vector<aiTextureType> types = { aiTextureType_DIFFUSE, aiTextureType_SPECULAR };
+		if (model_import_type == MODEL_IMPORT_TYPE::MODLE_TYPE_OBJ)
+			types.push_back(aiTextureType_HEIGHT);
+
+		std::vector<std::string> names;
+		for (uint32_t m = 0; m < scene->mNumMaterials; m++)
+			for (aiTextureType type : types)
+				for (uint32_t i = 0; i < scene->mMaterials[m]->GetTextureCount(type); i++) {
+					aiString str;
+					scene->mMaterials[m]->GetTexture(type, i, &str);
+					names.push_back(str.C_Str());
+				}
+		PreloadTextures(names);
+	}
+
+	void Model::PreloadTextures(std::vector<std::string>& names)
+	{
+		std::sort(names.begin(), names.end());
+		names.erase(std::unique(names.begin(), names.end()), names.end());
+		std::erase_if(names, [](const std::string& name) { return VulkanPlus::Plus().HasTexture2D(name); });
+		if (names.empty())
+			return;
+
+		std::vector<std::string> texture_paths;
+		for (auto& name : names)
+			texture_paths.push_back(directory + "/" + name);
+
+		std::vector<const char*> pPaths;
+		for (auto& texture_path : texture_paths)
+			pPaths.push_back(texture_path.c_str());
+		VulkanPlus::Plus().CreateTexture2Ds({ names.data(), names.size() }, { pPaths.data(), pPaths.size() },
+			VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM);
+	}
 }
\ No newline at end of file
@@ -1,175 +1,184 @@
 #include "Engine/Actor/Vertex.h"
 
 namespace HoshioEngine {
-	Vertex::Vertex(glm::vec3 position, glm::vec3 normal)
-		:position(position), normal(normal)
+
+#pragma region VertexLayout
+
+	VertexLayout::VertexLayout(VERTEX_STORAGE storage)
+		:storage(storage)
 	{
+	}
 
+	VertexLayout& VertexLayout::Add(VETEX_ATTRIBUTE_TYPE type, VkFormat format)
+	{
+		if (attributeCount == maxAttributeCount)
+			throw std::runtime_error(std::format("[ VertexLayout ] ERROR::No more than {} attributes!", maxAttributeCount));
+		bool interleaved = storage == VERTEX_STORAGE::INTERLEAVED;
+		attributes[attributeCount] = {
+			.location = attributeCount,
+			.binding = interleaved ? 0 : attributeCount,
+			.format = format,
+			.offset = interleaved ? vertexSize : 0,
+			.type = type
+		};
+		attributeCount++;
+		vertexSize += vkuFormatElementSize(format);
+		return *this;
 	}
 
-	const glm::vec3& Vertex::GetPosition() const {
-		return position;
+	VERTEX_STORAGE VertexLayout::Storage() const
+	{
+		return storage;
 	}
 
-	const glm::vec3& Vertex::GetNormal() const
+	uint32_t VertexLayout::AttributeCount() const
 	{
-		return normal;
+		return attributeCount;
 	}
 
-	const glm::vec2& Vertex::GetUV(uint32_t id) const
+	const VertexInputAttribute& VertexLayout::Attribute(uint32_t index) const
 	{
-		checkIndex(uvs, "uv", id);
-		return uvs[id];
+		return attributes[index];
 	}
 
-	const glm::vec4& Vertex::GetColor(uint32_t id) const
+	std::span<const VertexInputAttribute> VertexLayout::Attributes() const
 	{
-		checkIndex(colors, "color", id);
-		return colors[id];
+		return { attributes, attributeCount };
 	}
 
-	const float Vertex::GetValue(uint32_t id) const
+	uint32_t VertexLayout::AttributeSize(uint32_t index) const
 	{
-		checkIndex(values, "value", id);
-		return values[id];
+		return vkuFormatElementSize(attributes[index].format);
 	}
 
+	int32_t VertexLayout::Find(VETEX_ATTRIBUTE_TYPE type, uint32_t n) const
+	{
+		for (uint32_t i = 0; i < attributeCount; i++)
+			if (attributes[i].type == type && !n--)
+				return int32_t(i);
+		return -1;
+	}
 
-	void Vertex::SetPosition(glm::vec3 position)
+	uint32_t VertexLayout::Count(VETEX_ATTRIBUTE_TYPE type) const
 	{
-		this->position = position;
+		return uint32_t(std::count_if(attributes, attributes + attributeCount, [type](const VertexInputAttribute& attribute) { return attribute.type == type; }));
 	}
 
-	void Vertex::SetNormal(glm::vec3 normal)
+	uint32_t VertexLayout::BindingCount() const
 	{
-		this->normal = normal;
+		return storage == VERTEX_STORAGE::INTERLEAVED ? std::min(attributeCount, 1u) : attributeCount;
 	}
 
-	void Vertex::SetUV(uint32_t id, glm::vec2 uv)
+	uint32_t VertexLayout::Stride(uint32_t binding) const
 	{
-		checkIndex(uvs, "uv", id);
-		uvs[id] = uv;
+		return storage == VERTEX_STORAGE::INTERLEAVED ? vertexSize : AttributeSize(binding);
 	}
 
-	void Vertex::SetColor(uint32_t id, glm::vec4 color)
+	uint32_t VertexLayout::VertexSize() const
 	{
-		checkIndex(colors, "color", id);
-		colors[id] = color;
+		return vertexSize;
 	}
 
-	void Vertex::SetValue(uint32_t id, float value)
+	std::pmr::vector<VertexInputAttribute> VertexLayout::GetVertexInputAttributes(std::pmr::memory_resource* resource) const
 	{
-		checkIndex(values, "value", id);
-		values[id] = value;
+		return std::pmr::vector<VertexInputAttribute>(attributes, attributes + attributeCount, resource);
 	}
 
-	void Vertex::AddUV(glm::vec2 uv)
+	bool VertexLayout::operator==(const VertexLayout& other) const
 	{
-		uvs.push_back(uv);
+		return storage == other.storage && attributeCount == other.attributeCount &&
+			std::equal(attributes, attributes + attributeCount, other.attributes, [](const VertexInputAttribute& a, const VertexInputAttribute& b) {
+				return a.format == b.format && a.type == b.type;
+			});
 	}
 
-	void Vertex::AddColor(glm::vec4 color)
+#pragma endregion
+
+#pragma region VertexStream
+
+	VertexStream::VertexStream(const VertexLayout& layout, size_t vertexCount)
+		:layout(layout)
 	{
-		colors.push_back(color);
+		Resize(vertexCount);
 	}
 
-	void Vertex::AddValue(float value)
+	VertexStream::VertexStream(const VertexLayout& layout, size_t vertexCount, const uint8_t* pData)
+		:layout(layout), vertexCount(vertexCount), data(pData, pData + vertexCount * layout.VertexSize())
 	{
-		values.push_back(value);
 	}
 
-	size_t Vertex::GetUVCount() const
+	void VertexStream::Resize(size_t vertexCount)
 	{
-		return uvs.size();
+		if (vertexCount == this->vertexCount)
+			return;
+		//Interleaved vertices keep their place, separate arrays all move when the count changes
+		if (layout.Storage() == VERTEX_STORAGE::INTERLEAVED || this->vertexCount == 0)
+			data.resize(vertexCount * layout.VertexSize());
+		else {
+			std::vector<uint8_t> resized(vertexCount * layout.VertexSize());
+			size_t keptCount = std::min(vertexCount, this->vertexCount);
+			for (uint32_t i = 0, offset_old = 0, offset_new = 0; i < layout.AttributeCount(); i++) {
+				size_t attributeSize = layout.AttributeSize(i);
+				memcpy(resized.data() + offset_new, data.data() + offset_old, attributeSize * keptCount);
+				offset_old += attributeSize * this->vertexCount;
+				offset_new += attributeSize * vertexCount;
+			}
+			data = std::move(resized);
+		}
+		this->vertexCount = vertexCount;
 	}
 
-	size_t Vertex::GetColorCount() const
+	const VertexLayout& VertexStream::Layout() const
 	{
-		return colors.size();
+		return layout;
 	}
 
-	size_t Vertex::GetValueCount() const
+	size_t VertexStream::VertexCount() const
 	{
-		return values.size();
+		return vertexCount;
 	}
 
-	uint32_t Vertex::GetVertexInputAttributeStride()
+	bool VertexStream::Empty() const
 	{
-		//cal the stride of the group attribute of a vertex (Byte)
-		return (3 + 3 + 4 * colors.size() + 2 * uvs.size() + values.size()) * sizeof(float);
+		return !vertexCount;
 	}
 
-	uint32_t Vertex::GetVertexInputAttributeCount()
+	uint8_t* VertexStream::Data()
 	{
-		return 2 + colors.size() + uvs.size() + values.size();
+		return data.data();
 	}
 
-	uint32_t Vertex::GetVertexInputAttributeFloatCount()
+	const uint8_t* VertexStream::Data() const
 	{
-		return 3 + 3 + 4 * colors.size() + 2 * uvs.size() + values.size();
+		return data.data();
 	}
 
-	std::vector<VertexInputAttribute> Vertex::GetVertexInputAttributes()
+	size_t VertexStream::DataSize() const
 	{
-		std::vector<VertexInputAttribute> vertex_inpute_attributes;
+		return data.size();
+	}
 
-		uint32_t location = 0;
-		uint32_t offset = 0;
+	size_t VertexStream::BindingOffset(uint32_t binding) const
+	{
+		if (layout.Storage() == VERTEX_STORAGE::INTERLEAVED)
+			return 0;
+		size_t offset = 0;
+		for (uint32_t i = 0; i < binding; i++)
+			offset += layout.AttributeSize(i) * vertexCount;
+		return offset;
+	}
 
-		//position
-		VertexInputAttribute attribute = {
-			.location = location,
-			.binding = 0,
-			.format = VK_FORMAT_R32G32B32_SFLOAT,
-			.offset = offset,
-			.type = VETEX_ATTRIBUTE_TYPE::POSITION
-			
-		};
-		vertex_inpute_attributes.push_back(attribute);
-		location += 1;
-		offset += 3 * sizeof(float);
-
-		//normal
-		attribute.location = location;
-		attribute.offset = offset;
-		attribute.type =  VETEX_ATTRIBUTE_TYPE::NORMAL;
-		vertex_inpute_attributes.push_back(attribute);
-		location += 1;
-		offset += 3 * sizeof(float);
-
-		//color
-		attribute.type = VETEX_ATTRIBUTE_TYPE::COLOR;
-		for (size_t i = 0; i < colors.size(); i++) {
-			attribute.location = location;
-			attribute.offset = offset;
-			attribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
-			vertex_inpute_attributes.push_back(attribute);
-			location += 1;
-			offset += 4 * sizeof(float);
+	uint8_t* VertexStream::AttributeAddress(uint32_t index, size_t& stride) const
+	{
+		uint8_t* pData = const_cast<uint8_t*>(data.data());
+		if (layout.Storage() == VERTEX_STORAGE::INTERLEAVED) {
+			stride = layout.VertexSize();
+			return pData + layout.Attribute(index).offset;
 		}
+		stride = layout.AttributeSize(index);
+		return pData + BindingOffset(index);
+	}
 
-		//uvs
-		attribute.type = VETEX_ATTRIBUTE_TYPE::UV;
-		for (size_t i = 0; i < uvs.size(); i++) {
-			attribute.location = location;
-			attribute.offset = offset;
-			attribute.format = VK_FORMAT_R32G32_SFLOAT;
-			vertex_inpute_attributes.push_back(attribute);
-			location += 1;
-			offset += 2 * sizeof(float);
-		}
+#pragma endregion
 
-		//values
-		attribute.type = VETEX_ATTRIBUTE_TYPE::VALUE;
-		for (size_t i = 0; i < values.size(); i++) {
-			attribute.location = location;
-			attribute.offset = offset;
-			attribute.format = VK_FORMAT_R32_SFLOAT;
-			vertex_inpute_attributes.push_back(attribute);
-			location += 1;
-			offset += sizeof(float);
-		}
-		
-		return vertex_inpute_attributes;
-	}
 }
@@ -0,0 +1,221 @@
+#include "Engine/Actor/VertexQuantizer.h"
+#include "Engine/Actor/VertexFormat.h"
+
+namespace HoshioEngine {
+
+	namespace {
+		//First byte of attribute index and the distance between two vertices, for either storage
+		const uint8_t* AttributeBytes(const VertexStream& vertices, uint32_t index, size_t& stride) {
+			const VertexLayout& layout = vertices.Layout();
+			if (layout.Storage() == VERTEX_STORAGE::INTERLEAVED) {
+				stride = layout.VertexSize();
+				return vertices.Data() + layout.Attribute(index).offset;
+			}
+			stride = layout.AttributeSize(index);
+			return vertices.Data() + vertices.BindingOffset(index);
+		}
+
+		//What the vertex fetch hands to the shader, missing components read 0
+		glm::vec4 Fetch(const uint8_t* pData, VkFormat format) {
+			glm::vec4 value(0.f);
+			switch (format) {
+			case VK_FORMAT_R32_SFLOAT:
+			case VK_FORMAT_R32G32_SFLOAT:
+			case VK_FORMAT_R32G32B32_SFLOAT:
+			case VK_FORMAT_R32G32B32A32_SFLOAT:
+				memcpy(&value, pData, vkuFormatElementSize(format));
+				break;
+			case VK_FORMAT_R16G16_SNORM: {
+				int16_t encoded[2];
+				memcpy(encoded, pData, sizeof encoded);
+				value.x = std::max(encoded[0] / 32767.f, -1.f), value.y = std::max(encoded[1] / 32767.f, -1.f);
+				break;
+			}
+			case VK_FORMAT_R16G16_SFLOAT: {
+				uint32_t encoded;
+				memcpy(&encoded, pData, sizeof encoded);
+				glm::vec2 decoded = glm::unpackHalf2x16(encoded);
+				value.x = decoded.x, value.y = decoded.y;
+				break;
+			}
+			case VK_FORMAT_R16G16_UNORM:
+			case VK_FORMAT_R16G16B16A16_UNORM: {
+				uint16_t encoded[4] = {};
+				memcpy(encoded, pData, vkuFormatElementSize(format));
+				for (uint32_t i = 0; i < vkuFormatComponentCount(format); i++)
+					value[i] = encoded[i] / 65535.f;
+				break;
+			}
+			case VK_FORMAT_R8G8B8A8_UNORM:
+				for (uint32_t i = 0; i < 4; i++)
+					value[i] = pData[i] / 255.f;
+				break;
+			default:
+				throw std::runtime_error(std::format("[ VertexQuantizer ] ERROR::Cannot decode {}!", magic_enum::enum_name(format)));
+			}
+			return value;
+		}
+
+		//Same as OctDecode() in res/shaders/GLSL/VertexDecode.glsl
+		glm::vec3 OctDecode(glm::vec2 e) {
+			glm::vec3 n(e, 1.f - std::abs(e.x) - std::abs(e.y));
+			float t = std::max(-n.z, 0.f);
+			n.x += n.x >= 0.f ? -t : t;
+			n.y += n.y >= 0.f ? -t : t;
+			return glm::normalize(n);
+		}
+
+		//Source is how the attribute is stored now, transform turns it into what Element encodes
+		template<typename Element, typename Source = typename Element::Source>
+		void Encode(const VertexStream& source, uint32_t index, VertexStream& result, auto&& transform) {
+			StridedSpan<const Source> src = source.Attribute<Source>(index);
+			StridedSpan<typename Element::Storage> dst = result.Attribute<typename Element::Storage>(index);
+			for (size_t i = 0; i < src.size(); i++)
+				dst[i] = Element::Encode(transform(src[i]));
+		}
+	}
+
+	MeshBounds VertexQuantizer::QuantizationBox(const MeshBounds& bounds)
+	{
+		if (bounds.Empty())
+			return { glm::vec3(0.f), glm::vec3(1.f) };
+		glm::vec3 extent = bounds.Extent();
+		float halfEdge = std::max(std::max(extent.x, std::max(extent.y, extent.z)) * 0.5f, 1e-6f);
+		glm::vec3 center = bounds.Center();
+		return { center - halfEdge, center + halfEdge };
+	}
+
+	glm::mat4 VertexQuantizer::PositionDequantization(const MeshBounds& box)
+	{
+		return glm::scale(glm::translate(glm::mat4(1.f), box.min), glm::vec3(box.max.x - box.min.x));
+	}
+
+	bool VertexQuantizer::UVsInUnitRange(const VertexStream& vertices)
+	{
+		const VertexLayout& layout = vertices.Layout();
+		for (uint32_t a = 0; a < layout.AttributeCount(); a++) {
+			if (layout.Attribute(a).type != VETEX_ATTRIBUTE_TYPE::UV || layout.Attribute(a).format != VK_FORMAT_R32G32_SFLOAT)
+				continue;
+			StridedSpan<const glm::vec2> uvs = vertices.Attribute<glm::vec2>(a);
+			for (size_t i = 0; i < uvs.size(); i++)
+				if (uvs[i].x < 0.f || uvs[i].x > 1.f || uvs[i].y < 0.f || uvs[i].y > 1.f)
+					return false;
+		}
+		return true;
+	}
+
+	VertexLayout VertexQuantizer::QuantizedLayout(const VertexLayout& layout, const VertexQuantization& quantization)
+	{
+		VertexLayout result(layout.Storage());
+		for (const VertexInputAttribute& attribute : layout.Attributes()) {
+			VkFormat format = attribute.format;
+			switch (attribute.type) {
+			case VETEX_ATTRIBUTE_TYPE::POSITION:
+				if (quantization.positions && format == VK_FORMAT_R32G32B32_SFLOAT)
+					format = VertexElements::unorm16x4::format;
+				break;
+			case VETEX_ATTRIBUTE_TYPE::NORMAL:
+				if (quantization.normals && format == VK_FORMAT_R32G32B32_SFLOAT)
+					format = VertexElements::oct16::format;
+				break;
+			case VETEX_ATTRIBUTE_TYPE::UV:
+				if (quantization.uvs != UV_QUANTIZATION::NONE && format == VK_FORMAT_R32G32_SFLOAT)
+					format = quantization.uvs == UV_QUANTIZATION::HALF ? VertexElements::f16x2::format : VertexElements::unorm16x2::format;
+				break;
+			case VETEX_ATTRIBUTE_TYPE::COLOR:
+				if (quantization.colors && format == VK_FORMAT_R32G32B32A32_SFLOAT)
+					format = VertexElements::unorm8x4::format;
+				break;
+			default:
+				break;
+			}
+			result.Add(attribute.type, format);
+		}
+		return result;
+	}
+
+	VertexStream VertexQuantizer::Quantize(const VertexStream& vertices, const VertexQuantization& quantization, const MeshBounds& box)
+	{
+		const VertexLayout& layout = vertices.Layout();
+		VertexStream result(QuantizedLayout(layout, quantization), vertices.VertexCount());
+		glm::vec3 boxMin = box.min;
+		float inverseEdge = 1.f / (box.max.x - box.min.x);
+		for (uint32_t a = 0; a < layout.AttributeCount(); a++) {
+			VkFormat format = result.Layout().Attribute(a).format;
+			if (format == layout.Attribute(a).format) {
+				size_t srcStride, dstStride;
+				const uint8_t* pSrc = AttributeBytes(vertices, a, srcStride);
+				uint8_t* pDst = const_cast<uint8_t*>(AttributeBytes(result, a, dstStride));
+				for (size_t i = 0; i < vertices.VertexCount(); i++)
+					memcpy(pDst + i * dstStride, pSrc + i * srcStride, layout.AttributeSize(a));
+				continue;
+			}
+			auto Same = [](const auto& value) { return value; };
+			switch (format) {
+			case VertexElements::unorm16x4::format:
+				Encode<VertexElements::unorm16x4, glm::vec3>(vertices, a, result,
+					[&](const glm::vec3& position) { return glm::vec4((position - boxMin) * inverseEdge, 1.f); });
+				break;
+			case VertexElements::oct16::format:
+				Encode<VertexElements::oct16>(vertices, a, result, Same);
+				break;
+			case VertexElements::f16x2::format:
+				Encode<VertexElements::f16x2>(vertices, a, result, Same);
+				break;
+			case VertexElements::unorm16x2::format:
+				Encode<VertexElements::unorm16x2>(vertices, a, result, Same);
+				break;
+			case VertexElements::unorm8x4::format:
+				Encode<VertexElements::unorm8x4>(vertices, a, result, Same);
+				break;
+			default:
+				break;
+			}
+		}
+		return result;
+	}
+
+	VertexQuantizationError VertexQuantizer::MeasureError(const VertexStream& original, const VertexStream& quantized, const MeshBounds& box)
+	{
+		VertexQuantizationError error;
+		const VertexLayout& layout = original.Layout();
+		glm::mat4 dequantization = PositionDequantization(box);
+		for (uint32_t a = 0; a < layout.AttributeCount(); a++) {
+			VkFormat originalFormat = layout.Attribute(a).format;
+			VkFormat quantizedFormat = quantized.Layout().Attribute(a).format;
+			size_t originalStride, quantizedStride;
+			const uint8_t* pOriginal = AttributeBytes(original, a, originalStride);
+			const uint8_t* pQuantized = AttributeBytes(quantized, a, quantizedStride);
+			for (size_t i = 0; i < original.VertexCount(); i++) {
+				glm::vec4 expected = Fetch(pOriginal + i * originalStride, originalFormat);
+				glm::vec4 decoded = Fetch(pQuantized + i * quantizedStride, quantizedFormat);
+				switch (layout.Attribute(a).type) {
+				case VETEX_ATTRIBUTE_TYPE::POSITION:
+					if (quantizedFormat == VertexElements::unorm16x4::format)
+						decoded = dequantization * glm::vec4(glm::vec3(decoded), 1.f);
+					error.position = std::max(error.position, glm::length(glm::vec3(decoded) - glm::vec3(expected)));
+					break;
+				case VETEX_ATTRIBUTE_TYPE::NORMAL: {
+					glm::vec3 normal = quantizedFormat == VertexElements::oct16::format ? OctDecode(glm::vec2(decoded)) : glm::normalize(glm::vec3(decoded));
+					float cosine = glm::clamp(glm::dot(normal, glm::normalize(glm::vec3(expected))), -1.f, 1.f);
+					error.normal = std::max(error.normal, std::acos(cosine));
+					break;
+				}
+				case VETEX_ATTRIBUTE_TYPE::UV: {
+					glm::vec2 difference = glm::abs(glm::vec2(decoded) - glm::vec2(expected));
+					error.uv = std::max(error.uv, std::max(difference.x, difference.y));
+					break;
+				}
+				case VETEX_ATTRIBUTE_TYPE::COLOR: {
+					glm::vec4 difference = glm::abs(decoded - glm::clamp(expected, 0.f, 1.f));
+					error.color = std::max(error.color, std::max(std::max(difference.x, difference.y), std::max(difference.z, difference.w)));
+					break;
+				}
+				default:
+					break;
+				}
+			}
+		}
+		return error;
+	}
+}
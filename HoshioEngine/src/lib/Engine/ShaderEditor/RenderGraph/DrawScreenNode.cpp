@@ -14,6 +14,10 @@ namespace HoshioEngine {
 		case TexturePicker::TextureMode::TEXTURE_MODE:
 			descriptorSet.Write(texturePicker.texture->DescriptorImageInfo(sampler), VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
 			break;
+		case TexturePicker::TextureMode::STREAMED_TEXTURE_MODE:
+			//Written now and again by the streamer whenever the texture's view changes
+			VulkanPlus::Plus().TextureStreaming().BindDescriptor(texturePicker.streamedTexture, descriptorSet, sampler, 0);
+			break;
 		default:
 			break;
 		}
@@ -22,7 +26,12 @@ namespace HoshioEngine {
 	void DrawScreenNode::RecordCommandBuffer()
 	{
 		const CommandBuffer& commandBuffer = VulkanPlus::Plus().CommandBuffer_Graphics();
-		VulkanPlus::Plus().SwapchainRenderPass().Begin(commandBuffer, VulkanPlus::Plus().CurrentSwapchainFramebuffer(), { {},VulkanBase::Base().SwapchainCi().imageExtent }, { {1.0f} });
+		//The texture is stretched over the whole swapchain, its longer side covers about the longer side of the screen
+		if (texturePicker.textureMode == TexturePicker::TextureMode::STREAMED_TEXTURE_MODE) {
+			VkExtent2D extent = VulkanBase::Base().SwapchainCi().imageExtent;
+			VulkanPlus::Plus().TextureStreaming().RequestScreenSize(texturePicker.streamedTexture, float(std::max(extent.width, extent.height)));
+		}
+		VulkanPlus::Plus().BeginSwapchainRenderPass(commandBuffer, false, { {},VulkanBase::Base().SwapchainCi().imageExtent }, { {1.0f} });
 		VkDeviceSize offset = 0;
 		vkCmdBindVertexBuffers(commandBuffer, 0, 1, VulkanPlus::Plus().DefaultVertexBuffer().Address(), &offset);
 		vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, 8, &pushConstant);
@@ -50,6 +59,17 @@ namespace HoshioEngine {
 		SetSampledImage(&texture);
 	}
 
+	DrawScreenNode::DrawScreenNode(VkSampler sampler, int streamedTextureID):sampler(sampler)
+	{
+		SetStreamedImage(streamedTextureID);
+	}
+
+	DrawScreenNode::~DrawScreenNode()
+	{
+		if (texturePicker.textureMode == TexturePicker::TextureMode::STREAMED_TEXTURE_MODE)
+			VulkanPlus::Plus().TextureStreaming().UnbindDescriptors(descriptorSet);
+	}
+
 	uint32_t DrawScreenNode::TextureMaxLevel() const
 	{
 		switch (texturePicker.textureMode)
@@ -63,6 +83,12 @@ namespace HoshioEngine {
 		case TexturePicker::TextureMode::TEXTURE_MODE:
 			return texturePicker.texture->MipLevelCount() - 1;
 			break;
+		case TexturePicker::TextureMode::STREAMED_TEXTURE_MODE:
+		{
+			//The view starts at the finest resident level
+			StreamedTexture2D& texture = VulkanPlus::Plus().TextureStreaming().GetStreamedTexture2D(texturePicker.streamedTexture).second[0];
+			return texture.MipLevelCount() - texture.ResidentMip() - 1;
+		}
 		default:
 			return 0;
 			break;
@@ -90,6 +116,14 @@ namespace HoshioEngine {
 		texturePicker.textureMode = TexturePicker::TextureMode::TEXTURE_MODE;
 	}
 
+	void DrawScreenNode::SetStreamedImage(int streamedTextureID)
+	{
+		if (!VulkanPlus::Plus().TextureStreaming().HasStreamedTexture2D(streamedTextureID))
+			return;
+		texturePicker.streamedTexture = streamedTextureID;
+		texturePicker.textureMode = TexturePicker::TextureMode::STREAMED_TEXTURE_MODE;
+	}
+
 	void DrawScreenNode::SendDataToNextNode()
 	{
 	}
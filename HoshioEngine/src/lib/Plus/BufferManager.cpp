@@ -23,12 +23,14 @@ namespace HoshioEngine {
 	}
 	void StagingBuffer::RetrieveData(void* pData_src, VkDeviceSize size) const
 	{
-		bufferMemory.RetrieveData(pData_src, size);
+		bufferMemory.InvalidateMemory(size);
+		memcpy(pData_src, pData_mapped, size_t(size));
 	}
 	void StagingBuffer::SynchronizeData(const void* pData_src, VkDeviceSize size)
 	{
 		Expand(size);
-		bufferMemory.SynchronizeData(pData_src, size);
+		memcpy(pData_mapped, pData_src, size_t(size));
+		bufferMemory.FlushMemory(size);
 	}
 	void StagingBuffer::Expand(VkDeviceSize size)
 	{
@@ -40,22 +42,25 @@ namespace HoshioEngine {
 			.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT
 		};
 		bufferMemory.Create(createInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+		bufferMemory.MapMemory(pData_mapped, AllocationSize());
 	}
 	void StagingBuffer::Release()
 	{
+		if (pData_mapped)
+			vkUnmapMemory(VulkanBase::Base().Device(), bufferMemory.DeviceMemory()),
+			pData_mapped = nullptr;
 		bufferMemory.~BufferMemory();
 	}
 	void* StagingBuffer::MapMemory(VkDeviceSize size)
 	{
 		Expand(size);
-		void* pData_dst = nullptr;
-		bufferMemory.MapMemory(pData_dst, size);
 		memorySize = size;
-		return pData_dst;
+		return pData_mapped;
 	}
 	void StagingBuffer::UnMapMemory()
 	{
-		bufferMemory.UnMapMemory(memorySize);
+		//Nothing is unmapped, the written range only has to be made visible to the device
+		bufferMemory.FlushMemory(memorySize);
 		memorySize = 0;
 	}
 	VkImage StagingBuffer::AliasedImage2D(VkFormat format, VkExtent2D extent)
@@ -216,6 +221,18 @@ namespace HoshioEngine {
 		VulkanPlus::Plus().ExecuteCommandBuffer_Graphics(commandBuffer);
 	}
 
+	bool DeviceLocalBuffer::CmdTransferData(VkCommandBuffer commandBuffer, StagingBuffer& stagingBuffer, const void* pData_src, VkDeviceSize size, VkDeviceSize offset) const
+	{
+		if (bufferMemory.MemoryPropertyFlags() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+			bufferMemory.SynchronizeData(pData_src, size, offset);
+			return false;
+		}
+		stagingBuffer.SynchronizeData(pData_src, size);
+		VkBufferCopy region = { 0, offset, size };
+		vkCmdCopyBuffer(commandBuffer, stagingBuffer, bufferMemory.Buffer(), 1, &region);
+		return true;
+	}
+
 	void DeviceLocalBuffer::Create(VkDeviceSize size, VkBufferUsageFlags desiredUsages_without_transfer_dst)
 	{
 		VkBufferCreateInfo createInfo = {
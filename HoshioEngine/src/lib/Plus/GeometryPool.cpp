@@ -0,0 +1,155 @@
+#include "Plus/GeometryPool.h"
+
+namespace HoshioEngine {
+
+#pragma region Allocation
+
+	GeometryPool::Allocation::Allocation(Allocation&& other) noexcept
+		:vertexBlock(other.vertexBlock), firstVertex(other.firstVertex), vertexCount(other.vertexCount),
+		indexBlock(other.indexBlock), firstIndex(other.firstIndex), indexCount(other.indexCount)
+	{
+		other.vertexBlock = other.indexBlock = noBlock;
+	}
+
+	GeometryPool::Allocation& GeometryPool::Allocation::operator=(Allocation&& other) noexcept
+	{
+		if (this != &other) {
+			GeometryPool::Pool().Free(*this);
+			vertexBlock = other.vertexBlock, firstVertex = other.firstVertex, vertexCount = other.vertexCount;
+			indexBlock = other.indexBlock, firstIndex = other.firstIndex, indexCount = other.indexCount;
+			other.vertexBlock = other.indexBlock = noBlock;
+		}
+		return *this;
+	}
+
+	GeometryPool::Allocation::~Allocation()
+	{
+		if (!Empty())
+			GeometryPool::Pool().Free(*this);
+	}
+
+	VkBuffer GeometryPool::Allocation::VertexBuffer() const
+	{
+		return vertexBlock == noBlock ? VK_NULL_HANDLE : VkBuffer(GeometryPool::Pool().vertexBlocks[vertexBlock].buffer);
+	}
+
+	VkBuffer GeometryPool::Allocation::IndexBuffer() const
+	{
+		return indexBlock == noBlock ? VK_NULL_HANDLE : VkBuffer(GeometryPool::Pool().indexBlocks[indexBlock].buffer);
+	}
+
+#pragma endregion
+
+#pragma region GeometryPool
+
+	GeometryPool& GeometryPool::Pool()
+	{
+		static GeometryPool pool;
+		return pool;
+	}
+
+	VkDeviceSize GeometryPool::BlockSize() const
+	{
+		return blockSize;
+	}
+
+	void GeometryPool::SetBlockSize(VkDeviceSize size)
+	{
+		blockSize = std::max(size, VkDeviceSize(1) << 16);
+	}
+
+	GeometryPool::Allocation GeometryPool::Allocate(const void* pVertices, uint32_t vertexCount, uint32_t stride, ArrayRef<const uint32_t> indices)
+	{
+		Allocation allocation;
+		if (vertexCount && stride) {
+			uint32_t block = 0, offset = RangeAllocator::invalidOffset;
+			for (; block < vertexBlocks.size(); block++)
+				if (vertexBlocks[block].stride == stride &&
+					(offset = vertexBlocks[block].ranges.Allocate(vertexCount)) != RangeAllocator::invalidOffset)
+					break;
+			if (block == vertexBlocks.size()) {
+				//Sized in whole vertices, vertexOffset cannot address anything else
+				uint32_t capacity = uint32_t(std::min<VkDeviceSize>(std::max<VkDeviceSize>(blockSize / stride, vertexCount), std::numeric_limits<int32_t>::max()));
+				VertexBlock& vertexBlock = vertexBlocks.emplace_back();
+				vertexBlock.buffer.Create(VkDeviceSize(capacity) * stride);
+				vertexBlock.ranges.Reset(capacity);
+				vertexBlock.stride = stride;
+				offset = vertexBlock.ranges.Allocate(vertexCount);
+			}
+			vertexBlocks[block].buffer.TransferData(pVertices, VkDeviceSize(vertexCount) * stride, VkDeviceSize(offset) * stride);
+			allocation.vertexBlock = block, allocation.firstVertex = offset, allocation.vertexCount = vertexCount;
+		}
+		if (indices.size()) {
+			uint32_t indexCount = uint32_t(indices.size());
+			uint32_t block = 0, offset = RangeAllocator::invalidOffset;
+			for (; block < indexBlocks.size(); block++)
+				if ((offset = indexBlocks[block].ranges.Allocate(indexCount)) != RangeAllocator::invalidOffset)
+					break;
+			if (block == indexBlocks.size()) {
+				uint32_t capacity = uint32_t(std::max<VkDeviceSize>(blockSize / sizeof(uint32_t), indexCount));
+				IndexBlock& indexBlock = indexBlocks.emplace_back();
+				indexBlock.buffer.Create(VkDeviceSize(capacity) * sizeof(uint32_t));
+				indexBlock.ranges.Reset(capacity);
+				offset = indexBlock.ranges.Allocate(indexCount);
+			}
+			indexBlocks[block].buffer.TransferData(indices.data(), VkDeviceSize(indexCount) * sizeof(uint32_t), VkDeviceSize(offset) * sizeof(uint32_t));
+			allocation.indexBlock = block, allocation.firstIndex = offset, allocation.indexCount = indexCount;
+		}
+		return allocation;
+	}
+
+	void GeometryPool::Free(Allocation& allocation)
+	{
+		//Allocate() writes straight into a reused range, so it waits for the fence of the frame that may still read it
+		if (!allocation.Empty())
+			retiredRanges.push_back({
+				allocation.vertexBlock, allocation.firstVertex, allocation.vertexCount,
+				allocation.indexBlock, allocation.firstIndex, allocation.indexCount });
+		allocation.vertexBlock = allocation.indexBlock = Allocation::noBlock;
+	}
+
+	void GeometryPool::ReleaseRetired()
+	{
+		//Blocks are never given back, an emptied block is reused by the next allocation of its stride
+		for (const RetiredRanges& retired : retiredRanges) {
+			if (retired.vertexBlock != Allocation::noBlock)
+				vertexBlocks[retired.vertexBlock].ranges.Free(retired.firstVertex, retired.vertexCount);
+			if (retired.indexBlock != Allocation::noBlock)
+				indexBlocks[retired.indexBlock].ranges.Free(retired.firstIndex, retired.indexCount);
+		}
+		retiredRanges.clear();
+	}
+
+	uint32_t GeometryPool::VertexBlockCount() const
+	{
+		return uint32_t(vertexBlocks.size());
+	}
+
+	uint32_t GeometryPool::IndexBlockCount() const
+	{
+		return uint32_t(indexBlocks.size());
+	}
+
+	VkDeviceSize GeometryPool::UsedSize() const
+	{
+		VkDeviceSize size = 0;
+		for (auto& block : vertexBlocks)
+			size += VkDeviceSize(block.ranges.Capacity() - block.ranges.FreeSize()) * block.stride;
+		for (auto& block : indexBlocks)
+			size += VkDeviceSize(block.ranges.Capacity() - block.ranges.FreeSize()) * sizeof(uint32_t);
+		return size;
+	}
+
+	VkDeviceSize GeometryPool::CapacitySize() const
+	{
+		VkDeviceSize size = 0;
+		for (auto& block : vertexBlocks)
+			size += VkDeviceSize(block.ranges.Capacity()) * block.stride;
+		for (auto& block : indexBlocks)
+			size += VkDeviceSize(block.ranges.Capacity()) * sizeof(uint32_t);
+		return size;
+	}
+
+#pragma endregion
+
+}
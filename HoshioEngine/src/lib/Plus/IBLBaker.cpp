@@ -0,0 +1,410 @@
+#include "Plus/IBLBaker.h"
+#include "Plus/VulkanPlus.h"
+#include "Plus/MipGenerator.h"
+#include "Base/ShaderCompiler.h"
+#include "Utils/ImageUtils.h"
+#include "Utils/MappedFile.h"
+
+namespace HoshioEngine {
+
+	namespace {
+		constexpr const char* equirectToCubeShaderPath = "res/shaders/GLSL/IBLEquirectToCube.comp";
+		constexpr const char* irradianceShaderPath = "res/shaders/GLSL/IBLIrradiance.comp";
+		constexpr const char* prefilterShaderPath = "res/shaders/GLSL/IBLPrefilter.comp";
+		constexpr const char* brdfLutShaderPath = "res/shaders/GLSL/IBLBrdfLut.comp";
+
+		constexpr VkFormat cubeFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+		constexpr VkFormat brdfLutFormat = VK_FORMAT_R32G32_SFLOAT;
+		//Both formats above
+		constexpr VkDeviceSize texelSize = 8;
+		constexpr uint32_t groupExtent = 8;
+
+		constexpr uint32_t cacheMagic = 0x4C424948;	//"HIBL"
+		//Bump whenever the shaders change what they produce, old cache files are then ignored
+		//2: 8 bit environments are sampled through sRGB views
+		constexpr uint32_t cacheVersion = 2;
+
+		struct CacheHeader {
+			uint32_t magic;
+			uint32_t version;
+			uint64_t hash;
+			uint64_t dataSize;
+		};
+
+		struct PushConstants {
+			float roughness;
+			uint32_t sampleCount;
+		};
+
+		enum TARGET : uint32_t {
+			IRRADIANCE,
+			PREFILTERED,
+			BRDF_LUT
+		};
+
+		//Where every level of every target sits in the cache payload, the same layout is used for readback
+		struct CacheRegion {
+			TARGET target;
+			uint32_t mipLevel;
+			uint32_t extent;
+			uint32_t layerCount;
+			VkDeviceSize offset;
+		};
+
+		std::vector<CacheRegion> CacheRegions(const IBLSettings& settings, VkDeviceSize& dataSize) {
+			std::vector<CacheRegion> regions;
+			dataSize = 0;
+			auto Add = [&](TARGET target, uint32_t mipLevel, uint32_t extent, uint32_t layerCount) {
+				regions.push_back({ target, mipLevel, extent, layerCount, dataSize });
+				dataSize += texelSize * extent * extent * layerCount;
+				};
+			Add(IRRADIANCE, 0, settings.irradianceExtent, 6);
+			for (uint32_t i = 0; i < settings.prefilteredMipCount; i++)
+				Add(PREFILTERED, i, std::max(settings.prefilteredExtent >> i, 1u), 6);
+			Add(BRDF_LUT, 0, settings.brdfLutExtent, 1);
+			return regions;
+		}
+
+		IBLTexture& Target(IBLMaps& maps, TARGET target) {
+			IBLTexture* targets[] = { &maps.irradiance, &maps.prefiltered, &maps.brdfLut };
+			return *targets[target];
+		}
+	}
+
+#pragma region IBLTexture
+
+	VkExtent2D IBLTexture::Extent() const
+	{
+		return extent;
+	}
+
+	uint32_t IBLTexture::MipLevelCount() const
+	{
+		return mipLevelCount;
+	}
+
+#pragma endregion
+
+#pragma region IBLBaker
+
+	IBLBaker& IBLBaker::Baker()
+	{
+		static IBLBaker baker;
+		return baker;
+	}
+
+	const std::filesystem::path& IBLBaker::CacheDirectory() const
+	{
+		return cacheDirectory;
+	}
+
+	void IBLBaker::SetCacheDirectory(std::filesystem::path directory)
+	{
+		cacheDirectory = std::move(directory);
+	}
+
+	uint64_t IBLBaker::HashFiles(ArrayRef<const char* const> filePaths)
+	{
+		uint64_t hash = HashBytes(nullptr, 0);
+		for (const char* filePath : filePaths) {
+			MappedFile file(filePath);
+			hash = HashBytes(file.Data(), file.Size(), hash);
+		}
+		return hash;
+	}
+
+	void IBLBaker::CreateLayouts()
+	{
+		VkDescriptorSetLayoutBinding bindings[] = {
+			{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT }
+		};
+		VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
+			.bindingCount = uint32_t(std::size(bindings)),
+			.pBindings = bindings
+		};
+		descriptorSetLayout.Create(descriptorSetLayoutCreateInfo);
+
+		VkPushConstantRange pushConstantRange = { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants) };
+		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
+			.setLayoutCount = 1,
+			.pSetLayouts = descriptorSetLayout.Address(),
+			.pushConstantRangeCount = 1,
+			.pPushConstantRanges = &pushConstantRange
+		};
+		pipelineLayout.Create(pipelineLayoutCreateInfo);
+
+		//Cube sampling ignores the address mode, the panorama gets its own sampler
+		sampler = VulkanPlus::Plus().AcquireSampler(Sampler::SamplerCreateInfo()).second[0];
+	}
+
+	VkPipeline IBLBaker::AcquirePipeline(const char* shaderPath)
+	{
+		if (descriptorSetLayout == VK_NULL_HANDLE)
+			CreateLayouts();
+		if (auto iter = mPipelines.find(shaderPath); iter != mPipelines.end())
+			return iter->second;
+
+		ShaderBinary binary = ShaderCompiler::Compiler().Compile({ .filePath = shaderPath, .stage = VK_SHADER_STAGE_COMPUTE_BIT });
+		ShaderModule shaderModule(binary.code.size() * sizeof(uint32_t), binary.code.data());
+		VkComputePipelineCreateInfo createInfo = {
+			.stage = shaderModule.ShaderStageCi(VK_SHADER_STAGE_COMPUTE_BIT),
+			.layout = pipelineLayout
+		};
+		return mPipelines.emplace(shaderPath, Pipeline(createInfo)).first->second;
+	}
+
+	void IBLBaker::CreateTarget(IBLTexture& texture, VkFormat format, uint32_t extent, uint32_t mipLevelCount, bool cube)
+	{
+		uint32_t layerCount = cube ? 6 : 1;
+		VkImageCreateInfo createInfo = {
+			.flags = cube ? VkImageCreateFlags(VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT) : 0,
+			.imageType = VK_IMAGE_TYPE_2D,
+			.format = format,
+			.extent = { extent, extent, 1 },
+			.mipLevels = mipLevelCount,
+			.arrayLayers = layerCount,
+			.samples = VK_SAMPLE_COUNT_1_BIT,
+			.tiling = VK_IMAGE_TILING_OPTIMAL,
+			.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT
+		};
+		texture.imageMemory.Create(createInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		texture.imageView.Create(texture.imageMemory.Image(), cube ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_2D, format,
+			VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevelCount, 0, layerCount }, VkComponentMapping{});
+		texture.extent = { extent, extent };
+		texture.mipLevelCount = mipLevelCount;
+	}
+
+	void IBLBaker::CreateTargets(IBLMaps& maps, const IBLSettings& settings) const
+	{
+		CreateTarget(maps.irradiance, cubeFormat, settings.irradianceExtent, 1, true);
+		CreateTarget(maps.prefiltered, cubeFormat, settings.prefilteredExtent, settings.prefilteredMipCount, true);
+		CreateTarget(maps.brdfLut, brdfLutFormat, settings.brdfLutExtent, 1, false);
+	}
+
+	bool IBLBaker::LoadCache(IBLMaps& maps, const IBLSettings& settings) const
+	{
+		std::filesystem::path path = cacheDirectory / std::format("{:016x}.ibl", maps.hash);
+		std::error_code ec;
+		if (!std::filesystem::is_regular_file(path, ec))
+			return false;
+		MappedFile file;
+		try {
+			file.Open(path.string().c_str());
+		}
+		catch (const std::runtime_error&) {
+			return false;
+		}
+
+		VkDeviceSize dataSize;
+		std::vector<CacheRegion> regions = CacheRegions(settings, dataSize);
+		if (file.Size() != sizeof(CacheHeader) + dataSize)
+			return false;
+		CacheHeader header;
+		memcpy(&header, file.Data(), sizeof header);
+		if (header.magic != cacheMagic || header.version != cacheVersion || header.hash != maps.hash || header.dataSize != dataSize)
+			return false;
+
+		uint8_t* pData_dst = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(dataSize));
+		memcpy(pData_dst, file.Data() + sizeof header, size_t(dataSize));
+		StagingBuffer_MainThread::UnMapMemory();
+
+		auto& commandBuffer = VulkanPlus::Plus().CommandBuffer_Transfer();
+		commandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		for (const CacheRegion& region : regions) {
+			VkBufferImageCopy copy = {
+				.bufferOffset = region.offset,
+				.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, region.mipLevel, 0, region.layerCount },
+				.imageExtent = { region.extent, region.extent, 1 }
+			};
+			ImageUtils::CmdCopyBufferToImage(commandBuffer, StagingBuffer_MainThread::Main(), Target(maps, region.target).Image(), copy,
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+		}
+		commandBuffer.End();
+		VulkanPlus::Plus().ExecuteCommandBuffer_Graphics(commandBuffer);
+		return true;
+	}
+
+	void IBLBaker::StoreCache(const IBLMaps& maps, const IBLSettings& settings, const uint8_t* pData) const
+	{
+		VkDeviceSize dataSize;
+		CacheRegions(settings, dataSize);
+		CacheHeader header = { cacheMagic, cacheVersion, maps.hash, dataSize };
+
+		std::error_code ec;
+		std::filesystem::create_directories(cacheDirectory, ec);
+		std::filesystem::path path = cacheDirectory / std::format("{:016x}.ibl", maps.hash);
+		//Write then rename, a crash halfway never leaves a file that looks valid
+		std::filesystem::path tempPath = path;
+		tempPath += ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file) {
+				std::cout << std::format("[ IBLBaker ] WARNING\nFailed to write the IBL cache: {}\n", path.generic_string());
+				return;
+			}
+			file.write(reinterpret_cast<const char*>(&header), sizeof header);
+			file.write(reinterpret_cast<const char*>(pData), std::streamsize(dataSize));
+		}
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+			std::filesystem::remove(tempPath, ec);
+	}
+
+	void IBLBaker::CmdDispatch(VkCommandBuffer commandBuffer, const char* shaderPath, VkDescriptorImageInfo source, const IBLTexture& target, VkFormat format,
+		uint32_t mipLevel, uint32_t layerCount, float roughness, uint32_t sampleCount, std::vector<DescriptorSet>& descriptorSets, std::vector<ImageView>& imageViews)
+	{
+		VkPipeline pipeline = AcquirePipeline(shaderPath);
+		const ImageView& imageView = imageViews.emplace_back(target.Image(), VK_IMAGE_VIEW_TYPE_2D_ARRAY, format,
+			VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, 1, 0, layerCount }, VkComponentMapping{});
+		DescriptorSet& descriptorSet = descriptorSets.emplace_back();
+		VulkanPlus::Plus().DescriptorPool().AllocateDescriptorSets(descriptorSet, descriptorSetLayout);
+		if (source.imageView != VK_NULL_HANDLE)
+			descriptorSet.Write(source, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
+		descriptorSet.Write(VkDescriptorImageInfo{ VK_NULL_HANDLE, imageView, VK_IMAGE_LAYOUT_GENERAL }, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1);
+
+		uint32_t extent = std::max(target.Extent().width >> mipLevel, 1u);
+		uint32_t groupCount = (extent + groupExtent - 1) / groupExtent;
+		PushConstants pushConstants = { roughness, sampleCount };
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, descriptorSet.Address(), 0, nullptr);
+		vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof pushConstants, &pushConstants);
+		vkCmdDispatch(commandBuffer, groupCount, groupCount, layerCount);
+	}
+
+	void IBLBaker::CmdBake(VkCommandBuffer commandBuffer, IBLMaps& maps, VkImageView environment, const IBLSettings& settings,
+		std::vector<DescriptorSet>& descriptorSets, std::vector<ImageView>& imageViews)
+	{
+		VkDeviceSize dataSize;
+		std::vector<CacheRegion> regions = CacheRegions(settings, dataSize);
+		for (TARGET target : { IRRADIANCE, PREFILTERED, BRDF_LUT }) {
+			const IBLTexture& texture = Target(maps, target);
+			ImageUtils::CmdImagePipelineBarrier(commandBuffer, texture.Image(),
+				VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, texture.MipLevelCount(), 0, target == BRDF_LUT ? 1u : 6u },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL });
+		}
+
+		VkDescriptorImageInfo source = { sampler, environment, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		CmdDispatch(commandBuffer, irradianceShaderPath, source, maps.irradiance, cubeFormat, 0, 6, 0.f, settings.irradianceSampleCount, descriptorSets, imageViews);
+		for (uint32_t i = 0; i < settings.prefilteredMipCount; i++) {
+			float roughness = settings.prefilteredMipCount > 1 ? float(i) / float(settings.prefilteredMipCount - 1) : 0.f;
+			CmdDispatch(commandBuffer, prefilterShaderPath, source, maps.prefiltered, cubeFormat, i, 6, roughness, settings.prefilterSampleCount, descriptorSets, imageViews);
+		}
+		CmdDispatch(commandBuffer, brdfLutShaderPath, {}, maps.brdfLut, brdfLutFormat, 0, 1, 0.f, settings.brdfLutSampleCount, descriptorSets, imageViews);
+
+		//Read back for the cache, then leave everything ready for sampling
+		for (const CacheRegion& region : regions) {
+			VkImageSubresourceRange range = { VK_IMAGE_ASPECT_COLOR_BIT, region.mipLevel, 1, 0, region.layerCount };
+			VkImage image = Target(maps, region.target).Image();
+			ImageUtils::CmdImagePipelineBarrier(commandBuffer, image, range,
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL });
+			VkBufferImageCopy copy = {
+				.bufferOffset = region.offset,
+				.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, region.mipLevel, 0, region.layerCount },
+				.imageExtent = { region.extent, region.extent, 1 }
+			};
+			vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, StagingBuffer_MainThread::Main(), 1, &copy);
+			ImageUtils::CmdImagePipelineBarrier(commandBuffer, image, range,
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_TRANSFER_BIT, 0, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+		}
+		VkMemoryBarrier hostBarrier = {
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_HOST_READ_BIT
+		};
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+			1, &hostBarrier, 0, nullptr, 0, nullptr);
+	}
+
+	void IBLBaker::Bake_Internal(IBLMaps& maps, VkImageView environment, const IBLSettings& settings)
+	{
+		VkDeviceSize dataSize;
+		CacheRegions(settings, dataSize);
+		//Recorded copies target the buffer as it is now, it must not be reallocated afterwards
+		StagingBuffer_MainThread::Expand(dataSize);
+
+		std::vector<DescriptorSet> descriptorSets;
+		std::vector<ImageView> imageViews;
+		auto& commandBuffer = VulkanPlus::Plus().CommandBuffer_Transfer();
+		commandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		CmdBake(commandBuffer, maps, environment, settings, descriptorSets, imageViews);
+		commandBuffer.End();
+		VulkanPlus::Plus().ExecuteCommandBuffer_Graphics(commandBuffer);
+		VulkanPlus::Plus().DescriptorPool().FreeDescriptorSets(descriptorSets);
+
+		std::vector<uint8_t> data(dataSize);
+		StagingBuffer_MainThread::RetrieveData(data.data(), dataSize);
+		StoreCache(maps, settings, data.data());
+	}
+
+	bool IBLBaker::LoadCached(IBLMaps& maps, uint64_t sourceHash, const IBLSettings& settings)
+	{
+		maps.hash = HashBytes(&settings, sizeof settings, HashBytes(&cacheVersion, sizeof cacheVersion, sourceHash));
+		CreateTargets(maps, settings);
+		maps.loadedFromCache = LoadCache(maps, settings);
+		return maps.loadedFromCache;
+	}
+
+	void IBLBaker::Bake(IBLMaps& maps, const TextureCube& environment, uint64_t sourceHash, const IBLSettings& settings)
+	{
+		if (!LoadCached(maps, sourceHash, settings))
+			Bake_Internal(maps, environment.ImageView(), settings);
+	}
+
+	void IBLBaker::BakeEquirectangular(IBLMaps& maps, const char* filePath, const IBLSettings& settings)
+	{
+		//The hash is taken over the file as stored, a cache hit never decodes it
+		MappedFile file(filePath);
+		if (LoadCached(maps, HashBytes(file.Data(), file.Size()), settings))
+			return;
+
+		VkExtent2D extent;
+		std::unique_ptr<uint8_t[]> pImageData = Texture::LoadFile(file.Data(), file.Size(), extent, VK_FORMAT_R32G32B32A32_SFLOAT);
+		Texture2D panorama(pImageData.get(), extent, VK_FORMAT_R32G32B32A32_SFLOAT, cubeFormat);
+		pImageData.reset();
+		file.Close();
+
+		//Project onto a cube with a full mip chain, the filtering passes read coarser levels for wide lobes
+		IBLTexture environment;
+		uint32_t mipLevelCount = ImageUtils::CalculateMipLevelCount({ settings.environmentExtent, settings.environmentExtent });
+		CreateTarget(environment, cubeFormat, settings.environmentExtent, mipLevelCount, true);
+
+		VkSamplerCreateInfo panoramaSamplerCreateInfo = Sampler::SamplerCreateInfo();
+		panoramaSamplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		VkSampler panoramaSampler = VulkanPlus::Plus().AcquireSampler(panoramaSamplerCreateInfo).second[0];
+
+		std::vector<DescriptorSet> descriptorSets;
+		std::vector<ImageView> imageViews;
+		MipGenerator::Resources mipResources;
+		auto& commandBuffer = VulkanPlus::Plus().CommandBuffer_Transfer();
+		commandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		VkImageSubresourceRange level0 = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 6 };
+		ImageUtils::CmdImagePipelineBarrier(commandBuffer, environment.Image(), level0,
+			ImageBarrierInfo{ VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED },
+			ImageBarrierInfo{ VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL });
+		CmdDispatch(commandBuffer, equirectToCubeShaderPath, panorama.DescriptorImageInfo(panoramaSampler), environment, cubeFormat,
+			0, 6, 0.f, 0, descriptorSets, imageViews);
+		//Both mip paths expect level 0 as a transfer would leave it
+		ImageUtils::CmdImagePipelineBarrier(commandBuffer, environment.Image(), level0,
+			ImageBarrierInfo{ VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL },
+			ImageBarrierInfo{ VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL });
+		VkExtent2D environmentExtent = environment.Extent();
+		ImageBarrierInfo imgBarrier_to = { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		if (MipGenerator::IsSupported(cubeFormat, environmentExtent, mipLevelCount))
+			MipGenerator::Generator().CmdGenerateMipmap2D(mipResources, commandBuffer, environment.Image(), cubeFormat, environmentExtent, mipLevelCount, 6, imgBarrier_to);
+		else
+			ImageUtils::CmdGenerateMipmap2D(commandBuffer, environment.Image(), environmentExtent, mipLevelCount, 6, imgBarrier_to);
+		commandBuffer.End();
+		VulkanPlus::Plus().ExecuteCommandBuffer_Graphics(commandBuffer);
+		VulkanPlus::Plus().DescriptorPool().FreeDescriptorSets(descriptorSets);
+
+		Bake_Internal(maps, environment.ImageView(), settings);
+	}
+
+#pragma endregion
+
+}
@@ -1,13 +1,46 @@
 #include "Plus/ImageManager.h"
 #include "Plus/VulkanPlus.h"
+#include "Plus/MipGenerator.h"
 #include "Utils/ImageUtils.h"
+#include "Utils/PixelConverter.h"
+#include "Utils/WorkerPool.h"
 
 namespace HoshioEngine {
 
+	namespace {
+		//Texture views are only sampled, which has to be spelled out once an sRGB image also carries STORAGE for MipGenerator
+		constexpr VkImageViewUsageCreateInfo sampledViewUsage = { VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO, nullptr, VK_IMAGE_USAGE_SAMPLED_BIT };
+
+		//Shared by every LoadFileAsync() call, so a long list of files queues up instead of starting a thread each
+		WorkerPool& DecodeWorkers()
+		{
+			static WorkerPool workers;
+			return workers;
+		}
+
+		//Staging memory is sized from the file headers, a decode that disagrees must not be written into it
+		void CheckDecodedExtent(const char* tag, const char* filePath, VkExtent2D extent_decoded, VkExtent2D extent_header)
+		{
+			if (extent_decoded.width == extent_header.width &&
+				extent_decoded.height == extent_header.height)
+				return;
+			std::cerr << std::format(
+				"[ {} ] ERROR\nImage not available!\nFile: {}\nDecoded as {}x{}, its header says {}x{}!\n",
+				tag, filePath, extent_decoded.width, extent_decoded.height, extent_header.width, extent_header.height);
+			throw std::runtime_error(std::format("[ {} ] ERROR::Decoded extent does not match the file header!", tag));
+		}
+	}
+
 #pragma region Texture
 
 	void Texture::CreateImageMemory(VkImageType imageType, VkFormat format, VkExtent3D extent, uint32_t mipLevelCount, uint32_t arrayLayerCount, VkImageCreateFlags flags)
 	{
+		VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		//Lets CopyBlitAndGenerateMipmap2D() generate the chain in one compute dispatch
+		if (imageType == VK_IMAGE_TYPE_2D && MipGenerator::IsSupported(format, { extent.width, extent.height }, mipLevelCount)) {
+			usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+			flags |= MipGenerator::RequiredImageCreateFlags(format);
+		}
 		VkImageCreateInfo createInfo = {
 			.flags = flags,
 			.imageType = imageType,
@@ -17,16 +50,23 @@ namespace HoshioEngine {
 			.arrayLayers = arrayLayerCount,
 			.samples = VK_SAMPLE_COUNT_1_BIT,
 			.tiling = VK_IMAGE_TILING_OPTIMAL,
-			.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			.usage = usage,
 			.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
 		};
 		imageMemory.Create(createInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 	}
 
-	void Texture::CreateImageView(VkImageViewType viewType, VkFormat format, uint32_t mipLevelCount, uint32_t arrayLayerCount, VkImageViewCreateFlags flags)
+	void Texture::CreateImageView(VkImageViewType viewType, VkFormat format, uint32_t mipLevelCount, uint32_t arrayLayerCount, VkImageViewCreateFlags flags, uint32_t baseMipLevel)
 	{
-		imageView.Create(imageMemory.Image(), viewType, format, 
-			VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevelCount, 0, arrayLayerCount }, VkComponentMapping{}, flags);
+		VkImageViewCreateInfo createInfo = {
+			.pNext = &sampledViewUsage,
+			.flags = flags,
+			.image = imageMemory.Image(),
+			.viewType = viewType,
+			.format = format,
+			.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, baseMipLevel, mipLevelCount, 0, arrayLayerCount }
+		};
+		imageView.Create(createInfo);
 	}
 
 	/*
@@ -76,30 +116,14 @@ namespace HoshioEngine {
 
 	std::unique_ptr<uint8_t[]> Texture::LoadFile_Internal(const char* address, size_t fileSize, VkExtent2D& extent, VkFormat format)
 	{
-#ifndef NDEBUG
-		if (!(vkuFormatIsStoredFloat(format) && vkuFormatIs32bit(format)) &&
-			!(vkuFormatIsStoredInt(format) && (vkuFormatIs8bit(format) || vkuFormatIs16bit(format))))
-			throw std::runtime_error("Required format is not available for source image data!");
-#endif // !NDEBUG
-		int& width = reinterpret_cast<int&>(extent.width);
-		int& height = reinterpret_cast<int&>(extent.height);
-		int channelCount = 0;
-		void* pImageData = nullptr;
-
-		uint32_t componentCount = vkuGetFormatInfo(format).component_count;
-
-		if (vkuFormatIsStoredInt(format))
-			if (vkuFormatIs8bit(format)) 
-				pImageData = stbi_load(address, &width, &height, &channelCount, componentCount);
-			else 
-				pImageData = stbi_load_16(address, &width, &height, &channelCount, componentCount);
-		else
-			pImageData = stbi_loadf(address, &width, &height, &channelCount, componentCount);
-
-		if (!pImageData)
+		//Decoding from the mapped file skips stdio's buffered copy of the whole file
+		MappedFile file(address);
+		try {
+			return LoadFile_Internal(file.Data(), file.Size(), extent, format);
+		}
+		catch (const std::runtime_error&) {
 			throw std::runtime_error(std::format("[ Texture ] ERROR\nFailed to load the file: {}\n", address));
-
-		return std::unique_ptr<uint8_t[]>(static_cast<uint8_t*>(pImageData));
+		}
 	}
 
 	std::unique_ptr<uint8_t[]> Texture::LoadFile_Internal(const uint8_t* address, size_t fileSize, VkExtent2D& extent, VkFormat format)
@@ -170,7 +194,38 @@ namespace HoshioEngine {
 		return LoadFile_Internal(fileBinaries, fileSize, extent, format);
 	}
 
-	void Texture::CopyBlitAndGenerateMipmap2D(VkBuffer buffer_copyFrom, VkImage image_copyTo, VkImage image_blitTo, VkExtent2D imageExtent, uint32_t mipLevelCount, uint32_t layerCount, VkFilter minFilter)
+	std::future<ImageData> Texture::LoadFileAsync(std::string filePath, VkFormat format)
+	{
+		return DecodeWorkers().Submit([filePath = std::move(filePath), format] {
+			ImageData image;
+			image.pData = LoadFile(filePath.c_str(), image.extent, format);
+			return image;
+			});
+	}
+
+	bool Texture::ReadFileExtent(const char* filePath, VkExtent2D& extent)
+	{
+		int width = 0, height = 0, channelCount = 0;
+		if (!stbi_info(filePath, &width, &height, &channelCount))
+			return false;
+		extent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+		return true;
+	}
+
+	void Texture::DecodeFilesParallel(ArrayRef<const char* const> filePaths, VkFormat format,
+		const std::function<void(size_t index, const uint8_t* pImageData, VkExtent2D extent)>& consumer)
+	{
+		//ParallelFor() lets the first exception out only once every chunk is done with the consumer's memory
+		ParallelFor(filePaths.size(), 0, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				VkExtent2D extent;
+				std::unique_ptr<uint8_t[]> pImageData = LoadFile(filePaths[i], extent, format);
+				consumer(i, pImageData.get(), extent);
+			}
+			});
+	}
+
+	void Texture::CopyBlitAndGenerateMipmap2D(VkBuffer buffer_copyFrom, VkImage image_copyTo, VkImage image_blitTo, VkExtent2D imageExtent, uint32_t mipLevelCount, uint32_t layerCount, VkFilter minFilter, VkFormat format)
 	{
 		bool generateMipmap = mipLevelCount > 1;
 		bool blitMipLevel0 = image_copyTo != image_blitTo;
@@ -211,7 +266,12 @@ namespace HoshioEngine {
 					minFilter);
 		}
 
-		if (generateMipmap)
+		//Outlives the submission below
+		MipGenerator::Resources mipResources;
+		if (generateMipmap && MipGenerator::IsSupported(format, imageExtent, mipLevelCount))
+			MipGenerator::Generator().CmdGenerateMipmap2D(mipResources, commandBuffer, image_blitTo, format, imageExtent, mipLevelCount, layerCount,
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+		else if (generateMipmap)
 			ImageUtils::CmdGenerateMipmap2D(commandBuffer, image_blitTo, imageExtent, mipLevelCount, layerCount,
 				ImageBarrierInfo{ VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL },
 				minFilter);
@@ -220,7 +280,48 @@ namespace HoshioEngine {
 		VulkanPlus::Plus().ExecuteCommandBuffer_Graphics(commandBuffer);
 	}
 
-	void Texture::BlitAndGenerateMipmap2D(VkImage image_preinitialized, VkImage image_final, VkExtent2D imageExtent, uint32_t mipLevelCount, uint32_t layerCount, VkFilter minFilter)
+	void Texture::CreateFromContainer(const TextureContainer& container, VkImageViewType viewType, VkImageCreateFlags flags)
+	{
+		if (!FormatIsSupported(container.format)) {
+			std::cerr << std::format("[ Texture ] ERROR\nFormat {} cannot be sampled on this device!\n", uint32_t(container.format));
+			throw std::runtime_error("[ Texture ] ERROR::Format not supported!");
+		}
+		uint32_t mipLevelCount = container.MipLevelCount();
+		uint32_t arrayLayerCount = container.ArrayLayerCount();
+		CreateImageMemory(VK_IMAGE_TYPE_2D, container.format, { container.extent.width, container.extent.height, 1 }, mipLevelCount, arrayLayerCount, flags);
+		CreateImageView(viewType, container.format, mipLevelCount, arrayLayerCount);
+		//Straight from the mapped file into the mapped staging buffer
+		uint8_t* pData_dst = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(container.DataSize()));
+		container.CopyData(pData_dst);
+		StagingBuffer_MainThread::UnMapMemory();
+
+		auto& commandBuffer = VulkanPlus::Plus().CommandBuffer_Transfer();
+		commandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		for (uint32_t i = 0; i < mipLevelCount; i++) {
+			VkBufferImageCopy region = {
+				.bufferOffset = container.levels[i].offset,
+				.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i, 0, arrayLayerCount },
+				.imageExtent = { container.levels[i].extent.width, container.levels[i].extent.height, 1 },
+			};
+			ImageUtils::CmdCopyBufferToImage(commandBuffer, StagingBuffer_MainThread::Main(), imageMemory.Image(), region,
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+		}
+		commandBuffer.End();
+		VulkanPlus::Plus().ExecuteCommandBuffer_Graphics(commandBuffer);
+	}
+
+	bool Texture::FormatIsSupported(VkFormat format)
+	{
+		return ImageUtils::FormatProperties(format).optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+	}
+
+	VkFormat Texture::StagingFormat(VkFormat format_initial, VkFormat format_final)
+	{
+		return PixelConverter::CanConvert(format_initial, format_final) ? format_final : format_initial;
+	}
+
+	void Texture::BlitAndGenerateMipmap2D(VkImage image_preinitialized, VkImage image_final, VkExtent2D imageExtent, uint32_t mipLevelCount, uint32_t layerCount, VkFilter minFilter, VkFormat format)
 	{
 		bool generateMipmap = mipLevelCount > 1;
 		bool blitMipLevel0 = image_preinitialized != image_final;
@@ -253,7 +354,11 @@ namespace HoshioEngine {
 						minFilter);
 			}
 
-			if (generateMipmap)
+			MipGenerator::Resources mipResources;
+			if (generateMipmap && MipGenerator::IsSupported(format, imageExtent, mipLevelCount))
+				MipGenerator::Generator().CmdGenerateMipmap2D(mipResources, commandBuffer, image_final, format, imageExtent, mipLevelCount, layerCount,
+					ImageBarrierInfo{ VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+			else if (generateMipmap)
 				ImageUtils::CmdGenerateMipmap2D(commandBuffer, image_final, imageExtent, mipLevelCount, layerCount,
 					ImageBarrierInfo{ VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL },
 					minFilter);
@@ -276,15 +381,21 @@ namespace HoshioEngine {
 		imageViews.resize(mipLevelCount);
 		for (uint32_t i = 0; i < mipLevelCount; i++)
 		{
-			imageViews[i].Create(imageMemory.Image(), VK_IMAGE_VIEW_TYPE_2D, final_format,
-				VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1 }, VkComponentMapping{});
+			VkImageViewCreateInfo createInfo = {
+				.pNext = &sampledViewUsage,
+				.image = imageMemory.Image(),
+				.viewType = VK_IMAGE_VIEW_TYPE_2D,
+				.format = final_format,
+				.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1 }
+			};
+			imageViews[i].Create(createInfo);
 		}
 
 		if (initial_format == final_format) 
-			CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory.Image(), imageMemory.Image(), extent, mipLevelCount, 1);
+			CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory.Image(), imageMemory.Image(), extent, mipLevelCount, 1, VK_FILTER_LINEAR, final_format);
 		else {
 			if (VkImage alisedImage = StagingBuffer_MainThread::AliasedImage2D(initial_format, extent))
-				BlitAndGenerateMipmap2D(alisedImage, imageMemory.Image(), extent, mipLevelCount, 1);
+				BlitAndGenerateMipmap2D(alisedImage, imageMemory.Image(), extent, mipLevelCount, 1, VK_FILTER_LINEAR, final_format);
 			else {
 				VkImageCreateInfo createInfo = {
 					.imageType = VK_IMAGE_TYPE_2D,
@@ -297,7 +408,7 @@ namespace HoshioEngine {
 					.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT
 				};
 				ImageMemory imageMemory_conversion(createInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-				CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory_conversion.Image(), imageMemory.Image(), extent, mipLevelCount, 1);
+				CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory_conversion.Image(), imageMemory.Image(), extent, mipLevelCount, 1, VK_FILTER_LINEAR, final_format);
 			}
 		}
 	}
@@ -313,6 +424,11 @@ namespace HoshioEngine {
 		Create(pImageData, extent, initial_format, final_format, generateMip);
 	}
 
+	Texture2D::Texture2D(const TextureContainer& container)
+	{
+		Create(container);
+	}
+
 	VkExtent2D Texture2D::Extent() const
 	{
 		return extent;
@@ -340,6 +456,10 @@ namespace HoshioEngine {
 
 	void Texture2D::Create(const char* filePath, VkFormat initial_format, VkFormat final_format, bool generateMip)
 	{
+		if (TextureContainer::IsContainerFile(filePath)) {
+			Create(TextureContainer::Load(filePath));
+			return;
+		}
 		VkExtent2D extent;
 		std::unique_ptr<uint8_t[]> pImageData = LoadFile(filePath, extent, initial_format);
 		if (pImageData)
@@ -349,18 +469,42 @@ namespace HoshioEngine {
 	void Texture2D::Create(const uint8_t* pImageData, VkExtent2D extent, VkFormat initial_format, VkFormat final_format, bool generateMip)
 	{
 		this->extent = extent;
-		size_t imageDataSize = VkDeviceSize(vkuFormatElementSize(initial_format)) * extent.width * extent.height;
-		StagingBuffer_MainThread::SynchronizeData(pImageData, imageDataSize);
-		Create_Internal(initial_format, final_format, generateMip);
+		VkFormat staging_format = StagingFormat(initial_format, final_format);
+		size_t imageDataSize = VkDeviceSize(vkuFormatElementSize(staging_format)) * extent.width * extent.height;
+		if (staging_format == initial_format)
+			StagingBuffer_MainThread::SynchronizeData(pImageData, imageDataSize);
+		else {
+			uint8_t* pData_dst = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(imageDataSize));
+			PixelConverter::Convert(pImageData, initial_format, pData_dst, staging_format, size_t(extent.width) * extent.height);
+			StagingBuffer_MainThread::UnMapMemory();
+		}
+		Create_Internal(staging_format, final_format, generateMip);
+	}
+
+	void Texture2D::Create(const TextureContainer& container)
+	{
+		if (container.ArrayLayerCount() != 1)
+			throw std::runtime_error("[ Texture2D ] ERROR\nContainer holds more than one image, load it as a TextureArray or TextureCube!\n");
+		extent = container.extent;
+		mipLevelCount = container.MipLevelCount();
+		CreateFromContainer(container, VK_IMAGE_VIEW_TYPE_2D);
+
+		imageViews.resize(mipLevelCount);
+		for (uint32_t i = 0; i < mipLevelCount; i++)
+			imageViews[i].Create(imageMemory.Image(), VK_IMAGE_VIEW_TYPE_2D, container.format,
+				VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1 }, VkComponentMapping{});
 	}
 
-	void TextureArray::Create_Internal(VkFormat format_initial, VkFormat format_final, bool generateMipmap)
+	void TextureArray::Create_Internal(VkFormat format_initial, VkFormat format_final, bool generateMipmap, uint32_t mipLevelCount)
 	{
-		uint32_t mipLevelCount = generateMipmap ? ImageUtils::CalculateMipLevelCount(extent) : 1;
+		if (!generateMipmap)
+			mipLevelCount = 1;
+		else if (!mipLevelCount)
+			mipLevelCount = ImageUtils::CalculateMipLevelCount(extent);
 		CreateImageMemory(VK_IMAGE_TYPE_2D, format_final, { extent.width, extent.height, 1 }, mipLevelCount, layerCount);
 		CreateImageView(VK_IMAGE_VIEW_TYPE_2D_ARRAY, format_final, mipLevelCount, layerCount);
 		if (format_initial == format_final)
-			CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory.Image(), imageMemory.Image(), extent, mipLevelCount, layerCount);
+			CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory.Image(), imageMemory.Image(), extent, mipLevelCount, layerCount, VK_FILTER_LINEAR, format_final);
 		else {
 			VkImageCreateInfo createInfo = {
 				.imageType = VK_IMAGE_TYPE_2D,
@@ -372,7 +516,7 @@ namespace HoshioEngine {
 				.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT
 			};
 			ImageMemory imageMemory_conversion(createInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-			CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory_conversion.Image(), imageMemory.Image(), extent, mipLevelCount, 1);
+			CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory_conversion.Image(), imageMemory.Image(), extent, mipLevelCount, layerCount, VK_FILTER_LINEAR, format_final);
 		}
 	}
 
@@ -418,6 +562,11 @@ namespace HoshioEngine {
 
 	void TextureArray::Create(const char* filepath, VkExtent2D extentInTiles, VkFormat format_initial, VkFormat format_final, bool generateMipmap)
 	{
+		//Containers carry their own layers
+		if (TextureContainer::IsContainerFile(filepath)) {
+			Create(TextureContainer::Load(filepath));
+			return;
+		}
 		if (extentInTiles.width * extentInTiles.height > VulkanBase::Base().PhysicalDeviceProperties().limits.maxImageArrayLayers) {
 			std::cerr << std::format("[ TextureArray ] ERROR\nLayer count is out of limit! Must be less than: {}\nFile: {}\n", VulkanBase::Base().PhysicalDeviceProperties().limits.maxImageArrayLayers, filepath);
 			throw std::runtime_error("[ TextureArray ] ERROR::Layer count is out of limit!");
@@ -456,26 +605,29 @@ namespace HoshioEngine {
 		extent.width = fullExtent.width / extentInTiles.width;
 		extent.height = fullExtent.height / extentInTiles.height;
 
+		VkFormat format_staging = StagingFormat(format_initial, format_final);
 		size_t dataSizePerPixel = vkuFormatElementSize(format_initial);
-		size_t imageDataSize = dataSizePerPixel * fullExtent.width * fullExtent.height;
+		size_t dataSizePerPixel_staging = vkuFormatElementSize(format_staging);
+		size_t imageDataSize = dataSizePerPixel_staging * fullExtent.width * fullExtent.height;
 
-		if (extentInTiles.width == 1)
+		if (extentInTiles.width == 1 && format_staging == format_initial)
 			StagingBuffer_MainThread::SynchronizeData(pImageData, imageDataSize);
 		else {
+			//Tiles are independent, each worker cuts (and converts) whole layers straight into the mapped staging memory
 			uint8_t* pData_dst = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(imageDataSize));
-			size_t dataSizePerRow = dataSizePerPixel * extent.width;
-			for (size_t j = 0; j < extentInTiles.height; j++)
-				for (size_t i = 0; i < extentInTiles.width; i++) {
-					for (size_t k = 0; k < extent.height; k++)
-						memcpy(
-							pData_dst,
-							pImageData + (i * extent.width + (k + j * extent.height) * fullExtent.width) * dataSizePerPixel,
-							dataSizePerRow),
-						pData_dst += dataSizePerRow; //ÿһУpData_dstƶһеݴС
+			size_t dataSizePerImage = dataSizePerPixel_staging * extent.width * extent.height;
+			ParallelFor(layerCount, 0, [&](size_t begin, size_t end) {
+				for (size_t layer = begin; layer < end; layer++) {
+					size_t i = layer % extentInTiles.width, j = layer / extentInTiles.width;
+					PixelConverter::ConvertTexels(
+						pImageData + (i * extent.width + j * extent.height * fullExtent.width) * dataSizePerPixel, dataSizePerPixel * fullExtent.width, format_initial,
+						pData_dst + dataSizePerImage * layer, dataSizePerPixel_staging * extent.width, format_staging,
+						extent);
 				}
+				});
 			StagingBuffer_MainThread::UnMapMemory();
 		}
-		Create_Internal(format_initial, format_final, generateMipmap);
+		Create_Internal(format_staging, format_final, generateMipmap);
 	}
 
 	void TextureArray::Create(ArrayRef<const char* const> filepaths, VkFormat format_initial, VkFormat format_final, bool generateMipmap)
@@ -486,26 +638,37 @@ namespace HoshioEngine {
 				VulkanBase::Base().PhysicalDeviceProperties().limits.maxImageArrayLayers);
 			throw std::runtime_error("[ TextureArray ] ERROR::Layer count is out of limit!");
 		}
-		std::unique_ptr psImageData = std::make_unique<std::unique_ptr<uint8_t[]>[]>(filepaths.size());
+		//Headers only, so the staging buffer can be sized up front and every layer decoded straight into its slot
 		for (size_t i = 0; i < filepaths.size(); i++) {
 			VkExtent2D extent_currentLayer;
-			psImageData[i] = LoadFile(filepaths[i], extent_currentLayer, format_initial);
-			if (psImageData[i]) {
-				if (i == 0)
-					extent = extent_currentLayer;
-				if (extent.width == extent_currentLayer.width &&
-					extent.height == extent_currentLayer.height)
-					continue;
-				else {
-					std::cerr << std::format(
-						"[ TextureArray ] ERROR\nImage not available!\nFile: {}\nAll the images must be in same size!\n",
-						filepaths[i]);//fallthrough
-					throw std::runtime_error("[ TextureArray ] All the images must be in same size!");
-				}
+			if (!ReadFileExtent(filepaths[i], extent_currentLayer))
+				throw std::runtime_error(std::format("[ Texture ] ERROR\nFailed to load the file: {}\n", filepaths[i]));
+			if (i == 0)
+				extent = extent_currentLayer;
+			if (extent.width != extent_currentLayer.width ||
+				extent.height != extent_currentLayer.height) {
+				std::cerr << std::format(
+					"[ TextureArray ] ERROR\nImage not available!\nFile: {}\nAll the images must be in same size!\n",
+					filepaths[i]);
+				throw std::runtime_error("[ TextureArray ] All the images must be in same size!");
 			}
-			return;
 		}
-		Create({ reinterpret_cast<const uint8_t* const*>(psImageData.get()), filepaths.size() }, extent, format_initial, format_final, generateMipmap);
+		layerCount = filepaths.size();
+		VkFormat format_staging = StagingFormat(format_initial, format_final);
+		size_t dataSizePerImage = vkuFormatElementSize(format_staging) * extent.width * extent.height;
+		uint8_t* pData_dst = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(dataSizePerImage * layerCount));
+		try {
+			DecodeFilesParallel(filepaths, format_initial, [&](size_t i, const uint8_t* pImageData, VkExtent2D extent_decoded) {
+				CheckDecodedExtent("TextureArray", filepaths[i], extent_decoded, extent);
+				PixelConverter::ConvertRow(pImageData, format_initial, pData_dst + dataSizePerImage * i, format_staging, size_t(extent.width) * extent.height);
+				});
+		}
+		catch (...) {
+			StagingBuffer_MainThread::UnMapMemory();
+			throw;
+		}
+		StagingBuffer_MainThread::UnMapMemory();
+		Create_Internal(format_staging, format_final, generateMipmap);
 	}
 
 	void TextureArray::Create(ArrayRef<const uint8_t* const> psImageData, VkExtent2D extent, VkFormat format_initial, VkFormat format_final, bool generateMipmap)
@@ -518,15 +681,35 @@ namespace HoshioEngine {
 				throw std::runtime_error("[ TextureArray ] ERROR::Layer count is out of limit!");
 		}
 		this->extent = extent;
-		size_t dataSizePerImage = vkuFormatElementSize(format_initial) * extent.width * extent.height;
+		VkFormat format_staging = StagingFormat(format_initial, format_final);
+		size_t dataSizePerImage = vkuFormatElementSize(format_staging) * extent.width * extent.height;
 		size_t imageDataSize = dataSizePerImage * layerCount;
 		uint8_t* pData_dst = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(imageDataSize));
-		for (size_t i = 0; i < layerCount; i++)
-			memcpy(pData_dst, psImageData[i], dataSizePerImage),
-			pData_dst += dataSizePerImage;
+		ParallelFor(layerCount, 0, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++)
+				PixelConverter::ConvertRow(psImageData[i], format_initial, pData_dst + dataSizePerImage * i, format_staging, size_t(extent.width) * extent.height);
+			});
 		StagingBuffer_MainThread::UnMapMemory();
 		//Create image and allocate memory, create image view, then copy data from staging buffer to image
-		Create_Internal(format_initial, format_final, generateMipmap);
+		Create_Internal(format_staging, format_final, generateMipmap);
+	}
+
+	TextureArray::TextureArray(const TextureContainer& container)
+	{
+		Create(container);
+	}
+
+	void TextureArray::Create(const TextureContainer& container)
+	{
+		if (container.ArrayLayerCount() > VulkanBase::Base().PhysicalDeviceProperties().limits.maxImageArrayLayers) {
+			std::cerr << std::format(
+				"[ TextureArray ] ERROR\nLayer count is out of limit! Must be less than: {}\n",
+				VulkanBase::Base().PhysicalDeviceProperties().limits.maxImageArrayLayers);
+			throw std::runtime_error("[ TextureArray ] ERROR::Layer count is out of limit!");
+		}
+		extent = container.extent;
+		layerCount = container.ArrayLayerCount();
+		CreateFromContainer(container, VK_IMAGE_VIEW_TYPE_2D_ARRAY);
 	}
 
 	VkExtent2D TextureCube::GetExtentInTiles(const glm::uvec2*& facePositions, bool lookFromOutside, bool loadPreviousResult)
@@ -557,7 +740,7 @@ namespace HoshioEngine {
 		CreateImageMemory(VK_IMAGE_TYPE_2D, format_final, { extent.width, extent.height, 1 }, mipLevelCount, 6, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
 		CreateImageView(VK_IMAGE_VIEW_TYPE_CUBE, format_final, mipLevelCount, 6);
 		if (format_initial == format_final)
-			CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory.Image(), imageMemory.Image(), extent, mipLevelCount, 6);
+			CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory.Image(), imageMemory.Image(), extent, mipLevelCount, 6, VK_FILTER_LINEAR, format_final);
 		else {
 			VkImageCreateInfo createInfo = {
 				.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT,
@@ -570,7 +753,7 @@ namespace HoshioEngine {
 				.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT
 			};
 			ImageMemory imageMemory_conversion(createInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-			CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory_conversion.Image(), imageMemory.Image(), extent, mipLevelCount, 6);
+			CopyBlitAndGenerateMipmap2D(StagingBuffer_MainThread::Main(), imageMemory_conversion.Image(), imageMemory.Image(), extent, mipLevelCount, 6, VK_FILTER_LINEAR, format_final);
 		}
 	}
 
@@ -609,6 +792,10 @@ namespace HoshioEngine {
 	}
 	void TextureCube::Create(const char* filepath, const glm::uvec2 facePositions[6], VkFormat format_initial, VkFormat format_final, bool lookFromOutside, bool generateMipmap)
 	{
+		if (TextureContainer::IsContainerFile(filepath)) {
+			Create(TextureContainer::Load(filepath));
+			return;
+		}
 		VkExtent2D fullExtent;
 		std::unique_ptr<uint8_t[]> pImageData = LoadFile(filepath, fullExtent, format_initial);
 		if (pImageData) {
@@ -644,106 +831,98 @@ namespace HoshioEngine {
 			extent.height = fullExtent.height / extentInTiles.height;
 		}
 
+		VkFormat format_staging = StagingFormat(format_initial, format_final);
 		size_t dataSizePerPixel = vkuFormatElementSize(format_initial);
-		size_t dataSizePerRow = dataSizePerPixel * extent.width;
-		size_t dataSizePerImage = dataSizePerRow * extent.height;
+		size_t dataSizePerImage = vkuFormatElementSize(format_staging) * extent.width * extent.height;
 		size_t imageDataSize = dataSizePerImage * 6;
 		uint8_t* pData_dst = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(imageDataSize));
 
-		if (lookFromOutside) {
-			if (extentInTiles.width == 1 && extentInTiles.height == 6 &&
-				facePositions[0].y == 0 && facePositions[1].y == 1 &&
-				facePositions[2].y == 2 && facePositions[3].y == 3 &&
-				facePositions[4].y == 4 && facePositions[5].y == 5)
-				memcpy(pData_dst, pImageData, imageDataSize);
-			else
-				for (size_t face = 0; face < 6; face++)
-					for (uint32_t j = 0; j < extent.height; j++)
-						memcpy(
-							pData_dst,
-							pImageData + dataSizePerPixel * (facePositions[face].x * extent.width + (j + facePositions[face].y * extent.height) * fullExtent.width),
-							dataSizePerRow),
-						pData_dst += dataSizePerRow;
-		}
-		else {
-			for (size_t face = 0; face < 6; face++) {
-				if (face != 2 && face != 3)
-					for (uint32_t i = 0; i < extent.height; i++)
-						for (uint32_t j = 0; j < extent.width; j++)
-							memcpy(
-								pData_dst,
-								pImageData + dataSizePerPixel * (extent.width - 1 - j + facePositions[face].x * extent.width + (i + facePositions[face].y * extent.height) * fullExtent.width),
-								dataSizePerPixel),
-							pData_dst += dataSizePerPixel;
-				else
-					for (uint32_t j = 0; j < extent.height; j++)
-						for (uint32_t k = 0; k < extent.width; k++)
-							memcpy(
-								pData_dst,
-								pImageData + dataSizePerPixel * (k + facePositions[face].x * extent.width + ((extent.height - 1 - j) + facePositions[face].y * extent.height) * fullExtent.width),
-								dataSizePerPixel),
-							pData_dst += dataSizePerPixel;
-			}
-		}
+		if (lookFromOutside &&
+			extentInTiles.width == 1 && extentInTiles.height == 6 &&
+			facePositions[0].y == 0 && facePositions[1].y == 1 &&
+			facePositions[2].y == 2 && facePositions[3].y == 3 &&
+			facePositions[4].y == 4 && facePositions[5].y == 5)
+			PixelConverter::Convert(pImageData, format_initial, pData_dst, format_staging, size_t(extent.width) * extent.height * 6);
+		else
+			ParallelFor(6, 0, [&](size_t begin, size_t end) {
+				for (size_t face = begin; face < end; face++)
+					WriteFace(
+						pData_dst + dataSizePerImage * face, format_staging,
+						pImageData + dataSizePerPixel * (facePositions[face].x * extent.width + facePositions[face].y * extent.height * fullExtent.width), format_initial,
+						dataSizePerPixel * fullExtent.width,
+						extent, face, lookFromOutside);
+				});
 		StagingBuffer_MainThread::UnMapMemory();
-		Create_Internal(format_initial, format_final, generateMipmap);
+		Create_Internal(format_staging, format_final, generateMipmap);
+	}
+
+	TextureCube::TextureCube(const TextureContainer& container)
+	{
+		Create(container);
+	}
+
+	void TextureCube::Create(const TextureContainer& container)
+	{
+		if (!container.IsCube() || container.layerCount != 1)
+			throw std::runtime_error("[ textureCube ] ERROR\nContainer is not a single cubemap!\n");
+		extent = container.extent;
+		CreateFromContainer(container, VK_IMAGE_VIEW_TYPE_CUBE, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
+	}
+
+	void TextureCube::WriteFace(uint8_t* pData_dst, VkFormat format_dst, const uint8_t* pImageData, VkFormat format_src, size_t srcRowPitch, VkExtent2D extent, size_t face, bool lookFromOutside)
+	{
+		TEXEL_TRANSFORM transform =
+			lookFromOutside ? TEXEL_TRANSFORM::NONE :
+			face == 2 || face == 3 ? TEXEL_TRANSFORM::FLIP_VERTICAL : TEXEL_TRANSFORM::FLIP_HORIZONTAL;
+		PixelConverter::ConvertTexels(pImageData, srcRowPitch, format_src, pData_dst, vkuFormatElementSize(format_dst) * extent.width, format_dst, extent, transform);
 	}
 
 	void TextureCube::Create(const char* const* filepaths, VkFormat format_initial, VkFormat format_final, bool lookFromOutside, bool generateMipmap)
 	{
-		std::unique_ptr<uint8_t[]> psImageData[6] = {};
 		for (size_t i = 0; i < 6; i++) {
 			VkExtent2D extent_currentLayer;
-			psImageData[i] = LoadFile(filepaths[i], extent_currentLayer, format_initial);
-			if (psImageData[i]) {
-				if (i == 0)
-					extent = extent_currentLayer;
-				if (extent.width == extent_currentLayer.width ||
-					extent.height == extent_currentLayer.height)
-					continue;
-				else {
-					std::cerr << std::format("[ textureCube ] ERROR\nImage not available!\nFile: {}\nAll the images must be in same size!\n", filepaths[i]);
-					throw std::runtime_error("[ textureCube ] ERROR::Image not available!");
-				}
+			if (!ReadFileExtent(filepaths[i], extent_currentLayer))
+				throw std::runtime_error(std::format("[ Texture ] ERROR\nFailed to load the file: {}\n", filepaths[i]));
+			if (i == 0)
+				extent = extent_currentLayer;
+			if (extent.width != extent_currentLayer.width ||
+				extent.height != extent_currentLayer.height) {
+				std::cerr << std::format("[ textureCube ] ERROR\nImage not available!\nFile: {}\nAll the images must be in same size!\n", filepaths[i]);
+				throw std::runtime_error("[ textureCube ] ERROR::Image not available!");
 			}
-			return;
 		}
-		Create(reinterpret_cast<const uint8_t* const*>(psImageData), extent, format_initial, format_final, lookFromOutside, generateMipmap);
+		//Each face is decoded, converted and flipped into its staging slot on its own worker
+		VkFormat format_staging = StagingFormat(format_initial, format_final);
+		size_t dataSizePerPixel = vkuFormatElementSize(format_initial);
+		size_t dataSizePerImage = vkuFormatElementSize(format_staging) * extent.width * extent.height;
+		uint8_t* pData_dst = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(dataSizePerImage * 6));
+		try {
+			DecodeFilesParallel({ filepaths, 6 }, format_initial, [&](size_t face, const uint8_t* pImageData, VkExtent2D extent_decoded) {
+				CheckDecodedExtent("textureCube", filepaths[face], extent_decoded, extent);
+				WriteFace(pData_dst + dataSizePerImage * face, format_staging, pImageData, format_initial, dataSizePerPixel * extent.width, extent, face, lookFromOutside);
+				});
+		}
+		catch (...) {
+			StagingBuffer_MainThread::UnMapMemory();
+			throw;
+		}
+		StagingBuffer_MainThread::UnMapMemory();
+		Create_Internal(format_staging, format_final, generateMipmap);
 	}
 
 	void TextureCube::Create(const uint8_t* const* psImageData, VkExtent2D extent, VkFormat format_initial, VkFormat format_final, bool lookFromOutside, bool generateMipmap)
 	{
 		this->extent = extent;
+		VkFormat format_staging = StagingFormat(format_initial, format_final);
 		size_t dataSizePerPixel = vkuFormatElementSize(format_initial);
-		size_t dataSizePerImage = dataSizePerPixel * extent.width * extent.height;
-		size_t imageDataSize = dataSizePerImage * 6;
-		uint8_t* pData_dst = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(imageDataSize));
-		if (lookFromOutside) {
-			for (size_t i = 0; i < 6; i++)
-				memcpy(pData_dst + dataSizePerImage * i, psImageData[i], dataSizePerImage);
-		}
-		else {
-			for (size_t face = 0; face < 6; face++) {
-				if (face != 2 && face != 3)
-					for (uint32_t j = 0; j < extent.height; j++)
-						for (uint32_t i = 0; i < extent.width; i++)
-							memcpy(
-								pData_dst,
-								psImageData[face] + dataSizePerPixel * ((j + 1) * extent.width - 1 - i),
-								dataSizePerPixel),
-							pData_dst += dataSizePerPixel;
-				else
-					for (uint32_t j = 0; j < extent.height; j++)
-						for (uint32_t i = 0; i < extent.width; i++)
-							memcpy(
-								pData_dst,
-								psImageData[face] + dataSizePerPixel * ((extent.height - 1 - j) * extent.width + i),
-								dataSizePerPixel),
-							pData_dst += dataSizePerPixel;
-			}
-		}
+		size_t dataSizePerImage = vkuFormatElementSize(format_staging) * extent.width * extent.height;
+		uint8_t* pData_dst = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(dataSizePerImage * 6));
+		ParallelFor(6, 0, [&](size_t begin, size_t end) {
+			for (size_t face = begin; face < end; face++)
+				WriteFace(pData_dst + dataSizePerImage * face, format_staging, psImageData[face], format_initial, dataSizePerPixel * extent.width, extent, face, lookFromOutside);
+			});
 		StagingBuffer_MainThread::UnMapMemory();
-		Create_Internal(format_initial, format_final, generateMipmap);
+		Create_Internal(format_staging, format_final, generateMipmap);
 	}
 
 #pragma endregion
@@ -1062,7 +1241,34 @@ namespace HoshioEngine {
 		return { id, std::span<Texture2D>(&vec, 1) };
 	}
 
-	std::pair<int, std::span<Texture2D>> ImageManager::GetTexture2D(std::string name)
+	std::vector<int> ImageManager::CreateTexture2Ds(ArrayRef<const std::string> names, ArrayRef<const char* const> filePaths, VkFormat initial_format, VkFormat final_format, bool generateMip)
+	{
+		if (names.size() != filePaths.size()) {
+			std::cerr << std::format("[ERROR] ImageManager: CreateTexture2Ds got {} names for {} files\n", names.size(), filePaths.size());
+			return {};
+		}
+		std::vector<std::future<ImageData>> decodes(names.size());
+		for (size_t i = 0; i < names.size(); i++)
+			if (!mTexture2DIDs.contains(names[i]) && !TextureContainer::IsContainerFile(filePaths[i]))
+				decodes[i] = Texture::LoadFileAsync(filePaths[i], initial_format);
+
+		//Uploads go through the main thread staging buffer in request order, later files keep decoding meanwhile
+		std::vector<int> ids(names.size(), M_INVALID_ID);
+		for (size_t i = 0; i < names.size(); i++) {
+			if (!decodes[i].valid()) {
+				//Already loaded, or a container that is uploaded as stored
+				ids[i] = mTexture2DIDs.contains(names[i]) ?
+					GetTexture2D(names[i]).first :
+					CreateTexture2D(names[i], filePaths[i], initial_format, final_format, generateMip).first;
+				continue;
+			}
+			ImageData image = decodes[i].get();
+			ids[i] = CreateTexture2D(names[i], image.pData.get(), image.extent, initial_format, final_format, generateMip).first;
+		}
+		return ids;
+	}
+
+	std::pair<int, std::span<Texture2D>> ImageManager::GetTexture2D(std::string_view name)
 	{
 		if (auto it = mTexture2DIDs.find(name); it != mTexture2DIDs.end())
 			return GetTexture2D(it->second);
@@ -1078,7 +1284,7 @@ namespace HoshioEngine {
 		return { M_INVALID_ID, {} };
 	}
 
-	bool ImageManager::HasTexture2D(std::string name)
+	bool ImageManager::HasTexture2D(std::string_view name)
 	{
 		if (auto it = mTexture2DIDs.find(name); it != mTexture2DIDs.end())
 			return HasTexture2D(it->second);
@@ -1203,7 +1409,7 @@ namespace HoshioEngine {
 		return { id, std::span<TextureArray>(&vec, 1) };
 	}
 
-	std::pair<int, std::span<TextureArray>> ImageManager::GetTextureArray(std::string name)
+	std::pair<int, std::span<TextureArray>> ImageManager::GetTextureArray(std::string_view name)
 	{
 		if (auto it = mTextureArrayIDs.find(name); it != mTextureArrayIDs.end())
 			return GetTextureArray(it->second);
@@ -1219,10 +1425,10 @@ namespace HoshioEngine {
 		return { M_INVALID_ID, {} };
 	}
 
-	bool ImageManager::HasTextureArray(std::string name)
+	bool ImageManager::HasTextureArray(std::string_view name)
 	{
 		if (auto it = mTextureArrayIDs.find(name); it != mTextureArrayIDs.end())
-			return HasTexture2D(it->second);
+			return HasTextureArray(it->second);
 		return false;
 	}
 
@@ -1344,7 +1550,7 @@ namespace HoshioEngine {
 		return { id, std::span<TextureCube>(&vec, 1) };
 	}
 
-	std::pair<int, std::span<TextureCube>> ImageManager::GetTextureCube(std::string name)
+	std::pair<int, std::span<TextureCube>> ImageManager::GetTextureCube(std::string_view name)
 	{
 		if (auto it = mTextureCubeIDs.find(name); it != mTextureCubeIDs.end())
 			return GetTextureCube(it->second);
@@ -1360,10 +1566,10 @@ namespace HoshioEngine {
 		return { M_INVALID_ID, {} };
 	}
 
-	bool ImageManager::HasTextureCube(std::string name)
+	bool ImageManager::HasTextureCube(std::string_view name)
 	{
 		if (auto it = mTextureCubeIDs.find(name); it != mTextureCubeIDs.end())
-			return HasTexture2D(it->second);
+			return HasTextureCube(it->second);
 		return false;
 	}
 
@@ -1410,7 +1616,7 @@ namespace HoshioEngine {
 		return { id, std::span<ColorAttachment>(vec.data(), vec.size()) };
 	}
 
-	std::pair<int, std::span<ColorAttachment>> ImageManager::GetColorAttachments(std::string name)
+	std::pair<int, std::span<ColorAttachment>> ImageManager::GetColorAttachments(std::string_view name)
 	{
 		if (auto it = mColorAttachmentIDs.find(name); it != mColorAttachmentIDs.end())
 			return GetColorAttachments(it->second);
@@ -1426,7 +1632,7 @@ namespace HoshioEngine {
 		return { M_INVALID_ID, {} };
 	}
 
-	int ImageManager::DestroyColorAttachments(std::string name)
+	int ImageManager::DestroyColorAttachments(std::string_view name)
 	{
 		if (auto it = mColorAttachmentIDs.find(name); it != mColorAttachmentIDs.end())
 			return DestroyColorAttachments(it->second);
@@ -1444,7 +1650,7 @@ namespace HoshioEngine {
 		return M_INVALID_ID;
 	}
 
-	bool ImageManager::HasColorAttachments(std::string name)
+	bool ImageManager::HasColorAttachments(std::string_view name)
 	{
 		if (auto it = mColorAttachmentIDs.find(name); it != mColorAttachmentIDs.end())
 			return HasColorAttachments(it->second);
@@ -1494,7 +1700,7 @@ namespace HoshioEngine {
 		return { id, std::span<DepthStencilAttachment>(vec.data(), vec.size()) };
 	}
 
-	std::pair<int, std::span<DepthStencilAttachment>> ImageManager::GetDepthStencilAttachments(std::string name)
+	std::pair<int, std::span<DepthStencilAttachment>> ImageManager::GetDepthStencilAttachments(std::string_view name)
 	{
 		if (auto it = mDepthStencilAttachmentIDs.find(name); it != mDepthStencilAttachmentIDs.end())
 			return GetDepthStencilAttachments(it->second);
@@ -1510,7 +1716,7 @@ namespace HoshioEngine {
 		return { M_INVALID_ID, {} };
 	}
 
-	int ImageManager::DestroyDepthStencilAttachments(std::string name)
+	int ImageManager::DestroyDepthStencilAttachments(std::string_view name)
 	{
 		if (auto it = mDepthStencilAttachmentIDs.find(name); it != mDepthStencilAttachmentIDs.end())
 			return DestroyDepthStencilAttachments(it->second);
@@ -1528,7 +1734,7 @@ namespace HoshioEngine {
 		return M_INVALID_ID;
 	}
 
-	bool ImageManager::HasDepthStencilAttachments(std::string name)
+	bool ImageManager::HasDepthStencilAttachments(std::string_view name)
 	{
 		if (auto it = mDepthStencilAttachmentIDs.find(name); it != mDepthStencilAttachmentIDs.end())
 			return HasDepthStencilAttachments(it->second);
@@ -1578,7 +1784,7 @@ namespace HoshioEngine {
 		return { id, std::span<CubeAttachment>(vec.data(), vec.size()) };
 	}
 
-	std::pair<int, std::span<CubeAttachment>> ImageManager::GetCubeAttachments(std::string name)
+	std::pair<int, std::span<CubeAttachment>> ImageManager::GetCubeAttachments(std::string_view name)
 	{
 		if (auto it = mCubeAttachmentIDs.find(name); it != mCubeAttachmentIDs.end())
 			return GetCubeAttachments(it->second);
@@ -1594,7 +1800,7 @@ namespace HoshioEngine {
 		return { M_INVALID_ID, {} };
 	}
 
-	int ImageManager::DestroyCubeAttachments(std::string name)
+	int ImageManager::DestroyCubeAttachments(std::string_view name)
 	{
 		if (auto it = mCubeAttachmentIDs.find(name); it != mCubeAttachmentIDs.end())
 			return DestroyCubeAttachments(it->second);
@@ -1612,7 +1818,7 @@ namespace HoshioEngine {
 		return M_INVALID_ID;
 	}
 
-	bool ImageManager::HasCubeAttachments(std::string name)
+	bool ImageManager::HasCubeAttachments(std::string_view name)
 	{
 		if (auto it = mCubeAttachmentIDs.find(name); it != mCubeAttachmentIDs.end())
 			return HasCubeAttachments(it->second);
@@ -0,0 +1,242 @@
+#include "Plus/MipGenerator.h"
+#include "Plus/VulkanPlus.h"
+#include "Base/ShaderCompiler.h"
+
+namespace HoshioEngine {
+
+	namespace {
+		constexpr const char* defaultShaderPath = "res/shaders/GLSL/SinglePassDownsample.comp";
+		//Each workgroup covers a 64x64 tile of level 0
+		constexpr uint32_t tileExtent = 64;
+
+		struct PushConstants {
+			uint32_t mipCount;
+			uint32_t workGroupCount;
+		};
+
+		//Shader format qualifier of a storage format
+		const char* FormatQualifier(VkFormat storageFormat) {
+			switch (storageFormat) {
+			case VK_FORMAT_R8_UNORM: return "r8";
+			case VK_FORMAT_R8G8_UNORM: return "rg8";
+			case VK_FORMAT_R8G8B8A8_UNORM: return "rgba8";
+			case VK_FORMAT_R8G8B8A8_SNORM: return "rgba8_snorm";
+			case VK_FORMAT_R16_SFLOAT: return "r16f";
+			case VK_FORMAT_R16G16_SFLOAT: return "rg16f";
+			case VK_FORMAT_R16G16B16A16_SFLOAT: return "rgba16f";
+			case VK_FORMAT_R16G16B16A16_UNORM: return "rgba16";
+			case VK_FORMAT_R32_SFLOAT: return "r32f";
+			case VK_FORMAT_R32G32_SFLOAT: return "rg32f";
+			case VK_FORMAT_R32G32B32A32_SFLOAT: return "rgba32f";
+			case VK_FORMAT_B10G11R11_UFLOAT_PACK32: return "r11f_g11f_b10f";
+			case VK_FORMAT_A2B10G10R10_UNORM_PACK32: return "rgb10_a2";
+			default: return nullptr;
+			}
+		}
+	}
+
+#pragma region Resources
+
+	MipGenerator::Resources::~Resources()
+	{
+		if (descriptorSet != VK_NULL_HANDLE)
+			VulkanPlus::Plus().DescriptorPool().FreeDescriptorSets(descriptorSet);
+	}
+
+#pragma endregion
+
+#pragma region MipGenerator
+
+	MipGenerator& MipGenerator::Generator()
+	{
+		static MipGenerator generator;
+		return generator;
+	}
+
+	VkFormat MipGenerator::StorageFormat(VkFormat format)
+	{
+		//sRGB has no storage support anywhere, its UNORM twin is written and the shader does the encoding
+		if (format == VK_FORMAT_R8G8B8A8_SRGB)
+			format = VK_FORMAT_R8G8B8A8_UNORM;
+		return FormatQualifier(format) ? format : VK_FORMAT_UNDEFINED;
+	}
+
+	VkImageCreateFlags MipGenerator::RequiredImageCreateFlags(VkFormat format)
+	{
+		//Extended usage lets the sRGB image carry STORAGE although only its UNORM views use it
+		if (StorageFormat(format) != format)
+			return VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+		return 0;
+	}
+
+	bool MipGenerator::FormatIsSupported(VkFormat format)
+	{
+		VkFormat storageFormat = StorageFormat(format);
+		return storageFormat != VK_FORMAT_UNDEFINED &&
+			(ImageUtils::FormatProperties(storageFormat).optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) &&
+			(ImageUtils::FormatProperties(format).optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+	}
+
+	bool MipGenerator::IsSupported(VkFormat format, VkExtent2D imageExtent, uint32_t mipLevelCount)
+	{
+		if (mipLevelCount < 2 || mipLevelCount - 1 > maxGeneratedMipCount)
+			return false;
+		//Level 6 must fit in the one 64x64 tile the last workgroup reduces
+		if (mipLevelCount > 7 && std::max(imageExtent.width, imageExtent.height) > tileExtent << 6)
+			return false;
+		return FormatIsSupported(format);
+	}
+
+	void MipGenerator::CreateLayouts()
+	{
+		VkDescriptorSetLayoutBinding bindings[] = {
+			{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxGeneratedMipCount, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT }
+		};
+		VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
+			.bindingCount = uint32_t(std::size(bindings)),
+			.pBindings = bindings
+		};
+		descriptorSetLayout.Create(descriptorSetLayoutCreateInfo);
+
+		VkPushConstantRange pushConstantRange = { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants) };
+		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
+			.setLayoutCount = 1,
+			.pSetLayouts = descriptorSetLayout.Address(),
+			.pushConstantRangeCount = 1,
+			.pPushConstantRanges = &pushConstantRange
+		};
+		pipelineLayout.Create(pipelineLayoutCreateInfo);
+
+		//Sized once for the largest layer count, never reallocated under a recorded command buffer
+		counterBuffer.Create(VkDeviceSize(VulkanBase::Base().PhysicalDeviceProperties().limits.maxImageArrayLayers) * sizeof(uint32_t));
+		sampler = VulkanPlus::Plus().AcquireSampler(Sampler::SamplerCreateInfo(VK_FILTER_NEAREST, VK_FILTER_NEAREST, VK_SAMPLER_MIPMAP_MODE_NEAREST)).second[0];
+	}
+
+	VkPipeline MipGenerator::AcquirePipeline(VkFormat format, MIP_FILTER filter, const char* customShaderPath)
+	{
+		std::string shaderPath = customShaderPath ? customShaderPath : defaultShaderPath;
+		if (customShaderPath)
+			filter = MIP_FILTER::AVERAGE;
+		std::string key = std::format("{}|{}|{}", shaderPath, uint32_t(format), uint32_t(filter));
+		if (auto iter = mPipelines.find(key); iter != mPipelines.end())
+			return iter->second;
+
+		VkFormat storageFormat = StorageFormat(format);
+		ShaderCompileInfo compileInfo = {
+			.filePath = shaderPath,
+			.stage = VK_SHADER_STAGE_COMPUTE_BIT,
+			.defines = { { "STORAGE_FORMAT", FormatQualifier(storageFormat) } }
+		};
+		if (storageFormat != format)
+			compileInfo.defines.push_back({ "SRGB" });
+		if (filter == MIP_FILTER::MIN)
+			compileInfo.defines.push_back({ "FILTER_MIN" });
+		else if (filter == MIP_FILTER::MAX)
+			compileInfo.defines.push_back({ "FILTER_MAX" });
+
+		ShaderBinary binary = ShaderCompiler::Compiler().Compile(compileInfo);
+		ShaderModule shaderModule(binary.code.size() * sizeof(uint32_t), binary.code.data());
+		VkComputePipelineCreateInfo createInfo = {
+			.stage = shaderModule.ShaderStageCi(VK_SHADER_STAGE_COMPUTE_BIT),
+			.layout = pipelineLayout
+		};
+		return mPipelines.emplace(std::move(key), Pipeline(createInfo)).first->second;
+	}
+
+	void MipGenerator::CmdGenerateMipmap2D(Resources& resources, VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkExtent2D imageExtent,
+		uint32_t mipLevelCount, uint32_t layerCount, ImageBarrierInfo imgBarrier_to, MIP_FILTER filter, const char* customShaderPath)
+	{
+		if (!IsSupported(format, imageExtent, mipLevelCount)) {
+			std::cerr << std::format("[ MipGenerator ] ERROR\nFormat {} with {} levels of {}x{} cannot be generated in one dispatch!\n",
+				uint32_t(format), mipLevelCount, imageExtent.width, imageExtent.height);
+			throw std::runtime_error("[ MipGenerator ] ERROR::Image not supported!");
+		}
+		if (descriptorSetLayout == VK_NULL_HANDLE)
+			CreateLayouts();
+		VkPipeline pipeline = AcquirePipeline(format, filter, customShaderPath);
+		uint32_t generatedMipCount = mipLevelCount - 1;
+
+		//Level 0 is sampled through a view of the image's own format, sRGB is decoded by the hardware
+		VkImageViewUsageCreateInfo sampledUsage = {
+			.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+			.usage = VK_IMAGE_USAGE_SAMPLED_BIT
+		};
+		VkImageViewCreateInfo viewCreateInfo = {
+			.pNext = &sampledUsage,
+			.image = image,
+			.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+			.format = format,
+			.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, layerCount }
+		};
+		resources.imageViews.clear();
+		resources.imageViews.reserve(mipLevelCount);
+		resources.imageViews.emplace_back(viewCreateInfo);
+		VkFormat storageFormat = StorageFormat(format);
+		for (uint32_t i = 1; i < mipLevelCount; i++)
+			resources.imageViews.emplace_back(image, VK_IMAGE_VIEW_TYPE_2D_ARRAY, storageFormat,
+				VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, layerCount }, VkComponentMapping{});
+
+		if (resources.descriptorSet == VK_NULL_HANDLE)
+			VulkanPlus::Plus().DescriptorPool().AllocateDescriptorSets(resources.descriptorSet, descriptorSetLayout);
+		VkDescriptorImageInfo sourceInfo = { sampler, resources.imageViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		//Unused elements repeat the last level so the whole array is valid
+		VkDescriptorImageInfo destinationInfos[maxGeneratedMipCount];
+		for (uint32_t i = 0; i < maxGeneratedMipCount; i++)
+			destinationInfos[i] = { VK_NULL_HANDLE, resources.imageViews[std::min(i, generatedMipCount - 1) + 1], VK_IMAGE_LAYOUT_GENERAL };
+		VkDescriptorBufferInfo counterInfo = { counterBuffer, 0, VkDeviceSize(layerCount) * sizeof(uint32_t) };
+		resources.descriptorSet.Write(sourceInfo, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
+		resources.descriptorSet.Write(destinationInfos, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1);
+		resources.descriptorSet.Write(counterInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2);
+
+		//The counters may still be in use by a previous dispatch in the same command buffer
+		VkBufferMemoryBarrier counterBarrier = {
+			.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+			.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.buffer = counterBuffer,
+			.size = VK_WHOLE_SIZE
+		};
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+			0, nullptr, 1, &counterBarrier, 0, nullptr);
+		vkCmdFillBuffer(commandBuffer, counterBuffer, 0, counterInfo.range, 0);
+		counterBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		counterBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+			0, nullptr, 1, &counterBarrier, 0, nullptr);
+
+		ImageUtils::CmdImagePipelineBarrier(commandBuffer, image,
+			VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, layerCount },
+			ImageBarrierInfo{ VK_PIPELINE_STAGE_TRANSFER_BIT, 0, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL },
+			ImageBarrierInfo{ VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+		ImageUtils::CmdImagePipelineBarrier(commandBuffer, image,
+			VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 1, generatedMipCount, 0, layerCount },
+			ImageBarrierInfo{ VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED },
+			ImageBarrierInfo{ VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL });
+
+		uint32_t groupCountX = (imageExtent.width + tileExtent - 1) / tileExtent;
+		uint32_t groupCountY = (imageExtent.height + tileExtent - 1) / tileExtent;
+		PushConstants pushConstants = { generatedMipCount, groupCountX * groupCountY };
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, resources.descriptorSet.Address(), 0, nullptr);
+		vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof pushConstants, &pushConstants);
+		vkCmdDispatch(commandBuffer, groupCountX, groupCountY, layerCount);
+
+		if (imgBarrier_to.isNeeded) {
+			ImageUtils::CmdImagePipelineBarrier(commandBuffer, image,
+				VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, layerCount },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL },
+				imgBarrier_to);
+			ImageUtils::CmdImagePipelineBarrier(commandBuffer, image,
+				VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 1, generatedMipCount, 0, layerCount },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL },
+				imgBarrier_to);
+		}
+	}
+
+#pragma endregion
+
+}
@@ -0,0 +1,184 @@
+#include "Plus/TextureAtlas.h"
+#include "Utils/PixelConverter.h"
+
+namespace HoshioEngine {
+
+#pragma region AtlasRegion
+
+	glm::vec2 AtlasRegion::Transform(glm::vec2 uv) const
+	{
+		return uv * uvScale + uvOffset;
+	}
+
+	glm::vec4 AtlasRegion::UVTransform() const
+	{
+		return glm::vec4(uvScale, uvOffset);
+	}
+
+#pragma endregion
+
+#pragma region TextureAtlas
+
+	TextureAtlas::TextureAtlas(ArrayRef<const char* const> filePaths, VkFormat format_initial, VkFormat format_final, const TextureAtlasSettings& settings)
+	{
+		Create(filePaths, format_initial, format_final, settings);
+	}
+
+	TextureAtlas::TextureAtlas(ArrayRef<const ImageData> images, VkFormat format_initial, VkFormat format_final, const TextureAtlasSettings& settings)
+	{
+		Create(images, format_initial, format_final, settings);
+	}
+
+	uint32_t TextureAtlas::MipLevelCount() const
+	{
+		return mipLevelCount;
+	}
+
+	uint32_t TextureAtlas::Padding() const
+	{
+		return padding;
+	}
+
+	const AtlasRegion& TextureAtlas::Region(size_t index) const
+	{
+		return regions[index];
+	}
+
+	std::span<const AtlasRegion> TextureAtlas::Regions() const
+	{
+		return regions;
+	}
+
+	float TextureAtlas::Occupancy() const
+	{
+		return occupancy;
+	}
+
+	uint32_t TextureAtlas::Pack(ArrayRef<const ImageData> images, const TextureAtlasSettings& settings, std::vector<VkRect2D>& blocks)
+	{
+		const VkExtent2D& layerExtent = settings.layerExtent;
+		//Blocks start and end on whole texels of the last level, so no level mixes two images
+		uint32_t alignment = 1u << (mipLevelCount - 1);
+		auto BlockExtent = [&](VkExtent2D extent) -> VkExtent2D {
+			return {
+				(extent.width + 2 * padding + alignment - 1) & ~(alignment - 1),
+				(extent.height + 2 * padding + alignment - 1) & ~(alignment - 1)
+			};
+		};
+
+		//Tallest first keeps the skyline flat
+		std::vector<size_t> order(images.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+			VkExtent2D extent_a = images[a].extent, extent_b = images[b].extent;
+			return extent_a.height != extent_b.height ? extent_a.height > extent_b.height : extent_a.width > extent_b.width;
+			});
+
+		uint32_t maxLayerCount = VulkanBase::Base().PhysicalDeviceProperties().limits.maxImageArrayLayers;
+		std::vector<SkylinePacker> packers;
+		uint64_t imageArea = 0;
+		for (size_t i : order) {
+			VkExtent2D extent = images[i].extent;
+			VkExtent2D blockExtent = BlockExtent(extent);
+			if (!extent.width || !extent.height || blockExtent.width > layerExtent.width || blockExtent.height > layerExtent.height) {
+				std::cerr << std::format("[ TextureAtlas ] ERROR\nImage {} ({}x{}) does not fit a {}x{} layer with a padding of {}!\n",
+					i, extent.width, extent.height, layerExtent.width, layerExtent.height, padding);
+				throw std::runtime_error("[ TextureAtlas ] ERROR::Image does not fit a layer!");
+			}
+
+			//Lowest top edge over all layers, a new layer only when none has room
+			size_t bestLayer = packers.size();
+			VkOffset2D bestOffset = {};
+			for (size_t layer = 0; layer < packers.size(); layer++) {
+				VkOffset2D offset;
+				if (packers[layer].Find(blockExtent, offset) && (bestLayer == packers.size() || offset.y < bestOffset.y))
+					bestLayer = layer, bestOffset = offset;
+			}
+			if (bestLayer == packers.size()) {
+				if (packers.size() == maxLayerCount) {
+					std::cerr << std::format("[ TextureAtlas ] ERROR\nLayer count is out of limit! Must be less than: {}\n", maxLayerCount);
+					throw std::runtime_error("[ TextureAtlas ] ERROR::Layer count is out of limit!");
+				}
+				packers.emplace_back(layerExtent);
+				packers.back().Find(blockExtent, bestOffset);
+			}
+			packers[bestLayer].Insert({ bestOffset, blockExtent });
+			blocks[i] = { bestOffset, blockExtent };
+
+			AtlasRegion& region = regions[i];
+			region.layer = uint32_t(bestLayer);
+			region.rect = { { bestOffset.x + int32_t(padding), bestOffset.y + int32_t(padding) }, extent };
+			region.uvScale = glm::vec2(extent.width, extent.height) / glm::vec2(layerExtent.width, layerExtent.height);
+			region.uvOffset = glm::vec2(region.rect.offset.x, region.rect.offset.y) / glm::vec2(layerExtent.width, layerExtent.height);
+			imageArea += uint64_t(extent.width) * extent.height;
+		}
+		occupancy = packers.empty() ? 0.f : float(imageArea) / (float(layerExtent.width) * layerExtent.height * packers.size());
+		return uint32_t(packers.size());
+	}
+
+	void TextureAtlas::Create(ArrayRef<const char* const> filePaths, VkFormat format_initial, VkFormat format_final, const TextureAtlasSettings& settings)
+	{
+		size_t texelSize = vkuFormatElementSize(format_initial);
+		std::vector<ImageData> images(filePaths.size());
+		DecodeFilesParallel(filePaths, format_initial, [&](size_t index, const uint8_t* pImageData, VkExtent2D extent) {
+			size_t dataSize = texelSize * extent.width * extent.height;
+			images[index].pData = std::make_unique<uint8_t[]>(dataSize);
+			images[index].extent = extent;
+			memcpy(images[index].pData.get(), pImageData, dataSize);
+			});
+		Create(ArrayRef<const ImageData>(images.data(), images.size()), format_initial, format_final, settings);
+	}
+
+	void TextureAtlas::Create(ArrayRef<const ImageData> images, VkFormat format_initial, VkFormat format_final, const TextureAtlasSettings& settings)
+	{
+		if (!images.size()) {
+			std::cerr << "[ TextureAtlas ] ERROR\nNo image to pack!\n";
+			throw std::runtime_error("[ TextureAtlas ] ERROR::No image to pack!");
+		}
+		mipLevelCount = std::clamp(settings.mipLevelCount, 1u, ImageUtils::CalculateMipLevelCount(settings.layerExtent));
+		//At least one texel of border on the last level
+		padding = std::max(settings.padding, 1u << (mipLevelCount - 1));
+		regions.assign(images.size(), {});
+		std::vector<VkRect2D> blocks(images.size());
+		layerCount = Pack(images, settings, blocks);
+		extent = settings.layerExtent;
+
+		VkFormat format_staging = StagingFormat(format_initial, format_final);
+		size_t srcTexelSize = vkuFormatElementSize(format_initial);
+		size_t texelSize = vkuFormatElementSize(format_staging);
+		size_t rowPitch = texelSize * extent.width;
+		size_t dataSizePerLayer = rowPitch * extent.height;
+		uint8_t* pData_dst = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(dataSizePerLayer * layerCount));
+		//Space no image claimed stays black
+		ParallelFor(layerCount, 0, [&](size_t begin, size_t end) {
+			memset(pData_dst + dataSizePerLayer * begin, 0, dataSizePerLayer * (end - begin));
+			});
+		//Every block is the converted image surrounded by copies of its nearest edge texel, like clamp to edge would read
+		ParallelFor(images.size(), 0, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				const VkRect2D& block = blocks[i];
+				const uint8_t* pData_src = images[i].pData.get();
+				uint32_t width = regions[i].rect.extent.width, height = regions[i].rect.extent.height;
+				uint32_t rightBorder = block.extent.width - padding - width;
+				size_t srcRowPitch = srcTexelSize * width;
+				uint8_t* pBlock = pData_dst + dataSizePerLayer * regions[i].layer + rowPitch * block.offset.y + texelSize * block.offset.x;
+				for (uint32_t y = 0; y < block.extent.height; y++) {
+					uint32_t y_src = y < padding ? 0 : std::min(y - padding, height - 1);
+					const uint8_t* pRow_src = pData_src + srcRowPitch * y_src;
+					uint8_t* pRow_dst = pBlock + rowPitch * y;
+					uint8_t* pImageRow_dst = pRow_dst + texelSize * padding;
+					PixelConverter::ConvertRow(pRow_src, format_initial, pImageRow_dst, format_staging, width);
+					for (uint32_t x = 0; x < padding; x++)
+						memcpy(pRow_dst + texelSize * x, pImageRow_dst, texelSize);
+					for (uint32_t x = 0; x < rightBorder; x++)
+						memcpy(pImageRow_dst + texelSize * (width + x), pImageRow_dst + texelSize * (width - 1), texelSize);
+				}
+			}
+			});
+		StagingBuffer_MainThread::UnMapMemory();
+		Create_Internal(format_staging, format_final, true, mipLevelCount);
+	}
+
+#pragma endregion
+
+}
@@ -0,0 +1,395 @@
+#include "Plus/TextureStreamer.h"
+#include "Plus/VulkanPlus.h"
+#include "Utils/ImageUtils.h"
+
+namespace HoshioEngine {
+
+	namespace {
+		//vkCmdCopyBufferToImage wants bufferOffset to be a multiple of both the texel block size and 4
+		VkDeviceSize UploadAlignment(VkFormat format) {
+			return std::lcm(VkDeviceSize(vkuFormatElementSize(format)), VkDeviceSize(4));
+		}
+
+		VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+			return (value + alignment - 1) / alignment * alignment;
+		}
+	}
+
+#pragma region StreamedTexture2D
+
+	VkDeviceSize StreamedTexture2D::LevelRangeSize(uint32_t firstMip, uint32_t endMip) const
+	{
+		VkDeviceSize size = 0;
+		for (uint32_t i = firstMip; i < endMip; i++)
+			size += container.levels[i].size;
+		return size;
+	}
+
+	void StreamedTexture2D::CmdSetResidency(VkCommandBuffer commandBuffer, uint32_t newAllocatedMip, uint32_t newResidentMip,
+		VkBuffer stagingBuffer, uint8_t* pStaging, VkDeviceSize& stagingOffset, std::vector<std::pair<ImageMemory, ImageView>>& retired)
+	{
+		uint32_t mipLevelCount = MipLevelCount();
+		if (newAllocatedMip != allocatedMip) {
+			VkImage oldImage = imageMemory.Image();
+			uint32_t oldAllocatedMip = allocatedMip;
+			retired.emplace_back(std::move(imageMemory), std::move(imageView));
+
+			uint32_t levelCount = mipLevelCount - newAllocatedMip;
+			VkExtent2D extent = container.levels[newAllocatedMip].extent;
+			CreateImageMemory(VK_IMAGE_TYPE_2D, container.format, { extent.width, extent.height, 1 }, levelCount, 1);
+			//Levels not uploaded yet stay in TRANSFER_DST_OPTIMAL, no view reaches them
+			ImageUtils::CmdImagePipelineBarrier(commandBuffer, imageMemory.Image(),
+				VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, levelCount, 0, 1 },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL });
+
+			//Uploaded levels both images hold are copied on the device, only the missing ones come from the file
+			uint32_t firstKeptMip = std::max(residentMip, newResidentMip);
+			if (oldImage && firstKeptMip < mipLevelCount) {
+				ImageUtils::CmdImagePipelineBarrier(commandBuffer, oldImage,
+					VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, firstKeptMip - oldAllocatedMip, mipLevelCount - firstKeptMip, 0, 1 },
+					ImageBarrierInfo{ VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL },
+					ImageBarrierInfo{ VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL });
+				std::vector<VkImageCopy> regions;
+				regions.reserve(mipLevelCount - firstKeptMip);
+				for (uint32_t mip = firstKeptMip; mip < mipLevelCount; mip++)
+					regions.push_back({
+						.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip - oldAllocatedMip, 0, 1 },
+						.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip - newAllocatedMip, 0, 1 },
+						.extent = { container.levels[mip].extent.width, container.levels[mip].extent.height, 1 }
+						});
+				vkCmdCopyImage(commandBuffer, oldImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, imageMemory.Image(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					uint32_t(regions.size()), regions.data());
+				ImageUtils::CmdImagePipelineBarrier(commandBuffer, imageMemory.Image(),
+					VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, firstKeptMip - newAllocatedMip, mipLevelCount - firstKeptMip, 0, 1 },
+					ImageBarrierInfo{ VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL },
+					ImageBarrierInfo{ VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+			}
+			allocatedMip = newAllocatedMip;
+		}
+		else
+			retired.emplace_back(ImageMemory(), std::move(imageView));
+
+		if (newResidentMip < residentMip) {
+			VkDeviceSize alignment = UploadAlignment(container.format);
+			for (uint32_t mip = newResidentMip; mip < residentMip; mip++) {
+				stagingOffset = AlignUp(stagingOffset, alignment);
+				container.CopyLevel(mip, pStaging + stagingOffset);
+				VkBufferImageCopy region = {
+					.bufferOffset = stagingOffset,
+					.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip - allocatedMip, 0, 1 },
+					.imageExtent = { container.levels[mip].extent.width, container.levels[mip].extent.height, 1 },
+				};
+				vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, imageMemory.Image(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+				stagingOffset += container.levels[mip].size;
+			}
+			ImageUtils::CmdImagePipelineBarrier(commandBuffer, imageMemory.Image(),
+				VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, newResidentMip - allocatedMip, residentMip - newResidentMip, 0, 1 },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL },
+				ImageBarrierInfo{ VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+		}
+
+		//The view is clamped to the uploaded levels both ways, evicting and streaming in
+		CreateImageView(VK_IMAGE_VIEW_TYPE_2D, container.format, mipLevelCount - newResidentMip, 1, 0, newResidentMip - allocatedMip);
+		residentMip = newResidentMip;
+	}
+
+	void StreamedTexture2D::RewriteDescriptors() const
+	{
+		if (descriptorBindings.empty())
+			return;
+		std::vector<VkDescriptorImageInfo> imageInfos;
+		std::vector<VkWriteDescriptorSet> writes;
+		imageInfos.reserve(descriptorBindings.size());
+		writes.reserve(descriptorBindings.size());
+		for (const DescriptorBinding& binding : descriptorBindings) {
+			imageInfos.push_back(DescriptorImageInfo(binding.sampler));
+			writes.push_back({
+				.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				.dstSet = binding.descriptorSet,
+				.dstBinding = binding.binding,
+				.dstArrayElement = binding.arrayElement,
+				.descriptorCount = 1,
+				.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+				.pImageInfo = &imageInfos.back()
+				});
+		}
+		DescriptorSet::Update(writes);
+	}
+
+	VkExtent2D StreamedTexture2D::Extent() const
+	{
+		return container.extent;
+	}
+
+	VkFormat StreamedTexture2D::Format() const
+	{
+		return container.format;
+	}
+
+	uint32_t StreamedTexture2D::MipLevelCount() const
+	{
+		return container.MipLevelCount();
+	}
+
+	uint32_t StreamedTexture2D::AllocatedMip() const
+	{
+		return allocatedMip;
+	}
+
+	uint32_t StreamedTexture2D::ResidentMip() const
+	{
+		return residentMip;
+	}
+
+	VkExtent2D StreamedTexture2D::ResidentExtent() const
+	{
+		return residentMip < MipLevelCount() ? container.levels[residentMip].extent : VkExtent2D{};
+	}
+
+	VkDeviceSize StreamedTexture2D::ResidentSize() const
+	{
+		return LevelRangeSize(allocatedMip, MipLevelCount());
+	}
+
+	bool StreamedTexture2D::IsFullyResident() const
+	{
+		return residentMip == 0;
+	}
+
+#pragma endregion
+
+#pragma region TextureStreamer
+
+	std::pair<int, std::span<StreamedTexture2D>> TextureStreamer::CreateStreamedTexture2D(std::string name, const char* filePath)
+	{
+		if (auto it = mStreamedTextureIDs.find(name); it != mStreamedTextureIDs.end()) {
+			std::cout << std::format("[TextureStreamer]::Warning::StreamedTexture2D({}) has been loaded!", name);
+			return GetStreamedTexture2D(name);
+		}
+
+		StreamedTexture2D texture;
+		texture.container = TextureContainer::Load(filePath);
+		if (texture.container.ArrayLayerCount() != 1)
+			throw std::runtime_error(std::format("[ TextureStreamer ] ERROR\nOnly single 2D images can be streamed: {}\n", filePath));
+		if (!Texture::FormatIsSupported(texture.container.format)) {
+			std::cerr << std::format("[ TextureStreamer ] ERROR\nFormat {} cannot be sampled on this device!\n", uint32_t(texture.container.format));
+			throw std::runtime_error("[ TextureStreamer ] ERROR::Format not supported!");
+		}
+
+		//Only the tail is uploaded here, so creation costs the same whatever the size of level 0
+		uint32_t mipLevelCount = texture.MipLevelCount();
+		uint32_t tailMip = mipLevelCount - 1;
+		while (tailMip > 0 &&
+			std::max(texture.container.levels[tailMip - 1].extent.width, texture.container.levels[tailMip - 1].extent.height) <= settings.tailExtent)
+			tailMip--;
+		texture.tailMip = tailMip;
+		texture.allocatedMip = texture.residentMip = mipLevelCount;
+
+		VkDeviceSize stagingSize = texture.LevelRangeSize(tailMip, mipLevelCount) + UploadAlignment(texture.container.format) * (mipLevelCount - tailMip);
+		uint8_t* pStaging = static_cast<uint8_t*>(StagingBuffer_MainThread::MapMemory(stagingSize));
+		auto& commandBuffer = VulkanPlus::Plus().CommandBuffer_Transfer();
+		commandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		VkDeviceSize stagingOffset = 0;
+		texture.CmdSetResidency(commandBuffer, tailMip, tailMip, StagingBuffer_MainThread::Main(), pStaging, stagingOffset, retired);
+		commandBuffer.End();
+		StagingBuffer_MainThread::UnMapMemory();
+		VulkanPlus::Plus().ExecuteCommandBuffer_Graphics(commandBuffer);
+		residentSize += texture.ResidentSize();
+
+		const int id = m_streamed_texture_id++;
+		auto [it1, ok1] = mStreamedTextures.emplace(id, std::move(texture));
+		if (!ok1) {
+			std::cerr << std::format("[ERROR] TextureStreamer: Emplace streamed texture for '{}' (id={}) failed\n", name, id);
+			return { M_INVALID_ID, {} };
+		}
+
+		auto [it2, ok2] = mStreamedTextureIDs.emplace(name, id);
+		if (!ok2) {
+			std::cerr << std::format("[WARNING] TextureStreamer: StreamedTexture2D '{}' has not been recorded!\n", name);
+			residentSize -= it1->second.ResidentSize();
+			mStreamedTextures.erase(id);
+			return { M_INVALID_ID, {} };
+		}
+
+		return { id, std::span<StreamedTexture2D>(&it1->second, 1) };
+	}
+
+	std::pair<int, std::span<StreamedTexture2D>> TextureStreamer::GetStreamedTexture2D(std::string_view name)
+	{
+		if (auto it = mStreamedTextureIDs.find(name); it != mStreamedTextureIDs.end())
+			return GetStreamedTexture2D(it->second);
+		std::cerr << std::format("[ERROR] TextureStreamer: StreamedTexture2D with name '{}' do not exist!\n", name);
+		return { M_INVALID_ID, {} };
+	}
+
+	std::pair<int, std::span<StreamedTexture2D>> TextureStreamer::GetStreamedTexture2D(int id)
+	{
+		if (auto it = mStreamedTextures.find(id); it != mStreamedTextures.end())
+			return { id, std::span<StreamedTexture2D>(&it->second, 1) };
+		std::cerr << std::format("[ERROR] TextureStreamer: StreamedTexture2D with id {} do not exist!\n", id);
+		return { M_INVALID_ID, {} };
+	}
+
+	bool TextureStreamer::HasStreamedTexture2D(std::string_view name)
+	{
+		if (auto it = mStreamedTextureIDs.find(name); it != mStreamedTextureIDs.end())
+			return HasStreamedTexture2D(it->second);
+		return false;
+	}
+
+	bool TextureStreamer::HasStreamedTexture2D(int id)
+	{
+		return mStreamedTextures.contains(id);
+	}
+
+	size_t TextureStreamer::GetStreamedTexture2DCount() const
+	{
+		return mStreamedTextures.size();
+	}
+
+	void TextureStreamer::BindDescriptor(int id, VkDescriptorSet descriptorSet, VkSampler sampler, uint32_t binding, uint32_t arrayElement)
+	{
+		auto it = mStreamedTextures.find(id);
+		if (it == mStreamedTextures.end()) {
+			std::cerr << std::format("[ERROR] TextureStreamer: StreamedTexture2D with id {} do not exist!\n", id);
+			return;
+		}
+		StreamedTexture2D& texture = it->second;
+		auto& bindings = texture.descriptorBindings;
+		std::erase_if(bindings, [&](const StreamedTexture2D::DescriptorBinding& b) {
+			return b.descriptorSet == descriptorSet && b.binding == binding && b.arrayElement == arrayElement;
+			});
+		bindings.push_back({ descriptorSet, sampler, binding, arrayElement });
+		VkDescriptorImageInfo imageInfo = texture.DescriptorImageInfo(sampler);
+		VkWriteDescriptorSet write = {
+			.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			.dstSet = descriptorSet,
+			.dstBinding = binding,
+			.dstArrayElement = arrayElement,
+			.descriptorCount = 1,
+			.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+			.pImageInfo = &imageInfo
+		};
+		DescriptorSet::Update(write);
+	}
+
+	void TextureStreamer::UnbindDescriptors(VkDescriptorSet descriptorSet)
+	{
+		for (auto& [id, texture] : mStreamedTextures)
+			std::erase_if(texture.descriptorBindings, [&](const StreamedTexture2D::DescriptorBinding& b) {
+				return b.descriptorSet == descriptorSet;
+				});
+	}
+
+	void TextureStreamer::RequestScreenSize(int id, float pixels)
+	{
+		auto it = mStreamedTextures.find(id);
+		if (it == mStreamedTextures.end())
+			return;
+		VkExtent2D extent = it->second.Extent();
+		float size = float(std::max(extent.width, extent.height));
+		//The coarsest level that still has at least one texel per pixel
+		uint32_t mipLevel = pixels >= size ? 0 : uint32_t(std::floor(std::log2(size / std::max(pixels, 1.f))));
+		RequestMip(id, mipLevel);
+	}
+
+	void TextureStreamer::RequestMip(int id, uint32_t mipLevel)
+	{
+		if (auto it = mStreamedTextures.find(id); it != mStreamedTextures.end())
+			it->second.requestedMip = std::min(it->second.requestedMip, mipLevel);
+	}
+
+	void TextureStreamer::Update(VkCommandBuffer commandBuffer)
+	{
+		//The frame that could still read these has been waited on by the caller
+		retired.clear();
+
+		struct Change {
+			StreamedTexture2D* pTexture;
+			uint32_t newAllocatedMip;
+			uint32_t newResidentMip;
+		};
+		//Only live for this call, the frame arena keeps Update() off the heap
+		std::pmr::vector<Change> evictions(&FrameMemory::Frame());
+		std::pmr::vector<Change> streamIns(&FrameMemory::Frame());
+		for (auto& [id, texture] : mStreamedTextures) {
+			uint32_t wantedMip = std::min(texture.requestedMip, texture.tailMip);
+			texture.requestedMip = UINT32_MAX;
+			if (wantedMip > texture.allocatedMip) {
+				if (++texture.unwantedFrames >= settings.evictionDelayFrames)
+					evictions.push_back({ &texture, wantedMip, std::max(wantedMip, texture.residentMip) });
+			}
+			else {
+				texture.unwantedFrames = 0;
+				if (wantedMip < texture.residentMip)
+					streamIns.push_back({ &texture, wantedMip, wantedMip });
+			}
+		}
+
+		//Evictions first so their memory can be handed to stream-ins of the same frame
+		for (const Change& change : evictions)
+			residentSize -= change.pTexture->LevelRangeSize(change.pTexture->allocatedMip, change.newAllocatedMip);
+
+		//Textures furthest from what they want go first, each is refined level by level from its resident top down
+		std::sort(streamIns.begin(), streamIns.end(), [](const Change& a, const Change& b) {
+			return a.pTexture->residentMip - a.newResidentMip > b.pTexture->residentMip - b.newResidentMip;
+			});
+		VkDeviceSize uploadSize = 0;
+		VkDeviceSize stagingSize = 0;
+		std::pmr::vector<Change> changes(evictions, &FrameMemory::Frame());
+		for (const Change& streamIn : streamIns) {
+			StreamedTexture2D& texture = *streamIn.pTexture;
+			//The image grows once to what is wanted, as far as the budget allows, later frames only upload into it
+			uint32_t newAllocatedMip = texture.allocatedMip;
+			while (newAllocatedMip > streamIn.newAllocatedMip &&
+				residentSize + texture.container.levels[newAllocatedMip - 1].size <= settings.residentBudget)
+				residentSize += texture.container.levels[--newAllocatedMip].size;
+			uint32_t newResidentMip = texture.residentMip;
+			while (newResidentMip > newAllocatedMip) {
+				VkDeviceSize levelSize = texture.container.levels[newResidentMip - 1].size;
+				if (uploadSize && uploadSize + levelSize > settings.uploadBudgetPerFrame)
+					break;
+				uploadSize += levelSize;
+				stagingSize += levelSize + UploadAlignment(texture.container.format);
+				newResidentMip--;
+			}
+			if (newResidentMip != texture.residentMip)
+				changes.push_back({ &texture, newAllocatedMip, newResidentMip });
+			else
+				residentSize -= texture.LevelRangeSize(newAllocatedMip, texture.allocatedMip);
+			if (uploadSize >= settings.uploadBudgetPerFrame)
+				break;
+		}
+		if (changes.empty())
+			return;
+
+		uint8_t* pStaging = stagingSize ? static_cast<uint8_t*>(stagingBuffer.MapMemory(stagingSize)) : nullptr;
+		VkDeviceSize stagingOffset = 0;
+		for (const Change& change : changes) {
+			change.pTexture->CmdSetResidency(commandBuffer, change.newAllocatedMip, change.newResidentMip, stagingBuffer, pStaging, stagingOffset, retired);
+			change.pTexture->unwantedFrames = 0;
+		}
+		if (pStaging)
+			stagingBuffer.UnMapMemory();
+		for (const Change& change : changes)
+			change.pTexture->RewriteDescriptors();
+	}
+
+	const TextureStreamingSettings& TextureStreamer::Settings() const
+	{
+		return settings;
+	}
+
+	void TextureStreamer::SetSettings(const TextureStreamingSettings& settings)
+	{
+		this->settings = settings;
+	}
+
+	VkDeviceSize TextureStreamer::ResidentSize() const
+	{
+		return residentSize;
+	}
+
+#pragma endregion
+}
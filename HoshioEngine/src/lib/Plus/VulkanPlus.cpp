@@ -155,54 +155,73 @@ namespace HoshioEngine {
 	{
 		InitSwapchainRenderPass();
 		auto Create = [&] {
-			{
-				swapchainFramebuffers.resize(VulkanBase::Base().SwapchainImageCount());
-				VkFramebufferCreateInfo framebufferCreateInfo = {
-					.renderPass = swapchainRenderPass,
-					.attachmentCount = 1,
-					.width = VulkanBase::Base().SwapchainCi().imageExtent.width,
-					.height = VulkanBase::Base().SwapchainCi().imageExtent.height,
-					.layers = 1
+			const VkExtent2D extent = VulkanBase::Base().SwapchainExtent();
+			const uint32_t imageCount = VulkanBase::Base().SwapchainImageCount();
+
+			swapchainDepthStencilAttachments.resize(imageCount);
+			for (auto& dsAttachment : swapchainDepthStencilAttachments)
+				dsAttachment.Create(VK_FORMAT_D24_UNORM_S8_UINT, extent,
+					false, 1, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT);
+
+			if (VulkanBase::Base().ImagelessFramebufferSupported()) {
+				const VkFormat formats[2] = { VulkanBase::Base().SwapchainCi().imageFormat, VK_FORMAT_D24_UNORM_S8_UINT };
+				VkFramebufferAttachmentImageInfo imageInfos[2] = {
+					{
+						.usage = VulkanBase::Base().SwapchainCi().imageUsage,
+						.width = extent.width,
+						.height = extent.height,
+						.layerCount = 1,
+						.viewFormatCount = 1,
+						.pViewFormats = formats
+					},
+					{
+						.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+						.width = extent.width,
+						.height = extent.height,
+						.layerCount = 1,
+						.viewFormatCount = 1,
+						.pViewFormats = formats + 1
+					}
 				};
-				for (uint32_t i = 0; i < VulkanBase::Base().SwapchainImageCount(); i++) {
-					VkImageView attachment = VulkanBase::Base().SwapchainImageView(i);
-					framebufferCreateInfo.pAttachments = &attachment;
-					swapchainFramebuffers[i].Create(framebufferCreateInfo);
-				}
+				const Framebuffer& framebuffer = rpwf_manager.AcquireImagelessFramebuffer(swapchainRenderPass, imageInfos[0], extent);
+				const Framebuffer& framebufferWithDepthStencil = rpwf_manager.AcquireImagelessFramebuffer(swapchainRenderPassWithDepthStencil, imageInfos, extent);
+				//Recreating at the same size hits the cache, a resize leaves the previous pair unused
+				for (const Framebuffer* previous : swapchainFramebuffers)
+					if (previous != &framebuffer)
+						rpwf_manager.EvictFramebuffer(*previous);
+				for (const Framebuffer* previous : swapchainFramebuffersWithDepthStencil)
+					if (previous != &framebufferWithDepthStencil)
+						rpwf_manager.EvictFramebuffer(*previous);
+				swapchainFramebuffers.assign(1, &framebuffer);
+				swapchainFramebuffersWithDepthStencil.assign(1, &framebufferWithDepthStencil);
+				return;
 			}
-			
-			{
-				swapchainFramebuffersWithDepthStencil.resize(VulkanBase::Base().SwapchainImageCount());
-				swapchainDepthStencilAttachments.resize(VulkanBase::Base().SwapchainImageCount());
-				for (auto& dsAttachment : swapchainDepthStencilAttachments)
-					dsAttachment.Create(VK_FORMAT_D24_UNORM_S8_UINT, VulkanBase::Base().SwapchainCi().imageExtent,
-						false, 1, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT);
-				VkFramebufferCreateInfo framebufferCreateInfo = {
-					.renderPass = swapchainRenderPassWithDepthStencil,
-					.attachmentCount = 2,
-					.width = VulkanBase::Base().SwapchainExtent().width,
-					.height = VulkanBase::Base().SwapchainExtent().height,
-					.layers = 1
+
+			swapchainFramebuffers.resize(imageCount);
+			swapchainFramebuffersWithDepthStencil.resize(imageCount);
+			for (uint32_t i = 0; i < imageCount; i++) {
+				VkImageView attachments[2] = {
+					VulkanBase::Base().SwapchainImageView(i),
+					swapchainDepthStencilAttachments[i].ImageView()
 				};
-				std::vector<VkImageView> attachments(2);
-				for (uint32_t i = 0; i < VulkanBase::Base().SwapchainImageCount(); i++) {
-					attachments[0] = VulkanBase::Base().SwapchainImageView(i);
-					attachments[1] = swapchainDepthStencilAttachments[i].ImageView();
-					framebufferCreateInfo.pAttachments = attachments.data();
-					swapchainFramebuffersWithDepthStencil[i].Create(framebufferCreateInfo);
-				}
+				swapchainFramebuffers[i] = &rpwf_manager.AcquireFramebuffer(swapchainRenderPass, attachments[0], extent);
+				swapchainFramebuffersWithDepthStencil[i] = &rpwf_manager.AcquireFramebuffer(swapchainRenderPassWithDepthStencil, attachments, extent);
 			}
-
-
 			};
 
 		auto Destroy = [&] {
-			if (!swapchainFramebuffers.empty())
+			//Covers every cached framebuffer built on the swapchain images, not only the ones above
+			std::vector<VkImageView> attachments;
+			for (uint32_t i = 0; i < VulkanBase::Base().SwapchainImageCount(); i++)
+				attachments.push_back(VulkanBase::Base().SwapchainImageView(i));
+			for (auto& dsAttachment : swapchainDepthStencilAttachments)
+				attachments.push_back(dsAttachment.ImageView());
+			rpwf_manager.EvictFramebuffers({ attachments.data(), attachments.size() });
+			swapchainDepthStencilAttachments.clear();
+			if (!VulkanBase::Base().ImagelessFramebufferSupported()) {
 				swapchainFramebuffers.clear();
-			if (!swapchainFramebuffersWithDepthStencil.empty())
 				swapchainFramebuffersWithDepthStencil.clear();
-			if (!swapchainDepthStencilAttachments.empty())
-				swapchainDepthStencilAttachments.clear();
+			}
 			};
 
 		Create();
@@ -251,17 +270,21 @@ namespace HoshioEngine {
 	}
 	const Framebuffer& VulkanPlus::CurrentSwapchainFramebuffer() const
 	{
-		return swapchainFramebuffers[VulkanBase::Base().CurrentImageIndex()];
+		if (VulkanBase::Base().ImagelessFramebufferSupported())
+			return *swapchainFramebuffers[0];
+		return *swapchainFramebuffers[VulkanBase::Base().CurrentImageIndex()];
 	}
 	const Framebuffer& VulkanPlus::CurrentSwapchainFramebufferWithDepthStencil() const
 	{
-		return swapchainFramebuffersWithDepthStencil[VulkanBase::Base().CurrentImageIndex()];
+		if (VulkanBase::Base().ImagelessFramebufferSupported())
+			return *swapchainFramebuffersWithDepthStencil[0];
+		return *swapchainFramebuffersWithDepthStencil[VulkanBase::Base().CurrentImageIndex()];
 	}
-	const std::vector<Framebuffer>& VulkanPlus::SwapchainFramebuffers() const
+	const std::vector<const Framebuffer*>& VulkanPlus::SwapchainFramebuffers() const
 	{
 		return swapchainFramebuffers;
 	}
-	const std::vector<Framebuffer>& VulkanPlus::SwapchainFramebuffersWithDepthStencil() const
+	const std::vector<const Framebuffer*>& VulkanPlus::SwapchainFramebuffersWithDepthStencil() const
 	{
 		return swapchainFramebuffersWithDepthStencil;
 	}
@@ -274,6 +297,21 @@ namespace HoshioEngine {
 	{
 		return swapchainRenderPassWithDepthStencil;
 	}
+	void VulkanPlus::BeginSwapchainRenderPass(VkCommandBuffer commandBuffer, bool withDepthStencil, VkRect2D renderArea, ArrayRef<const VkClearValue> clearValues, VkSubpassContents subpassContents) const
+	{
+		const RenderPass& renderPass = withDepthStencil ? swapchainRenderPassWithDepthStencil : swapchainRenderPass;
+		const Framebuffer& framebuffer = withDepthStencil ? CurrentSwapchainFramebufferWithDepthStencil() : CurrentSwapchainFramebuffer();
+		if (!VulkanBase::Base().ImagelessFramebufferSupported()) {
+			renderPass.Begin(commandBuffer, framebuffer, renderArea, clearValues, subpassContents);
+			return;
+		}
+		uint32_t currentImageIndex = VulkanBase::Base().CurrentImageIndex();
+		VkImageView attachments[2] = {
+			VulkanBase::Base().SwapchainImageView(currentImageIndex),
+			swapchainDepthStencilAttachments[currentImageIndex].ImageView()
+		};
+		renderPass.Begin(commandBuffer, framebuffer, { attachments, withDepthStencil ? 2u : 1u }, renderArea, clearValues, subpassContents);
+	}
 
 	void VulkanPlus::ExecuteCommandBuffer_Graphics(VkCommandBuffer commandBuffer) const
 	{
@@ -296,9 +334,14 @@ namespace HoshioEngine {
 		return image_manager.CreateTexture2D(std::move(name), pImageData, extent, initial_format, final_format, generateMip);
 	}
 
-	std::pair<int, std::span<Texture2D>> VulkanPlus::GetTexture2D(std::string name)
+	std::vector<int> VulkanPlus::CreateTexture2Ds(ArrayRef<const std::string> names, ArrayRef<const char* const> filePaths, VkFormat initial_format, VkFormat final_format, bool generateMip)
+	{
+		return image_manager.CreateTexture2Ds(names, filePaths, initial_format, final_format, generateMip);
+	}
+
+	std::pair<int, std::span<Texture2D>> VulkanPlus::GetTexture2D(std::string_view name)
 	{
-		return image_manager.GetTexture2D(std::move(name));
+		return image_manager.GetTexture2D(name);
 	}
 
 	std::pair<int, std::span<Texture2D>> VulkanPlus::GetTexture2D(int id)
@@ -306,9 +349,9 @@ namespace HoshioEngine {
 		return image_manager.GetTexture2D(id);
 	}
 
-	bool VulkanPlus::HasTexture2D(std::string name)
+	bool VulkanPlus::HasTexture2D(std::string_view name)
 	{
-		return image_manager.HasTexture2D(std::move(name));
+		return image_manager.HasTexture2D(name);
 	}
 
 	bool VulkanPlus::HasTexture2D(int id)
@@ -341,9 +384,9 @@ namespace HoshioEngine {
 		return image_manager.CreateTextureArray(std::move(name), psImageData, extent, format_initial, format_final, generateMipmap);
 	}
 
-	std::pair<int, std::span<TextureArray>> VulkanPlus::GetTextureArray(std::string name)
+	std::pair<int, std::span<TextureArray>> VulkanPlus::GetTextureArray(std::string_view name)
 	{
-		return image_manager.GetTextureArray(std::move(name));
+		return image_manager.GetTextureArray(name);
 	}
 
 	std::pair<int, std::span<TextureArray>> VulkanPlus::GetTextureArray(int id)
@@ -351,9 +394,9 @@ namespace HoshioEngine {
 		return image_manager.GetTextureArray(id);
 	}
 
-	bool VulkanPlus::HasTextureArray(std::string name)
+	bool VulkanPlus::HasTextureArray(std::string_view name)
 	{
-		return image_manager.HasTextureArray(std::move(name));
+		return image_manager.HasTextureArray(name);
 	}
 
 	bool VulkanPlus::HasTextureArray(int id)
@@ -386,9 +429,9 @@ namespace HoshioEngine {
 		return image_manager.CreateTextureCube(std::move(name), psImageData, extent, format_initial, format_final, lookFromOutside, generateMipmap);
 	}
 
-	std::pair<int, std::span<TextureCube>> VulkanPlus::GetTextureCube(std::string name)
+	std::pair<int, std::span<TextureCube>> VulkanPlus::GetTextureCube(std::string_view name)
 	{
-		return image_manager.GetTextureCube(std::move(name));
+		return image_manager.GetTextureCube(name);
 	}
 
 	std::pair<int, std::span<TextureCube>> VulkanPlus::GetTextureCube(int id)
@@ -396,9 +439,9 @@ namespace HoshioEngine {
 		return image_manager.GetTextureCube(id);
 	}
 
-	bool VulkanPlus::HasTextureCube(std::string name)
+	bool VulkanPlus::HasTextureCube(std::string_view name)
 	{
-		return image_manager.HasTextureCube(std::move(name));
+		return image_manager.HasTextureCube(name);
 	}
 
 	bool VulkanPlus::HasTextureCube(int id)
@@ -411,14 +454,49 @@ namespace HoshioEngine {
 		return image_manager.GetTextureCubeCount();
 	}
 
+	std::pair<int, std::span<StreamedTexture2D>> VulkanPlus::CreateStreamedTexture2D(std::string name, const char* filePath)
+	{
+		return texture_streamer.CreateStreamedTexture2D(std::move(name), filePath);
+	}
+
+	std::pair<int, std::span<StreamedTexture2D>> VulkanPlus::GetStreamedTexture2D(std::string_view name)
+	{
+		return texture_streamer.GetStreamedTexture2D(name);
+	}
+
+	std::pair<int, std::span<StreamedTexture2D>> VulkanPlus::GetStreamedTexture2D(int id)
+	{
+		return texture_streamer.GetStreamedTexture2D(id);
+	}
+
+	bool VulkanPlus::HasStreamedTexture2D(std::string_view name)
+	{
+		return texture_streamer.HasStreamedTexture2D(name);
+	}
+
+	bool VulkanPlus::HasStreamedTexture2D(int id)
+	{
+		return texture_streamer.HasStreamedTexture2D(id);
+	}
+
+	size_t VulkanPlus::GetStreamedTexture2DCount() const
+	{
+		return texture_streamer.GetStreamedTexture2DCount();
+	}
+
+	TextureStreamer& VulkanPlus::TextureStreaming()
+	{
+		return texture_streamer;
+	}
+
 	std::pair<int, std::span<ColorAttachment>> VulkanPlus::CreateColorAttachments(std::string name, uint32_t count, VkFormat format, VkExtent2D extent, bool hasMipmap, uint32_t layerCount, VkSampleCountFlagBits sampleCount, VkImageUsageFlags otherUsages)
 	{
 		return image_manager.CreateColorAttachments(std::move(name), count, format, extent, hasMipmap, layerCount, sampleCount, otherUsages);
 	}
 
-	int VulkanPlus::DestroyColorAttachments(std::string name)
+	int VulkanPlus::DestroyColorAttachments(std::string_view name)
 	{
-		return image_manager.DestroyColorAttachments(std::move(name));
+		return image_manager.DestroyColorAttachments(name);
 	}
 
 	int VulkanPlus::DestroyColorAttachments(int id)
@@ -426,9 +504,9 @@ namespace HoshioEngine {
 		return image_manager.DestroyColorAttachments(id);
 	}
 
-	std::pair<int, std::span<ColorAttachment>> VulkanPlus::GetColorAttachments(std::string name)
+	std::pair<int, std::span<ColorAttachment>> VulkanPlus::GetColorAttachments(std::string_view name)
 	{
-		return image_manager.GetColorAttachments(std::move(name));
+		return image_manager.GetColorAttachments(name);
 	}
 
 	std::pair<int, std::span<ColorAttachment>> VulkanPlus::GetColorAttachments(int id)
@@ -436,9 +514,9 @@ namespace HoshioEngine {
 		return image_manager.GetColorAttachments(id);
 	}
 
-	bool VulkanPlus::HasColorAttachments(std::string name)
+	bool VulkanPlus::HasColorAttachments(std::string_view name)
 	{
-		return image_manager.HasColorAttachments(std::move(name));
+		return image_manager.HasColorAttachments(name);
 	}
 
 	bool VulkanPlus::HasColorAttachments(int id)
@@ -455,26 +533,26 @@ namespace HoshioEngine {
 	{
 		return image_manager.CreateDepthStencilAttachments(std::move(name), count, format, extent, stencilOnly, layerCount, sampleCount, otherUsages);
 	}
-	int VulkanPlus::DestroyDepthStencilAttachments(std::string name)
+	int VulkanPlus::DestroyDepthStencilAttachments(std::string_view name)
 	{
-		return image_manager.DestroyDepthStencilAttachments(std::move(name));
+		return image_manager.DestroyDepthStencilAttachments(name);
 	}
 	int VulkanPlus::DestroyDepthStencilAttachments(int id)
 	{
 		return image_manager.DestroyDepthStencilAttachments(id);
 	}
-	std::pair<int, std::span<DepthStencilAttachment>> VulkanPlus::GetDepthStencilAttachments(std::string name)
+	std::pair<int, std::span<DepthStencilAttachment>> VulkanPlus::GetDepthStencilAttachments(std::string_view name)
 	{
-		return image_manager.GetDepthStencilAttachments(std::move(name));
+		return image_manager.GetDepthStencilAttachments(name);
 	}
 	std::pair<int, std::span<DepthStencilAttachment>> VulkanPlus::GetDepthStencilAttachments(int id)
 	{
 		return image_manager.GetDepthStencilAttachments(id);
 	}
 
-	bool VulkanPlus::HasDepthStencilAttachments(std::string name)
+	bool VulkanPlus::HasDepthStencilAttachments(std::string_view name)
 	{
-		return image_manager.HasDepthStencilAttachments(std::move(name));
+		return image_manager.HasDepthStencilAttachments(name);
 	}
 
 	bool VulkanPlus::HasDepthStencilAttachments(int id)
@@ -492,9 +570,9 @@ namespace HoshioEngine {
 		return image_manager.CreateCubeAttachments(std::move(name), count, format, extent, hasMipmap, sampleCount, otherUsages);
 	}
 
-	std::pair<int, std::span<CubeAttachment>> VulkanPlus::GetCubeAttachments(std::string name)
+	std::pair<int, std::span<CubeAttachment>> VulkanPlus::GetCubeAttachments(std::string_view name)
 	{
-		return image_manager.GetCubeAttachments(std::move(name));
+		return image_manager.GetCubeAttachments(name);
 	}
 
 	std::pair<int, std::span<CubeAttachment>> VulkanPlus::GetCubeAttachments(int id)
@@ -502,9 +580,9 @@ namespace HoshioEngine {
 		return image_manager.GetCubeAttachments(id);
 	}
 
-	int VulkanPlus::DestroyCubeAttachments(std::string name)
+	int VulkanPlus::DestroyCubeAttachments(std::string_view name)
 	{
-		return image_manager.DestroyCubeAttachments(std::move(name));
+		return image_manager.DestroyCubeAttachments(name);
 	}
 
 	int VulkanPlus::DestroyCubeAttachments(int id)
@@ -512,9 +590,9 @@ namespace HoshioEngine {
 		return image_manager.DestroyCubeAttachments(id);
 	}
 
-	bool VulkanPlus::HasCubeAttachments(std::string name)
+	bool VulkanPlus::HasCubeAttachments(std::string_view name)
 	{
-		return image_manager.HasCubeAttachments(std::move(name));
+		return image_manager.HasCubeAttachments(name);
 	}
 
 	bool VulkanPlus::HasCubeAttachments(int id)
@@ -551,6 +629,21 @@ namespace HoshioEngine {
 	size_t VulkanPlus::GetFramebuffersCount() const {
 		return rpwf_manager.GetFramebuffersCount();
 	}
+	const Framebuffer& VulkanPlus::AcquireFramebuffer(const RenderPass& renderPass, ArrayRef<const VkImageView> attachments, VkExtent2D extent, uint32_t layers) {
+		return rpwf_manager.AcquireFramebuffer(renderPass, attachments, extent, layers);
+	}
+	const Framebuffer& VulkanPlus::AcquireImagelessFramebuffer(const RenderPass& renderPass, ArrayRef<const VkFramebufferAttachmentImageInfo> attachmentImageInfos, VkExtent2D extent, uint32_t layers) {
+		return rpwf_manager.AcquireImagelessFramebuffer(renderPass, attachmentImageInfos, extent, layers);
+	}
+	uint32_t VulkanPlus::EvictFramebuffers(ArrayRef<const VkImageView> attachments) {
+		return rpwf_manager.EvictFramebuffers(attachments);
+	}
+	bool VulkanPlus::EvictFramebuffer(VkFramebuffer framebuffer) {
+		return rpwf_manager.EvictFramebuffer(framebuffer);
+	}
+	size_t VulkanPlus::GetFramebufferCacheCount() const {
+		return rpwf_manager.GetFramebufferCacheCount();
+	}
 	
 	std::pair<int, std::span<Fence>> VulkanPlus::CreateFences(std::string name, uint32_t count, VkFenceCreateFlags flags)
 	{
@@ -614,6 +707,14 @@ namespace HoshioEngine {
 	{
 		return pipeline_manager.CreateShaderModule(std::move(name), codeSize, pCode);
 	}
+	std::pair<int, std::span<ShaderModule>> VulkanPlus::CreateShaderModule(std::string name, const ShaderCompileInfo& compileInfo)
+	{
+		return pipeline_manager.CreateShaderModule(std::move(name), compileInfo);
+	}
+	int VulkanPlus::WatchShaderModule(std::string name, const ShaderCompileInfo& compileInfo, std::function<void()> onReloaded)
+	{
+		return pipeline_manager.WatchShaderModule(std::move(name), compileInfo, std::move(onReloaded));
+	}
 	std::pair<int, std::span<ShaderModule>> VulkanPlus::GetShaderModule(std::string name)
 	{
 		return pipeline_manager.GetShaderModule(std::move(name));
@@ -677,6 +778,36 @@ namespace HoshioEngine {
 		return pipeline_manager.GetPipelineCount();
 	}
 
+	int VulkanPlus::RequestPipeline(std::string name, const PipelineConfigurator& configurator, int fallback_id)
+	{
+		return pipeline_manager.RequestPipeline(std::move(name), configurator, fallback_id);
+	}
+
+	int VulkanPlus::RequestPipeline(std::string name, const VkComputePipelineCreateInfo& createInfo, int fallback_id)
+	{
+		return pipeline_manager.RequestPipeline(std::move(name), createInfo, fallback_id);
+	}
+
+	VkPipeline VulkanPlus::ResolvePipeline(int id)
+	{
+		return pipeline_manager.ResolvePipeline(id);
+	}
+
+	bool VulkanPlus::IsPipelineReady(int id)
+	{
+		return pipeline_manager.IsPipelineReady(id);
+	}
+
+	uint32_t VulkanPlus::CollectAsyncPipelines()
+	{
+		return pipeline_manager.CollectAsyncPipelines();
+	}
+
+	void VulkanPlus::WaitAsyncPipelines()
+	{
+		pipeline_manager.WaitAsyncPipelines();
+	}
+
 	std::pair<int, std::span<PipelineLayout>> VulkanPlus::CreatePipelineLayout(std::string name, VkPipelineLayoutCreateInfo& createInfo)
 	{
 		return pipeline_manager.CreatePipelineLayout(std::move(name), createInfo);
@@ -759,11 +890,16 @@ namespace HoshioEngine {
 		return query_pool_manager.GetTimestampQueriesCount();
 	}
 
-	std::pair<int, std::span<Sampler>> VulkanPlus::CreateSampler(std::string name, VkSamplerCreateInfo& createInfo)
+	std::pair<int, std::span<Sampler>> VulkanPlus::CreateSampler(std::string name, const VkSamplerCreateInfo& createInfo)
 	{
 		return sampler_manager.CreateSampler(std::move(name), createInfo);
 	}
 
+	std::pair<int, std::span<Sampler>> VulkanPlus::AcquireSampler(const VkSamplerCreateInfo& createInfo)
+	{
+		return sampler_manager.AcquireSampler(createInfo);
+	}
+
 	std::pair<int, std::span<Sampler>> VulkanPlus::GetSampler(std::string name)
 	{
 		return sampler_manager.GetSampler(std::move(name));
@@ -789,6 +925,11 @@ namespace HoshioEngine {
 		return sampler_manager.GetSamplerCount();
 	}
 
+	const VkSampler* VulkanPlus::ImmutableSamplers(int id, uint32_t descriptorCount)
+	{
+		return sampler_manager.ImmutableSamplers(id, descriptorCount);
+	}
+
 	std::pair<int, std::span<DescriptorSetLayout>> VulkanPlus::CreateDescriptorSetLayout(std::string name, VkDescriptorSetLayoutCreateInfo& createInfo)
 	{
 		return descriptor_manager.CreateDescriptorSetLayout(std::move(name), createInfo);
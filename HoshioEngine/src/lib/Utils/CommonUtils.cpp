@@ -42,4 +42,34 @@ glm::mat4 FlipVertical(const glm::mat4& projection)
 	return _projection;
 }
 
+uint64_t HashBytes(const void* pData, size_t size, uint64_t seed)
+{
+	const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= pBytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
 
+void ParallelFor(size_t count, uint32_t threadCount, const std::function<void(size_t begin, size_t end)>& body)
+{
+	if (!threadCount)
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	size_t chunkCount = std::min<size_t>(threadCount, count);
+	if (chunkCount <= 1) {
+		body(0, count);
+		return;
+	}
+	std::vector<std::future<void>> chunks;
+	chunks.reserve(chunkCount);
+	for (size_t i = 0; i < chunkCount; i++)
+		chunks.push_back(std::async(std::launch::async, [&body, begin = count * i / chunkCount, end = count * (i + 1) / chunkCount] {
+			body(begin, end);
+			}));
+	for (auto& chunk : chunks)
+		chunk.wait();
+	for (auto& chunk : chunks)
+		chunk.get();
+}
@@ -0,0 +1,194 @@
+#include "Utils/FrameAllocator.h"
+#include <cstdlib>
+
+namespace {
+	constexpr size_t BLOCK_ALIGNMENT = 64;
+	//Frames before EndFrame() starts complaining about heap traffic, caches and arenas grow during these
+	constexpr uint64_t WARMUP_FRAMES = 8;
+	//After warm-up every allocating frame is counted, the summary is printed at most once per this many frames
+	constexpr uint64_t REPORT_INTERVAL = 120;
+
+	std::atomic<uint64_t> frameIndex = 0;
+	thread_local uint64_t heapAllocationCount = 0;
+}
+
+#ifndef NDEBUG
+
+//Counting replacements of the global allocation functions. The array and nothrow forms forward to these by default.
+void* operator new(std::size_t size)
+{
+	++heapAllocationCount;
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	++heapAllocationCount;
+	const size_t alignmentValue = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+	if (void* p = _aligned_malloc(size ? size : 1, alignmentValue))
+		return p;
+#else
+	if (void* p = std::aligned_alloc(alignmentValue, (std::max<size_t>(size, 1) + alignmentValue - 1) / alignmentValue * alignmentValue))
+		return p;
+#endif
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+#ifdef _MSC_VER
+	_aligned_free(p);
+#else
+	std::free(p);
+#endif
+}
+
+#endif // !NDEBUG
+
+namespace HoshioEngine {
+#pragma region LinearArena
+
+	LinearArena::LinearArena(size_t initialCapacity) : initialCapacity(initialCapacity)
+	{
+	}
+
+	LinearArena::~LinearArena()
+	{
+		Release();
+	}
+
+	void* LinearArena::TryAllocate(size_t bytes, size_t alignment)
+	{
+		Block& block = blocks[currentBlock];
+		const uintptr_t base = reinterpret_cast<uintptr_t>(block.pData);
+		const uintptr_t address = (base + offset + alignment - 1) & ~uintptr_t(alignment - 1);
+		if (address + bytes > base + block.capacity)
+			return nullptr;
+		offset = address + bytes - base;
+		bytesUsed += bytes;
+		return reinterpret_cast<void*>(address);
+	}
+
+	void LinearArena::Release()
+	{
+		for (auto& block : blocks)
+			::operator delete(block.pData, std::align_val_t(BLOCK_ALIGNMENT));
+		blocks.clear();
+	}
+
+	void* LinearArena::do_allocate(size_t bytes, size_t alignment)
+	{
+		for (; currentBlock < blocks.size(); currentBlock++, offset = 0)
+			if (void* p = TryAllocate(bytes, alignment))
+				return p;
+
+		const size_t capacity = std::max(blocks.empty() ? initialCapacity : blocks.back().capacity * 2, bytes + alignment);
+		blocks.push_back({ static_cast<std::byte*>(::operator new(capacity, std::align_val_t(BLOCK_ALIGNMENT))), capacity });
+		currentBlock = blocks.size() - 1;
+		offset = 0;
+		return TryAllocate(bytes, alignment);
+	}
+
+	void LinearArena::do_deallocate(void* p, size_t bytes, size_t alignment)
+	{
+	}
+
+	bool LinearArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+	{
+		return this == &other;
+	}
+
+	void LinearArena::Reset()
+	{
+		if (blocks.size() > 1) {
+			size_t capacity = 0;
+			for (auto& block : blocks)
+				capacity += block.capacity;
+			Release();
+			blocks.push_back({ static_cast<std::byte*>(::operator new(capacity, std::align_val_t(BLOCK_ALIGNMENT))), capacity });
+		}
+		currentBlock = 0;
+		offset = 0;
+		bytesUsed = 0;
+	}
+
+	size_t LinearArena::BytesUsed() const
+	{
+		return bytesUsed;
+	}
+
+	size_t LinearArena::Capacity() const
+	{
+		size_t capacity = 0;
+		for (auto& block : blocks)
+			capacity += block.capacity;
+		return capacity;
+	}
+
+#pragma endregion
+
+#pragma region FrameMemory
+
+	LinearArena& FrameMemory::Frame()
+	{
+		static LinearArena frameArena(4 << 20);
+		return frameArena;
+	}
+
+	LinearArena& FrameMemory::Scratch()
+	{
+		//Memory handed out here stays valid until this thread asks for scratch memory again in a later frame
+		thread_local LinearArena scratchArena(256 << 10);
+		thread_local uint64_t scratchFrame = 0;
+		const uint64_t currentFrame = frameIndex.load(std::memory_order_acquire);
+		if (scratchFrame != currentFrame) {
+			scratchArena.Reset();
+			scratchFrame = currentFrame;
+		}
+		return scratchArena;
+	}
+
+	void FrameMemory::EndFrame()
+	{
+		Frame().Reset();
+		const uint64_t endedFrame = frameIndex.fetch_add(1, std::memory_order_acq_rel);
+
+#ifndef NDEBUG
+		static uint64_t lastCount = HeapAllocationCount();
+		static uint64_t lastReport = 0;
+		static uint64_t allocatingFrames = 0, unreportedAllocations = 0;
+		const uint64_t allocations = HeapAllocationCount() - lastCount;
+		if (endedFrame >= WARMUP_FRAMES && allocations) {
+			allocatingFrames++;
+			unreportedAllocations += allocations;
+			if (!lastReport || endedFrame - lastReport >= REPORT_INTERVAL) {
+				std::cerr << std::format("[WARNING] FrameMemory: {} frame(s) up to frame {} made {} heap allocations on the main thread, {} in the last one\n",
+					allocatingFrames, endedFrame, unreportedAllocations, allocations);
+				lastReport = endedFrame;
+				allocatingFrames = unreportedAllocations = 0;
+			}
+		}
+		lastCount = HeapAllocationCount();
+#endif // !NDEBUG
+	}
+
+	uint64_t FrameMemory::FrameIndex()
+	{
+		return frameIndex.load(std::memory_order_acquire);
+	}
+
+	uint64_t FrameMemory::HeapAllocationCount()
+	{
+		return heapAllocationCount;
+	}
+
+#pragma endregion
+}
@@ -1,7 +1,48 @@
 #include "Utils/ImageUtils.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HOSHIO_SSE2
+#include <immintrin.h>
+#endif
+
 namespace HoshioEngine {
 
+	namespace {
+		//Writes the texels of one row in reverse order
+		void MirrorRow(const uint8_t* pSrc, uint8_t* pDst, uint32_t width, size_t texelSize) {
+			uint32_t x = 0;
+			const uint8_t* pSrc_end = pSrc + width * texelSize;
+#ifdef HOSHIO_SSE2
+			switch (texelSize) {
+			case 4:
+#ifdef __AVX2__
+				for (const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0); x + 8 <= width; x += 8) {
+					__m256i texels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc_end - (x + 8) * 4));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + x * 4), _mm256_permutevar8x32_epi32(texels, reverse));
+				}
+#endif
+				for (; x + 4 <= width; x += 4) {
+					__m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc_end - (x + 4) * 4));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x * 4), _mm_shuffle_epi32(texels, _MM_SHUFFLE(0, 1, 2, 3)));
+				}
+				break;
+			case 8:
+				for (; x + 2 <= width; x += 2) {
+					__m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc_end - (x + 2) * 8));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x * 8), _mm_shuffle_epi32(texels, _MM_SHUFFLE(1, 0, 3, 2)));
+				}
+				break;
+			case 16:
+				for (; x < width; x++)
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x * 16), _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc_end - (x + 1) * 16)));
+				break;
+			}
+#endif
+			for (; x < width; x++)
+				memcpy(pDst + x * texelSize, pSrc_end - (x + 1) * texelSize, texelSize);
+		}
+	}
+
 
 	uint32_t ImageUtils::CalculateMipLevelCount(VkExtent2D extent)
 	{
@@ -159,4 +200,23 @@ namespace HoshioEngine {
 				imgBarrier_to);
 	}
 
-}
\ No newline at end of file
+	void ImageUtils::CopyTexels(const uint8_t* pSrc, size_t srcRowPitch, uint8_t* pDst, size_t dstRowPitch,
+		VkExtent2D extent, size_t texelSize, TEXEL_TRANSFORM transform)
+	{
+		size_t rowSize = extent.width * texelSize;
+		bool flipVertical = transform == TEXEL_TRANSFORM::FLIP_VERTICAL || transform == TEXEL_TRANSFORM::ROTATE_180;
+		bool flipHorizontal = transform == TEXEL_TRANSFORM::FLIP_HORIZONTAL || transform == TEXEL_TRANSFORM::ROTATE_180;
+		if (!flipVertical && !flipHorizontal && srcRowPitch == rowSize && dstRowPitch == rowSize) {
+			memcpy(pDst, pSrc, rowSize * extent.height);
+			return;
+		}
+		for (uint32_t y = 0; y < extent.height; y++) {
+			const uint8_t* pSrc_row = pSrc + (flipVertical ? extent.height - 1 - y : y) * srcRowPitch;
+			uint8_t* pDst_row = pDst + y * dstRowPitch;
+			if (flipHorizontal)
+				MirrorRow(pSrc_row, pDst_row, extent.width, texelSize);
+			else
+				memcpy(pDst_row, pSrc_row, rowSize);
+		}
+	}
+}
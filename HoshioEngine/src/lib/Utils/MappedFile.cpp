@@ -0,0 +1,110 @@
+#include "Utils/MappedFile.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace HoshioEngine {
+
+	MappedFile::MappedFile(const char* filePath)
+	{
+		Open(filePath);
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		pData = other.pData;
+		size = other.size;
+		other.pData = nullptr;
+		other.size = 0;
+#ifdef _WIN32
+		fileHandle = other.fileHandle;
+		mappingHandle = other.mappingHandle;
+		other.fileHandle = nullptr;
+		other.mappingHandle = nullptr;
+#else
+		fileDescriptor = other.fileDescriptor;
+		other.fileDescriptor = -1;
+#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	const uint8_t* MappedFile::Data() const
+	{
+		return pData;
+	}
+
+	size_t MappedFile::Size() const
+	{
+		return size;
+	}
+
+	void MappedFile::Open(const char* filePath)
+	{
+		Close();
+#ifdef _WIN32
+		fileHandle = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE) {
+			fileHandle = nullptr;
+			throw std::runtime_error(std::format("[ MappedFile ] ERROR\nFailed to open the file: {}\n", filePath));
+		}
+		LARGE_INTEGER fileSize;
+		GetFileSizeEx(fileHandle, &fileSize);
+		size = size_t(fileSize.QuadPart);
+		//Empty files cannot be mapped, Data() stays nullptr
+		if (!size)
+			return;
+		mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mappingHandle)
+			pData = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+		fileDescriptor = open(filePath, O_RDONLY);
+		if (fileDescriptor < 0)
+			throw std::runtime_error(std::format("[ MappedFile ] ERROR\nFailed to open the file: {}\n", filePath));
+		struct stat fileStatus;
+		fstat(fileDescriptor, &fileStatus);
+		size = size_t(fileStatus.st_size);
+		if (!size)
+			return;
+		if (void* pMapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0); pMapped != MAP_FAILED) {
+			madvise(pMapped, size, MADV_SEQUENTIAL);
+			pData = static_cast<const uint8_t*>(pMapped);
+		}
+#endif
+		if (!pData) {
+			Close();
+			throw std::runtime_error(std::format("[ MappedFile ] ERROR\nFailed to map the file: {}\n", filePath));
+		}
+	}
+
+	void MappedFile::Close()
+	{
+#ifdef _WIN32
+		if (pData)
+			UnmapViewOfFile(pData);
+		if (mappingHandle)
+			CloseHandle(mappingHandle);
+		if (fileHandle)
+			CloseHandle(fileHandle);
+		mappingHandle = nullptr;
+		fileHandle = nullptr;
+#else
+		if (pData)
+			munmap(const_cast<uint8_t*>(pData), size);
+		if (fileDescriptor >= 0)
+			close(fileDescriptor);
+		fileDescriptor = -1;
+#endif
+		pData = nullptr;
+		size = 0;
+	}
+}
@@ -0,0 +1,350 @@
+#include "Utils/PixelConverter.h"
+#include <bit>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HOSHIO_SSE2
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+#define HOSHIO_SSSE3
+#endif
+//MSVC has no __F16C__, but its /arch:AVX2 implies F16C. GCC and Clang can enable AVX2 without it
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define HOSHIO_F16C
+#endif
+#endif
+
+namespace HoshioEngine {
+
+	namespace {
+		enum class COMPONENT_TYPE {
+			UNORM8,
+			SRGB8,
+			UNORM16,
+			SFLOAT16,
+			SFLOAT32
+		};
+
+		struct PixelLayout {
+			COMPONENT_TYPE type;
+			uint32_t componentCount;
+			//B, G, R in memory
+			bool bgr = false;
+
+			bool Is8Bit() const { return type == COMPONENT_TYPE::UNORM8 || type == COMPONENT_TYPE::SRGB8; }
+		};
+
+		bool Describe(VkFormat format, PixelLayout& layout) {
+			switch (format) {
+			case VK_FORMAT_R8_UNORM:				layout = { COMPONENT_TYPE::UNORM8, 1 }; return true;
+			case VK_FORMAT_R8G8_UNORM:				layout = { COMPONENT_TYPE::UNORM8, 2 }; return true;
+			case VK_FORMAT_R8G8B8_UNORM:			layout = { COMPONENT_TYPE::UNORM8, 3 }; return true;
+			case VK_FORMAT_R8G8B8A8_UNORM:			layout = { COMPONENT_TYPE::UNORM8, 4 }; return true;
+			case VK_FORMAT_B8G8R8_UNORM:			layout = { COMPONENT_TYPE::UNORM8, 3, true }; return true;
+			case VK_FORMAT_B8G8R8A8_UNORM:			layout = { COMPONENT_TYPE::UNORM8, 4, true }; return true;
+			case VK_FORMAT_R8_SRGB:					layout = { COMPONENT_TYPE::SRGB8, 1 }; return true;
+			case VK_FORMAT_R8G8_SRGB:				layout = { COMPONENT_TYPE::SRGB8, 2 }; return true;
+			case VK_FORMAT_R8G8B8_SRGB:				layout = { COMPONENT_TYPE::SRGB8, 3 }; return true;
+			case VK_FORMAT_R8G8B8A8_SRGB:			layout = { COMPONENT_TYPE::SRGB8, 4 }; return true;
+			case VK_FORMAT_B8G8R8_SRGB:				layout = { COMPONENT_TYPE::SRGB8, 3, true }; return true;
+			case VK_FORMAT_B8G8R8A8_SRGB:			layout = { COMPONENT_TYPE::SRGB8, 4, true }; return true;
+			case VK_FORMAT_R16_UNORM:				layout = { COMPONENT_TYPE::UNORM16, 1 }; return true;
+			case VK_FORMAT_R16G16_UNORM:			layout = { COMPONENT_TYPE::UNORM16, 2 }; return true;
+			case VK_FORMAT_R16G16B16_UNORM:			layout = { COMPONENT_TYPE::UNORM16, 3 }; return true;
+			case VK_FORMAT_R16G16B16A16_UNORM:		layout = { COMPONENT_TYPE::UNORM16, 4 }; return true;
+			case VK_FORMAT_R16_SFLOAT:				layout = { COMPONENT_TYPE::SFLOAT16, 1 }; return true;
+			case VK_FORMAT_R16G16_SFLOAT:			layout = { COMPONENT_TYPE::SFLOAT16, 2 }; return true;
+			case VK_FORMAT_R16G16B16_SFLOAT:		layout = { COMPONENT_TYPE::SFLOAT16, 3 }; return true;
+			case VK_FORMAT_R16G16B16A16_SFLOAT:		layout = { COMPONENT_TYPE::SFLOAT16, 4 }; return true;
+			case VK_FORMAT_R32_SFLOAT:				layout = { COMPONENT_TYPE::SFLOAT32, 1 }; return true;
+			case VK_FORMAT_R32G32_SFLOAT:			layout = { COMPONENT_TYPE::SFLOAT32, 2 }; return true;
+			case VK_FORMAT_R32G32B32_SFLOAT:		layout = { COMPONENT_TYPE::SFLOAT32, 3 }; return true;
+			case VK_FORMAT_R32G32B32A32_SFLOAT:		layout = { COMPONENT_TYPE::SFLOAT32, 4 }; return true;
+			default:
+				return false;
+			}
+		}
+
+		//Component in memory order -> channel in RGBA order
+		uint32_t Channel(const PixelLayout& layout, uint32_t component) {
+			return layout.bgr && component < 3 ? 2 - component : component;
+		}
+
+		float SrgbToLinear(float c) {
+			return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+
+		float LinearToSrgb(float c) {
+			return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.f / 2.4f) - 0.055f;
+		}
+
+		struct SrgbTables {
+			float toLinear[256];
+			uint8_t decode[256];
+			uint8_t encode[256];
+
+			SrgbTables() {
+				for (uint32_t i = 0; i < 256; i++) {
+					toLinear[i] = SrgbToLinear(i / 255.f);
+					decode[i] = uint8_t(toLinear[i] * 255.f + 0.5f);
+					encode[i] = uint8_t(LinearToSrgb(i / 255.f) * 255.f + 0.5f);
+				}
+			}
+		};
+
+		const SrgbTables& Srgb() {
+			static const SrgbTables tables;
+			return tables;
+		}
+
+		//Round to nearest even, overflow goes to infinity
+		uint16_t FloatToHalf(float value) {
+			uint32_t bits = std::bit_cast<uint32_t>(value);
+			uint32_t sign = (bits >> 16) & 0x8000;
+			uint32_t exponent = (bits >> 23) & 0xFF;
+			uint32_t mantissa = bits & 0x7FFFFF;
+			if (exponent == 0xFF)
+				return uint16_t(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+			int32_t e = int32_t(exponent) - 127 + 15;
+			if (e >= 31)
+				return uint16_t(sign | 0x7C00);
+			if (e <= 0) {
+				if (e < -10)
+					return uint16_t(sign);
+				mantissa |= 0x800000;
+				uint32_t shift = uint32_t(14 - e);
+				uint32_t half = mantissa >> shift;
+				uint32_t rest = mantissa & ((1u << shift) - 1), halfway = 1u << (shift - 1);
+				if (rest > halfway || (rest == halfway && (half & 1)))
+					half++;
+				return uint16_t(sign | half);
+			}
+			uint32_t half = (uint32_t(e) << 10) | (mantissa >> 13);
+			uint32_t rest = mantissa & 0x1FFF;
+			if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+				half++;
+			return uint16_t(sign | half);
+		}
+
+		float HalfToFloat(uint16_t value) {
+			uint32_t sign = uint32_t(value & 0x8000) << 16;
+			uint32_t exponent = (value >> 10) & 0x1F;
+			uint32_t mantissa = value & 0x3FF;
+			if (exponent == 0x1F)
+				return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+			if (exponent == 0) {
+				float subnormal = std::ldexp(float(mantissa), -24);
+				return sign ? -subnormal : subnormal;
+			}
+			return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+		}
+
+#pragma region Kernels
+
+		//R and B of 4 byte texels swap places, SRGB and UNORM alike
+		void SwapRedBlue8(const uint8_t* pSrc, uint8_t* pDst, size_t texelCount) {
+			size_t i = 0;
+#ifdef HOSHIO_SSE2
+			const __m128i maskAG = _mm_set1_epi32(int(0xFF00FF00));
+			const __m128i maskRB = _mm_set1_epi32(0x00FF00FF);
+			for (; i + 4 <= texelCount; i += 4) {
+				__m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 4));
+				__m128i rb = _mm_and_si128(texels, maskRB);
+				rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i * 4), _mm_or_si128(_mm_and_si128(texels, maskAG), rb));
+			}
+#endif
+			for (; i < texelCount; i++) {
+				pDst[i * 4] = pSrc[i * 4 + 2];
+				pDst[i * 4 + 1] = pSrc[i * 4 + 1];
+				pDst[i * 4 + 2] = pSrc[i * 4];
+				pDst[i * 4 + 3] = pSrc[i * 4 + 3];
+			}
+		}
+
+		//x * 257 maps 0-255 onto 0-65535 exactly, which is a byte unpacked next to itself
+		void Unorm8ToUnorm16(const uint8_t* pSrc, uint8_t* pDst, size_t componentCount) {
+			size_t i = 0;
+			uint16_t* pDst16 = reinterpret_cast<uint16_t*>(pDst);
+#ifdef HOSHIO_SSE2
+			for (; i + 16 <= componentCount; i += 16) {
+				__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst16 + i), _mm_unpacklo_epi8(bytes, bytes));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst16 + i + 8), _mm_unpackhi_epi8(bytes, bytes));
+			}
+#endif
+			for (; i < componentCount; i++)
+				pDst16[i] = uint16_t(pSrc[i] * 257);
+		}
+
+		void Float32ToFloat16(const uint8_t* pSrc, uint8_t* pDst, size_t componentCount) {
+			size_t i = 0;
+			const float* pSrc32 = reinterpret_cast<const float*>(pSrc);
+			uint16_t* pDst16 = reinterpret_cast<uint16_t*>(pDst);
+#ifdef HOSHIO_F16C
+			for (; i + 8 <= componentCount; i += 8)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst16 + i), _mm256_cvtps_ph(_mm256_loadu_ps(pSrc32 + i), _MM_FROUND_TO_NEAREST_INT));
+#endif
+			for (; i < componentCount; i++)
+				pDst16[i] = FloatToHalf(pSrc32[i]);
+		}
+
+		//RGB/BGR to RGBA/BGRA of the same type, alpha becomes 255
+		bool ExpandRGB8(const uint8_t* pSrc, bool swapRedBlue, uint8_t* pDst, size_t texelCount) {
+#ifdef HOSHIO_SSSE3
+			size_t i = 0;
+			const __m128i shuffle = swapRedBlue ?
+				_mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1) :
+				_mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+			const __m128i alpha = _mm_set1_epi32(int(0xFF000000));
+			//16 byte loads for 12 bytes of texels, the last few texels go to the scalar loop
+			for (; i + 6 <= texelCount; i += 4) {
+				__m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 3));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i * 4), _mm_or_si128(_mm_shuffle_epi8(texels, shuffle), alpha));
+			}
+			for (; i < texelCount; i++) {
+				pDst[i * 4] = pSrc[i * 3 + (swapRedBlue ? 2 : 0)];
+				pDst[i * 4 + 1] = pSrc[i * 3 + 1];
+				pDst[i * 4 + 2] = pSrc[i * 3 + (swapRedBlue ? 0 : 2)];
+				pDst[i * 4 + 3] = 255;
+			}
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		//Any 8 bit to 8 bit pair: swizzle, expansion and sRGB through the tables
+		void Convert8To8(const uint8_t* pSrc, const PixelLayout& src, uint8_t* pDst, const PixelLayout& dst, size_t texelCount) {
+			const uint8_t* pTable =
+				src.type == dst.type ? nullptr :
+				dst.type == COMPONENT_TYPE::SRGB8 ? Srgb().encode : Srgb().decode;
+			for (size_t i = 0; i < texelCount; i++) {
+				uint8_t rgba[4] = { 0, 0, 0, 255 };
+				for (uint32_t c = 0; c < src.componentCount; c++)
+					rgba[Channel(src, c)] = pSrc[i * src.componentCount + c];
+				if (pTable)
+					for (uint32_t c = 0; c < 3; c++)
+						rgba[c] = pTable[rgba[c]];
+				for (uint32_t c = 0; c < dst.componentCount; c++)
+					pDst[i * dst.componentCount + c] = rgba[Channel(dst, c)];
+			}
+		}
+
+		void ConvertThroughFloat(const uint8_t* pSrc, const PixelLayout& src, uint8_t* pDst, const PixelLayout& dst, size_t texelCount) {
+			const SrgbTables& srgb = Srgb();
+			for (size_t i = 0; i < texelCount; i++) {
+				float rgba[4] = { 0.f, 0.f, 0.f, 1.f };
+				for (uint32_t c = 0; c < src.componentCount; c++) {
+					size_t index = i * src.componentCount + c;
+					float& value = rgba[Channel(src, c)];
+					switch (src.type) {
+					case COMPONENT_TYPE::UNORM8:	value = pSrc[index] / 255.f; break;
+					case COMPONENT_TYPE::SRGB8:		value = c < 3 ? srgb.toLinear[pSrc[index]] : pSrc[index] / 255.f; break;
+					case COMPONENT_TYPE::UNORM16:	value = reinterpret_cast<const uint16_t*>(pSrc)[index] / 65535.f; break;
+					case COMPONENT_TYPE::SFLOAT16:	value = HalfToFloat(reinterpret_cast<const uint16_t*>(pSrc)[index]); break;
+					case COMPONENT_TYPE::SFLOAT32:	value = reinterpret_cast<const float*>(pSrc)[index]; break;
+					}
+				}
+				for (uint32_t c = 0; c < dst.componentCount; c++) {
+					size_t index = i * dst.componentCount + c;
+					float value = rgba[Channel(dst, c)];
+					float unorm = std::clamp(value, 0.f, 1.f);
+					switch (dst.type) {
+					case COMPONENT_TYPE::UNORM8:	pDst[index] = uint8_t(unorm * 255.f + 0.5f); break;
+					case COMPONENT_TYPE::SRGB8:		pDst[index] = uint8_t((c < 3 ? LinearToSrgb(unorm) : unorm) * 255.f + 0.5f); break;
+					case COMPONENT_TYPE::UNORM16:	reinterpret_cast<uint16_t*>(pDst)[index] = uint16_t(unorm * 65535.f + 0.5f); break;
+					case COMPONENT_TYPE::SFLOAT16:	reinterpret_cast<uint16_t*>(pDst)[index] = FloatToHalf(value); break;
+					case COMPONENT_TYPE::SFLOAT32:	reinterpret_cast<float*>(pDst)[index] = value; break;
+					}
+				}
+			}
+		}
+
+#pragma endregion
+	}
+
+	bool PixelConverter::CanConvert(VkFormat srcFormat, VkFormat dstFormat)
+	{
+		PixelLayout src, dst;
+		return Describe(srcFormat, src) && Describe(dstFormat, dst);
+	}
+
+	void PixelConverter::ConvertRow(const uint8_t* pSrc, VkFormat srcFormat, uint8_t* pDst, VkFormat dstFormat, size_t texelCount)
+	{
+		if (srcFormat == dstFormat) {
+			memcpy(pDst, pSrc, texelCount * vkuFormatElementSize(srcFormat));
+			return;
+		}
+		PixelLayout src, dst;
+		if (!Describe(srcFormat, src) || !Describe(dstFormat, dst))
+			throw std::runtime_error(std::format("[ PixelConverter ] ERROR\nNo conversion from {} to {}!\n", uint32_t(srcFormat), uint32_t(dstFormat)));
+
+		bool sameOrder = src.bgr == dst.bgr || src.componentCount < 3;
+		if (src.Is8Bit() && dst.Is8Bit()) {
+			if (src.type == dst.type && src.componentCount == 4 && dst.componentCount == 4)
+				SwapRedBlue8(pSrc, pDst, texelCount);
+			else if (src.type == dst.type && src.componentCount == 3 && dst.componentCount == 4 && ExpandRGB8(pSrc, !sameOrder, pDst, texelCount))
+				return;
+			else
+				Convert8To8(pSrc, src, pDst, dst, texelCount);
+			return;
+		}
+		if (sameOrder && src.componentCount == dst.componentCount) {
+			if (src.type == COMPONENT_TYPE::UNORM8 && dst.type == COMPONENT_TYPE::UNORM16) {
+				Unorm8ToUnorm16(pSrc, pDst, texelCount * src.componentCount);
+				return;
+			}
+			if (src.type == COMPONENT_TYPE::SFLOAT32 && dst.type == COMPONENT_TYPE::SFLOAT16) {
+				Float32ToFloat16(pSrc, pDst, texelCount * src.componentCount);
+				return;
+			}
+		}
+		ConvertThroughFloat(pSrc, src, pDst, dst, texelCount);
+	}
+
+	void PixelConverter::ConvertTexels(const uint8_t* pSrc, size_t srcRowPitch, VkFormat srcFormat, uint8_t* pDst, size_t dstRowPitch, VkFormat dstFormat,
+		VkExtent2D extent, TEXEL_TRANSFORM transform)
+	{
+		size_t dstTexelSize = vkuFormatElementSize(dstFormat);
+		if (srcFormat == dstFormat) {
+			ImageUtils::CopyTexels(pSrc, srcRowPitch, pDst, dstRowPitch, extent, dstTexelSize, transform);
+			return;
+		}
+		size_t srcRowSize = extent.width * vkuFormatElementSize(srcFormat);
+		size_t dstRowSize = extent.width * dstTexelSize;
+		bool flipVertical = transform == TEXEL_TRANSFORM::FLIP_VERTICAL || transform == TEXEL_TRANSFORM::ROTATE_180;
+		bool flipHorizontal = transform == TEXEL_TRANSFORM::FLIP_HORIZONTAL || transform == TEXEL_TRANSFORM::ROTATE_180;
+		if (!flipVertical && !flipHorizontal && srcRowPitch == srcRowSize && dstRowPitch == dstRowSize) {
+			ConvertRow(pSrc, srcFormat, pDst, dstFormat, size_t(extent.width) * extent.height);
+			return;
+		}
+		//Mirrored rows are converted into a scratch row first, the mirror then runs on destination texels
+		std::vector<uint8_t> row(flipHorizontal ? dstRowSize : 0);
+		for (uint32_t y = 0; y < extent.height; y++) {
+			const uint8_t* pSrc_row = pSrc + (flipVertical ? extent.height - 1 - y : y) * srcRowPitch;
+			uint8_t* pDst_row = pDst + y * dstRowPitch;
+			if (flipHorizontal) {
+				ConvertRow(pSrc_row, srcFormat, row.data(), dstFormat, extent.width);
+				ImageUtils::CopyTexels(row.data(), dstRowSize, pDst_row, dstRowSize, { extent.width, 1 }, dstTexelSize, TEXEL_TRANSFORM::FLIP_HORIZONTAL);
+			}
+			else
+				ConvertRow(pSrc_row, srcFormat, pDst_row, dstFormat, extent.width);
+		}
+	}
+
+	void PixelConverter::Convert(const uint8_t* pSrc, VkFormat srcFormat, uint8_t* pDst, VkFormat dstFormat, size_t texelCount, uint32_t threadCount)
+	{
+		//Small images are not worth a thread
+		constexpr size_t minTexelCountPerThread = 1 << 16;
+		if (!threadCount)
+			threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+		threadCount = uint32_t(std::min<size_t>(threadCount, texelCount / minTexelCountPerThread + 1));
+		size_t srcTexelSize = vkuFormatElementSize(srcFormat), dstTexelSize = vkuFormatElementSize(dstFormat);
+		ParallelFor(texelCount, threadCount, [&](size_t begin, size_t end) {
+			ConvertRow(pSrc + begin * srcTexelSize, srcFormat, pDst + begin * dstTexelSize, dstFormat, end - begin);
+			});
+	}
+}
@@ -0,0 +1,84 @@
+#include "Utils/RangeAllocator.h"
+
+namespace HoshioEngine {
+
+	RangeAllocator::RangeAllocator(uint32_t capacity)
+	{
+		Reset(capacity);
+	}
+
+	void RangeAllocator::Reset(uint32_t capacity)
+	{
+		this->capacity = capacity;
+		freeRanges.clear();
+		if (capacity)
+			freeRanges.emplace(0, capacity);
+		freeSize = capacity;
+	}
+
+	uint32_t RangeAllocator::Allocate(uint32_t size)
+	{
+		if (!size || size > freeSize)
+			return invalidOffset;
+		for (auto iter = freeRanges.begin(); iter != freeRanges.end(); ++iter) {
+			auto [offset, rangeSize] = *iter;
+			if (rangeSize < size)
+				continue;
+			//The rest of the range stays free behind the allocation
+			freeRanges.erase(iter);
+			if (rangeSize > size)
+				freeRanges.emplace(offset + size, rangeSize - size);
+			freeSize -= size;
+			return offset;
+		}
+		return invalidOffset;
+	}
+
+	void RangeAllocator::Free(uint32_t offset, uint32_t size)
+	{
+		if (!size)
+			return;
+		auto next = freeRanges.lower_bound(offset);
+		auto previous = next == freeRanges.begin() ? freeRanges.end() : std::prev(next);
+		if (uint64_t(offset) + size > capacity ||
+			(next != freeRanges.end() && offset + size > next->first) ||
+			(previous != freeRanges.end() && previous->first + previous->second > offset)) {
+			std::cerr << std::format("[ RangeAllocator ] ERROR\nRange {} + {} is not allocated!\n", offset, size);
+			throw std::runtime_error("[ RangeAllocator ] ERROR::Freeing a range that is not allocated!");
+		}
+		freeSize += size;
+
+		if (next != freeRanges.end() && offset + size == next->first) {
+			size += next->second;
+			next = freeRanges.erase(next);
+		}
+		if (previous != freeRanges.end() && previous->first + previous->second == offset) {
+			previous->second += size;
+			return;
+		}
+		freeRanges.emplace_hint(next, offset, size);
+	}
+
+	uint32_t RangeAllocator::Capacity() const
+	{
+		return capacity;
+	}
+
+	uint32_t RangeAllocator::FreeSize() const
+	{
+		return freeSize;
+	}
+
+	uint32_t RangeAllocator::LargestFreeRange() const
+	{
+		uint32_t largest = 0;
+		for (auto& [offset, size] : freeRanges)
+			largest = std::max(largest, size);
+		return largest;
+	}
+
+	size_t RangeAllocator::FreeRangeCount() const
+	{
+		return freeRanges.size();
+	}
+}
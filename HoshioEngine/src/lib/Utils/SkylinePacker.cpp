@@ -0,0 +1,107 @@
+#include "Utils/SkylinePacker.h"
+
+namespace HoshioEngine {
+
+	SkylinePacker::SkylinePacker(VkExtent2D extent)
+	{
+		Reset(extent);
+	}
+
+	void SkylinePacker::Reset(VkExtent2D extent)
+	{
+		this->extent = extent;
+		skyline.clear();
+		skyline.push_back({ 0, 0, extent.width });
+		usedArea = 0;
+	}
+
+	bool SkylinePacker::Fits(size_t index, VkExtent2D size, uint32_t& y) const
+	{
+		uint32_t x = skyline[index].x;
+		if (x + size.width > extent.width)
+			return false;
+		//The rectangle rests on the highest segment it spans
+		y = 0;
+		uint32_t widthLeft = size.width;
+		for (size_t i = index; widthLeft > 0; i++) {
+			y = std::max(y, skyline[i].y);
+			if (y + size.height > extent.height)
+				return false;
+			widthLeft -= std::min(widthLeft, skyline[i].width);
+		}
+		return true;
+	}
+
+	bool SkylinePacker::Find(VkExtent2D size, VkOffset2D& offset) const
+	{
+		if (!size.width || !size.height)
+			return false;
+		uint32_t bestTop = UINT32_MAX;
+		uint32_t bestWidth = UINT32_MAX;
+		for (size_t i = 0; i < skyline.size(); i++) {
+			uint32_t y;
+			if (!Fits(i, size, y))
+				continue;
+			//Lowest top edge first, then the narrowest segment so wide gaps stay open for wide rectangles
+			uint32_t top = y + size.height;
+			if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth)) {
+				bestTop = top;
+				bestWidth = skyline[i].width;
+				offset = { int32_t(skyline[i].x), int32_t(y) };
+			}
+		}
+		return bestTop != UINT32_MAX;
+	}
+
+	void SkylinePacker::Insert(VkRect2D rect)
+	{
+		uint32_t x = uint32_t(rect.offset.x);
+		uint32_t right = x + rect.extent.width;
+		auto iterator = std::find_if(skyline.begin(), skyline.end(), [x](const Segment& segment) { return segment.x == x; });
+		size_t index = iterator - skyline.begin();
+		skyline.insert(iterator, { x, uint32_t(rect.offset.y) + rect.extent.height, rect.extent.width });
+
+		//Cut what the new segment covers off the following ones
+		while (index + 1 < skyline.size()) {
+			Segment& segment = skyline[index + 1];
+			if (segment.x >= right)
+				break;
+			uint32_t overlap = right - segment.x;
+			if (segment.width > overlap) {
+				segment.x += overlap;
+				segment.width -= overlap;
+				break;
+			}
+			skyline.erase(skyline.begin() + index + 1);
+		}
+
+		for (size_t i = 1; i < skyline.size();)
+			if (skyline[i - 1].y == skyline[i].y) {
+				skyline[i - 1].width += skyline[i].width;
+				skyline.erase(skyline.begin() + i);
+			}
+			else
+				i++;
+
+		usedArea += uint64_t(rect.extent.width) * rect.extent.height;
+	}
+
+	bool SkylinePacker::Pack(VkExtent2D size, VkOffset2D& offset)
+	{
+		if (!Find(size, offset))
+			return false;
+		Insert({ offset, size });
+		return true;
+	}
+
+	VkExtent2D SkylinePacker::Extent() const
+	{
+		return extent;
+	}
+
+	float SkylinePacker::Occupancy() const
+	{
+		uint64_t area = uint64_t(extent.width) * extent.height;
+		return area ? float(usedArea) / float(area) : 0.f;
+	}
+}
@@ -0,0 +1,227 @@
+#include "Utils/TextureContainer.h"
+
+namespace HoshioEngine {
+
+	namespace {
+		constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+		constexpr uint32_t DDS_MAGIC = 0x20534444; //"DDS "
+
+		constexpr uint32_t MakeFourCC(char a, char b, char c, char d) {
+			return uint32_t(uint8_t(a)) | uint32_t(uint8_t(b)) << 8 | uint32_t(uint8_t(c)) << 16 | uint32_t(uint8_t(d)) << 24;
+		}
+
+		//Written so that neither side can wrap, whatever the header claims
+		bool FitsInFile(uint64_t offset, uint64_t length, uint64_t fileSize) {
+			return offset <= fileSize && length <= fileSize - offset;
+		}
+
+		//product *= factor, false once the result would pass limit
+		bool MultiplyWithin(VkDeviceSize& product, VkDeviceSize factor, VkDeviceSize limit) {
+			if (factor && product > limit / factor)
+				return false;
+			product *= factor;
+			return true;
+		}
+
+		template<typename T>
+		T ReadField(const uint8_t* pFile, size_t fileSize, size_t offset) {
+			if (!FitsInFile(offset, sizeof(T), fileSize))
+				throw std::runtime_error("[ TextureContainer ] ERROR\nUnexpected end of file!\n");
+			T value;
+			memcpy(&value, pFile + offset, sizeof(T));
+			return value;
+		}
+
+		//Fills in levels[] for a level-major layout, the whole payload has to fit in the file so every size is bounded by fileSize
+		void LayoutLevels(TextureContainer& container, uint32_t mipLevelCount, size_t fileSize) {
+			if (mipLevelCount > 32 || uint64_t(container.layerCount) * container.faceCount > std::numeric_limits<uint32_t>::max())
+				throw std::runtime_error("[ TextureContainer ] ERROR\nInvalid level or layer count!\n");
+			container.levels.resize(mipLevelCount);
+			VkExtent3D blockExtent = vkuFormatTexelBlockExtent(container.format);
+			VkDeviceSize offset = 0;
+			for (uint32_t i = 0; i < mipLevelCount; i++) {
+				VkExtent2D extent = { std::max(container.extent.width >> i, 1u), std::max(container.extent.height >> i, 1u) };
+				VkDeviceSize limit = fileSize - offset;
+				VkDeviceSize size = (VkDeviceSize(extent.width) + blockExtent.width - 1) / blockExtent.width;
+				if (!MultiplyWithin(size, (VkDeviceSize(extent.height) + blockExtent.height - 1) / blockExtent.height, limit) ||
+					!MultiplyWithin(size, vkuFormatElementSize(container.format), limit) ||
+					!MultiplyWithin(size, container.ArrayLayerCount(), limit))
+					throw std::runtime_error("[ TextureContainer ] ERROR\nTexture data is larger than the file!\n");
+				container.levels[i] = { offset, size, extent };
+				offset += size;
+			}
+		}
+
+		VkFormat FormatFromDxgi(uint32_t dxgiFormat) {
+			switch (dxgiFormat) {
+			case 2:  return VK_FORMAT_R32G32B32A32_SFLOAT;
+			case 10: return VK_FORMAT_R16G16B16A16_SFLOAT;
+			case 28: return VK_FORMAT_R8G8B8A8_UNORM;
+			case 29: return VK_FORMAT_R8G8B8A8_SRGB;
+			case 71: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+			case 72: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+			case 74: return VK_FORMAT_BC2_UNORM_BLOCK;
+			case 75: return VK_FORMAT_BC2_SRGB_BLOCK;
+			case 77: return VK_FORMAT_BC3_UNORM_BLOCK;
+			case 78: return VK_FORMAT_BC3_SRGB_BLOCK;
+			case 80: return VK_FORMAT_BC4_UNORM_BLOCK;
+			case 81: return VK_FORMAT_BC4_SNORM_BLOCK;
+			case 83: return VK_FORMAT_BC5_UNORM_BLOCK;
+			case 84: return VK_FORMAT_BC5_SNORM_BLOCK;
+			case 95: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+			case 96: return VK_FORMAT_BC6H_SFLOAT_BLOCK;
+			case 98: return VK_FORMAT_BC7_UNORM_BLOCK;
+			case 99: return VK_FORMAT_BC7_SRGB_BLOCK;
+			default: return VK_FORMAT_UNDEFINED;
+			}
+		}
+
+		VkFormat FormatFromFourCC(uint32_t fourCC) {
+			switch (fourCC) {
+			case MakeFourCC('D', 'X', 'T', '1'): return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+			case MakeFourCC('D', 'X', 'T', '3'): return VK_FORMAT_BC2_UNORM_BLOCK;
+			case MakeFourCC('D', 'X', 'T', '5'): return VK_FORMAT_BC3_UNORM_BLOCK;
+			case MakeFourCC('A', 'T', 'I', '1'):
+			case MakeFourCC('B', 'C', '4', 'U'): return VK_FORMAT_BC4_UNORM_BLOCK;
+			case MakeFourCC('B', 'C', '4', 'S'): return VK_FORMAT_BC4_SNORM_BLOCK;
+			case MakeFourCC('A', 'T', 'I', '2'):
+			case MakeFourCC('B', 'C', '5', 'U'): return VK_FORMAT_BC5_UNORM_BLOCK;
+			case MakeFourCC('B', 'C', '5', 'S'): return VK_FORMAT_BC5_SNORM_BLOCK;
+			default: return VK_FORMAT_UNDEFINED;
+			}
+		}
+	}
+
+	bool TextureContainer::IsContainerFile(std::string_view filePath)
+	{
+		size_t pos = filePath.find_last_of('.');
+		if (pos == std::string_view::npos)
+			return false;
+		std::string extension(filePath.substr(pos + 1));
+		for (char& c : extension)
+			c = char(std::tolower(uint8_t(c)));
+		return extension == "ktx2" || extension == "dds";
+	}
+
+	void TextureContainer::CopyData(uint8_t* pData_dst) const
+	{
+		for (const CopyRegion& region : regions)
+			memcpy(pData_dst + region.dstOffset, pSource + region.srcOffset, size_t(region.size));
+	}
+
+	void TextureContainer::CopyLevel(uint32_t level, uint8_t* pData_dst) const
+	{
+		const Level& range = levels[level];
+		for (const CopyRegion& region : regions)
+			if (region.dstOffset >= range.offset && region.dstOffset < range.offset + range.size)
+				memcpy(pData_dst + (region.dstOffset - range.offset), pSource + region.srcOffset, size_t(region.size));
+	}
+
+	TextureContainer TextureContainer::Load(const char* filePath)
+	{
+		auto file = std::make_shared<MappedFile>(filePath);
+		const uint8_t* pFile = file->Data();
+		size_t fileSize = file->Size();
+
+		TextureContainer container;
+		if (fileSize >= sizeof KTX2_IDENTIFIER && !memcmp(pFile, KTX2_IDENTIFIER, sizeof KTX2_IDENTIFIER))
+			container = LoadKtx2(pFile, fileSize);
+		else if (fileSize >= 4 && ReadField<uint32_t>(pFile, fileSize, 0) == DDS_MAGIC)
+			container = LoadDds(pFile, fileSize);
+		else
+			throw std::runtime_error(std::format("[ TextureContainer ] ERROR\nNeither KTX2 nor DDS: {}\n", filePath));
+		container.mappedFile = std::move(file);
+		return container;
+	}
+
+	TextureContainer TextureContainer::LoadKtx2(const uint8_t* pFile, size_t fileSize)
+	{
+		TextureContainer container;
+		container.pSource = pFile;
+		container.format = VkFormat(ReadField<uint32_t>(pFile, fileSize, 12));
+		uint32_t pixelWidth = ReadField<uint32_t>(pFile, fileSize, 20);
+		uint32_t pixelHeight = ReadField<uint32_t>(pFile, fileSize, 24);
+		uint32_t pixelDepth = ReadField<uint32_t>(pFile, fileSize, 28);
+		uint32_t layerCount = ReadField<uint32_t>(pFile, fileSize, 32);
+		uint32_t faceCount = ReadField<uint32_t>(pFile, fileSize, 36);
+		uint32_t levelCount = ReadField<uint32_t>(pFile, fileSize, 40);
+		uint32_t supercompressionScheme = ReadField<uint32_t>(pFile, fileSize, 44);
+
+		if (container.format == VK_FORMAT_UNDEFINED || supercompressionScheme)
+			throw std::runtime_error("[ TextureContainer ] ERROR\nBasis/supercompressed KTX2 is not supported, cook it to a GPU format first!\n");
+		if (pixelDepth > 1 || (faceCount != 1 && faceCount != 6))
+			throw std::runtime_error("[ TextureContainer ] ERROR\nOnly 2D, 2D array and cube KTX2 textures are supported!\n");
+
+		container.extent = { pixelWidth, std::max(pixelHeight, 1u) };
+		container.layerCount = std::max(layerCount, 1u);
+		container.faceCount = faceCount;
+		//levelCount of 0 asks the loader to generate mips, which cannot be done for block compressed data
+		LayoutLevels(container, std::max(levelCount, 1u), fileSize);
+
+		constexpr size_t levelIndexOffset = 80;
+		for (uint32_t i = 0; i < container.MipLevelCount(); i++) {
+			uint64_t byteOffset = ReadField<uint64_t>(pFile, fileSize, levelIndexOffset + 24 * i);
+			uint64_t byteLength = ReadField<uint64_t>(pFile, fileSize, levelIndexOffset + 24 * i + 8);
+			const Level& level = container.levels[i];
+			if (byteLength != level.size || !FitsInFile(byteOffset, byteLength, fileSize))
+				throw std::runtime_error(std::format("[ TextureContainer ] ERROR\nKTX2 level {} has an unexpected size!\n", i));
+			container.regions.push_back({ size_t(byteOffset), level.offset, level.size });
+		}
+		return container;
+	}
+
+	TextureContainer TextureContainer::LoadDds(const uint8_t* pFile, size_t fileSize)
+	{
+		//Offsets are from the start of the file, the 124 byte DDS_HEADER follows the magic
+		constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+		constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+		constexpr uint32_t DDSCAPS2_VOLUME = 0x200000;
+		constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+		constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+
+		uint32_t flags = ReadField<uint32_t>(pFile, fileSize, 8);
+		uint32_t height = ReadField<uint32_t>(pFile, fileSize, 12);
+		uint32_t width = ReadField<uint32_t>(pFile, fileSize, 16);
+		uint32_t mipMapCount = ReadField<uint32_t>(pFile, fileSize, 28);
+		uint32_t fourCC = ReadField<uint32_t>(pFile, fileSize, 84);
+		uint32_t caps2 = ReadField<uint32_t>(pFile, fileSize, 112);
+		size_t dataOffset = 128;
+
+		TextureContainer container;
+		container.pSource = pFile;
+		container.extent = { width, std::max(height, 1u) };
+		if (fourCC == MakeFourCC('D', 'X', '1', '0')) {
+			container.format = FormatFromDxgi(ReadField<uint32_t>(pFile, fileSize, 128));
+			uint32_t resourceDimension = ReadField<uint32_t>(pFile, fileSize, 132);
+			uint32_t miscFlag = ReadField<uint32_t>(pFile, fileSize, 136);
+			container.layerCount = std::max(ReadField<uint32_t>(pFile, fileSize, 140), 1u);
+			container.faceCount = miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE ? 6 : 1;
+			if (resourceDimension != DDS_DIMENSION_TEXTURE2D)
+				throw std::runtime_error("[ TextureContainer ] ERROR\nOnly 2D, 2D array and cube DDS textures are supported!\n");
+			dataOffset += 20;
+		}
+		else {
+			container.format = FormatFromFourCC(fourCC);
+			if (caps2 & DDSCAPS2_VOLUME)
+				throw std::runtime_error("[ TextureContainer ] ERROR\nOnly 2D, 2D array and cube DDS textures are supported!\n");
+			//Legacy cubemaps are expected to carry all six faces
+			container.faceCount = caps2 & DDSCAPS2_CUBEMAP ? 6 : 1;
+		}
+		if (container.format == VK_FORMAT_UNDEFINED)
+			throw std::runtime_error("[ TextureContainer ] ERROR\nUnsupported DDS pixel format!\n");
+
+		LayoutLevels(container, flags & DDSD_MIPMAPCOUNT ? std::max(mipMapCount, 1u) : 1, fileSize);
+
+		//DDS stores every array element with its full mip chain, transpose to level-major
+		size_t srcOffset = dataOffset;
+		for (uint32_t element = 0; element < container.ArrayLayerCount(); element++)
+			for (const Level& level : container.levels) {
+				VkDeviceSize imageSize = level.size / container.ArrayLayerCount();
+				if (!FitsInFile(srcOffset, imageSize, fileSize))
+					throw std::runtime_error("[ TextureContainer ] ERROR\nUnexpected end of file!\n");
+				container.regions.push_back({ srcOffset, level.offset + imageSize * element, imageSize });
+				srcOffset += size_t(imageSize);
+			}
+		return container;
+	}
+}
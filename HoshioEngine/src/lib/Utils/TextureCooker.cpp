@@ -0,0 +1,522 @@
+#include "Utils/TextureCooker.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HOSHIO_SSE2
+#include <immintrin.h>
+#endif
+
+namespace HoshioEngine {
+
+	namespace {
+		//Bump whenever filtering or encoding changes, so every cooked file is rebuilt
+		constexpr uint32_t COOKER_VERSION = 1;
+		constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+		constexpr std::string_view HASH_KEY = "HoshioEngine.sourceHash";
+		constexpr int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		float SrgbToLinear(float c) {
+			return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+
+		float LinearToSrgb(float c) {
+			return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.f / 2.4f) - 0.055f;
+		}
+
+		struct SrgbTable {
+			float values[256];
+			SrgbTable() {
+				for (uint32_t i = 0; i < 256; i++)
+					values[i] = SrgbToLinear(i / 255.f);
+			}
+		};
+		const SrgbTable srgbTable;
+
+		//Edge blocks repeat the last row/column
+		void FetchBlock(const uint8_t* pRgba8, VkExtent2D extent, uint32_t bx, uint32_t by, uint8_t block[16][4]) {
+			for (uint32_t y = 0; y < 4; y++)
+				for (uint32_t x = 0; x < 4; x++) {
+					uint32_t px = std::min(bx * 4 + x, extent.width - 1);
+					uint32_t py = std::min(by * 4 + y, extent.height - 1);
+					memcpy(block[y * 4 + x], pRgba8 + 4 * (size_t(py) * extent.width + px), 4);
+				}
+		}
+
+		struct BitWriter {
+			uint64_t bits[2] = {};
+			uint32_t position = 0;
+			void Write(uint32_t value, uint32_t count) {
+				for (uint32_t i = 0; i < count; i++, position++)
+					if (value >> i & 1)
+						bits[position >> 6] |= 1ull << (position & 63);
+			}
+		};
+
+		//Mode 6 endpoints are 7 bits per channel plus one shared p-bit, keep whichever p-bit rounds closer
+		void QuantizeEndpoint(const glm::vec4& endpoint, uint32_t quantized[4], uint32_t& pBit) {
+			float bestError = std::numeric_limits<float>::max();
+			for (uint32_t p = 0; p < 2; p++) {
+				uint32_t q[4];
+				float error = 0;
+				for (uint32_t c = 0; c < 4; c++) {
+					q[c] = uint32_t(std::clamp(int(std::round((endpoint[c] - p) / 2.f)), 0, 127));
+					float d = float(q[c] << 1 | p) - endpoint[c];
+					error += d * d;
+				}
+				if (error < bestError)
+					bestError = error, pBit = p, memcpy(quantized, q, sizeof q);
+			}
+		}
+
+		//Picks the closest palette entry for every texel, returns the summed squared error
+		float FitIndices(const glm::vec4 texels[16], const uint32_t q0[4], uint32_t p0, const uint32_t q1[4], uint32_t p1, uint32_t indices[16]) {
+			glm::vec4 palette[16];
+			for (uint32_t i = 0; i < 16; i++)
+				for (uint32_t c = 0; c < 4; c++) {
+					int e0 = int(q0[c] << 1 | p0), e1 = int(q1[c] << 1 | p1);
+					palette[i][c] = float(((64 - BC7_WEIGHTS4[i]) * e0 + BC7_WEIGHTS4[i] * e1 + 32) >> 6);
+				}
+#ifdef HOSHIO_SSE2
+			__m128 palette_sse[16];
+			for (uint32_t i = 0; i < 16; i++)
+				palette_sse[i] = _mm_loadu_ps(&palette[i].x);
+#endif
+			float totalError = 0;
+			for (uint32_t t = 0; t < 16; t++) {
+				float bestError = std::numeric_limits<float>::max();
+#ifdef HOSHIO_SSE2
+				__m128 texel = _mm_loadu_ps(&texels[t].x);
+#endif
+				for (uint32_t i = 0; i < 16; i++) {
+#ifdef HOSHIO_SSE2
+					__m128 d = _mm_sub_ps(texel, palette_sse[i]);
+					d = _mm_mul_ps(d, d);
+					d = _mm_add_ps(d, _mm_movehl_ps(d, d));
+					d = _mm_add_ss(d, _mm_shuffle_ps(d, d, 1));
+					float error = _mm_cvtss_f32(d);
+#else
+					glm::vec4 d = texels[t] - palette[i];
+					float error = glm::dot(d, d);
+#endif
+					if (error < bestError)
+						bestError = error, indices[t] = i;
+				}
+				totalError += bestError;
+			}
+			return totalError;
+		}
+
+		//Endpoints on the principal axis of the block, found by power iteration
+		void PrincipalEndpoints(const glm::vec4 texels[16], glm::vec4& e0, glm::vec4& e1) {
+			glm::vec4 mean(0.f), minimum(255.f), maximum(0.f);
+			for (uint32_t t = 0; t < 16; t++)
+				mean += texels[t],
+				minimum = glm::min(minimum, texels[t]),
+				maximum = glm::max(maximum, texels[t]);
+			mean /= 16.f;
+			glm::vec4 axis = maximum - minimum;
+			if (glm::length(axis) < 1e-3f) {
+				e0 = e1 = mean;
+				return;
+			}
+			glm::mat4 covariance(0.f);
+			for (uint32_t t = 0; t < 16; t++)
+				covariance += glm::outerProduct(texels[t] - mean, texels[t] - mean);
+			axis = glm::normalize(axis);
+			for (uint32_t i = 0; i < 8; i++) {
+				glm::vec4 next = covariance * axis;
+				if (glm::length(next) < 1e-6f)
+					break;
+				axis = glm::normalize(next);
+			}
+			float tMin = std::numeric_limits<float>::max(), tMax = -tMin;
+			for (uint32_t t = 0; t < 16; t++) {
+				float projection = glm::dot(texels[t] - mean, axis);
+				tMin = std::min(tMin, projection);
+				tMax = std::max(tMax, projection);
+			}
+			e0 = glm::clamp(mean + axis * tMin, 0.f, 255.f);
+			e1 = glm::clamp(mean + axis * tMax, 0.f, 255.f);
+		}
+
+		//Least squares endpoints for fixed indices
+		bool RefitEndpoints(const glm::vec4 texels[16], const uint32_t indices[16], glm::vec4& e0, glm::vec4& e1) {
+			float aa = 0, ab = 0, bb = 0;
+			glm::vec4 ax(0.f), bx(0.f);
+			for (uint32_t t = 0; t < 16; t++) {
+				float b = BC7_WEIGHTS4[indices[t]] / 64.f, a = 1.f - b;
+				aa += a * a, ab += a * b, bb += b * b;
+				ax += a * texels[t], bx += b * texels[t];
+			}
+			float determinant = aa * bb - ab * ab;
+			if (std::abs(determinant) < 1e-6f)
+				return false;
+			e0 = glm::clamp((ax * bb - bx * ab) / determinant, 0.f, 255.f);
+			e1 = glm::clamp((bx * aa - ax * ab) / determinant, 0.f, 255.f);
+			return true;
+		}
+
+		//BC7 mode 6 only: one subset, RGBA endpoints, 4 bit indices
+		void EncodeBC7Block(const uint8_t block[16][4], uint8_t* pOut) {
+			glm::vec4 texels[16];
+			for (uint32_t t = 0; t < 16; t++)
+				texels[t] = glm::vec4(block[t][0], block[t][1], block[t][2], block[t][3]);
+
+			glm::vec4 e0, e1;
+			PrincipalEndpoints(texels, e0, e1);
+			uint32_t q0[4], q1[4], p0 = 0, p1 = 0, indices[16];
+			QuantizeEndpoint(e0, q0, p0);
+			QuantizeEndpoint(e1, q1, p1);
+			float error = FitIndices(texels, q0, p0, q1, p1, indices);
+
+			if (error > 0.f && RefitEndpoints(texels, indices, e0, e1)) {
+				uint32_t rq0[4], rq1[4], rp0 = 0, rp1 = 0, rIndices[16];
+				QuantizeEndpoint(e0, rq0, rp0);
+				QuantizeEndpoint(e1, rq1, rp1);
+				if (FitIndices(texels, rq0, rp0, rq1, rp1, rIndices) < error)
+					memcpy(q0, rq0, sizeof q0), memcpy(q1, rq1, sizeof q1),
+					p0 = rp0, p1 = rp1,
+					memcpy(indices, rIndices, sizeof indices);
+			}
+
+			//The top bit of the anchor index is implicitly 0
+			if (indices[0] & 8) {
+				std::swap(q0, q1);
+				std::swap(p0, p1);
+				for (uint32_t& index : indices)
+					index = 15 - index;
+			}
+
+			BitWriter writer;
+			writer.Write(1u << 6, 7);
+			for (uint32_t c = 0; c < 4; c++)
+				writer.Write(q0[c], 7),
+				writer.Write(q1[c], 7);
+			writer.Write(p0, 1);
+			writer.Write(p1, 1);
+			writer.Write(indices[0], 3);
+			for (uint32_t t = 1; t < 16; t++)
+				writer.Write(indices[t], 4);
+			memcpy(pOut, writer.bits, 16);
+		}
+
+		//8 value mode, index 0/1 are the endpoints and 2..7 step from red0 towards red1
+		void EncodeBC4Block(const uint8_t values[16], uint8_t* pOut) {
+			uint8_t red0 = *std::max_element(values, values + 16);
+			uint8_t red1 = *std::min_element(values, values + 16);
+			uint64_t bits = uint64_t(red0) | uint64_t(red1) << 8;
+			if (red0 > red1)
+				for (uint32_t t = 0; t < 16; t++) {
+					int k = int(std::round(float(red0 - values[t]) * 7.f / float(red0 - red1)));
+					uint64_t index = k == 0 ? 0 : k == 7 ? 1 : k + 1;
+					bits |= index << (16 + 3 * t);
+				}
+			memcpy(pOut, &bits, 8);
+		}
+	}
+
+	std::vector<std::vector<glm::vec4>> TextureCooker::BuildMipChain(const uint8_t* pRgba8, VkExtent2D extent, const CookOptions& options)
+	{
+		bool srgb = options.srgb && options.format != COOK_FORMAT::BC5;
+		std::vector<std::vector<glm::vec4>> levels(1);
+		levels[0].resize(size_t(extent.width) * extent.height);
+		for (size_t i = 0; i < levels[0].size(); i++) {
+			const uint8_t* pTexel = pRgba8 + 4 * i;
+			levels[0][i] = srgb ?
+				glm::vec4(srgbTable.values[pTexel[0]], srgbTable.values[pTexel[1]], srgbTable.values[pTexel[2]], pTexel[3] / 255.f) :
+				glm::vec4(pTexel[0], pTexel[1], pTexel[2], pTexel[3]) / 255.f;
+		}
+		if (!options.generateMips)
+			return levels;
+
+		uint32_t mipLevelCount = uint32_t(std::floor(std::log2(std::max(extent.width, extent.height)))) + 1;
+		VkExtent2D srcExtent = extent;
+		for (uint32_t level = 1; level < mipLevelCount; level++) {
+			VkExtent2D dstExtent = { std::max(srcExtent.width >> 1, 1u), std::max(srcExtent.height >> 1, 1u) };
+			const std::vector<glm::vec4>& src = levels.back();
+			std::vector<glm::vec4> dst(size_t(dstExtent.width) * dstExtent.height);
+			//2x2 box, odd edges clamp onto the last row/column
+			ParallelFor(dstExtent.height, options.threadCount, [&](size_t begin, size_t end) {
+#ifdef HOSHIO_SSE2
+				const __m128 quarter = _mm_set1_ps(0.25f);
+#endif
+				for (size_t y = begin; y < end; y++) {
+					size_t row0 = std::min<size_t>(2 * y, srcExtent.height - 1) * srcExtent.width;
+					size_t row1 = std::min<size_t>(2 * y + 1, srcExtent.height - 1) * srcExtent.width;
+					for (size_t x = 0; x < dstExtent.width; x++) {
+						size_t x0 = std::min<size_t>(2 * x, srcExtent.width - 1);
+						size_t x1 = std::min<size_t>(2 * x + 1, srcExtent.width - 1);
+#ifdef HOSHIO_SSE2
+						__m128 sum = _mm_add_ps(
+							_mm_add_ps(_mm_loadu_ps(&src[row0 + x0].x), _mm_loadu_ps(&src[row0 + x1].x)),
+							_mm_add_ps(_mm_loadu_ps(&src[row1 + x0].x), _mm_loadu_ps(&src[row1 + x1].x)));
+						_mm_storeu_ps(&dst[y * dstExtent.width + x].x, _mm_mul_ps(sum, quarter));
+#else
+						dst[y * dstExtent.width + x] = (src[row0 + x0] + src[row0 + x1] + src[row1 + x0] + src[row1 + x1]) * 0.25f;
+#endif
+					}
+				}
+				});
+			if (options.format == COOK_FORMAT::BC5)
+				for (glm::vec4& texel : dst) {
+					glm::vec3 normal = glm::vec3(texel) * 2.f - 1.f;
+					if (float length = glm::length(normal); length > 0.f)
+						normal /= length;
+					texel = glm::vec4(normal * 0.5f + 0.5f, texel.a);
+				}
+			levels.push_back(std::move(dst));
+			srcExtent = dstExtent;
+		}
+		return levels;
+	}
+
+	std::vector<uint8_t> TextureCooker::ToRgba8(const std::vector<glm::vec4>& pixels, const CookOptions& options)
+	{
+		bool srgb = options.srgb && options.format != COOK_FORMAT::BC5;
+		std::vector<uint8_t> rgba8(pixels.size() * 4);
+		ParallelFor(pixels.size(), options.threadCount, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++)
+				for (uint32_t c = 0; c < 4; c++) {
+					float value = std::clamp(pixels[i][c], 0.f, 1.f);
+					if (srgb && c < 3)
+						value = LinearToSrgb(value);
+					rgba8[4 * i + c] = uint8_t(value * 255.f + 0.5f);
+				}
+			});
+		return rgba8;
+	}
+
+	VkFormat TextureCooker::OutputFormat(const CookOptions& options)
+	{
+		switch (options.format) {
+		case COOK_FORMAT::BC5:
+			return VK_FORMAT_BC5_UNORM_BLOCK;
+		case COOK_FORMAT::BC7:
+			return options.srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+		default:
+			return options.srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+		}
+	}
+
+	uint64_t TextureCooker::SourceHash(const uint8_t* pFile, size_t fileSize, const CookOptions& options)
+	{
+		uint32_t settings[4] = { COOKER_VERSION, uint32_t(options.format), options.srgb, options.generateMips };
+		return HashBytes(settings, sizeof settings, HashBytes(pFile, fileSize));
+	}
+
+	uint64_t TextureCooker::ReadCookedHash(const std::filesystem::path& cookedPath)
+	{
+		std::ifstream file(cookedPath, std::ios::binary);
+		uint8_t header[80];
+		if (!file || !file.read(reinterpret_cast<char*>(header), sizeof header) || memcmp(header, KTX2_IDENTIFIER, sizeof KTX2_IDENTIFIER))
+			return 0;
+		uint32_t kvdOffset, kvdLength;
+		memcpy(&kvdOffset, header + 56, 4);
+		memcpy(&kvdLength, header + 60, 4);
+		std::vector<char> kvd(kvdLength);
+		file.seekg(kvdOffset);
+		if (!file.read(kvd.data(), kvdLength))
+			return 0;
+		for (size_t offset = 0; offset + 4 <= kvd.size();) {
+			uint32_t length;
+			memcpy(&length, kvd.data() + offset, 4);
+			if (offset + 4 + length > kvd.size())
+				break;
+			std::string_view entry(kvd.data() + offset + 4, length);
+			if (size_t separator = entry.find('\0'); separator != std::string_view::npos && entry.substr(0, separator) == HASH_KEY)
+				return std::strtoull(std::string(entry.substr(separator + 1)).c_str(), nullptr, 16);
+			offset += (4 + length + 3) & ~size_t(3);
+		}
+		return 0;
+	}
+
+	bool TextureCooker::Cook(const std::filesystem::path& input, const std::filesystem::path& output, const CookOptions& options, bool force)
+	{
+		std::ifstream file(input, std::ios::ate | std::ios::binary);
+		if (!file)
+			throw std::runtime_error(std::format("[ TextureCooker ] ERROR\nFailed to open the file: {}\n", input.string()));
+		std::vector<uint8_t> binaries(size_t(file.tellg()));
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(binaries.data()), binaries.size());
+		file.close();
+
+		uint64_t hash = SourceHash(binaries.data(), binaries.size(), options);
+		if (!force && ReadCookedHash(output) == hash)
+			return false;
+
+		int width = 0, height = 0, channelCount = 0;
+		std::unique_ptr<uint8_t, decltype(&stbi_image_free)> pRgba8(
+			stbi_load_from_memory(binaries.data(), int(binaries.size()), &width, &height, &channelCount, 4), stbi_image_free);
+		if (!pRgba8)
+			throw std::runtime_error(std::format("[ TextureCooker ] ERROR\nFailed to decode the file: {}\n{}\n", input.string(), stbi_failure_reason()));
+
+		VkExtent2D extent = { uint32_t(width), uint32_t(height) };
+		std::vector<std::vector<glm::vec4>> mipChain = BuildMipChain(pRgba8.get(), extent, options);
+		std::vector<Level> levels(mipChain.size());
+		for (size_t i = 0; i < mipChain.size(); i++) {
+			levels[i].extent = { std::max(extent.width >> i, 1u), std::max(extent.height >> i, 1u) };
+			std::vector<uint8_t> rgba8 = ToRgba8(mipChain[i], options);
+			if (options.format == COOK_FORMAT::RGBA8) {
+				levels[i].data = std::move(rgba8);
+				continue;
+			}
+			//BC7 and BC5 blocks are both 16 bytes
+			size_t blockCount = size_t((levels[i].extent.width + 3) / 4) * ((levels[i].extent.height + 3) / 4);
+			levels[i].data.resize(blockCount * 16);
+			if (options.format == COOK_FORMAT::BC7)
+				EncodeBC7(rgba8.data(), levels[i].extent, levels[i].data.data(), options.threadCount);
+			else
+				EncodeBC5(rgba8.data(), levels[i].extent, levels[i].data.data(), options.threadCount);
+		}
+		WriteKtx2(output, OutputFormat(options), { levels.data(), levels.size() }, hash);
+		return true;
+	}
+
+	void TextureCooker::EncodeBC7(const uint8_t* pRgba8, VkExtent2D extent, uint8_t* pBlocks, uint32_t threadCount)
+	{
+		uint32_t blockCountX = (extent.width + 3) / 4;
+		uint32_t blockCountY = (extent.height + 3) / 4;
+		ParallelFor(blockCountY, threadCount, [&](size_t begin, size_t end) {
+			uint8_t block[16][4];
+			for (size_t by = begin; by < end; by++)
+				for (uint32_t bx = 0; bx < blockCountX; bx++) {
+					FetchBlock(pRgba8, extent, bx, uint32_t(by), block);
+					EncodeBC7Block(block, pBlocks + 16 * (by * blockCountX + bx));
+				}
+			});
+	}
+
+	void TextureCooker::EncodeBC5(const uint8_t* pRgba8, VkExtent2D extent, uint8_t* pBlocks, uint32_t threadCount)
+	{
+		uint32_t blockCountX = (extent.width + 3) / 4;
+		uint32_t blockCountY = (extent.height + 3) / 4;
+		ParallelFor(blockCountY, threadCount, [&](size_t begin, size_t end) {
+			uint8_t block[16][4], red[16], green[16];
+			for (size_t by = begin; by < end; by++)
+				for (uint32_t bx = 0; bx < blockCountX; bx++) {
+					FetchBlock(pRgba8, extent, bx, uint32_t(by), block);
+					for (uint32_t t = 0; t < 16; t++)
+						red[t] = block[t][0],
+						green[t] = block[t][1];
+					uint8_t* pOut = pBlocks + 16 * (by * blockCountX + bx);
+					EncodeBC4Block(red, pOut);
+					EncodeBC4Block(green, pOut + 8);
+				}
+			});
+	}
+
+	void TextureCooker::WriteKtx2(const std::filesystem::path& output, VkFormat format, ArrayRef<const Level> levels, uint64_t sourceHash)
+	{
+		bool srgb = vkuFormatIsSRGB(format);
+		VkExtent3D blockExtent = vkuFormatTexelBlockExtent(format);
+		uint32_t elementSize = vkuFormatElementSize(format);
+
+		//Data format descriptor: total size, then one basic descriptor block followed by its samples
+		std::vector<uint32_t> dfd(7);
+		auto AddSample = [&](uint32_t bitOffset, uint32_t bitLength, uint32_t channel, uint32_t upper) {
+			dfd.insert(dfd.end(), { bitOffset | (bitLength - 1) << 16 | channel << 24, 0, 0, upper });
+			};
+		uint32_t colorModel;
+		switch (format) {
+		case VK_FORMAT_BC7_UNORM_BLOCK:
+		case VK_FORMAT_BC7_SRGB_BLOCK:
+			colorModel = 134;
+			AddSample(0, 128, 0, UINT32_MAX);
+			break;
+		case VK_FORMAT_BC5_UNORM_BLOCK:
+			colorModel = 132;
+			AddSample(0, 64, 0, UINT32_MAX);
+			AddSample(64, 64, 1, UINT32_MAX);
+			break;
+		default:
+			colorModel = 1;
+			AddSample(0, 8, 0, 255);
+			AddSample(8, 8, 1, 255);
+			AddSample(16, 8, 2, 255);
+			//Alpha stays linear under an sRGB transfer function
+			AddSample(24, 8, 15 | (srgb ? 0x10 : 0), 255);
+			break;
+		}
+		uint32_t descriptorBlockSize = uint32_t(dfd.size() - 1) * 4;
+		dfd[0] = descriptorBlockSize + 4;
+		dfd[1] = 0;
+		dfd[2] = 2 | descriptorBlockSize << 16;
+		dfd[3] = colorModel | 1 << 8 | (srgb ? 2 : 1) << 16;
+		dfd[4] = (blockExtent.width - 1) | (blockExtent.height - 1) << 8;
+		dfd[5] = elementSize;
+
+		//Keys sorted by code point as the spec requires
+		std::vector<uint8_t> kvd;
+		auto AddKeyValue = [&](std::string_view key, std::string_view value) {
+			uint32_t length = uint32_t(key.size() + value.size() + 2);
+			kvd.insert(kvd.end(), reinterpret_cast<const uint8_t*>(&length), reinterpret_cast<const uint8_t*>(&length) + 4);
+			kvd.insert(kvd.end(), key.begin(), key.end());
+			kvd.push_back(0);
+			kvd.insert(kvd.end(), value.begin(), value.end());
+			kvd.push_back(0);
+			kvd.resize((kvd.size() + 3) & ~size_t(3));
+			};
+		AddKeyValue(HASH_KEY, std::format("{:016x}", sourceHash));
+		AddKeyValue("KTXwriter", "HoshioEngine TextureCooker");
+
+		size_t dfdOffset = 80 + 24 * levels.size();
+		size_t kvdOffset = dfdOffset + dfd.size() * 4;
+		size_t dataSize = kvdOffset + kvd.size();
+		size_t alignment = std::lcm(size_t(elementSize), size_t(4));
+		//Smallest level first
+		std::vector<uint64_t> levelOffsets(levels.size());
+		for (size_t i = levels.size(); i-- > 0;) {
+			dataSize = (dataSize + alignment - 1) / alignment * alignment;
+			levelOffsets[i] = dataSize;
+			dataSize += levels[i].data.size();
+		}
+
+		std::vector<uint8_t> binaries(dataSize);
+		auto Put = [&](size_t offset, auto value) { memcpy(binaries.data() + offset, &value, sizeof value); };
+		memcpy(binaries.data(), KTX2_IDENTIFIER, sizeof KTX2_IDENTIFIER);
+		Put(12, uint32_t(format));
+		Put(16, uint32_t(1)); //typeSize, 1 for block compressed and 8 bit formats
+		Put(20, levels[0].extent.width);
+		Put(24, levels[0].extent.height);
+		Put(28, uint32_t(0));
+		Put(32, uint32_t(0));
+		Put(36, uint32_t(1));
+		Put(40, uint32_t(levels.size()));
+		Put(44, uint32_t(0));
+		Put(48, uint32_t(dfdOffset));
+		Put(52, uint32_t(dfd.size() * 4));
+		Put(56, uint32_t(kvdOffset));
+		Put(60, uint32_t(kvd.size()));
+		Put(64, uint64_t(0));
+		Put(72, uint64_t(0));
+		for (size_t i = 0; i < levels.size(); i++) {
+			Put(80 + 24 * i, levelOffsets[i]);
+			Put(80 + 24 * i + 8, uint64_t(levels[i].data.size()));
+			Put(80 + 24 * i + 16, uint64_t(levels[i].data.size()));
+			memcpy(binaries.data() + levelOffsets[i], levels[i].data.data(), levels[i].data.size());
+		}
+		memcpy(binaries.data() + dfdOffset, dfd.data(), dfd.size() * 4);
+		memcpy(binaries.data() + kvdOffset, kvd.data(), kvd.size());
+
+		if (output.has_parent_path())
+			std::filesystem::create_directories(output.parent_path());
+		//Write then rename, Cook() trusts the hash at the front of any file it finds, so a half written one must never appear
+		std::filesystem::path tempPath = output;
+		tempPath += ".tmp";
+		std::error_code ec;
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (file)
+				file.write(reinterpret_cast<const char*>(binaries.data()), binaries.size());
+			if (!file) {
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				throw std::runtime_error(std::format("[ TextureCooker ] ERROR\nFailed to write the file: {}\n", output.string()));
+			}
+		}
+		std::filesystem::rename(tempPath, output, ec);
+		if (ec) {
+			std::filesystem::remove(tempPath, ec);
+			throw std::runtime_error(std::format("[ TextureCooker ] ERROR\nFailed to write the file: {}\n", output.string()));
+		}
+	}
+}
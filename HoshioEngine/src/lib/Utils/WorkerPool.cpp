@@ -0,0 +1,47 @@
+#include "Utils/WorkerPool.h"
+
+namespace HoshioEngine {
+
+	WorkerPool::WorkerPool(uint32_t threadCount)
+	{
+		if (!threadCount)
+			threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		workers.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; i++)
+			workers.emplace_back(&WorkerPool::Work, this);
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		condition.notify_all();
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	uint32_t WorkerPool::ThreadCount() const
+	{
+		return uint32_t(workers.size());
+	}
+
+	void WorkerPool::Work()
+	{
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock lock(mutex);
+				condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+				//The queue is drained before the workers leave
+				if (tasks.empty())
+					return;
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+			//packaged_task stores what the task throws in its future
+			task();
+		}
+	}
+}
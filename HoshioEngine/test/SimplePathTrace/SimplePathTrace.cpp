@@ -18,7 +18,7 @@ namespace HoshioEngine {
 	void SimplePathTrace::RecordCommandBuffer()
 	{
 		const CommandBuffer& commandBuffer = VulkanPlus::Plus().CommandBuffer_Graphics();
-		VulkanPlus::Plus().SwapchainRenderPass().Begin(commandBuffer, VulkanPlus::Plus().CurrentSwapchainFramebuffer(), { {},VulkanBase::Base().SwapchainCi().imageExtent }, { {1.0f} });
+		VulkanPlus::Plus().BeginSwapchainRenderPass(commandBuffer, false, { {},VulkanBase::Base().SwapchainCi().imageExtent }, { {1.0f} });
 		VkDeviceSize offset = 0;
 		vkCmdBindVertexBuffers(commandBuffer, 0, 1, VulkanPlus::Plus().DefaultVertexBuffer().Address(), &offset);
 		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
@@ -27,8 +27,14 @@ namespace HoshioEngine {
 		};
 
 		const CommandBuffer& commandBuffer = VulkanPlus::Plus().CommandBuffer_Graphics();
+		uint32_t currentImageIndex = VulkanBase::Base().CurrentImageIndex();
+		VkImageView attachments[2] = {
+			VulkanBase::Base().SwapchainImageView(currentImageIndex),
+			dsAttachments[currentImageIndex].ImageView()
+		};
+		const Framebuffer& framebuffer = VulkanPlus::Plus().AcquireFramebuffer(renderPass, attachments, VulkanBase::Base().SwapchainExtent());
 		renderPass.Begin(commandBuffer,
-			framebuffers[VulkanBase::Base().CurrentImageIndex()], {{},VulkanBase::Base().SwapchainCi().imageExtent},
+			framebuffer, {{},VulkanBase::Base().SwapchainCi().imageExtent},
 			clearValues);
 		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 		VkBuffer buffers[2] = { vertexBuffer_perVertex, vertexBuffer_perInstance };
@@ -155,10 +161,8 @@ namespace HoshioEngine {
 				PipelineConfigurator configurator;
 				configurator.PipelineLayout(pipelineLayout)
 					.RenderPass(renderPass)
-					.AddVertexInputBindings(0, sizeof(mVertex), VK_VERTEX_INPUT_RATE_VERTEX)
+					.AddVertexFormat<mVertexFormat>(0)
 					.AddVertexInputBindings(1, sizeof(glm::vec3), VK_VERTEX_INPUT_RATE_INSTANCE)
-					.AddVertexInputAttribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(mVertex, position))
-					.AddVertexInputAttribute(1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(mVertex, color))
 					.AddVertexInputAttribute(2, 1, VK_FORMAT_R32G32B32_SFLOAT, 0)
 					.PrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
 					.AddViewport(0.0f, 0.0f, static_cast<float>(VulkanBase::Base().SwapchainCi().imageExtent.width), static_cast<float>(VulkanBase::Base().SwapchainCi().imageExtent.height), 0.0f, 1.0f)
@@ -189,33 +193,17 @@ namespace HoshioEngine {
 	{
 		//Create Attachment 
 		{
+			//Framebuffers come from the shared cache on first use
 			auto Create = [&] {
 				dsAttachments.resize(VulkanBase::Base().SwapchainImageCount());
-				framebuffers.resize(VulkanBase::Base().SwapchainImageCount());
 				for (auto& dsAttachment : dsAttachments)
 					dsAttachment.Create(VK_FORMAT_D24_UNORM_S8_UINT, VulkanBase::Base().SwapchainExtent(), false, 1, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT);
-
-				VkFramebufferCreateInfo framebufferCreateInfo = {
-					.renderPass = renderPass,
-					.attachmentCount = 2,
-					.width = VulkanBase::Base().SwapchainExtent().width,
-					.height = VulkanBase::Base().SwapchainExtent().height,
-					.layers = 1
-				};
-
-				for (uint32_t i = 0; i < VulkanBase::Base().SwapchainImageCount(); i++) {
-					VkImageView attachments[2] = {
-						VulkanBase::Base().SwapchainImageView(i),
-						dsAttachments[i].ImageView()
-					};
-					framebufferCreateInfo.pAttachments = attachments;
-					framebuffers[i].Create(framebufferCreateInfo);
-				}
 				};
 
 			auto Destroy = [&] {
+				for (auto& dsAttachment : dsAttachments)
+					VulkanPlus::Plus().EvictFramebuffers(*dsAttachment.AddressOfImageView());
 				dsAttachments.clear();
-				framebuffers.clear();
 				};
 
 			VulkanBase::Base().AddCallback_CreateSwapchain(Create);
@@ -3,18 +3,16 @@
 
 #include "Engine/ShaderEditor/RenderGraph/RenderNode.h"
 #include "Engine/Actor/Camera.h"
+#include "Engine/Actor/VertexFormat.h"
 
 namespace HoshioEngine {
 	class Test3D : public RenderNode{
 	private:
-		struct mVertex {
-			glm::vec3 position;
-			glm::vec4 color;
-		};
+		using mVertexFormat = VertexFormat<VertexElements::Position<VertexElements::f32x3>, VertexElements::Color<VertexElements::f32x4>>;
+		using mVertex = mVertexFormat::Vertex;
 
 		RenderPass renderPass;
 		std::vector<DepthStencilAttachment> dsAttachments;
-		std::vector<Framebuffer> framebuffers;
 
 		VertexBuffer vertexBuffer_perVertex;
 		VertexBuffer vertexBuffer_perInstance;
@@ -0,0 +1,29 @@
+#version 460
+#pragma shader_stage(vertex)
+
+// Blinn-Phong.vert for GpuScene, the model matrix comes per instance from the scene's transforms
+layout(location = 0) in vec3 i_Position;
+layout(location = 1) in vec3 i_Normal;
+layout(location = 2) in vec2 i_Texcoord;
+
+layout(set = 1,binding = 0) uniform u_Transform{
+	mat4 model;
+	mat4 view;
+	mat4 projection;
+};
+
+layout(std430, set = 2, binding = 0) readonly buffer Instances{
+	mat4 transforms[];
+};
+
+layout(location = 0) out vec3 o_Position;
+layout(location = 1) out vec3 o_Normal;
+layout(location = 2) out vec2 o_Texcoord;
+
+void main(){
+	mat4 instance = transforms[gl_InstanceIndex];
+	o_Position = vec3(instance * vec4(i_Position, 1.0f));
+	o_Normal = mat3(transpose(inverse(mat3(instance)))) * i_Normal;
+	o_Texcoord = i_Texcoord;
+	gl_Position = projection * view * vec4(o_Position, 1.0f);
+}
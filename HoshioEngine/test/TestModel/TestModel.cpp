@@ -1,5 +1,6 @@
 #include "TestModel.h"
 #include "Wins/GlfwManager.h"
+#include "Base/ShaderCompiler.h"
 
 namespace HoshioEngine {
 	TestModel::TestModel(const char* file_path) : model(file_path)
@@ -33,7 +34,6 @@ namespace HoshioEngine {
 
 		const RenderPass& renderPass = VulkanPlus::Plus().SwapchainRenderPassWithDepthStencil();
 		const CommandBuffer& commandBuffer = VulkanPlus::Plus().CommandBuffer_Graphics();
-		const Framebuffer& framebuffer = VulkanPlus::Plus().CurrentSwapchainFramebufferWithDepthStencil();
 
 		VkRect2D renderArea = {{}, VulkanBase::Base().SwapchainExtent() };
 		VkClearValue clearValues[2] = {
@@ -41,15 +41,50 @@ namespace HoshioEngine {
 			{.depthStencil = { 1.f, 0 } }
 		};
 
-		renderPass.Begin(commandBuffer, framebuffer, renderArea, clearValues);
-		PipelineLayout& pipeline_layout = VulkanPlus::Plus().GetPipelineLayout(shader_info.pipeline_layout_id).second[0];
-		DescriptorSetLayout& uniform_set_layout = VulkanPlus::Plus().GetDescriptorSetLayout(uniform_set_layout_id).second[0];
-		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout,
-			1, 1, uniform_set.Address(), 0, nullptr);
-		model.Render(shader_info);
+		if (gpu_driven) {
+			if (placed_grid != instance_grid)
+				PlaceInstances();
+			scene.CmdCull(commandBuffer, CullView::FromCamera(GlfwWindow::camera));
+		}
+		else {
+			//Levels first, the clusters culled are those of the picked levels and the dispatch has to precede the render pass
+			LodSelector::SetQualityBias(quality_bias);
+			drawn_triangles = model.SelectLods(LodView::FromCamera(GlfwWindow::camera), vertex_uniform.model);
+			if (cluster_culling)
+				model.CullClusters(commandBuffer, CullView::FromCamera(GlfwWindow::camera), vertex_uniform.model);
+		}
+
+		VulkanPlus::Plus().BeginSwapchainRenderPass(commandBuffer, true, renderArea, clearValues);
+		if (gpu_driven) {
+			PipelineLayout& pipeline_layout = VulkanPlus::Plus().GetPipelineLayout(instanced_shader_info.pipeline_layout_id).second[0];
+			Pipeline& pipeline = VulkanPlus::Plus().GetPipeline(instanced_shader_info.pipeline_id).second[0];
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout,
+				1, 1, uniform_set.Address(), 0, nullptr);
+			scene.CmdDraw(commandBuffer, instanced_shader_info, 2);
+		}
+		else {
+			PipelineLayout& pipeline_layout = VulkanPlus::Plus().GetPipelineLayout(shader_info.pipeline_layout_id).second[0];
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout,
+				1, 1, uniform_set.Address(), 0, nullptr);
+			model.Render(shader_info);
+		}
 		renderPass.End(commandBuffer);
 	}
 
+	void TestModel::PlaceInstances()
+	{
+		//A grid on the xz plane around the origin, the model's extent apart
+		scene.Clear();
+		MeshBounds bounds = model.Bounds();
+		float spacing = bounds.Empty() ? 1.f : std::max(bounds.Extent().x, bounds.Extent().z) * 1.25f;
+		float origin = -0.5f * spacing * (instance_grid - 1);
+		for (int x = 0; x < instance_grid; x++)
+			for (int z = 0; z < instance_grid; z++)
+				scene.AddInstance(model, glm::translate(glm::mat4(1.f), glm::vec3(origin + x * spacing, 0.f, origin + z * spacing)));
+		placed_grid = instance_grid;
+	}
+
 	void TestModel::InitResource()
 	{
 	}
@@ -167,16 +202,23 @@ namespace HoshioEngine {
 
 		shader_info.pipeline_layout_id = VulkanPlus::Plus().CreatePipelineLayout("model-pipeline-layout", createInfo).first;
 
+		//Same sets plus the scene's transforms at set 2
+		VkDescriptorSetLayout instanced_layouts[] = { sampler_set_layout, uniform_set_layout, SceneCuller::Culler().InstanceSetLayout() };
+		createInfo.setLayoutCount = 3;
+		createInfo.pSetLayouts = instanced_layouts;
+		instanced_shader_info.sampler_id = shader_info.sampler_id;
+		instanced_shader_info.sampler_set_layout_id = shader_info.sampler_set_layout_id;
+		instanced_shader_info.pipeline_layout_id = VulkanPlus::Plus().CreatePipelineLayout("model-instanced-pipeline-layout", createInfo).first;
+
 	}
 
 	void TestModel::CreatePipeline()
 	{
-		auto Create = [&] {
-			static ShaderModule vertModule("test/TestModel/Resource/Shaders/SPIR-V/Blinn-Phong.vert.spv");
+		auto CreateWith = [&](ShaderModule& vertModule, ShaderInfo& info, const char* name) {
 			static ShaderModule fragModule("test/TestModel/Resource/Shaders/SPIR-V/Blinn-Phong.frag.spv");
 
 			PipelineConfigurator configurator;
-			std::vector<VertexInputAttribute> vertex_input_attributes = model.GetVertexInputeAttributes();
+			std::pmr::vector<VertexInputAttribute> vertex_input_attributes = model.GetVertexInputeAttributes(&FrameMemory::Scratch());
 			uint32_t stride = model.GetVertexInputAttributesStride();
 			configurator.AddVertexInputBindings(0, stride, VK_VERTEX_INPUT_RATE_VERTEX);
 			for (auto& attribute : vertex_input_attributes) {
@@ -184,7 +226,7 @@ namespace HoshioEngine {
 					attribute.location, attribute.binding, attribute.format, attribute.offset);
 			}
 
-			PipelineLayout& pipeline_layout = VulkanPlus::Plus().GetPipelineLayout(shader_info.pipeline_layout_id).second[0];
+			PipelineLayout& pipeline_layout = VulkanPlus::Plus().GetPipelineLayout(info.pipeline_layout_id).second[0];
 			const RenderPass& renderpass = VulkanPlus::Plus().SwapchainRenderPassWithDepthStencil();
 			configurator.PipelineLayout(pipeline_layout)
 				.RenderPass(renderpass)
@@ -202,11 +244,23 @@ namespace HoshioEngine {
 				.AddShaderStage(vertModule.ShaderStageCi(VK_SHADER_STAGE_VERTEX_BIT))
 				.AddShaderStage(fragModule.ShaderStageCi(VK_SHADER_STAGE_FRAGMENT_BIT))
 				.UpdatePipelineCreateInfo();
-			shader_info.pipeline_id = VulkanPlus::Plus().CreatePipeline("test-model-pipeline",configurator).first;
+			info.pipeline_id = VulkanPlus::Plus().CreatePipeline(name, configurator).first;
+			};
+
+		auto Create = [&] {
+			static ShaderModule vertModule("test/TestModel/Resource/Shaders/SPIR-V/Blinn-Phong.vert.spv");
+			//Compiled at run time, no SPIR-V of it is checked in
+			static ShaderBinary instancedVertBinary = ShaderCompiler::Compiler().Compile(ShaderCompileInfo{
+				.filePath = "test/TestModel/Resource/Shaders/GLSL/Blinn-Phong-Instanced.vert",
+				.stage = VK_SHADER_STAGE_VERTEX_BIT });
+			static ShaderModule instancedVertModule(instancedVertBinary.code.size() * sizeof(uint32_t), instancedVertBinary.code.data());
+			CreateWith(vertModule, shader_info, "test-model-pipeline");
+			CreateWith(instancedVertModule, instanced_shader_info, "test-model-instanced-pipeline");
 			};
 
 		auto Destroy = [&] {
 			VulkanPlus::Plus().DestroyPipeline(shader_info.pipeline_id);
+			VulkanPlus::Plus().DestroyPipeline(instanced_shader_info.pipeline_id);
 			};
 
 		VulkanBase::Base().AddCallback_CreateSwapchain(Create);
@@ -233,7 +287,15 @@ namespace HoshioEngine {
 
 	void TestModel::ImguiRender()
 	{
-
+		ImGui::Checkbox("GPU driven", &gpu_driven);
+		if (gpu_driven) {
+			ImGui::SliderInt("Instances per side", &instance_grid, 1, 64);
+			ImGui::Text("Draws : %u in %u batches", scene.DrawCount(), scene.BatchCount());
+			return;
+		}
+		ImGui::SliderFloat("LOD quality", &quality_bias, 0.1f, 4.0f);
+		ImGui::Checkbox("Cluster culling", &cluster_culling);
+		ImGui::Text("Triangles : %zu", drawn_triangles);
 	}
 
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "Engine/ShaderEditor/RenderGraph/RenderNode.h"
 #include "Engine/Actor/Model.h"
+#include "Engine/Actor/GpuScene.h"
 
 namespace HoshioEngine {
 	class TestModel : public RenderNode {
@@ -24,6 +25,19 @@ namespace HoshioEngine {
 		int uniform_set_layout_id = M_INVALID_ID;
 		DescriptorSet uniform_set;
 
+		float quality_bias = 1.f;
+		bool cluster_culling = true;
+		size_t drawn_triangles = 0;
+
+		//The model on a grid, culled and drawn through indirect draws
+		GpuScene scene;
+		ShaderInfo instanced_shader_info;
+		bool gpu_driven = false;
+		int instance_grid = 8;
+		int placed_grid = 0;
+
+		void PlaceInstances();
+
 		void UpdateDescriptorSets() override;
 		void RecordCommandBuffer() override;
 		void InitResource() override;
@@ -9,16 +9,38 @@ layout(location = 0) out vec4 o_Color;
 
 //layout(set = 0, binding = 0) uniform sampler2D u_Texture;
 
-vec3 hsv2rgb(vec3 c)
-{
-    vec3 rgb = clamp( abs(mod(c.x * 6.0 + vec3(0.0, 4.0, 2.0),
-                              6.0) - 3.0) - 1.0,
-                      0.0,
-                      1.0 );
-    rgb = rgb * rgb * (3.0 - 2.0 * rgb); // ƽֵѡ
-    return c.z * mix(vec3(1.0), rgb, c.y);
+layout(set = 1, binding = 1) uniform u_Material {
+	vec4 cameraPosition;
+	vec4 albedo;
+	float metallic;
+	float roughness;
+	float prefilteredMaxLod;
+};
+
+// Baked by IBLBaker
+layout(set = 2, binding = 0) uniform samplerCube u_Irradiance;
+layout(set = 2, binding = 1) uniform samplerCube u_Prefiltered;
+layout(set = 2, binding = 2) uniform sampler2D u_BrdfLut;
+
+vec3 FresnelSchlickRoughness(float NdotV, vec3 F0, float roughness) {
+	return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(1.0 - NdotV, 5.0);
 }
 
+// Split sum image based lighting, every integral is a texture lookup
 void main(){
-	o_Color = vec4(hsv2rgb(vec3(i_Texcoord.x,1.0, (i_Texcoord.y + 0.5)/1.5)), 1.0);
-}
\ No newline at end of file
+	vec3 N = normalize(i_Normal);
+	vec3 V = normalize(cameraPosition.xyz - i_Position);
+	vec3 R = reflect(-V, N);
+	float NdotV = max(dot(N, V), 1e-4);
+
+	vec3 F0 = mix(vec3(0.04), albedo.rgb, metallic);
+	vec3 F = FresnelSchlickRoughness(NdotV, F0, roughness);
+	vec3 kD = (1.0 - F) * (1.0 - metallic);
+
+	vec3 diffuse = texture(u_Irradiance, N).rgb * albedo.rgb;
+	vec3 prefiltered = textureLod(u_Prefiltered, R, roughness * prefilteredMaxLod).rgb;
+	vec2 brdf = texture(u_BrdfLut, vec2(NdotV, roughness)).rg;
+	vec3 specular = prefiltered * (F0 * brdf.x + brdf.y);
+
+	o_Color = vec4(kD * diffuse + specular, 1.0);
+}
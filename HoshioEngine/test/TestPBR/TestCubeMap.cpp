@@ -18,9 +18,8 @@ void TestCubeMap::InitResource()
 
 void TestCubeMap::CreateSampler()
 {
-	sampler_id = VulkanPlus::Plus().HasSampler("trilinear-sampler") ?
-		VulkanPlus::Plus().GetSampler("trilinear-sampler").first : 
-		VulkanPlus::Plus().CreateSampler("trilinear-sampler", Sampler::SamplerCreateInfo()).first;
+	//Identical create infos share one sampler, no need to check for an existing name
+	sampler_id = VulkanPlus::Plus().CreateSampler("trilinear-sampler", Sampler::SamplerCreateInfo()).first;
 }
 
 void TestCubeMap::CreateBuffer()
@@ -96,7 +95,8 @@ void TestCubeMap::CreateDescriptorSetLayout()
 			.binding = 1,
 			.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
 			.descriptorCount = 1,
-			.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT
+			.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+			.pImmutableSamplers = VulkanPlus::Plus().ImmutableSamplers(sampler_id)
 		}
 	};
 
@@ -124,9 +124,20 @@ void TestCubeMap::CreatePipelineLayout()
 
 void TestCubeMap::CreatePipeline()
 {
-	auto Create = [&] {
-		static ShaderModule vertModule("test/TestPBR/Resource/Shaders/SPIR-V/TestCubeMap.vert.spv");
-		static ShaderModule fragModule("test/TestPBR/Resource/Shaders/SPIR-V/TestCubeMap.frag.spv");
+	ShaderCompileInfo vertCi = {
+		.filePath = "test/TestPBR/Resource/shaders/GLSL/TestCubeMap.vert",
+		.stage = VK_SHADER_STAGE_VERTEX_BIT
+	};
+	ShaderCompileInfo fragCi = {
+		.filePath = "test/TestPBR/Resource/shaders/GLSL/TestCubeMap.frag",
+		.stage = VK_SHADER_STAGE_FRAGMENT_BIT
+	};
+	vert_module_id = VulkanPlus::Plus().CreateShaderModule("test-cubemap-vert", vertCi).first;
+	frag_module_id = VulkanPlus::Plus().CreateShaderModule("test-cubemap-frag", fragCi).first;
+
+	auto Configure = [&] {
+		ShaderModule& vertModule = VulkanPlus::Plus().GetShaderModule(vert_module_id).second[0];
+		ShaderModule& fragModule = VulkanPlus::Plus().GetShaderModule(frag_module_id).second[0];
 		PipelineConfigurator configurator;
 
 		PipelineLayout& pipeline_layout = VulkanPlus::Plus().GetPipelineLayout(pipeline_layout_id).second[0];
@@ -148,15 +159,27 @@ void TestCubeMap::CreatePipeline()
 			.AddShaderStage(vertModule.ShaderStageCi(VK_SHADER_STAGE_VERTEX_BIT))
 			.AddShaderStage(fragModule.ShaderStageCi(VK_SHADER_STAGE_FRAGMENT_BIT))
 			.UpdatePipelineCreateInfo();
+		return configurator;
+		};
+
+	auto Create = [this, Configure] {
+		PipelineConfigurator configurator = Configure();
 		pipeline_id = VulkanPlus::Plus().CreatePipeline("test-cubemap-pipeline", configurator).first;
 		};
 
+	//Edited shaders compile in the background, the old pipeline keeps drawing until the new one is collected
+	auto Request = [this, Configure] {
+		pipeline_id = VulkanPlus::Plus().RequestPipeline("test-cubemap-pipeline", Configure());
+		};
+
 	auto Destroy = [&] {
 		VulkanPlus::Plus().DestroyPipeline(pipeline_id);
 		};
 
 	VulkanBase::Base().AddCallback_CreateSwapchain(Create);
 	VulkanBase::Base().AddCallback_DestroySwapchain(Destroy);
+	VulkanPlus::Plus().WatchShaderModule("test-cubemap-vert", vertCi, Request);
+	VulkanPlus::Plus().WatchShaderModule("test-cubemap-frag", fragCi, Request);
 
 	Create();
 }
@@ -168,8 +191,8 @@ void TestCubeMap::CreateFramebuffers()
 
 void TestCubeMap::OtherOperations()
 {
-	Sampler& sampler = VulkanPlus::Plus().GetSampler(sampler_id).second[0];
-	descriptor_set.Write(cubemap.DescriptorImageInfo(sampler), VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1);
+	//The sampler is baked into the set layout
+	descriptor_set.Write(cubemap.DescriptorImageInfo(), VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1);
 }
 
 void TestCubeMap::UpdateDescriptorSets()
@@ -195,10 +218,9 @@ void TestCubeMap::RecordCommandBuffer()
 
 	const RenderPass& renderPass = VulkanPlus::Plus().SwapchainRenderPassWithDepthStencil();
 	const CommandBuffer& commandBuffer = VulkanPlus::Plus().CommandBuffer_Graphics();
-	const Framebuffer& framebuffer = VulkanPlus::Plus().CurrentSwapchainFramebufferWithDepthStencil();
 	PipelineLayout& pipeline_layout = VulkanPlus::Plus().GetPipelineLayout(pipeline_layout_id).second[0];
 	DescriptorSetLayout& uniform_set_layout = VulkanPlus::Plus().GetDescriptorSetLayout(descriptor_set_layout_id).second[0];
-	Pipeline& pipeline = VulkanPlus::Plus().GetPipeline(pipeline_id).second[0];
+	VkPipeline pipeline = VulkanPlus::Plus().ResolvePipeline(pipeline_id);
 
 	VkRect2D renderArea = { {}, VulkanBase::Base().SwapchainExtent() };
 	VkClearValue clearValues[2] = {
@@ -207,12 +229,14 @@ void TestCubeMap::RecordCommandBuffer()
 	};
 	VkDeviceSize offset = 0;
 
-	renderPass.Begin(commandBuffer, framebuffer, renderArea, clearValues);
-	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout,
-		0, 1, descriptor_set.Address(), 0, nullptr);
-	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertex_buffer.Address(), &offset);
-	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-	vkCmdDraw(commandBuffer, 36, 1, 0, 0);
+	VulkanPlus::Plus().BeginSwapchainRenderPass(commandBuffer, true, renderArea, clearValues);
+	if (pipeline) {
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout,
+			0, 1, descriptor_set.Address(), 0, nullptr);
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertex_buffer.Address(), &offset);
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		vkCmdDraw(commandBuffer, 36, 1, 0, 0);
+	}
 	renderPass.End(commandBuffer);
 }
 
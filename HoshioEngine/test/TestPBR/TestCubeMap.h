@@ -15,6 +15,8 @@ public:
 	int descriptor_set_layout_id = M_INVALID_ID;
 	int dsAttachments_id = M_INVALID_ID;
 	int framebuffers_id = M_INVALID_ID;
+	int vert_module_id = M_INVALID_ID;
+	int frag_module_id = M_INVALID_ID;
 
 	struct CubemapUniform {
 		glm::mat4 model = {};
@@ -4,6 +4,23 @@
 void TestPBR::InitResource()
 {
 	CreateSphere();
+
+	const char* const filepaths[6] = {
+		"test/TestPBR/Resource/images/cubemap/right.jpg",
+		"test/TestPBR/Resource/images/cubemap/left.jpg",
+		"test/TestPBR/Resource/images/cubemap/top.jpg",
+		"test/TestPBR/Resource/images/cubemap/bottom.jpg",
+		"test/TestPBR/Resource/images/cubemap/front.jpg",
+		"test/TestPBR/Resource/images/cubemap/back.jpg"
+	};
+	uint64_t sourceHash = IBLBaker::HashFiles(filepaths);
+	//The cube is only decoded when nothing is cached for these files
+	if (!IBLBaker::Baker().LoadCached(ibl, sourceHash)) {
+		//The JPGs are sRGB encoded, an sRGB view hands the bake linear radiance
+		TextureCube environment(filepaths, VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_R8G8B8A8_SRGB, false, true);
+		IBLBaker::Baker().Bake(ibl, environment, sourceHash);
+	}
+	fragment_uniform.prefilteredMaxLod = float(ibl.prefiltered.MipLevelCount() - 1);
 }
 
 void TestPBR::CreateSampler()
@@ -14,6 +31,7 @@ void TestPBR::CreateSampler()
 void TestPBR::CreateBuffer()
 {
 	vertex_uniform_buffer.Create(sizeof vertex_uniform);
+	fragment_uniform_buffer.Create(sizeof fragment_uniform);
 }
 
 void TestPBR::CreateRenderPass()
@@ -100,16 +118,36 @@ void TestPBR::CreateDescriptorSetLayout()
 		DescriptorSetLayout& uniform_set_layout = VulkanPlus::Plus().GetDescriptorSetLayout(uniform_set_layout_id).second[0];
 		VulkanPlus::Plus().DescriptorPool().AllocateDescriptorSets(uniform_set, uniform_set_layout);
 	}
+
+	//IBL: irradiance, prefiltered, BRDF LUT
+	{
+		VkDescriptorSetLayoutBinding bindings[3] = {};
+		for (uint32_t i = 0; i < 3; i++)
+			bindings[i] = {
+				.binding = i,
+				.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+				.descriptorCount = 1,
+				.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT
+			};
+		VkDescriptorSetLayoutCreateInfo createInfo = {
+			.bindingCount = 3,
+			.pBindings = bindings
+		};
+		ibl_set_layout_id = VulkanPlus::Plus().CreateDescriptorSetLayout("test-pbr-ibl-set-layout", createInfo).first;
+		DescriptorSetLayout& ibl_set_layout = VulkanPlus::Plus().GetDescriptorSetLayout(ibl_set_layout_id).second[0];
+		VulkanPlus::Plus().DescriptorPool().AllocateDescriptorSets(ibl_set, ibl_set_layout);
+	}
 }
 
 void TestPBR::CreatePipelineLayout()
 {
 	DescriptorSetLayout& sampler_set_layout = VulkanPlus::Plus().GetDescriptorSetLayout(shader_info.sampler_set_layout_id).second[0];
 	DescriptorSetLayout& uniform_set_layout = VulkanPlus::Plus().GetDescriptorSetLayout(uniform_set_layout_id).second[0];
-	VkDescriptorSetLayout layouts[] = { sampler_set_layout, uniform_set_layout };
+	DescriptorSetLayout& ibl_set_layout = VulkanPlus::Plus().GetDescriptorSetLayout(ibl_set_layout_id).second[0];
+	VkDescriptorSetLayout layouts[] = { sampler_set_layout, uniform_set_layout, ibl_set_layout };
 
 	VkPipelineLayoutCreateInfo createInfo = {
-		.setLayoutCount = 2,
+		.setLayoutCount = 3,
 		.pSetLayouts = layouts
 	};
 
@@ -118,11 +156,22 @@ void TestPBR::CreatePipelineLayout()
 
 void TestPBR::CreatePipeline()
 {
+	ShaderCompileInfo vertCi = {
+		.filePath = "test/TestPBR/Resource/shaders/GLSL/PBR.vert",
+		.stage = VK_SHADER_STAGE_VERTEX_BIT
+	};
+	ShaderCompileInfo fragCi = {
+		.filePath = "test/TestPBR/Resource/shaders/GLSL/PBR.frag",
+		.stage = VK_SHADER_STAGE_FRAGMENT_BIT
+	};
+	vert_module_id = VulkanPlus::Plus().CreateShaderModule("test-pbr-vert", vertCi).first;
+	frag_module_id = VulkanPlus::Plus().CreateShaderModule("test-pbr-frag", fragCi).first;
+
 	auto Create = [&] {
-		static ShaderModule vertModule("test/TestPBR/Resource/Shaders/SPIR-V/PBR.vert.spv");
-		static ShaderModule fragModule("test/TestPBR/Resource/Shaders/SPIR-V/PBR.frag.spv");
+		ShaderModule& vertModule = VulkanPlus::Plus().GetShaderModule(vert_module_id).second[0];
+		ShaderModule& fragModule = VulkanPlus::Plus().GetShaderModule(frag_module_id).second[0];
 		PipelineConfigurator configurator;
-		std::vector<VertexInputAttribute> vertex_input_attributes = sphere.GetVertexInputeAttributes();
+		std::pmr::vector<VertexInputAttribute> vertex_input_attributes = sphere.GetVertexInputeAttributes(&FrameMemory::Scratch());
 		uint32_t stride = sphere.GetVertexInputAttributesStride();
 		configurator.AddVertexInputBindings(0, stride, VK_VERTEX_INPUT_RATE_VERTEX);
 		for (auto& attribute : vertex_input_attributes) {
@@ -144,7 +193,7 @@ void TestPBR::CreatePipeline()
 			.FrontFace(VK_FRONT_FACE_COUNTER_CLOCKWISE)
 			.EnableDepthTest(VK_TRUE, VK_TRUE)
 			.RasterizationSamples(VK_SAMPLE_COUNT_1_BIT)
-			.PolygonMode(VK_POLYGON_MODE_LINE)
+			.PolygonMode(VK_POLYGON_MODE_FILL)
 			.LineWidth(1.0f)
 			.AddAttachmentState(0b1111)
 			.AddShaderStage(vertModule.ShaderStageCi(VK_SHADER_STAGE_VERTEX_BIT))
@@ -171,6 +220,11 @@ void TestPBR::CreateFramebuffers()
 void TestPBR::OtherOperations()
 {
 	sphere.SetupModel(shader_info);
+
+	VkSampler sampler = VulkanPlus::Plus().GetSampler(shader_info.sampler_id).second[0];
+	ibl_set.Write(ibl.irradiance.DescriptorImageInfo(sampler), VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
+	ibl_set.Write(ibl.prefiltered.DescriptorImageInfo(sampler), VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1);
+	ibl_set.Write(ibl.brdfLut.DescriptorImageInfo(sampler), VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2);
 }
 
 void TestPBR::UpdateDescriptorSets()
@@ -188,6 +242,17 @@ void TestPBR::UpdateDescriptorSets()
 	};
 
 	uniform_set.Write(bufferInfo, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0);
+
+	fragment_uniform.cameraPosition = glm::vec4(GlfwWindow::camera.Position(), 1.0f);
+	fragment_uniform_buffer.TransferData(&fragment_uniform, sizeof fragment_uniform);
+
+	VkDescriptorBufferInfo fragmentBufferInfo = {
+		.buffer = fragment_uniform_buffer,
+		.offset = 0,
+		.range = sizeof fragment_uniform
+	};
+
+	uniform_set.Write(fragmentBufferInfo, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1);
 }
 
 void TestPBR::RecordCommandBuffer()
@@ -196,7 +261,6 @@ void TestPBR::RecordCommandBuffer()
 
 	const RenderPass& renderPass = VulkanPlus::Plus().SwapchainRenderPassWithDepthStencil();
 	const CommandBuffer& commandBuffer = VulkanPlus::Plus().CommandBuffer_Graphics();
-	const Framebuffer& framebuffer = VulkanPlus::Plus().CurrentSwapchainFramebufferWithDepthStencil();
 
 	VkRect2D renderArea = { {}, VulkanBase::Base().SwapchainExtent() };
 	VkClearValue clearValues[2] = {
@@ -204,11 +268,12 @@ void TestPBR::RecordCommandBuffer()
 		{.depthStencil = { 1.f, 0 } }
 	};
 
-	renderPass.Begin(commandBuffer, framebuffer, renderArea, clearValues);
+	VulkanPlus::Plus().BeginSwapchainRenderPass(commandBuffer, true, renderArea, clearValues);
 	PipelineLayout& pipeline_layout = VulkanPlus::Plus().GetPipelineLayout(shader_info.pipeline_layout_id).second[0];
 	DescriptorSetLayout& uniform_set_layout = VulkanPlus::Plus().GetDescriptorSetLayout(uniform_set_layout_id).second[0];
+	VkDescriptorSet descriptorSets[] = { uniform_set, ibl_set };
 	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout,
-		1, 1, uniform_set.Address(), 0, nullptr);
+		1, 2, descriptorSets, 0, nullptr);
 	sphere.Render(shader_info);
 	renderPass.End(commandBuffer);
 }
@@ -220,7 +285,14 @@ void TestPBR::SendDataToNextNode()
 
 void TestPBR::CreateSphere(uint32_t segments, uint32_t rings, float radius)
 {
-	std::vector<Vertex> vertices;
+	VertexLayout layout;
+	layout.Add(VETEX_ATTRIBUTE_TYPE::POSITION, VK_FORMAT_R32G32B32_SFLOAT)
+		.Add(VETEX_ATTRIBUTE_TYPE::NORMAL, VK_FORMAT_R32G32B32_SFLOAT)
+		.Add(VETEX_ATTRIBUTE_TYPE::UV, VK_FORMAT_R32G32_SFLOAT);
+	VertexStream vertices(layout, (rings + 1) * (segments + 1));
+	StridedSpan<glm::vec3> positions = vertices.Attribute<glm::vec3>(0);
+	StridedSpan<glm::vec3> normals = vertices.Attribute<glm::vec3>(1);
+	StridedSpan<glm::vec2> uvs = vertices.Attribute<glm::vec2>(2);
 	std::vector<uint32_t> indices;
 	std::vector<TextureInfo> textures;
 
@@ -237,11 +309,10 @@ void TestPBR::CreateSphere(uint32_t segments, uint32_t rings, float radius)
 			vector.y = radius * glm::cos(theta);
 			vector.z = radius * glm::sin(theta) * glm::sin(phi);
 
-			Vertex vertex;
-			vertex.SetPosition(vector);
-			vertex.SetNormal(glm::normalize(vector));
-			vertex.AddUV(glm::vec2((float)x / segments, (float)y / rings));
-			vertices.push_back(vertex);
+			uint32_t i = y * (segments + 1) + x;
+			positions[i] = vector;
+			normals[i] = glm::normalize(vector);
+			uvs[i] = glm::vec2((float)x / segments, (float)y / rings);
 		}
 	}
 
@@ -263,10 +334,13 @@ void TestPBR::CreateSphere(uint32_t segments, uint32_t rings, float radius)
 		}
 	}
 	std::vector<Mesh> meshes;
-	meshes.emplace_back(vertices, indices, textures);
+	meshes.emplace_back(std::move(vertices), std::move(indices), std::move(textures));
 	sphere.LoadModel(meshes);
 }
 
 void TestPBR::ImguiRender()
 {
+	ImGui::ColorEdit3("Albedo", &fragment_uniform.albedo.x);
+	ImGui::SliderFloat("Metallic", &fragment_uniform.metallic, 0.0f, 1.0f);
+	ImGui::SliderFloat("Roughness", &fragment_uniform.roughness, 0.0f, 1.0f);
 }
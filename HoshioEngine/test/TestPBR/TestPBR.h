@@ -3,6 +3,7 @@
 
 #include "Engine/ShaderEditor/RenderGraph/RenderNode.h"
 #include "Engine/Actor/Model.h"
+#include "Plus/IBLBaker.h"
 
 using namespace HoshioEngine;
 
@@ -12,6 +13,8 @@ private:
 	ShaderInfo shader_info;
 	int dsAttachments_id = M_INVALID_ID;
 	int framebuffers_id = M_INVALID_ID;
+	int vert_module_id = M_INVALID_ID;
+	int frag_module_id = M_INVALID_ID;
 
 	struct VertexUniform {
 		glm::mat4 model = {};
@@ -19,11 +22,24 @@ private:
 		glm::mat4 proj = {};
 	}vertex_uniform;
 
+	struct FragmentUniform {
+		glm::vec4 cameraPosition = {};
+		glm::vec4 albedo = { 1.0f, 0.766f, 0.336f, 1.0f };
+		float metallic = 1.0f;
+		float roughness = 0.3f;
+		float prefilteredMaxLod = 0.0f;
+	}fragment_uniform;
+
 	UniformBuffer vertex_uniform_buffer;
 	UniformBuffer fragment_uniform_buffer;
 
 	int uniform_set_layout_id = M_INVALID_ID;
 	DescriptorSet uniform_set;
+
+	//Same environment as TestCubeMap, baked once and then loaded from cache/ibl
+	IBLMaps ibl;
+	int ibl_set_layout_id = M_INVALID_ID;
+	DescriptorSet ibl_set;
 	// ͨ RenderNode ̳
 	void InitResource() override;
 	void CreateSampler() override;
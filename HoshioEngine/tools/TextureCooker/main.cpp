@@ -0,0 +1,80 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include "Utils/TextureCooker.h"
+using namespace HoshioEngine;
+
+/*
+* Standalone target, links src/lib/Utils/TextureCooker.cpp and CommonUtils.cpp only.
+* Usage: TextureCooker [--bc7 | --bc5 | --rgba8] [--linear] [--no-mips] [--force] [--threads N] -o <output dir> <file or directory>...
+* Directories are walked recursively, outputs mirror the input tree with a .ktx2 extension.
+*/
+
+static bool IsSourceImage(const std::filesystem::path& path) {
+	std::string extension = path.extension().string();
+	for (char& c : extension)
+		c = char(std::tolower(uint8_t(c)));
+	return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+}
+
+int main(int argc, char** argv) {
+	CookOptions options;
+	bool force = false;
+	std::filesystem::path outputDirectory;
+	std::vector<std::filesystem::path> inputs;
+
+	for (int i = 1; i < argc; i++) {
+		std::string_view argument = argv[i];
+		if (argument == "--bc7")
+			options.format = COOK_FORMAT::BC7;
+		else if (argument == "--bc5")
+			options.format = COOK_FORMAT::BC5;
+		else if (argument == "--rgba8")
+			options.format = COOK_FORMAT::RGBA8;
+		else if (argument == "--linear")
+			options.srgb = false;
+		else if (argument == "--no-mips")
+			options.generateMips = false;
+		else if (argument == "--force")
+			force = true;
+		else if (argument == "--threads" && i + 1 < argc)
+			options.threadCount = uint32_t(std::stoul(argv[++i]));
+		else if (argument == "-o" && i + 1 < argc)
+			outputDirectory = argv[++i];
+		else
+			inputs.emplace_back(argument);
+	}
+	if (outputDirectory.empty() || inputs.empty()) {
+		std::cerr << "Usage: TextureCooker [--bc7 | --bc5 | --rgba8] [--linear] [--no-mips] [--force] [--threads N] -o <output dir> <file or directory>...\n";
+		return -1;
+	}
+
+	//(source, cooked) pairs
+	std::vector<std::pair<std::filesystem::path, std::filesystem::path>> jobs;
+	for (auto& input : inputs) {
+		if (std::filesystem::is_directory(input)) {
+			for (auto& entry : std::filesystem::recursive_directory_iterator(input))
+				if (entry.is_regular_file() && IsSourceImage(entry.path()))
+					jobs.emplace_back(entry.path(), (outputDirectory / std::filesystem::relative(entry.path(), input)).replace_extension(".ktx2"));
+		}
+		else
+			jobs.emplace_back(input, (outputDirectory / input.filename()).replace_extension(".ktx2"));
+	}
+
+	uint32_t cookedCount = 0, skippedCount = 0, failedCount = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (auto& [source, cooked] : jobs) {
+		try {
+			if (TextureCooker::Cook(source, cooked, options, force))
+				cookedCount++,
+				std::cout << std::format("Cooked {} -> {}\n", source.string(), cooked.string());
+			else
+				skippedCount++;
+		}
+		catch (const std::exception& e) {
+			failedCount++;
+			std::cerr << e.what();
+		}
+	}
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+	std::cout << std::format("{} cooked, {} up to date, {} failed in {} ms\n", cookedCount, skippedCount, failedCount, elapsed.count());
+	return failedCount ? 1 : 0;
+}